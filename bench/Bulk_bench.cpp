@@ -0,0 +1,664 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "CompactFigureBatch.h"
+#include "ConcurrentFigureStore.h"
+#include "FigureAggregates.h"
+#include "FigureBatch.h"
+#include "FigureEngine.h"
+#include "FigureIngest.h"
+#include "FigureOverlap.h"
+#include "FigureParser.h"
+#include "FigureWriter.h"
+#include "PointClassifier.h"
+#include "SpatialIndex.h"
+
+namespace {
+
+// 1K to 1M figures by default; FIGURES_BENCH_LARGE=1 adds 10M and 100M,
+// which need several GB of memory.
+void FigureCounts(benchmark::internal::Benchmark* benchmark) {
+	int64_t maxCount = 1000000;
+	const char* large = std::getenv("FIGURES_BENCH_LARGE");
+	if (large != nullptr && std::string(large) == "1") {
+		maxCount = 100000000;
+	}
+
+	for (int64_t count = 1000; count <= maxCount; count *= 10) {
+		benchmark->Arg(count);
+	}
+	benchmark->Unit(benchmark::kMillisecond);
+}
+
+HexagonBatch MakeBatch(uint64_t count) {
+	std::mt19937_64 generator(52);
+	std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+	HexagonBatch batch(count);
+	std::array<Point, 6> points;
+	for (uint64_t i = 0; i < count; ++i) {
+		for (Point& point : points) {
+			point = Point(distribution(generator), distribution(generator));
+		}
+		batch.PushBack(points);
+	}
+
+	return batch;
+}
+
+// Small hexagons scattered over a square that grows with count, so the
+// density stays at about one figure per unit of area.
+HexagonBatch MakeScatteredBatch(uint64_t count) {
+	std::mt19937_64 generator(53);
+	const double side = std::sqrt(static_cast<double>(count));
+	std::uniform_real_distribution<double> distribution(0.0, side);
+	HexagonBatch batch(count);
+	std::array<Point, 6> points;
+	for (uint64_t i = 0; i < count; ++i) {
+		const Point center(distribution(generator), distribution(generator));
+		for (uint64_t j = 0; j < 6; ++j) {
+			const double angle = 3.141592653589793 / 3 * static_cast<double>(j);
+			points[j] = Point(center.x + 0.5 * std::cos(angle), center.y + 0.5 * std::sin(angle));
+		}
+		batch.PushBack(points);
+	}
+
+	return batch;
+}
+
+std::vector<SpatialEntry> MakeScatteredEntries(uint64_t count) {
+	return MakeSpatialEntries(MakeScatteredBatch(count));
+}
+
+// count points spread uniformly over the square of MakeScatteredBatch().
+std::vector<Point> MakeScatteredPoints(uint64_t count, uint64_t figureCount) {
+	std::mt19937_64 generator(56);
+	std::uniform_real_distribution<double> distribution(0.0, std::sqrt(static_cast<double>(figureCount)));
+	std::vector<Point> points(count);
+	for (Point& point : points) {
+		point = Point(distribution(generator), distribution(generator));
+	}
+
+	return points;
+}
+
+std::string MakeText(uint64_t count) {
+	const HexagonBatch batch = MakeBatch(count);
+	std::ostringstream os;
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		for (uint64_t j = 0; j < 6; ++j) {
+			os << batch.GetPoint(i, j).x << ' ' << batch.GetPoint(i, j).y << ' ';
+		}
+		os << '\n';
+	}
+
+	return os.str();
+}
+
+void BM_IngestStream(benchmark::State& state) {
+	const std::string text = MakeText(static_cast<uint64_t>(state.range(0)));
+	for (auto _ : state) {
+		std::istringstream is(text);
+		std::vector<Hexagon> figures(static_cast<uint64_t>(state.range(0)));
+		for (Hexagon& figure : figures) {
+			is >> figure;
+		}
+		benchmark::DoNotOptimize(figures.data());
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IngestStream)->Apply(FigureCounts);
+
+void BM_IngestParser(benchmark::State& state) {
+	const std::string text = MakeText(static_cast<uint64_t>(state.range(0)));
+	for (auto _ : state) {
+		ParseResult<Hexagon> result = ParseFigures<Hexagon>(text.data(), text.size());
+		benchmark::DoNotOptimize(result.figures.data());
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IngestParser)->Apply(FigureCounts);
+
+// The hexagons of MakeText() split into files of 1000 figures, written once
+// per count and removed at exit.
+class IngestFiles {
+public:
+	~IngestFiles() {
+		for (const std::pair<const uint64_t, std::vector<std::string>>& entry : _paths) {
+			for (const std::string& path : entry.second) {
+				std::remove(path.c_str());
+			}
+		}
+	}
+
+	const std::vector<std::string>& Get(uint64_t count) {
+		std::vector<std::string>& paths = _paths[count];
+		if (!paths.empty()) {
+			return paths;
+		}
+
+		const std::string text = MakeText(count);
+		uint64_t begin = 0;
+		while (begin < text.size()) {
+			uint64_t end = begin;
+			for (uint64_t lines = 0; lines < 1000 && end < text.size(); ++lines) {
+				end = text.find('\n', end) + 1;
+			}
+			paths.push_back("/tmp/figures_bench_" + std::to_string(getpid()) + "_" + std::to_string(count) + "_" +
+							std::to_string(paths.size()));
+			std::ofstream file(paths.back(), std::ios::binary);
+			file.write(text.data() + begin, static_cast<std::streamsize>(end - begin));
+			begin = end;
+		}
+
+		return paths;
+	}
+private:
+	std::map<uint64_t, std::vector<std::string>> _paths;
+};
+
+IngestFiles ingestFiles;
+
+void BM_IngestFilesSequential(benchmark::State& state) {
+	const std::vector<std::string>& paths = ingestFiles.Get(static_cast<uint64_t>(state.range(0)));
+	for (auto _ : state) {
+		for (const std::string& path : paths) {
+			std::ifstream file(path, std::ios::binary);
+			ParseResult<Hexagon> result = ParseFigures<Hexagon>(file);
+			benchmark::DoNotOptimize(result.figures.data());
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IngestFilesSequential)->Apply(FigureCounts)->UseRealTime();
+
+void BM_IngestFiles(benchmark::State& state, IngestBackend backend) {
+	const std::vector<std::string>& paths = ingestFiles.Get(static_cast<uint64_t>(state.range(0)));
+	IngestOptions options;
+	options.amountOfPoints = 6;
+	options.readSize = 1 << 16;
+	options.backend = backend;
+	FigureIngest ingest(options);
+	for (auto _ : state) {
+		ingest.Run(paths, [](IngestBatch batch) { benchmark::DoNotOptimize(&batch); });
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(BM_IngestFiles, IoUring, IngestBackend::Automatic)->Apply(FigureCounts)->UseRealTime();
+BENCHMARK_CAPTURE(BM_IngestFiles, ThreadPool, IngestBackend::ThreadPool)->Apply(FigureCounts)->UseRealTime();
+
+void BM_ExportWriter(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	std::vector<char> buffer(1 << 20);
+	uint64_t bytes = 0;
+	for (auto _ : state) {
+		FigureTextWriter writer(buffer.data(), buffer.size(), [](const char* data, uint64_t) {
+			benchmark::DoNotOptimize(data);
+		});
+		writer.WriteLines(batch);
+		writer.Flush();
+		bytes = writer.GetBytesWritten();
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ExportWriter)->Apply(FigureCounts);
+
+void BM_TotalAreaVirtual(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	std::vector<std::unique_ptr<Figure>> figures;
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		figures.push_back(std::make_unique<Hexagon>(batch.GetFigure(i)));
+	}
+
+	for (auto _ : state) {
+		double total = 0;
+		for (const std::unique_ptr<Figure>& figure : figures) {
+			total += static_cast<double>(*figure);
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TotalAreaVirtual)->Apply(FigureCounts);
+
+void BM_TotalAreaBatch(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	FigureEngine engine(1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(engine.TotalArea(batch));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TotalAreaBatch)->Apply(FigureCounts);
+
+void BM_TotalAreaParallel(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	FigureEngine engine;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(engine.TotalArea(batch));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["threads"] = static_cast<double>(engine.GetThreadCount());
+}
+BENCHMARK(BM_TotalAreaParallel)->Apply(FigureCounts)->UseRealTime();
+
+void BM_GeometricCentersBatch(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	std::vector<Point> centers(batch.Size());
+	for (auto _ : state) {
+		batch.GeometricCenters(centers.data());
+		benchmark::DoNotOptimize(centers.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GeometricCentersBatch)->Apply(FigureCounts);
+
+// What keeping a dashboard current costs per changed figure: summing area
+// and weighted centers over the whole collection again, or updating the
+// aggregates of the one figure.
+void BM_AggregatesRecompute(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	std::vector<Hexagon> figures;
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		figures.push_back(batch.GetFigure(i));
+	}
+
+	uint64_t changed = 0;
+	for (auto _ : state) {
+		figures[changed++ % figures.size()].Translate(1, 0);
+		double total = 0;
+		Point weighted;
+		for (const Hexagon& figure : figures) {
+			const double area = static_cast<double>(figure);
+			const Point center = figure.GetGeometricCenter();
+			total += area;
+			weighted = Point(weighted.x + area * center.x, weighted.y + area * center.y);
+		}
+		benchmark::DoNotOptimize(total);
+		benchmark::DoNotOptimize(weighted);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AggregatesRecompute)->Apply(FigureCounts);
+
+void BM_AggregatesUpdate(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	std::vector<Hexagon> figures;
+	FigureAggregates aggregates({1, 10, 100, 1000, 10000});
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		figures.push_back(batch.GetFigure(i));
+		aggregates.Insert(i, figures.back());
+	}
+
+	uint64_t changed = 0;
+	for (auto _ : state) {
+		const uint64_t id = changed++ % figures.size();
+		figures[id].Translate(1, 0);
+		aggregates.Update(id, figures[id]);
+		benchmark::DoNotOptimize(aggregates.GetTotalArea());
+		benchmark::DoNotOptimize(aggregates.GetCentroid());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AggregatesUpdate)->Apply(FigureCounts)->Unit(benchmark::kNanosecond);
+
+// The same kernels on double, float32 and fixed-point coordinates; the
+// compact forms read half the bytes per figure.
+template <typename Batch>
+void BM_BatchAreas(benchmark::State& state) {
+	const Batch batch(MakeBatch(static_cast<uint64_t>(state.range(0))));
+	std::vector<double> areas(batch.Size());
+	for (auto _ : state) {
+		batch.Areas(areas.data());
+		benchmark::DoNotOptimize(areas.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_BatchAreas, HexagonBatch)->Apply(FigureCounts);
+BENCHMARK_TEMPLATE(BM_BatchAreas, FloatFigureBatch<6>)->Apply(FigureCounts);
+BENCHMARK_TEMPLATE(BM_BatchAreas, FixedPointFigureBatch<6>)->Apply(FigureCounts);
+
+template <typename Batch>
+void BM_BatchCenters(benchmark::State& state) {
+	const Batch batch(MakeBatch(static_cast<uint64_t>(state.range(0))));
+	std::vector<Point> centers(batch.Size());
+	for (auto _ : state) {
+		batch.GeometricCenters(centers.data());
+		benchmark::DoNotOptimize(centers.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_BatchCenters, FloatFigureBatch<6>)->Apply(FigureCounts);
+BENCHMARK_TEMPLATE(BM_BatchCenters, FixedPointFigureBatch<6>)->Apply(FigureCounts);
+
+void BM_FindOverlaps(benchmark::State& state) {
+	const FigureOutlines figures = MakeFigureOutlines(MakeScatteredBatch(static_cast<uint64_t>(state.range(0))));
+	ThreadPool pool;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(FindOverlaps(figures, pool));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["pairs"] = static_cast<double>(FindOverlaps(figures, pool).size());
+}
+BENCHMARK(BM_FindOverlaps)->Apply(FigureCounts)->UseRealTime();
+
+// Sorting through the virtual interface against computing the areas once
+// and ranking the keys.
+void BM_SortVirtual(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	std::vector<std::unique_ptr<Figure>> figures;
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		figures.push_back(std::make_unique<Hexagon>(batch.GetFigure(i)));
+	}
+
+	for (auto _ : state) {
+		std::vector<const Figure*> order;
+		order.reserve(figures.size());
+		for (const std::unique_ptr<Figure>& figure : figures) {
+			order.push_back(figure.get());
+		}
+		std::sort(order.begin(), order.end(), [](const Figure* first, const Figure* second) {
+			return static_cast<double>(*first) < static_cast<double>(*second);
+		});
+		benchmark::DoNotOptimize(order.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortVirtual)->Apply(FigureCounts);
+
+void BM_SortByArea(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	FigureEngine engine;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(engine.SortByArea(batch));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["threads"] = static_cast<double>(engine.GetThreadCount());
+}
+BENCHMARK(BM_SortByArea)->Apply(FigureCounts)->UseRealTime();
+
+void BM_TopByArea(benchmark::State& state) {
+	const HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	FigureEngine engine;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(engine.TopByArea(batch, 100));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TopByArea)->Apply(FigureCounts)->UseRealTime();
+
+void BM_TransformBatch(benchmark::State& state) {
+	HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	const AffineTransform transform = AffineTransform::Rotation(1e-3).Then(AffineTransform::Translation(1e-3, 0));
+	for (auto _ : state) {
+		batch.Transform(transform);
+		benchmark::DoNotOptimize(batch.GetXs(0));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformBatch)->Apply(FigureCounts);
+
+void BM_TransformParallel(benchmark::State& state) {
+	HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	const AffineTransform transform = AffineTransform::Rotation(1e-3).Then(AffineTransform::Translation(1e-3, 0));
+	FigureEngine engine;
+	for (auto _ : state) {
+		engine.Transform(batch, transform);
+		benchmark::DoNotOptimize(batch.GetXs(0));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["threads"] = static_cast<double>(engine.GetThreadCount());
+}
+BENCHMARK(BM_TransformParallel)->Apply(FigureCounts)->UseRealTime();
+
+void BM_RotateBatch(benchmark::State& state) {
+	HexagonBatch batch = MakeBatch(static_cast<uint64_t>(state.range(0)));
+	for (auto _ : state) {
+		batch.Rotate(1e-3);
+		benchmark::DoNotOptimize(batch.GetXs(0));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RotateBatch)->Apply(FigureCounts);
+
+void BM_RTreeBuild(benchmark::State& state) {
+	const std::vector<SpatialEntry> entries = MakeScatteredEntries(static_cast<uint64_t>(state.range(0)));
+	ThreadPool pool;
+	for (auto _ : state) {
+		RTree tree(entries, pool);
+		benchmark::DoNotOptimize(tree.GetHeight());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RTreeBuild)->Apply(FigureCounts)->UseRealTime();
+
+void BM_UniformGridBuild(benchmark::State& state) {
+	const std::vector<SpatialEntry> entries = MakeScatteredEntries(static_cast<uint64_t>(state.range(0)));
+	ThreadPool pool;
+	for (auto _ : state) {
+		UniformGrid grid(entries, pool);
+		benchmark::DoNotOptimize(grid.GetCellSize());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UniformGridBuild)->Apply(FigureCounts)->UseRealTime();
+
+// Windows of 10 x 10 units, about 100 figures each, and 10 nearest
+// neighbours at random points; reported per query.
+template <typename Index>
+void BM_WindowQuery(benchmark::State& state) {
+	const Index index(MakeScatteredEntries(static_cast<uint64_t>(state.range(0))));
+	const double side = std::sqrt(static_cast<double>(state.range(0)));
+	std::mt19937_64 generator(54);
+	std::uniform_real_distribution<double> distribution(0.0, side);
+	std::vector<uint64_t> ids;
+	for (auto _ : state) {
+		const double x = distribution(generator);
+		const double y = distribution(generator);
+		ids.clear();
+		index.Query(BoundingBox(x, y, x + 10, y + 10), ids);
+		benchmark::DoNotOptimize(ids.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_WindowQuery, RTree)->Apply(FigureCounts)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_WindowQuery, UniformGrid)->Apply(FigureCounts)->Unit(benchmark::kMicrosecond);
+
+template <typename Index>
+void BM_NearestQuery(benchmark::State& state) {
+	const Index index(MakeScatteredEntries(static_cast<uint64_t>(state.range(0))));
+	const double side = std::sqrt(static_cast<double>(state.range(0)));
+	std::mt19937_64 generator(55);
+	std::uniform_real_distribution<double> distribution(0.0, side);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(index.Nearest(Point(distribution(generator), distribution(generator)), 10));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_NearestQuery, RTree)->Apply(FigureCounts)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_NearestQuery, UniformGrid)->Apply(FigureCounts)->Unit(benchmark::kMicrosecond);
+
+// Point tests per second for one hexagon with every point inside its
+// bounding box, so no vector is rejected early.
+void BM_ContainsPoints(benchmark::State& state) {
+	std::array<Point, 6> outline;
+	for (uint64_t j = 0; j < 6; ++j) {
+		const double angle = 3.141592653589793 / 3 * static_cast<double>(j);
+		outline[j] = Point(std::cos(angle), std::sin(angle));
+	}
+	std::mt19937_64 generator(57);
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	std::vector<double> xs(4096);
+	std::vector<double> ys(4096);
+	for (uint64_t i = 0; i < xs.size(); ++i) {
+		xs[i] = distribution(generator);
+		ys[i] = distribution(generator);
+	}
+	std::vector<uint8_t> inside(xs.size());
+	for (auto _ : state) {
+		ContainsPoints(outline.data(), 6, xs.data(), ys.data(), xs.size(), inside.data());
+		benchmark::DoNotOptimize(inside.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(xs.size()));
+}
+BENCHMARK(BM_ContainsPoints);
+
+// Four points per figure, classified against all figures; reported per point.
+void BM_ClassifyPoints(benchmark::State& state) {
+	const uint64_t count = static_cast<uint64_t>(state.range(0));
+	const FigureOutlines figures = MakeFigureOutlines(MakeScatteredBatch(count));
+	const std::vector<Point> points = MakeScatteredPoints(4 * count, count);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(Classify(points.data(), points.size(), figures));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(points.size()));
+}
+BENCHMARK(BM_ClassifyPoints)->Apply(FigureCounts);
+
+// Readers look up areas by id in 100K figures while one more thread keeps
+// replacing figures, either through a ConcurrentFigureStore or through a
+// vector behind one mutex. Reported per read.
+class StoreWorkload {
+public:
+	virtual ~StoreWorkload() = default;
+public:
+	virtual void Replace(uint64_t index, const AnyFigure& figure) = 0;
+
+	void Start(uint64_t count) {
+		_count = count;
+		_writer = std::thread([this]() {
+			std::mt19937_64 generator(58);
+			const HexagonBatch batch = MakeBatch(1024);
+			for (uint64_t i = 0; !_stop.load(std::memory_order_relaxed); ++i) {
+				Replace(generator() % _count, batch.GetFigure(i % batch.Size()));
+			}
+		});
+	}
+
+	void Stop() {
+		_stop.store(true);
+		_writer.join();
+	}
+protected:
+	uint64_t _count = 0;
+private:
+	std::atomic<bool> _stop{false};
+	std::thread _writer;
+};
+
+class LockedStoreWorkload : public StoreWorkload {
+public:
+	explicit LockedStoreWorkload(uint64_t count) {
+		const HexagonBatch batch = MakeBatch(count);
+		for (uint64_t i = 0; i < count; ++i) {
+			_areas.push_back(static_cast<double>(batch.GetFigure(i)));
+			_figures.push_back(batch.GetFigure(i));
+		}
+		Start(count);
+	}
+public:
+	void Replace(uint64_t index, const AnyFigure& figure) override {
+		const double area = static_cast<double>(figure);
+		std::lock_guard<std::mutex> lock(_mutex);
+		_figures[index] = figure;
+		_areas[index] = area;
+	}
+
+	double GetArea(uint64_t index) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _areas[index];
+	}
+private:
+	std::mutex _mutex;
+	std::vector<AnyFigure> _figures;
+	std::vector<double> _areas;
+};
+
+class ConcurrentStoreWorkload : public StoreWorkload {
+public:
+	explicit ConcurrentStoreWorkload(uint64_t count) {
+		const HexagonBatch batch = MakeBatch(count);
+		for (uint64_t i = 0; i < count; ++i) {
+			_ids.push_back(_store.Insert(batch.GetFigure(i)));
+		}
+		Start(count);
+	}
+public:
+	void Replace(uint64_t index, const AnyFigure& figure) override {
+		_store.Replace(_ids[index], figure);
+	}
+
+	ConcurrentFigureStore& GetStore() noexcept {
+		return _store;
+	}
+
+	uint64_t GetId(uint64_t index) const {
+		return _ids[index];
+	}
+private:
+	ConcurrentFigureStore _store;
+	std::vector<uint64_t> _ids;
+};
+
+constexpr uint64_t storeFigureCount = 100000;
+
+std::unique_ptr<LockedStoreWorkload> lockedStore;
+std::unique_ptr<ConcurrentStoreWorkload> concurrentStore;
+
+void BM_StoreReadsLocked(benchmark::State& state) {
+	if (state.thread_index() == 0) {
+		lockedStore.reset();
+		lockedStore = std::make_unique<LockedStoreWorkload>(storeFigureCount);
+	}
+	std::mt19937_64 generator(59 + static_cast<uint64_t>(state.thread_index()));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(lockedStore->GetArea(generator() % storeFigureCount));
+	}
+	state.SetItemsProcessed(state.iterations());
+	if (state.thread_index() == 0) {
+		lockedStore->Stop();
+	}
+}
+BENCHMARK(BM_StoreReadsLocked)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_StoreReadsConcurrent(benchmark::State& state) {
+	if (state.thread_index() == 0) {
+		concurrentStore.reset();
+		concurrentStore = std::make_unique<ConcurrentStoreWorkload>(storeFigureCount);
+	}
+	std::mt19937_64 generator(59 + static_cast<uint64_t>(state.thread_index()));
+	// Made on the first iteration: the threads only wait for thread 0 to set
+	// the store up once the loop starts.
+	std::optional<ConcurrentFigureStore::Reader> reader;
+	for (auto _ : state) {
+		if (!reader) {
+			reader.emplace(concurrentStore->GetStore());
+		}
+		benchmark::DoNotOptimize(reader->GetArea(concurrentStore->GetId(generator() % storeFigureCount)));
+	}
+	reader.reset();
+	state.SetItemsProcessed(state.iterations());
+	// Other threads may still be destroying their readers, so the store
+	// lives on until the next run sets up a new one.
+	if (state.thread_index() == 0) {
+		concurrentStore->Stop();
+	}
+}
+BENCHMARK(BM_StoreReadsConcurrent)->ThreadRange(1, 8)->UseRealTime();
+
+}
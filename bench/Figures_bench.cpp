@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <sstream>
+#include "Figures.h"
+#include "CachedFigure.h"
+
+namespace {
+
+template <typename T>
+T MakeFigure(uint64_t seed) {
+	std::mt19937_64 generator(seed);
+	std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+	std::array<Point, T::amountOfPoints> points;
+	for (Point& point : points) {
+		point = Point(distribution(generator), distribution(generator));
+	}
+
+	return T(points);
+}
+
+void BM_PointEquality(benchmark::State& state) {
+	Point first(5.2, 6.66);
+	Point second(5.2, 6.66);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(&first);
+		benchmark::DoNotOptimize(first == second);
+	}
+}
+BENCHMARK(BM_PointEquality);
+
+void BM_PointLess(benchmark::State& state) {
+	Point first(5.2, 6.66);
+	Point second(5.2, 7.0);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(&first);
+		benchmark::DoNotOptimize(first < second);
+	}
+}
+BENCHMARK(BM_PointLess);
+
+template <typename T>
+void BM_Area(benchmark::State& state) {
+	const T figure = MakeFigure<T>(52);
+	const Figure& base = figure;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(&base);
+		benchmark::DoNotOptimize(static_cast<double>(base));
+	}
+}
+BENCHMARK_TEMPLATE(BM_Area, Rhombus);
+BENCHMARK_TEMPLATE(BM_Area, Pentagon);
+BENCHMARK_TEMPLATE(BM_Area, Hexagon);
+BENCHMARK_TEMPLATE(BM_Area, CachedHexagon);
+
+template <typename T>
+void BM_ShoelaceArea(benchmark::State& state) {
+	const T figure = MakeFigure<T>(52);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(&figure);
+		benchmark::DoNotOptimize(figure.GetArea(AreaMode::Shoelace));
+	}
+}
+BENCHMARK_TEMPLATE(BM_ShoelaceArea, Rhombus);
+BENCHMARK_TEMPLATE(BM_ShoelaceArea, Hexagon);
+
+template <typename T>
+void BM_GeometricCenter(benchmark::State& state) {
+	const T figure = MakeFigure<T>(52);
+	const Figure& base = figure;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(&base);
+		benchmark::DoNotOptimize(base.GetGeometricCenter());
+	}
+}
+BENCHMARK_TEMPLATE(BM_GeometricCenter, Rhombus);
+BENCHMARK_TEMPLATE(BM_GeometricCenter, Pentagon);
+BENCHMARK_TEMPLATE(BM_GeometricCenter, Hexagon);
+
+template <typename T>
+void BM_Equality(benchmark::State& state) {
+	const T first = MakeFigure<T>(52);
+	const T second = MakeFigure<T>(52);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(&first);
+		benchmark::DoNotOptimize(first == second);
+	}
+}
+BENCHMARK_TEMPLATE(BM_Equality, Rhombus);
+BENCHMARK_TEMPLATE(BM_Equality, Pentagon);
+BENCHMARK_TEMPLATE(BM_Equality, Hexagon);
+
+template <typename T>
+void BM_CopyAssignment(benchmark::State& state) {
+	const T source = MakeFigure<T>(52);
+	T destination;
+	for (auto _ : state) {
+		destination = source;
+		benchmark::DoNotOptimize(&destination);
+	}
+}
+BENCHMARK_TEMPLATE(BM_CopyAssignment, Rhombus);
+BENCHMARK_TEMPLATE(BM_CopyAssignment, Pentagon);
+BENCHMARK_TEMPLATE(BM_CopyAssignment, Hexagon);
+
+template <typename T>
+void BM_MoveAssignment(benchmark::State& state) {
+	T source = MakeFigure<T>(52);
+	T destination;
+	for (auto _ : state) {
+		destination = std::move(source);
+		source = std::move(destination);
+		benchmark::DoNotOptimize(&source);
+	}
+}
+BENCHMARK_TEMPLATE(BM_MoveAssignment, Rhombus);
+BENCHMARK_TEMPLATE(BM_MoveAssignment, Pentagon);
+BENCHMARK_TEMPLATE(BM_MoveAssignment, Hexagon);
+
+template <typename T>
+void BM_StreamInput(benchmark::State& state) {
+	std::ostringstream os;
+	const T source = MakeFigure<T>(52);
+	for (const Point& point : source.GetPoints()) {
+		os << point.x << ' ' << point.y << ' ';
+	}
+	const std::string text = os.str();
+
+	T figure;
+	for (auto _ : state) {
+		std::istringstream is(text);
+		is >> figure;
+		benchmark::DoNotOptimize(&figure);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK_TEMPLATE(BM_StreamInput, Rhombus);
+BENCHMARK_TEMPLATE(BM_StreamInput, Pentagon);
+BENCHMARK_TEMPLATE(BM_StreamInput, Hexagon);
+
+template <typename T>
+void BM_StreamOutput(benchmark::State& state) {
+	const T figure = MakeFigure<T>(52);
+	std::ostringstream os;
+	for (auto _ : state) {
+		os.str(std::string());
+		os << figure;
+		benchmark::DoNotOptimize(os.tellp());
+	}
+}
+BENCHMARK_TEMPLATE(BM_StreamOutput, Rhombus);
+BENCHMARK_TEMPLATE(BM_StreamOutput, Pentagon);
+BENCHMARK_TEMPLATE(BM_StreamOutput, Hexagon);
+
+}
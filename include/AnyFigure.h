@@ -0,0 +1,119 @@
+#ifndef ANY_FIGURE_H
+#define ANY_FIGURE_H
+
+#include "Figures.h"
+#include <cinttypes>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Value-semantic figure that is a Rhombus, a Pentagon or a Hexagon. It is
+// stored inline without a heap allocation, and its queries are dispatched by
+// a switch over the alternative, calling the concrete member by its
+// qualified name so no virtual call is made. AsFigure() hands the held
+// object to code written against the Figure interface.
+class AnyFigure {
+public:
+	AnyFigure();
+	AnyFigure(const Rhombus& rhombus);
+	AnyFigure(const Pentagon& pentagon);
+	AnyFigure(const Hexagon& hexagon);
+public:
+	Point GetGeometricCenter() const;
+	bool Contains(const Point& point) const;
+	uint64_t GetAmountOfPoints() const noexcept;
+	const Figure& AsFigure() const noexcept;
+
+	template <typename T>
+	bool Holds() const noexcept;
+	template <typename T>
+	const T* Get() const noexcept;
+
+	// Calls visitor with the held figure as its concrete type.
+	template <typename Visitor>
+	decltype(auto) Visit(Visitor&& visitor) const;
+public:
+	bool operator==(const AnyFigure& other) const;
+	bool operator!=(const AnyFigure& other) const;
+
+	friend std::ostream& operator<<(std::ostream& ostream, const AnyFigure& figure);
+
+	explicit operator double() const;
+private:
+	std::variant<Rhombus, Pentagon, Hexagon> _figure;
+};
+
+std::ostream& operator<<(std::ostream& ostream, const AnyFigure& figure);
+
+// Mixed figure collection that keeps every kind in its own contiguous array
+// of values. Figures are ordered by kind (rhombuses, then pentagons, then
+// hexagons) and by insertion within a kind; Areas() and GeometricCenters()
+// follow that order.
+class FigureArray {
+public:
+	void PushBack(const AnyFigure& figure);
+	void PushBack(const Rhombus& rhombus);
+	void PushBack(const Pentagon& pentagon);
+	void PushBack(const Hexagon& hexagon);
+
+	void Clear() noexcept;
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+
+	AnyFigure operator[](uint64_t index) const;
+
+	const std::vector<Rhombus>& GetRhombuses() const noexcept;
+	const std::vector<Pentagon>& GetPentagons() const noexcept;
+	const std::vector<Hexagon>& GetHexagons() const noexcept;
+
+	template <typename Function>
+	void ForEach(Function&& function) const;
+
+	std::vector<double> Areas() const;
+	std::vector<Point> GeometricCenters() const;
+	double TotalArea() const;
+
+	void Transform(const AffineTransform& transform);
+private:
+	std::vector<Rhombus> _rhombuses;
+	std::vector<Pentagon> _pentagons;
+	std::vector<Hexagon> _hexagons;
+};
+
+template <typename T>
+bool AnyFigure::Holds() const noexcept {
+	return std::holds_alternative<T>(_figure);
+}
+
+template <typename T>
+const T* AnyFigure::Get() const noexcept {
+	return std::get_if<T>(&_figure);
+}
+
+template <typename Visitor>
+decltype(auto) AnyFigure::Visit(Visitor&& visitor) const {
+	switch (_figure.index()) {
+		case 0:
+			return std::forward<Visitor>(visitor)(*std::get_if<0>(&_figure));
+		case 1:
+			return std::forward<Visitor>(visitor)(*std::get_if<1>(&_figure));
+		default:
+			return std::forward<Visitor>(visitor)(*std::get_if<2>(&_figure));
+	}
+}
+
+template <typename Function>
+void FigureArray::ForEach(Function&& function) const {
+	for (const Rhombus& rhombus : _rhombuses) {
+		function(rhombus);
+	}
+	for (const Pentagon& pentagon : _pentagons) {
+		function(pentagon);
+	}
+	for (const Hexagon& hexagon : _hexagons) {
+		function(hexagon);
+	}
+}
+
+#endif
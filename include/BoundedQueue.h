@@ -0,0 +1,107 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+// First-in first-out queue with a fixed capacity that connects pipeline
+// stages running on different threads. Push() waits while the queue is full
+// and Pop() while it is empty, so a fast stage cannot run ahead of a slow one
+// by more than the capacity. After Close() pushes fail and pops return what
+// is left, then fail.
+template <typename T>
+class BoundedQueue {
+public:
+	explicit BoundedQueue(uint64_t capacity);
+	BoundedQueue(const BoundedQueue& other) = delete;
+public:
+	BoundedQueue& operator=(const BoundedQueue& other) = delete;
+public:
+	// Returns false, dropping value, if the queue is closed.
+	bool Push(T value);
+	// Returns false if the queue is closed and empty.
+	bool Pop(T& value);
+	void Close();
+
+	bool IsClosed() const;
+	uint64_t Size() const;
+	uint64_t GetCapacity() const noexcept;
+private:
+	mutable std::mutex _mutex;
+	std::condition_variable _notEmpty;
+	std::condition_variable _notFull;
+	std::deque<T> _items;
+	uint64_t _capacity;
+	bool _closed;
+};
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(uint64_t capacity) : _capacity(capacity), _closed(false) {
+	if (capacity == 0) {
+		throw std::invalid_argument("Queue capacity must be positive");
+	}
+}
+
+template <typename T>
+bool BoundedQueue<T>::Push(T value) {
+	std::unique_lock<std::mutex> lock(_mutex);
+	_notFull.wait(lock, [this] { return _closed || _items.size() < _capacity; });
+	if (_closed) {
+		return false;
+	}
+
+	_items.push_back(std::move(value));
+	lock.unlock();
+	_notEmpty.notify_one();
+
+	return true;
+}
+
+template <typename T>
+bool BoundedQueue<T>::Pop(T& value) {
+	std::unique_lock<std::mutex> lock(_mutex);
+	_notEmpty.wait(lock, [this] { return _closed || !_items.empty(); });
+	if (_items.empty()) {
+		return false;
+	}
+
+	value = std::move(_items.front());
+	_items.pop_front();
+	lock.unlock();
+	_notFull.notify_one();
+
+	return true;
+}
+
+template <typename T>
+void BoundedQueue<T>::Close() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_closed = true;
+	}
+	_notEmpty.notify_all();
+	_notFull.notify_all();
+}
+
+template <typename T>
+bool BoundedQueue<T>::IsClosed() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _closed;
+}
+
+template <typename T>
+uint64_t BoundedQueue<T>::Size() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _items.size();
+}
+
+template <typename T>
+uint64_t BoundedQueue<T>::GetCapacity() const noexcept {
+	return _capacity;
+}
+
+#endif
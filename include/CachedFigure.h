@@ -0,0 +1,283 @@
+#ifndef CACHED_FIGURE_H
+#define CACHED_FIGURE_H
+
+#include "Figures.h"
+#include <atomic>
+#include <cinttypes>
+#include <iostream>
+#include <utility>
+
+// Value computed on first Get() and returned from then on. Concurrent
+// Get() calls are safe: the first caller stores the value, callers racing
+// with it compute their own copy instead of waiting. Reset() must not run
+// concurrently with anything else, like any other mutation.
+template <typename V>
+class LazyValue {
+public:
+	LazyValue() noexcept;
+	LazyValue(const LazyValue& other) noexcept;
+public:
+	LazyValue& operator=(const LazyValue& other) noexcept;
+public:
+	template <typename Compute>
+	V Get(Compute&& compute) const;
+	bool IsReady() const noexcept;
+	void Reset() noexcept;
+private:
+	static constexpr uint8_t emptyState = 0;
+	static constexpr uint8_t computingState = 1;
+	static constexpr uint8_t readyState = 2;
+private:
+	mutable std::atomic<uint8_t> _state;
+	mutable V _value;
+};
+
+template <typename T>
+class Cached;
+
+template <typename T>
+void swap(Cached<T>& firstFigure, Cached<T>& secondFigure) noexcept;
+
+template <typename T>
+std::istream& operator>>(std::istream& istream, Cached<T>& figure);
+template <typename T>
+std::ostream& operator<<(std::ostream& ostream, const Cached<T>& figure);
+
+// Figure whose area, geometric center and bounding box are computed on first
+// access and kept until the figure changes through assignment, swap(),
+// operator>> or a transform. It is an opt-in wrapper, so the plain figure classes keep
+// their compact layout. The cached values are the ones of the wrapped
+// figure, bit for bit.
+template <typename T>
+class Cached: public Figure {
+public:
+	using FigureType = T;
+	static constexpr uint64_t amountOfPoints = T::amountOfPoints;
+public:
+	Cached();
+	explicit Cached(const T& figure);
+	explicit Cached(const std::array<Point, amountOfPoints>& points);
+	Cached(const Cached& other);
+	Cached(Cached&& moved) noexcept;
+public:
+	Point GetGeometricCenter() const override;
+	BoundingBox GetBoundingBox() const;
+	// Rejects points with the cached bounding box before any edge test.
+	bool Contains(const Point& point) const override;
+	const T& GetFigure() const noexcept;
+
+	// Transforms the wrapped figure and drops the cached values.
+	void Transform(const AffineTransform& transform) override;
+	void Rotate(double angle);
+
+	// Whether area, center and bounding box are currently cached.
+	bool IsAreaCached() const noexcept;
+	bool IsCenterCached() const noexcept;
+	bool IsBoundingBoxCached() const noexcept;
+public:
+	friend void swap<T>(Cached& firstFigure, Cached& secondFigure) noexcept;
+public:
+	Cached& operator=(const Cached& other);
+	Cached& operator=(Cached&& other) noexcept;
+	Cached& operator=(const T& figure);
+
+	bool operator==(const Cached& other) const;
+
+	friend std::istream& operator>> <T>(std::istream& istream, Cached& figure);
+	friend std::ostream& operator<< <T>(std::ostream& ostream, const Cached& figure);
+
+	explicit operator double() const override;
+private:
+	void Invalidate() noexcept;
+private:
+	T _figure;
+	LazyValue<double> _area;
+	LazyValue<Point> _center;
+	LazyValue<BoundingBox> _boundingBox;
+};
+
+using CachedRhombus = Cached<Rhombus>;
+using CachedPentagon = Cached<Pentagon>;
+using CachedHexagon = Cached<Hexagon>;
+
+template <typename V>
+LazyValue<V>::LazyValue() noexcept : _state(emptyState), _value() {}
+
+template <typename V>
+LazyValue<V>::LazyValue(const LazyValue& other) noexcept : _state(emptyState), _value() {
+	*this = other;
+}
+
+template <typename V>
+LazyValue<V>& LazyValue<V>::operator=(const LazyValue& other) noexcept {
+	if (this != &other) {
+		if (other.IsReady()) {
+			_value = other._value;
+			_state.store(readyState, std::memory_order_relaxed);
+		} else {
+			_state.store(emptyState, std::memory_order_relaxed);
+		}
+	}
+
+	return *this;
+}
+
+template <typename V>
+template <typename Compute>
+V LazyValue<V>::Get(Compute&& compute) const {
+	if (_state.load(std::memory_order_acquire) == readyState) {
+		return _value;
+	}
+
+	V value = compute();
+	uint8_t expected = emptyState;
+	if (_state.compare_exchange_strong(expected, computingState, std::memory_order_acquire)) {
+		_value = value;
+		_state.store(readyState, std::memory_order_release);
+	}
+
+	return value;
+}
+
+template <typename V>
+bool LazyValue<V>::IsReady() const noexcept {
+	return _state.load(std::memory_order_acquire) == readyState;
+}
+
+template <typename V>
+void LazyValue<V>::Reset() noexcept {
+	_state.store(emptyState, std::memory_order_relaxed);
+}
+
+template <typename T>
+Cached<T>::Cached() : _figure() {}
+
+template <typename T>
+Cached<T>::Cached(const T& figure) : _figure(figure) {}
+
+template <typename T>
+Cached<T>::Cached(const std::array<Point, amountOfPoints>& points) : _figure(points) {}
+
+template <typename T>
+Cached<T>::Cached(const Cached& other) :
+	Figure(), _figure(other._figure), _area(other._area), _center(other._center), _boundingBox(other._boundingBox) {}
+
+template <typename T>
+Cached<T>::Cached(Cached&& moved) noexcept :
+	Figure(), _figure(std::move(moved._figure)), _area(moved._area), _center(moved._center),
+	_boundingBox(moved._boundingBox) {}
+
+template <typename T>
+Point Cached<T>::GetGeometricCenter() const {
+	return _center.Get([this]() { return _figure.T::GetGeometricCenter(); });
+}
+
+template <typename T>
+BoundingBox Cached<T>::GetBoundingBox() const {
+	return _boundingBox.Get([this]() { return _figure.GetBoundingBox(); });
+}
+
+template <typename T>
+bool Cached<T>::Contains(const Point& point) const {
+	return ContainmentBox(GetBoundingBox()).Contains(point) &&
+		   OutlineEdgesContain(_figure.GetPoints().data(), amountOfPoints, point);
+}
+
+template <typename T>
+const T& Cached<T>::GetFigure() const noexcept {
+	return _figure;
+}
+
+template <typename T>
+void Cached<T>::Transform(const AffineTransform& transform) {
+	Invalidate();
+	_figure.Transform(transform);
+}
+
+template <typename T>
+void Cached<T>::Rotate(double angle) {
+	Invalidate();
+	_figure.Rotate(angle);
+}
+
+template <typename T>
+bool Cached<T>::IsAreaCached() const noexcept {
+	return _area.IsReady();
+}
+
+template <typename T>
+bool Cached<T>::IsCenterCached() const noexcept {
+	return _center.IsReady();
+}
+
+template <typename T>
+bool Cached<T>::IsBoundingBoxCached() const noexcept {
+	return _boundingBox.IsReady();
+}
+
+template <typename T>
+void swap(Cached<T>& firstFigure, Cached<T>& secondFigure) noexcept {
+	using std::swap;
+	swap(firstFigure._figure, secondFigure._figure);
+	firstFigure.Invalidate();
+	secondFigure.Invalidate();
+}
+
+template <typename T>
+Cached<T>& Cached<T>::operator=(const Cached& other) {
+	if (this != &other) {
+		Cached copy(other);
+		swap(*this, copy);
+	}
+
+	return *this;
+}
+
+template <typename T>
+Cached<T>& Cached<T>::operator=(Cached&& other) noexcept {
+	if (this != &other) {
+		Cached moved(std::move(other));
+		swap(*this, moved);
+	}
+
+	return *this;
+}
+
+template <typename T>
+Cached<T>& Cached<T>::operator=(const T& figure) {
+	_figure = figure;
+	Invalidate();
+
+	return *this;
+}
+
+template <typename T>
+bool Cached<T>::operator==(const Cached& other) const {
+	return _figure == other._figure;
+}
+
+template <typename T>
+std::istream& operator>>(std::istream& istream, Cached<T>& figure) {
+	figure.Invalidate();
+
+	return istream >> figure._figure;
+}
+
+template <typename T>
+std::ostream& operator<<(std::ostream& ostream, const Cached<T>& figure) {
+	return ostream << figure._figure;
+}
+
+template <typename T>
+Cached<T>::operator double() const {
+	return _area.Get([this]() { return _figure.T::operator double(); });
+}
+
+template <typename T>
+void Cached<T>::Invalidate() noexcept {
+	_area.Reset();
+	_center.Reset();
+	_boundingBox.Reset();
+}
+
+#endif
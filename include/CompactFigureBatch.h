@@ -0,0 +1,564 @@
+#ifndef COMPACT_FIGURE_BATCH_H
+#define COMPACT_FIGURE_BATCH_H
+
+#include "Figures.h"
+#include "FigureBatch.h"
+#include "FigureKernels.h"
+#include <array>
+#include <cfloat>
+#include <cinttypes>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Compact variants of FigureBatch that keep every coordinate in four bytes
+// instead of eight, so twice as many figures fit in a cache line or a GB of
+// memory (and more than twice as many as RegularPolygon objects, which also
+// carry a vptr). The area and center kernels read the compact arrays
+// directly and widen each value to double as it is loaded; their results are
+// bit-identical to GetFigure(i).GetArea(mode) / GetGeometricCenter() on the
+// decoded figure, on every instruction set.
+//
+// Encoding moves each coordinate by at most GetCoordinateError() = d. With
+// r = sqrt(2) * d the largest distance a vertex moves, the exact values of
+// the decoded figure differ from those of the original by at most:
+//   geometric center  d in each coordinate;
+//   shoelace area     r * P + N * r^2 / 2, P the perimeter;
+//   classic area      c * (4 * r * s + 4 * r^2) for the regular polygon area
+//                     c * s^2 with s the shortest side, and 2 * r * T + 3 * r^2
+//                     for a rhombus, T the perimeter of vertices 0, 1 and 2.
+// The double arithmetic on the decoded coordinates then rounds exactly as it
+// does in FigureBatch.
+
+// float32 coordinates. Rounding to nearest gives d = 2^-24 times the largest
+// magnitude stored (2^-150 for subnormals), so the error is relative to how
+// far figures lie from (0, 0): use FixedPointFigureBatch for figures far from
+// the origin of their coordinate system.
+template <uint64_t N>
+class FloatFigureBatch {
+public:
+	using FigureType = typename BatchFigure<N>::Type;
+	static constexpr uint64_t amountOfPoints = N;
+public:
+	FloatFigureBatch();
+	explicit FloatFigureBatch(const FigureBatch<N>& batch);
+public:
+	void Reserve(uint64_t capacity);
+	void Clear() noexcept;
+
+	// Throws std::invalid_argument if a finite coordinate exceeds the float
+	// range.
+	void PushBack(const FigureType& figure);
+	void PushBack(const std::array<Point, N>& points);
+
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+
+	Point GetPoint(uint64_t figureIndex, uint64_t pointIndex) const;
+	FigureType GetFigure(uint64_t figureIndex) const;
+	FigureBatch<N> ToFigureBatch() const;
+
+	const float* GetXs(uint64_t pointIndex) const;
+	const float* GetYs(uint64_t pointIndex) const;
+
+	double GetCoordinateError() const noexcept;
+public:
+	void Areas(double* out, AreaMode mode = AreaMode::Classic) const;
+	void GeometricCenters(Point* out) const;
+
+	std::vector<double> Areas(AreaMode mode = AreaMode::Classic) const;
+	std::vector<Point> GeometricCenters() const;
+private:
+	std::array<std::vector<float>, N> _xs;
+	std::array<std::vector<float>, N> _ys;
+	uint64_t _size;
+	double _maxMagnitude;
+private:
+	static float Encode(double value);
+	std::array<const float*, N> GetXPointers() const;
+	std::array<const float*, N> GetYPointers() const;
+};
+
+// int32 fixed-point coordinates: value q stands for origin + step * q, with
+// one origin and step for the whole batch, so d = step / 2 everywhere in the
+// range (plus a few units in the last place of the decoded double). Built
+// from a FigureBatch it picks the origin and the finest step that cover all
+// of its coordinates.
+template <uint64_t N>
+class FixedPointFigureBatch {
+public:
+	using FigureType = typename BatchFigure<N>::Type;
+	static constexpr uint64_t amountOfPoints = N;
+public:
+	// Throws std::invalid_argument unless step is finite and positive and
+	// origin is finite.
+	FixedPointFigureBatch(const Point& origin, double step);
+	explicit FixedPointFigureBatch(const FigureBatch<N>& batch);
+	FixedPointFigureBatch(const FigureBatch<N>& batch, const Point& origin, double step);
+public:
+	void Reserve(uint64_t capacity);
+	void Clear() noexcept;
+
+	// Throws std::invalid_argument if a coordinate falls outside the range
+	// the origin and step can represent, or is not finite.
+	void PushBack(const FigureType& figure);
+	void PushBack(const std::array<Point, N>& points);
+
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+
+	const Point& GetOrigin() const noexcept;
+	double GetStep() const noexcept;
+
+	Point GetPoint(uint64_t figureIndex, uint64_t pointIndex) const;
+	FigureType GetFigure(uint64_t figureIndex) const;
+	FigureBatch<N> ToFigureBatch() const;
+
+	const int32_t* GetXs(uint64_t pointIndex) const;
+	const int32_t* GetYs(uint64_t pointIndex) const;
+
+	double GetCoordinateError() const noexcept;
+public:
+	void Areas(double* out, AreaMode mode = AreaMode::Classic) const;
+	void GeometricCenters(Point* out) const;
+
+	std::vector<double> Areas(AreaMode mode = AreaMode::Classic) const;
+	std::vector<Point> GeometricCenters() const;
+private:
+	std::array<std::vector<int32_t>, N> _xs;
+	std::array<std::vector<int32_t>, N> _ys;
+	uint64_t _size;
+	Point _origin;
+	double _step;
+private:
+	static FixedPointFigureBatch Fit(const FigureBatch<N>& batch);
+	int32_t Encode(double value, double origin) const;
+	std::array<const int32_t*, N> GetXPointers() const;
+	std::array<const int32_t*, N> GetYPointers() const;
+};
+
+template <uint64_t N>
+FloatFigureBatch<N>::FloatFigureBatch() : _size(0), _maxMagnitude(0) {}
+
+template <uint64_t N>
+FloatFigureBatch<N>::FloatFigureBatch(const FigureBatch<N>& batch) : FloatFigureBatch() {
+	Reserve(batch.Size());
+	std::array<Point, N> points;
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		for (uint64_t j = 0; j < N; ++j) {
+			points[j] = batch.GetPoint(i, j);
+		}
+		PushBack(points);
+	}
+}
+
+template <uint64_t N>
+void FloatFigureBatch<N>::Reserve(uint64_t capacity) {
+	for (uint64_t i = 0; i < N; ++i) {
+		_xs[i].reserve(capacity);
+		_ys[i].reserve(capacity);
+	}
+}
+
+template <uint64_t N>
+void FloatFigureBatch<N>::Clear() noexcept {
+	for (uint64_t i = 0; i < N; ++i) {
+		_xs[i].clear();
+		_ys[i].clear();
+	}
+	_size = 0;
+	_maxMagnitude = 0;
+}
+
+template <uint64_t N>
+void FloatFigureBatch<N>::PushBack(const FigureType& figure) {
+	PushBack(figure.GetPoints());
+}
+
+template <uint64_t N>
+void FloatFigureBatch<N>::PushBack(const std::array<Point, N>& points) {
+	std::array<float, 2 * N> encoded;
+	double maxMagnitude = _maxMagnitude;
+	for (uint64_t i = 0; i < N; ++i) {
+		encoded[2 * i] = Encode(points[i].x);
+		encoded[2 * i + 1] = Encode(points[i].y);
+		for (double value : {points[i].x, points[i].y}) {
+			if (std::isfinite(value)) {
+				maxMagnitude = std::max(maxMagnitude, std::fabs(value));
+			}
+		}
+	}
+
+	for (uint64_t i = 0; i < N; ++i) {
+		_xs[i].push_back(encoded[2 * i]);
+		_ys[i].push_back(encoded[2 * i + 1]);
+	}
+	++_size;
+	_maxMagnitude = maxMagnitude;
+}
+
+template <uint64_t N>
+uint64_t FloatFigureBatch<N>::Size() const noexcept {
+	return _size;
+}
+
+template <uint64_t N>
+bool FloatFigureBatch<N>::Empty() const noexcept {
+	return _size == 0;
+}
+
+template <uint64_t N>
+Point FloatFigureBatch<N>::GetPoint(uint64_t figureIndex, uint64_t pointIndex) const {
+	if (figureIndex >= _size || pointIndex >= N) {
+		throw std::out_of_range("Index out of range");
+	}
+
+	return {_xs[pointIndex][figureIndex], _ys[pointIndex][figureIndex]};
+}
+
+template <uint64_t N>
+typename FloatFigureBatch<N>::FigureType FloatFigureBatch<N>::GetFigure(uint64_t figureIndex) const {
+	std::array<Point, N> points;
+	for (uint64_t i = 0; i < N; ++i) {
+		points[i] = GetPoint(figureIndex, i);
+	}
+
+	return FigureType(points);
+}
+
+template <uint64_t N>
+FigureBatch<N> FloatFigureBatch<N>::ToFigureBatch() const {
+	FigureBatch<N> batch(_size);
+	std::array<Point, N> points;
+	for (uint64_t i = 0; i < _size; ++i) {
+		for (uint64_t j = 0; j < N; ++j) {
+			points[j] = Point(_xs[j][i], _ys[j][i]);
+		}
+		batch.PushBack(points);
+	}
+
+	return batch;
+}
+
+template <uint64_t N>
+const float* FloatFigureBatch<N>::GetXs(uint64_t pointIndex) const {
+	return _xs.at(pointIndex).data();
+}
+
+template <uint64_t N>
+const float* FloatFigureBatch<N>::GetYs(uint64_t pointIndex) const {
+	return _ys.at(pointIndex).data();
+}
+
+template <uint64_t N>
+double FloatFigureBatch<N>::GetCoordinateError() const noexcept {
+	return std::ldexp(_maxMagnitude, -24) + std::ldexp(1.0, -150);
+}
+
+template <uint64_t N>
+void FloatFigureBatch<N>::Areas(double* out, AreaMode mode) const {
+	FIGURES_TIME_STAGE(Areas, _size);
+	FIGURES_COUNT_N(AreaComputations, _size);
+	std::array<const float*, N> xs = GetXPointers();
+	std::array<const float*, N> ys = GetYPointers();
+
+	if (mode == AreaMode::Shoelace) {
+		ComputeFloatShoelaceAreas(N, xs.data(), ys.data(), _size, out);
+	} else if constexpr (N == 4) {
+		ComputeFloatRhombusAreas(xs.data(), ys.data(), _size, out);
+	} else {
+		ComputeFloatRegularPolygonAreas(N, xs.data(), ys.data(), _size, out);
+	}
+}
+
+template <uint64_t N>
+void FloatFigureBatch<N>::GeometricCenters(Point* out) const {
+	FIGURES_TIME_STAGE(Centers, _size);
+	FIGURES_COUNT_N(CenterComputations, _size);
+	std::array<const float*, N> xs = GetXPointers();
+	std::array<const float*, N> ys = GetYPointers();
+	ComputeFloatGeometricCenters(N, xs.data(), ys.data(), _size, out);
+}
+
+template <uint64_t N>
+std::vector<double> FloatFigureBatch<N>::Areas(AreaMode mode) const {
+	std::vector<double> areas(_size);
+	Areas(areas.data(), mode);
+
+	return areas;
+}
+
+template <uint64_t N>
+std::vector<Point> FloatFigureBatch<N>::GeometricCenters() const {
+	std::vector<Point> centers(_size);
+	GeometricCenters(centers.data());
+
+	return centers;
+}
+
+template <uint64_t N>
+float FloatFigureBatch<N>::Encode(double value) {
+	// Converting a finite double beyond the float range is undefined.
+	if (std::isfinite(value) && std::fabs(value) > FLT_MAX) {
+		throw std::invalid_argument("Coordinate does not fit in a float");
+	}
+
+	return static_cast<float>(value);
+}
+
+template <uint64_t N>
+std::array<const float*, N> FloatFigureBatch<N>::GetXPointers() const {
+	std::array<const float*, N> pointers;
+	for (uint64_t i = 0; i < N; ++i) {
+		pointers[i] = _xs[i].data();
+	}
+
+	return pointers;
+}
+
+template <uint64_t N>
+std::array<const float*, N> FloatFigureBatch<N>::GetYPointers() const {
+	std::array<const float*, N> pointers;
+	for (uint64_t i = 0; i < N; ++i) {
+		pointers[i] = _ys[i].data();
+	}
+
+	return pointers;
+}
+
+template <uint64_t N>
+FixedPointFigureBatch<N>::FixedPointFigureBatch(const Point& origin, double step) : _size(0), _origin(origin), _step(step) {
+	if (!std::isfinite(origin.x) || !std::isfinite(origin.y)) {
+		throw std::invalid_argument("Fixed-point origin must be finite");
+	}
+	if (!std::isfinite(step) || !(step > 0)) {
+		throw std::invalid_argument("Fixed-point step must be finite and positive");
+	}
+}
+
+template <uint64_t N>
+FixedPointFigureBatch<N>::FixedPointFigureBatch(const FigureBatch<N>& batch) : FixedPointFigureBatch(Fit(batch)) {}
+
+template <uint64_t N>
+FixedPointFigureBatch<N>::FixedPointFigureBatch(const FigureBatch<N>& batch, const Point& origin, double step) :
+	FixedPointFigureBatch(origin, step) {
+	Reserve(batch.Size());
+	std::array<Point, N> points;
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		for (uint64_t j = 0; j < N; ++j) {
+			points[j] = batch.GetPoint(i, j);
+		}
+		PushBack(points);
+	}
+}
+
+template <uint64_t N>
+void FixedPointFigureBatch<N>::Reserve(uint64_t capacity) {
+	for (uint64_t i = 0; i < N; ++i) {
+		_xs[i].reserve(capacity);
+		_ys[i].reserve(capacity);
+	}
+}
+
+template <uint64_t N>
+void FixedPointFigureBatch<N>::Clear() noexcept {
+	for (uint64_t i = 0; i < N; ++i) {
+		_xs[i].clear();
+		_ys[i].clear();
+	}
+	_size = 0;
+}
+
+template <uint64_t N>
+void FixedPointFigureBatch<N>::PushBack(const FigureType& figure) {
+	PushBack(figure.GetPoints());
+}
+
+template <uint64_t N>
+void FixedPointFigureBatch<N>::PushBack(const std::array<Point, N>& points) {
+	std::array<int32_t, 2 * N> encoded;
+	for (uint64_t i = 0; i < N; ++i) {
+		encoded[2 * i] = Encode(points[i].x, _origin.x);
+		encoded[2 * i + 1] = Encode(points[i].y, _origin.y);
+	}
+
+	for (uint64_t i = 0; i < N; ++i) {
+		_xs[i].push_back(encoded[2 * i]);
+		_ys[i].push_back(encoded[2 * i + 1]);
+	}
+	++_size;
+}
+
+template <uint64_t N>
+uint64_t FixedPointFigureBatch<N>::Size() const noexcept {
+	return _size;
+}
+
+template <uint64_t N>
+bool FixedPointFigureBatch<N>::Empty() const noexcept {
+	return _size == 0;
+}
+
+template <uint64_t N>
+const Point& FixedPointFigureBatch<N>::GetOrigin() const noexcept {
+	return _origin;
+}
+
+template <uint64_t N>
+double FixedPointFigureBatch<N>::GetStep() const noexcept {
+	return _step;
+}
+
+// The same expression the kernels decode with.
+template <uint64_t N>
+Point FixedPointFigureBatch<N>::GetPoint(uint64_t figureIndex, uint64_t pointIndex) const {
+	if (figureIndex >= _size || pointIndex >= N) {
+		throw std::out_of_range("Index out of range");
+	}
+
+	return {_origin.x + _step * static_cast<double>(_xs[pointIndex][figureIndex]),
+			_origin.y + _step * static_cast<double>(_ys[pointIndex][figureIndex])};
+}
+
+template <uint64_t N>
+typename FixedPointFigureBatch<N>::FigureType FixedPointFigureBatch<N>::GetFigure(uint64_t figureIndex) const {
+	std::array<Point, N> points;
+	for (uint64_t i = 0; i < N; ++i) {
+		points[i] = GetPoint(figureIndex, i);
+	}
+
+	return FigureType(points);
+}
+
+template <uint64_t N>
+FigureBatch<N> FixedPointFigureBatch<N>::ToFigureBatch() const {
+	FigureBatch<N> batch(_size);
+	std::array<Point, N> points;
+	for (uint64_t i = 0; i < _size; ++i) {
+		for (uint64_t j = 0; j < N; ++j) {
+			points[j] = GetPoint(i, j);
+		}
+		batch.PushBack(points);
+	}
+
+	return batch;
+}
+
+template <uint64_t N>
+const int32_t* FixedPointFigureBatch<N>::GetXs(uint64_t pointIndex) const {
+	return _xs.at(pointIndex).data();
+}
+
+template <uint64_t N>
+const int32_t* FixedPointFigureBatch<N>::GetYs(uint64_t pointIndex) const {
+	return _ys.at(pointIndex).data();
+}
+
+// Half a step from rounding, and the two roundings of the decoding, each at
+// most one unit in the last place of a value no larger than
+// |origin| + 2^31 * step.
+template <uint64_t N>
+double FixedPointFigureBatch<N>::GetCoordinateError() const noexcept {
+	const double largest = std::max(std::fabs(_origin.x), std::fabs(_origin.y)) + 2147483648.0 * _step;
+	return 0.5 * _step + 2 * DBL_EPSILON * largest;
+}
+
+template <uint64_t N>
+void FixedPointFigureBatch<N>::Areas(double* out, AreaMode mode) const {
+	FIGURES_TIME_STAGE(Areas, _size);
+	FIGURES_COUNT_N(AreaComputations, _size);
+	std::array<const int32_t*, N> xs = GetXPointers();
+	std::array<const int32_t*, N> ys = GetYPointers();
+
+	if (mode == AreaMode::Shoelace) {
+		ComputeFixedPointShoelaceAreas(N, xs.data(), ys.data(), _origin, _step, _size, out);
+	} else if constexpr (N == 4) {
+		ComputeFixedPointRhombusAreas(xs.data(), ys.data(), _origin, _step, _size, out);
+	} else {
+		ComputeFixedPointRegularPolygonAreas(N, xs.data(), ys.data(), _origin, _step, _size, out);
+	}
+}
+
+template <uint64_t N>
+void FixedPointFigureBatch<N>::GeometricCenters(Point* out) const {
+	FIGURES_TIME_STAGE(Centers, _size);
+	FIGURES_COUNT_N(CenterComputations, _size);
+	std::array<const int32_t*, N> xs = GetXPointers();
+	std::array<const int32_t*, N> ys = GetYPointers();
+	ComputeFixedPointGeometricCenters(N, xs.data(), ys.data(), _origin, _step, _size, out);
+}
+
+template <uint64_t N>
+std::vector<double> FixedPointFigureBatch<N>::Areas(AreaMode mode) const {
+	std::vector<double> areas(_size);
+	Areas(areas.data(), mode);
+
+	return areas;
+}
+
+template <uint64_t N>
+std::vector<Point> FixedPointFigureBatch<N>::GeometricCenters() const {
+	std::vector<Point> centers(_size);
+	GeometricCenters(centers.data());
+
+	return centers;
+}
+
+// The origin goes to the middle of the bounding box of all coordinates and
+// the step spreads the larger half-extent over the whole int32 range, less
+// one step so that rounding in Encode stays inside it.
+template <uint64_t N>
+FixedPointFigureBatch<N> FixedPointFigureBatch<N>::Fit(const FigureBatch<N>& batch) {
+	BoundingBox bounds;
+	for (uint64_t i = 0; i < N; ++i) {
+		for (uint64_t j = 0; j < batch.Size(); ++j) {
+			const Point point(batch.GetXs(i)[j], batch.GetYs(i)[j]);
+			if (!std::isfinite(point.x) || !std::isfinite(point.y)) {
+				throw std::invalid_argument("Coordinate does not fit in fixed point");
+			}
+			bounds.Expand(point);
+		}
+	}
+	if (bounds.Empty()) {
+		return FixedPointFigureBatch(Point(), 1);
+	}
+
+	const Point origin(bounds.minX + (bounds.maxX - bounds.minX) / 2, bounds.minY + (bounds.maxY - bounds.minY) / 2);
+	const double halfExtent = std::max(bounds.maxX - bounds.minX, bounds.maxY - bounds.minY) / 2;
+	const double step = halfExtent > 0 ? halfExtent / (std::numeric_limits<int32_t>::max() - 1) : 1;
+
+	return FixedPointFigureBatch(batch, origin, step);
+}
+
+template <uint64_t N>
+int32_t FixedPointFigureBatch<N>::Encode(double value, double origin) const {
+	const double rounded = std::round((value - origin) / _step);
+	if (!(rounded >= std::numeric_limits<int32_t>::min() && rounded <= std::numeric_limits<int32_t>::max())) {
+		throw std::invalid_argument("Coordinate does not fit in fixed point");
+	}
+
+	return static_cast<int32_t>(rounded);
+}
+
+template <uint64_t N>
+std::array<const int32_t*, N> FixedPointFigureBatch<N>::GetXPointers() const {
+	std::array<const int32_t*, N> pointers;
+	for (uint64_t i = 0; i < N; ++i) {
+		pointers[i] = _xs[i].data();
+	}
+
+	return pointers;
+}
+
+template <uint64_t N>
+std::array<const int32_t*, N> FixedPointFigureBatch<N>::GetYPointers() const {
+	std::array<const int32_t*, N> pointers;
+	for (uint64_t i = 0; i < N; ++i) {
+		pointers[i] = _ys[i].data();
+	}
+
+	return pointers;
+}
+
+#endif
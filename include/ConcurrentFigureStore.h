@@ -0,0 +1,177 @@
+#ifndef CONCURRENT_FIGURE_STORE_H
+#define CONCURRENT_FIGURE_STORE_H
+
+#include "Figures.h"
+#include "AnyFigure.h"
+#include <atomic>
+#include <cinttypes>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+// Epoch-based reclamation. A reader enters the domain before it loads a
+// shared pointer and exits once it no longer uses what it loaded; an object
+// unlinked and retired in epoch e may be freed as soon as the epoch has
+// reached e + 2, because by then every reader that could have loaded it has
+// exited. The epoch only advances when every reader inside the domain has
+// seen the current one, so a reader that stays inside holds back
+// reclamation, never correctness. Entering and exiting are a load and a
+// store; nothing waits.
+class EpochDomain {
+public:
+	struct Participant;
+public:
+	EpochDomain();
+	EpochDomain(const EpochDomain& other) = delete;
+	// Every participant must have left.
+	~EpochDomain() noexcept;
+public:
+	EpochDomain& operator=(const EpochDomain& other) = delete;
+public:
+	// Claims a participant for the calling thread, reusing one that was left
+	// by another thread if possible. Lock-free.
+	Participant* Join();
+	void Leave(Participant* participant) noexcept;
+
+	// May be nested; only the outermost pair counts.
+	void Enter(Participant* participant) noexcept;
+	void Exit(Participant* participant) noexcept;
+
+	uint64_t GetEpoch() const noexcept;
+	// Advances the epoch if every participant inside the domain has seen the
+	// current one and returns the epoch now current.
+	uint64_t TryAdvance() noexcept;
+
+	static bool IsReclaimable(uint64_t retireEpoch, uint64_t currentEpoch) noexcept;
+private:
+	std::atomic<uint64_t> _epoch;
+	std::atomic<Participant*> _participants;
+};
+
+// A figure in a ConcurrentFigureStore with its area and geometric center,
+// computed once when it is stored. Never changes once published.
+struct StoredFigure {
+	AnyFigure figure;
+	double area;
+	Point center;
+};
+
+// Figures shared between writer and reader threads without a global lock.
+//
+// Figures are split across shards, each with its own writer mutex; a thread
+// inserts into the shard it was assigned on its first insert, so threads
+// ingesting at the same time rarely contend. Ids are stable: an id names
+// the same slot for the life of the store and is never reused, even after
+// the figure is removed. Every slot holds an atomic pointer to an immutable
+// StoredFigure. Replace() publishes a new one and Remove() clears the slot;
+// the old one is retired and freed by a later write once the EpochDomain
+// shows no reader can still hold it.
+//
+// Reads go through a Reader, one per thread, and are lock-free: they never
+// take a mutex and never write to memory shared with other readers. A
+// reader sees each figure either before or after a concurrent write, never
+// half of one.
+class ConcurrentFigureStore {
+public:
+	class Reader {
+	public:
+		explicit Reader(const ConcurrentFigureStore& store);
+		Reader(const Reader& other) = delete;
+		~Reader() noexcept;
+	public:
+		Reader& operator=(const Reader& other) = delete;
+	public:
+		// Empty if no figure has id, including ids that were removed.
+		std::optional<AnyFigure> Get(uint64_t id);
+		std::optional<double> GetArea(uint64_t id);
+		std::optional<Point> GetCenter(uint64_t id);
+		bool Contains(uint64_t id);
+
+		// Calls visitor with the StoredFigure of id, which stays valid until
+		// visitor returns. Returns false without calling it if no figure has
+		// id.
+		template <typename Visitor>
+		bool Visit(uint64_t id, Visitor&& visitor);
+
+		// Calls visitor for every figure, shard by shard. Figures inserted,
+		// replaced or removed during the scan may or may not be seen.
+		void ForEach(const std::function<void(uint64_t id, const StoredFigure& figure)>& visitor);
+	private:
+		class Guard;
+	private:
+		const ConcurrentFigureStore* _store;
+		EpochDomain::Participant* _participant;
+	};
+public:
+	// shardCount 0 means one per hardware thread; it is rounded up to a
+	// power of two.
+	explicit ConcurrentFigureStore(uint64_t shardCount = 0);
+	ConcurrentFigureStore(const ConcurrentFigureStore& other) = delete;
+	// Every Reader must have been destroyed.
+	~ConcurrentFigureStore() noexcept;
+public:
+	ConcurrentFigureStore& operator=(const ConcurrentFigureStore& other) = delete;
+public:
+	uint64_t Insert(const AnyFigure& figure);
+	// Return false if no figure has id.
+	bool Replace(uint64_t id, const AnyFigure& figure);
+	bool Remove(uint64_t id);
+
+	uint64_t Size() const noexcept;
+	uint64_t GetShardCount() const noexcept;
+
+	// Frees what no reader can still see. Writes do this as they go, so it
+	// is only needed to release memory once writes have stopped.
+	void Collect();
+	// Figures replaced or removed but not freed yet.
+	uint64_t GetRetiredCount() const;
+	uint64_t GetReclaimedCount() const noexcept;
+private:
+	struct Shard;
+private:
+	// The caller must be inside the epoch domain.
+	const StoredFigure* Find(uint64_t id) const noexcept;
+	Shard& GetShard(uint64_t id) const noexcept;
+	uint64_t GetSlotIndex(uint64_t id) const noexcept;
+	bool Exchange(uint64_t id, const StoredFigure* figure);
+	void Retire(Shard& shard, const StoredFigure* figure);
+	void Collect(Shard& shard);
+private:
+	uint64_t _shardBits;
+	std::unique_ptr<Shard[]> _shards;
+	mutable EpochDomain _domain;
+	std::atomic<uint64_t> _size;
+	std::atomic<uint64_t> _reclaimed;
+};
+
+class ConcurrentFigureStore::Reader::Guard {
+public:
+	explicit Guard(Reader& reader) noexcept : _reader(reader) {
+		_reader._store->_domain.Enter(_reader._participant);
+	}
+
+	Guard(const Guard& other) = delete;
+
+	~Guard() noexcept {
+		_reader._store->_domain.Exit(_reader._participant);
+	}
+public:
+	Guard& operator=(const Guard& other) = delete;
+private:
+	Reader& _reader;
+};
+
+template <typename Visitor>
+bool ConcurrentFigureStore::Reader::Visit(uint64_t id, Visitor&& visitor) {
+	Guard guard(*this);
+	const StoredFigure* figure = _store->Find(id);
+	if (figure == nullptr) {
+		return false;
+	}
+
+	std::forward<Visitor>(visitor)(*figure);
+	return true;
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef FIGURE_AGGREGATES_H
+#define FIGURE_AGGREGATES_H
+
+#include "Figures.h"
+#include "AnyFigure.h"
+#include <cinttypes>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Sum with Neumaier's compensation: the rounding error of every addition is
+// kept in a second term, so the result is about as accurate as if it were
+// computed in twice the precision, whatever the order and the number of
+// terms. Subtracting a value added before is adding its negation.
+class CompensatedSum {
+public:
+	CompensatedSum() noexcept;
+public:
+	void Add(double value) noexcept;
+	void Subtract(double value) noexcept;
+	void Reset() noexcept;
+
+	double Get() const noexcept;
+private:
+	double _sum;
+	double _compensation;
+};
+
+// Aggregates of a changing collection of figures, kept up to date on every
+// insert, update and erase instead of recomputed from every figure: count,
+// total, minimum and maximum area, the area-weighted centroid, the bounding
+// box of all figures and a histogram of areas.
+//
+// Figures are named by ids the caller chooses. Area and center of each
+// figure are computed once when it is inserted or updated and kept, so an
+// erase does not need the figure. Sums are compensated, and all of them
+// restart from exactly 0 whenever the collection becomes empty, so totals do
+// not drift over any number of changes. Minimum, maximum and bounds come
+// from ordered multisets, which makes every change O(log n).
+class FigureAggregates {
+public:
+	// Histogram bucket i holds the areas in [edges[i - 1], edges[i]); the
+	// first bucket everything below edges[0] and the last everything from
+	// edges.back() up, so there are edges.size() + 1 buckets. Throws
+	// std::invalid_argument unless the edges are finite and strictly
+	// increasing.
+	explicit FigureAggregates(const std::vector<double>& histogramEdges = {});
+public:
+	// Throws std::invalid_argument if id is already used, the figure has
+	// a coordinate, an area or an area times a center coordinate that is
+	// not finite, or adding it would overflow the total area or the sums
+	// behind the centroid. A rejected change changes nothing.
+	void Insert(uint64_t id, const AnyFigure& figure);
+	// Throw std::out_of_range if no figure has id.
+	void Update(uint64_t id, const AnyFigure& figure);
+	void Erase(uint64_t id);
+	void Clear() noexcept;
+
+	bool Contains(uint64_t id) const;
+	uint64_t GetCount() const noexcept;
+	double GetTotalArea() const noexcept;
+	// +infinity and -infinity while empty.
+	double GetMinArea() const noexcept;
+	double GetMaxArea() const noexcept;
+	// Mean of the geometric centers weighted by area; NaN coordinates while
+	// the total area is 0. Only an erase can leave figures whose weighted
+	// sums do not fit, and the coordinates are not finite until enough of
+	// them are erased again.
+	Point GetCentroid() const noexcept;
+	// Empty while the collection is.
+	BoundingBox GetBounds() const noexcept;
+
+	const std::vector<double>& GetHistogramEdges() const noexcept;
+	const std::vector<uint64_t>& GetHistogram() const noexcept;
+private:
+	struct Entry {
+		double area;
+		Point center;
+		uint64_t bucket;
+		std::multiset<double>::iterator areaPosition;
+		std::multiset<double>::iterator minXPosition;
+		std::multiset<double>::iterator minYPosition;
+		std::multiset<double>::iterator maxXPosition;
+		std::multiset<double>::iterator maxYPosition;
+	};
+private:
+	// Throws std::invalid_argument unless the figure is finite; changes
+	// nothing.
+	Entry Measure(const AnyFigure& figure, BoundingBox& box) const;
+	void Add(Entry& entry, const BoundingBox& box);
+	void Subtract(const Entry& entry) noexcept;
+	// Throws std::invalid_argument and changes nothing if a sum would
+	// overflow.
+	void AddSums(const Entry& entry);
+	void SubtractSums(const Entry& entry) noexcept;
+	bool SumsAreFinite() const noexcept;
+	void RecomputeSums() noexcept;
+	uint64_t GetBucket(double area) const noexcept;
+
+	// Moves the node at position to value without allocating.
+	static std::multiset<double>::iterator Move(std::multiset<double>& values,
+												std::multiset<double>::iterator position, double value);
+private:
+	std::vector<double> _histogramEdges;
+	std::vector<uint64_t> _histogram;
+	std::unordered_map<uint64_t, Entry> _entries;
+	CompensatedSum _area;
+	CompensatedSum _weightedX;
+	CompensatedSum _weightedY;
+	std::multiset<double> _areas;
+	std::multiset<double> _minX;
+	std::multiset<double> _minY;
+	std::multiset<double> _maxX;
+	std::multiset<double> _maxY;
+};
+
+#endif
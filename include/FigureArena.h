@@ -0,0 +1,249 @@
+#ifndef FIGURE_ARENA_H
+#define FIGURE_ARENA_H
+
+#include "FigureMetrics.h"
+#include <cinttypes>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+struct ArenaStats {
+	uint64_t blockAllocations;
+	uint64_t bytesReserved;
+	uint64_t allocations;
+	uint64_t bytesAllocated;
+	uint64_t resets;
+};
+
+// Bump allocator over a list of large blocks. Reset() rewinds to the first
+// block in O(1) and keeps every block, so a request that fits into memory
+// already reserved by earlier requests makes no calls to the system
+// allocator; GetStats().blockAllocations counts the ones that were made.
+//
+// Reset() and the destructor do not run destructors. Objects created in an
+// arena must have destructors without effects, which holds for Point,
+// Rhombus, Pentagon, Hexagon and AnyFigure.
+class MonotonicArena {
+public:
+	static constexpr uint64_t defaultBlockSize = 64 * 1024;
+public:
+	explicit MonotonicArena(uint64_t blockSize = defaultBlockSize);
+	MonotonicArena(const MonotonicArena& other) = delete;
+	~MonotonicArena() noexcept;
+public:
+	MonotonicArena& operator=(const MonotonicArena& other) = delete;
+public:
+	void* Allocate(uint64_t size, uint64_t alignment = alignof(std::max_align_t));
+
+	template <typename T, typename... Args>
+	T* Create(Args&&... args);
+
+	void Reset() noexcept;
+	void Release() noexcept;
+
+	// Changes on every Reset() and Release(), so that memory handed out
+	// before can be told from memory handed out since.
+	uint64_t GetGeneration() const noexcept;
+	const ArenaStats& GetStats() const noexcept;
+private:
+	struct Block {
+		unsigned char* data;
+		uint64_t size;
+	};
+private:
+	void* AllocateSlow(uint64_t size, uint64_t alignment);
+private:
+	std::vector<Block> _blocks;
+	uint64_t _blockSize;
+	uint64_t _current;
+	uint64_t _offset;
+	uint64_t _generation;
+	ArenaStats _stats;
+};
+
+// Fixed-size slots for one object type carved out of a MonotonicArena, which
+// several pools may share. Destroyed objects return their slot to a free
+// list that Create() reuses. Resetting or releasing the arena drops the
+// objects of every pool on it: a pool notices by the arena's generation and
+// forgets its free list and live count. Objects created before must not be
+// used or destroyed afterwards.
+//
+// Reset() drops the objects of this pool only and leaves the arena alone.
+// It is O(1): the pool chains every slot it has carved, and Create() hands
+// them out again before it takes memory from the arena, so a loop of
+// Create() and Reset() stops growing the arena once it has reached its
+// peak.
+template <typename T>
+class ObjectPool {
+public:
+	explicit ObjectPool(MonotonicArena& arena);
+public:
+	template <typename... Args>
+	T* Create(Args&&... args);
+	void Destroy(T* object) noexcept;
+
+	void Reset() noexcept;
+	uint64_t GetLiveCount() const noexcept;
+private:
+	struct Slot {
+		union {
+			Slot* next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+		// Every slot carved by the pool, free or not.
+		Slot* carved;
+	};
+private:
+	void Synchronize() noexcept;
+private:
+	MonotonicArena* _arena;
+	Slot* _freeList;
+	// Slots carved before the last Reset() and not handed out since.
+	Slot* _unused;
+	Slot* _carved;
+	uint64_t _liveCount;
+	uint64_t _generation;
+};
+
+// Standard allocator that takes memory from a MonotonicArena, so standard
+// containers (for example a std::vector<Figure*> of arena-created figures)
+// can live in the same arena. Deallocation is a no-op.
+template <typename T>
+class ArenaAllocator {
+public:
+	using value_type = T;
+public:
+	explicit ArenaAllocator(MonotonicArena& arena) noexcept;
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept;
+public:
+	T* allocate(std::size_t count);
+	void deallocate(T* pointer, std::size_t count) noexcept;
+
+	MonotonicArena* GetArena() const noexcept;
+private:
+	MonotonicArena* _arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+	return lhs.GetArena() == rhs.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+	return !(lhs == rhs);
+}
+
+inline void* MonotonicArena::Allocate(uint64_t size, uint64_t alignment) {
+	if (_current < _blocks.size() && alignment - 1 < alignof(std::max_align_t) && (alignment & (alignment - 1)) == 0) {
+		uint64_t aligned = (_offset + alignment - 1) & ~(alignment - 1);
+		if (aligned + size <= _blocks[_current].size) {
+			_offset = aligned + size;
+			++_stats.allocations;
+			FIGURES_COUNT(ArenaAllocations);
+			_stats.bytesAllocated += size;
+
+			return _blocks[_current].data + aligned;
+		}
+	}
+
+	return AllocateSlow(size, alignment);
+}
+
+template <typename T, typename... Args>
+T* MonotonicArena::Create(Args&&... args) {
+	return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+ObjectPool<T>::ObjectPool(MonotonicArena& arena) :
+	_arena(&arena), _freeList(nullptr), _unused(nullptr), _carved(nullptr), _liveCount(0),
+	_generation(arena.GetGeneration()) {}
+
+template <typename T>
+template <typename... Args>
+T* ObjectPool<T>::Create(Args&&... args) {
+	Synchronize();
+	Slot* slot = nullptr;
+	if (_freeList != nullptr) {
+		slot = _freeList;
+		_freeList = _freeList->next;
+	} else if (_unused != nullptr) {
+		slot = _unused;
+		_unused = _unused->carved;
+	} else {
+		slot = static_cast<Slot*>(_arena->Allocate(sizeof(Slot), alignof(Slot)));
+		slot->carved = _carved;
+		_carved = slot;
+	}
+
+	T* object = new (slot->storage) T(std::forward<Args>(args)...);
+	++_liveCount;
+
+	return object;
+}
+
+template <typename T>
+void ObjectPool<T>::Destroy(T* object) noexcept {
+	if (object == nullptr) {
+		return;
+	}
+
+	object->~T();
+	Slot* slot = reinterpret_cast<Slot*>(object);
+	slot->next = _freeList;
+	_freeList = slot;
+	--_liveCount;
+}
+
+template <typename T>
+void ObjectPool<T>::Reset() noexcept {
+	Synchronize();
+	_freeList = nullptr;
+	_unused = _carved;
+	_liveCount = 0;
+}
+
+template <typename T>
+uint64_t ObjectPool<T>::GetLiveCount() const noexcept {
+	return _generation == _arena->GetGeneration() ? _liveCount : 0;
+}
+
+template <typename T>
+void ObjectPool<T>::Synchronize() noexcept {
+	if (_generation != _arena->GetGeneration()) {
+		_freeList = nullptr;
+		_unused = nullptr;
+		_carved = nullptr;
+		_liveCount = 0;
+		_generation = _arena->GetGeneration();
+	}
+}
+
+template <typename T>
+ArenaAllocator<T>::ArenaAllocator(MonotonicArena& arena) noexcept : _arena(&arena) {}
+
+template <typename T>
+template <typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& other) noexcept : _arena(other.GetArena()) {}
+
+template <typename T>
+T* ArenaAllocator<T>::allocate(std::size_t count) {
+	if (count > static_cast<std::size_t>(-1) / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+
+	return static_cast<T*>(_arena->Allocate(count * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+void ArenaAllocator<T>::deallocate(T*, std::size_t) noexcept {}
+
+template <typename T>
+MonotonicArena* ArenaAllocator<T>::GetArena() const noexcept {
+	return _arena;
+}
+
+#endif
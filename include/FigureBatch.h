@@ -0,0 +1,272 @@
+#ifndef FIGURE_BATCH_H
+#define FIGURE_BATCH_H
+
+#include "Figures.h"
+#include "FigureKernels.h"
+#include <array>
+#include <cinttypes>
+#include <stdexcept>
+#include <vector>
+
+template <uint64_t N>
+struct BatchFigure {
+	using Type = RegularPolygon<N>;
+};
+
+// Structure-of-arrays storage for many figures with N vertices: the x and y
+// coordinates of vertex i of every figure live in their own contiguous array,
+// so the batch kernels walk memory linearly and without virtual calls.
+template <uint64_t N>
+class FigureBatch {
+public:
+	using FigureType = typename BatchFigure<N>::Type;
+	static constexpr uint64_t amountOfPoints = N;
+public:
+	FigureBatch();
+	explicit FigureBatch(uint64_t capacity);
+public:
+	void Reserve(uint64_t capacity);
+	void Clear() noexcept;
+
+	void PushBack(const FigureType& figure);
+	void PushBack(const std::array<Point, N>& points);
+
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+
+	Point GetPoint(uint64_t figureIndex, uint64_t pointIndex) const;
+	FigureType GetFigure(uint64_t figureIndex) const;
+
+	const double* GetXs(uint64_t pointIndex) const;
+	const double* GetYs(uint64_t pointIndex) const;
+public:
+	// Both kernels write Size() values into out and give exactly the same
+	// results as calling GetArea(mode) / GetGeometricCenter() per figure.
+	// They run on the instruction set selected in FigureKernels.h.
+	void Areas(double* out, AreaMode mode = AreaMode::Classic) const;
+	void GeometricCenters(Point* out) const;
+	// sides[i] receives Size() lengths of the side between vertices i and i + 1.
+	void SideLengths(double* const* sides) const;
+
+	std::vector<double> Areas(AreaMode mode = AreaMode::Classic) const;
+	std::vector<Point> GeometricCenters() const;
+public:
+	// In-place passes over the coordinate arrays with the same results as
+	// Transform(), Translate(), Scale() and Rotate() on every figure. The
+	// ranged forms touch figures [begin, end) only, so that disjoint ranges
+	// can be transformed in parallel.
+	void Transform(const AffineTransform& transform);
+	void Transform(const AffineTransform& transform, uint64_t begin, uint64_t end);
+	void Translate(double dx, double dy);
+	void Scale(double sx, double sy);
+	void Rotate(double angle);
+	void Rotate(double angle, uint64_t begin, uint64_t end);
+private:
+	std::array<std::vector<double>, N> _xs;
+	std::array<std::vector<double>, N> _ys;
+	uint64_t _size;
+private:
+	std::array<const double*, N> GetXPointers() const;
+	std::array<const double*, N> GetYPointers() const;
+	void CheckRange(uint64_t begin, uint64_t end) const;
+};
+
+using RhombusBatch = FigureBatch<4>;
+using PentagonBatch = FigureBatch<5>;
+using HexagonBatch = FigureBatch<6>;
+
+template <uint64_t N>
+FigureBatch<N>::FigureBatch() : _size(0) {}
+
+template <uint64_t N>
+FigureBatch<N>::FigureBatch(uint64_t capacity) : _size(0) {
+	Reserve(capacity);
+}
+
+template <uint64_t N>
+void FigureBatch<N>::Reserve(uint64_t capacity) {
+	for (uint64_t i = 0; i < N; ++i) {
+		_xs[i].reserve(capacity);
+		_ys[i].reserve(capacity);
+	}
+}
+
+template <uint64_t N>
+void FigureBatch<N>::Clear() noexcept {
+	for (uint64_t i = 0; i < N; ++i) {
+		_xs[i].clear();
+		_ys[i].clear();
+	}
+	_size = 0;
+}
+
+template <uint64_t N>
+void FigureBatch<N>::PushBack(const FigureType& figure) {
+	PushBack(figure.GetPoints());
+}
+
+template <uint64_t N>
+void FigureBatch<N>::PushBack(const std::array<Point, N>& points) {
+	for (uint64_t i = 0; i < N; ++i) {
+		_xs[i].push_back(points[i].x);
+		_ys[i].push_back(points[i].y);
+	}
+	++_size;
+}
+
+template <uint64_t N>
+uint64_t FigureBatch<N>::Size() const noexcept {
+	return _size;
+}
+
+template <uint64_t N>
+bool FigureBatch<N>::Empty() const noexcept {
+	return _size == 0;
+}
+
+template <uint64_t N>
+Point FigureBatch<N>::GetPoint(uint64_t figureIndex, uint64_t pointIndex) const {
+	if (figureIndex >= _size || pointIndex >= N) {
+		throw std::out_of_range("Index out of range");
+	}
+
+	return {_xs[pointIndex][figureIndex], _ys[pointIndex][figureIndex]};
+}
+
+template <uint64_t N>
+typename FigureBatch<N>::FigureType FigureBatch<N>::GetFigure(uint64_t figureIndex) const {
+	std::array<Point, N> points;
+	for (uint64_t i = 0; i < N; ++i) {
+		points[i] = GetPoint(figureIndex, i);
+	}
+
+	return FigureType(points);
+}
+
+template <uint64_t N>
+const double* FigureBatch<N>::GetXs(uint64_t pointIndex) const {
+	return _xs.at(pointIndex).data();
+}
+
+template <uint64_t N>
+const double* FigureBatch<N>::GetYs(uint64_t pointIndex) const {
+	return _ys.at(pointIndex).data();
+}
+
+template <uint64_t N>
+void FigureBatch<N>::Areas(double* out, AreaMode mode) const {
+	FIGURES_TIME_STAGE(Areas, _size);
+	FIGURES_COUNT_N(AreaComputations, _size);
+	std::array<const double*, N> xs = GetXPointers();
+	std::array<const double*, N> ys = GetYPointers();
+
+	if (mode == AreaMode::Shoelace) {
+		ComputeShoelaceAreas(N, xs.data(), ys.data(), _size, out);
+	} else if constexpr (N == 4) {
+		ComputeRhombusAreas(xs.data(), ys.data(), _size, out);
+	} else {
+		ComputeRegularPolygonAreas(N, xs.data(), ys.data(), _size, out);
+	}
+}
+
+template <uint64_t N>
+void FigureBatch<N>::GeometricCenters(Point* out) const {
+	FIGURES_TIME_STAGE(Centers, _size);
+	FIGURES_COUNT_N(CenterComputations, _size);
+	std::array<const double*, N> xs = GetXPointers();
+	std::array<const double*, N> ys = GetYPointers();
+	ComputeGeometricCenters(N, xs.data(), ys.data(), _size, out);
+}
+
+template <uint64_t N>
+void FigureBatch<N>::SideLengths(double* const* sides) const {
+	std::array<const double*, N> xs = GetXPointers();
+	std::array<const double*, N> ys = GetYPointers();
+	ComputeSideLengths(N, xs.data(), ys.data(), _size, sides);
+}
+
+template <uint64_t N>
+std::vector<double> FigureBatch<N>::Areas(AreaMode mode) const {
+	std::vector<double> areas(_size);
+	Areas(areas.data(), mode);
+
+	return areas;
+}
+
+template <uint64_t N>
+std::vector<Point> FigureBatch<N>::GeometricCenters() const {
+	std::vector<Point> centers(_size);
+	GeometricCenters(centers.data());
+
+	return centers;
+}
+
+template <uint64_t N>
+void FigureBatch<N>::Transform(const AffineTransform& transform) {
+	Transform(transform, 0, _size);
+}
+
+template <uint64_t N>
+void FigureBatch<N>::Transform(const AffineTransform& transform, uint64_t begin, uint64_t end) {
+	CheckRange(begin, end);
+	for (uint64_t i = 0; i < N; ++i) {
+		TransformPoints(transform, _xs[i].data() + begin, _ys[i].data() + begin, end - begin);
+	}
+}
+
+template <uint64_t N>
+void FigureBatch<N>::Translate(double dx, double dy) {
+	Transform(AffineTransform::Translation(dx, dy));
+}
+
+template <uint64_t N>
+void FigureBatch<N>::Scale(double sx, double sy) {
+	Transform(AffineTransform::Scaling(sx, sy));
+}
+
+template <uint64_t N>
+void FigureBatch<N>::Rotate(double angle) {
+	Rotate(angle, 0, _size);
+}
+
+template <uint64_t N>
+void FigureBatch<N>::Rotate(double angle, uint64_t begin, uint64_t end) {
+	CheckRange(begin, end);
+
+	std::array<double*, N> xs;
+	std::array<double*, N> ys;
+	for (uint64_t i = 0; i < N; ++i) {
+		xs[i] = _xs[i].data() + begin;
+		ys[i] = _ys[i].data() + begin;
+	}
+	RotateAboutCenters(N, xs.data(), ys.data(), end - begin, angle);
+}
+
+template <uint64_t N>
+void FigureBatch<N>::CheckRange(uint64_t begin, uint64_t end) const {
+	if (begin > end || end > _size) {
+		throw std::out_of_range("Index out of range");
+	}
+}
+
+template <uint64_t N>
+std::array<const double*, N> FigureBatch<N>::GetXPointers() const {
+	std::array<const double*, N> pointers;
+	for (uint64_t i = 0; i < N; ++i) {
+		pointers[i] = _xs[i].data();
+	}
+
+	return pointers;
+}
+
+template <uint64_t N>
+std::array<const double*, N> FigureBatch<N>::GetYPointers() const {
+	std::array<const double*, N> pointers;
+	for (uint64_t i = 0; i < N; ++i) {
+		pointers[i] = _ys[i].data();
+	}
+
+	return pointers;
+}
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef FIGURE_ENGINE_H
+#define FIGURE_ENGINE_H
+
+#include "Figures.h"
+#include "FigureBatch.h"
+#include "FigureKernels.h"
+#include "FigureSort.h"
+#include "ThreadPool.h"
+#include <array>
+#include <cinttypes>
+#include <vector>
+
+// Runs area, geometric center and total area computations over large figure
+// collections on a ThreadPool. Totals are summed per chunk and the chunk sums
+// are then added in chunk order; since chunk boundaries depend only on the
+// chunk size, a total is bit-for-bit the same for any number of threads.
+//
+// Collections are either FigureBatch objects or random-access containers
+// whose elements dereference to a Figure (Figure*, std::unique_ptr<Figure>,
+// ...).
+class FigureEngine {
+public:
+	static constexpr uint64_t defaultChunkSize = 16384;
+public:
+	explicit FigureEngine(uint64_t threadCount = 0, uint64_t chunkSize = defaultChunkSize);
+public:
+	uint64_t GetThreadCount() const noexcept;
+	uint64_t GetChunkSize() const noexcept;
+	ThreadPool& GetThreadPool() noexcept;
+
+	template <typename Container>
+	std::vector<double> Areas(const Container& figures);
+	template <typename Container>
+	std::vector<Point> GeometricCenters(const Container& figures);
+	template <typename Container>
+	double TotalArea(const Container& figures);
+
+	template <uint64_t N>
+	std::vector<double> Areas(const FigureBatch<N>& batch);
+	template <uint64_t N>
+	std::vector<Point> GeometricCenters(const FigureBatch<N>& batch);
+	template <uint64_t N>
+	double TotalArea(const FigureBatch<N>& batch);
+
+	// In place and chunk by chunk; the results do not depend on the number
+	// of threads.
+	template <typename Container>
+	void Transform(Container& figures, const AffineTransform& transform);
+	template <uint64_t N>
+	void Transform(FigureBatch<N>& batch, const AffineTransform& transform);
+	// Rotates every figure about its own geometric center.
+	template <uint64_t N>
+	void Rotate(FigureBatch<N>& batch, double angle);
+
+	// Computes the keys once and ranks them with the functions of
+	// FigureSort.h on the pool; figures is a FigureBatch or a container as
+	// above.
+	template <typename Figures>
+	std::vector<uint64_t> SortByArea(const Figures& figures, SortOrder order = SortOrder::Ascending);
+	template <typename Figures>
+	std::vector<uint64_t> SortByCenter(const Figures& figures, SortOrder order = SortOrder::Ascending);
+	template <typename Figures>
+	std::vector<uint64_t> TopByArea(const Figures& figures, uint64_t k, SortOrder order = SortOrder::Descending);
+	template <typename Figures>
+	KeyPartition PartitionByArea(const Figures& figures, double threshold);
+private:
+	double SumInChunkOrder(uint64_t count, const ThreadPool::ChunkTask& fillPartial, std::vector<double>& partials);
+	template <uint64_t N>
+	static void BatchAreas(const FigureBatch<N>& batch, uint64_t begin, uint64_t end, double* areas);
+private:
+	ThreadPool _pool;
+	uint64_t _chunkSize;
+};
+
+template <typename Container>
+std::vector<double> FigureEngine::Areas(const Container& figures) {
+	std::vector<double> areas(figures.size());
+	_pool.ParallelFor(figures.size(), _chunkSize, [&figures, &areas](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			areas[i] = static_cast<double>(*figures[i]);
+		}
+	});
+
+	return areas;
+}
+
+template <typename Container>
+std::vector<Point> FigureEngine::GeometricCenters(const Container& figures) {
+	std::vector<Point> centers(figures.size());
+	_pool.ParallelFor(figures.size(), _chunkSize, [&figures, &centers](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			centers[i] = figures[i]->GetGeometricCenter();
+		}
+	});
+
+	return centers;
+}
+
+template <typename Container>
+double FigureEngine::TotalArea(const Container& figures) {
+	std::vector<double> partials;
+	return SumInChunkOrder(figures.size(), [&figures, &partials](uint64_t chunk, uint64_t begin, uint64_t end) {
+		double sum = 0;
+		for (uint64_t i = begin; i < end; ++i) {
+			sum += static_cast<double>(*figures[i]);
+		}
+		partials[chunk] = sum;
+	}, partials);
+}
+
+template <uint64_t N>
+std::vector<double> FigureEngine::Areas(const FigureBatch<N>& batch) {
+	std::vector<double> areas(batch.Size());
+	_pool.ParallelFor(batch.Size(), _chunkSize, [&batch, &areas](uint64_t, uint64_t begin, uint64_t end) {
+		BatchAreas(batch, begin, end, areas.data() + begin);
+	});
+
+	return areas;
+}
+
+template <uint64_t N>
+std::vector<Point> FigureEngine::GeometricCenters(const FigureBatch<N>& batch) {
+	std::vector<Point> centers(batch.Size());
+	_pool.ParallelFor(batch.Size(), _chunkSize, [&batch, &centers](uint64_t, uint64_t begin, uint64_t end) {
+		std::array<const double*, N> xs;
+		std::array<const double*, N> ys;
+		for (uint64_t i = 0; i < N; ++i) {
+			xs[i] = batch.GetXs(i) + begin;
+			ys[i] = batch.GetYs(i) + begin;
+		}
+		ComputeGeometricCenters(N, xs.data(), ys.data(), end - begin, centers.data() + begin);
+	});
+
+	return centers;
+}
+
+template <uint64_t N>
+double FigureEngine::TotalArea(const FigureBatch<N>& batch) {
+	std::vector<double> partials;
+	return SumInChunkOrder(batch.Size(), [&batch, &partials](uint64_t chunk, uint64_t begin, uint64_t end) {
+		std::vector<double> areas(end - begin);
+		BatchAreas(batch, begin, end, areas.data());
+
+		double sum = 0;
+		for (double area : areas) {
+			sum += area;
+		}
+		partials[chunk] = sum;
+	}, partials);
+}
+
+template <typename Container>
+void FigureEngine::Transform(Container& figures, const AffineTransform& transform) {
+	_pool.ParallelFor(figures.size(), _chunkSize, [&figures, &transform](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			figures[i]->Transform(transform);
+		}
+	});
+}
+
+template <uint64_t N>
+void FigureEngine::Transform(FigureBatch<N>& batch, const AffineTransform& transform) {
+	_pool.ParallelFor(batch.Size(), _chunkSize, [&batch, &transform](uint64_t, uint64_t begin, uint64_t end) {
+		batch.Transform(transform, begin, end);
+	});
+}
+
+template <uint64_t N>
+void FigureEngine::Rotate(FigureBatch<N>& batch, double angle) {
+	_pool.ParallelFor(batch.Size(), _chunkSize, [&batch, angle](uint64_t, uint64_t begin, uint64_t end) {
+		batch.Rotate(angle, begin, end);
+	});
+}
+
+template <typename Figures>
+std::vector<uint64_t> FigureEngine::SortByArea(const Figures& figures, SortOrder order) {
+	const std::vector<double> areas = Areas(figures);
+	return SortByKey(areas.data(), areas.size(), _pool, order);
+}
+
+template <typename Figures>
+std::vector<uint64_t> FigureEngine::SortByCenter(const Figures& figures, SortOrder order) {
+	const std::vector<Point> centers = GeometricCenters(figures);
+	return SortByKey(centers.data(), centers.size(), _pool, order);
+}
+
+template <typename Figures>
+std::vector<uint64_t> FigureEngine::TopByArea(const Figures& figures, uint64_t k, SortOrder order) {
+	const std::vector<double> areas = Areas(figures);
+	return TopByKey(areas.data(), areas.size(), k, _pool, order);
+}
+
+template <typename Figures>
+KeyPartition FigureEngine::PartitionByArea(const Figures& figures, double threshold) {
+	const std::vector<double> areas = Areas(figures);
+	return PartitionByKey(areas.data(), areas.size(), threshold, _pool);
+}
+
+template <uint64_t N>
+void FigureEngine::BatchAreas(const FigureBatch<N>& batch, uint64_t begin, uint64_t end, double* areas) {
+	std::array<const double*, N> xs;
+	std::array<const double*, N> ys;
+	for (uint64_t i = 0; i < N; ++i) {
+		xs[i] = batch.GetXs(i) + begin;
+		ys[i] = batch.GetYs(i) + begin;
+	}
+
+	if constexpr (N == 4) {
+		ComputeRhombusAreas(xs.data(), ys.data(), end - begin, areas);
+	} else {
+		ComputeRegularPolygonAreas(N, xs.data(), ys.data(), end - begin, areas);
+	}
+}
+
+#endif
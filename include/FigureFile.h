@@ -0,0 +1,192 @@
+#ifndef FIGURE_FILE_H
+#define FIGURE_FILE_H
+
+#include "Figures.h"
+#include "FigureBatch.h"
+#include <array>
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+// Binary figure file, version 1. Every field is little-endian.
+//
+//   header   FigureFileHeader
+//   tables   tableCount x FigureFileTable
+//   data     for every table, count records of amountOfPoints packed Points
+//            (x then y as IEEE-754 doubles), starting at a 16-byte aligned offset
+//
+// Tables with an amountOfPoints the reader does not know are skipped, so new
+// figure kinds can be added without bumping the version.
+
+constexpr char figureFileMagic[4] = {'F', 'I', 'G', 'B'};
+constexpr uint32_t figureFileVersion = 1;
+
+struct FigureFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t tableCount;
+	uint32_t reserved;
+};
+
+struct FigureFileTable {
+	uint32_t amountOfPoints;
+	uint32_t reserved;
+	uint64_t count;
+	uint64_t offset;
+};
+
+static_assert(sizeof(FigureFileHeader) == 16, "FigureFileHeader must be packed");
+static_assert(sizeof(FigureFileTable) == 24, "FigureFileTable must be packed");
+
+// Read-only view of the records of one figure kind inside a mapped file.
+template <uint64_t N>
+class FigureRecordView {
+public:
+	using FigureType = typename BatchFigure<N>::Type;
+	using Record = std::array<Point, N>;
+public:
+	FigureRecordView();
+	FigureRecordView(const Record* records, uint64_t count);
+public:
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+
+	const Record& operator[](uint64_t index) const;
+	const Record* begin() const noexcept;
+	const Record* end() const noexcept;
+
+	FigureType GetFigure(uint64_t index) const;
+	FigureBatch<N> ToBatch() const;
+private:
+	const Record* _records;
+	uint64_t _count;
+};
+
+using RhombusRecords = FigureRecordView<4>;
+using PentagonRecords = FigureRecordView<5>;
+using HexagonRecords = FigureRecordView<6>;
+
+class FigureFileWriter {
+public:
+	void Add(const Rhombus& rhombus);
+	void Add(const Pentagon& pentagon);
+	void Add(const Hexagon& hexagon);
+
+	template <uint64_t N>
+	void Add(const FigureBatch<N>& batch);
+
+	uint64_t GetCount(uint64_t amountOfPoints) const;
+
+	void Save(const std::string& path) const;
+	void Save(std::ostream& ostream) const;
+private:
+	std::vector<Point>& GetPoints(uint64_t amountOfPoints);
+	const std::vector<Point>& GetPoints(uint64_t amountOfPoints) const;
+private:
+	std::array<std::vector<Point>, 3> _points;
+};
+
+// Maps a figure file into memory read-only. The views it hands out point
+// straight into the mapping and stay valid for as long as the reader lives;
+// several processes mapping the same file share its pages through the page
+// cache. Throws std::runtime_error if the file cannot be mapped and
+// std::invalid_argument if it is not a valid figure file.
+class FigureFileReader {
+public:
+	explicit FigureFileReader(const std::string& path);
+	FigureFileReader(const FigureFileReader& other) = delete;
+	FigureFileReader(FigureFileReader&& moved) noexcept;
+	~FigureFileReader() noexcept;
+public:
+	FigureFileReader& operator=(const FigureFileReader& other) = delete;
+	FigureFileReader& operator=(FigureFileReader&& other) noexcept;
+public:
+	uint32_t GetVersion() const;
+	uint64_t GetFileSize() const noexcept;
+
+	template <uint64_t N>
+	FigureRecordView<N> GetRecords() const;
+
+	RhombusRecords GetRhombuses() const;
+	PentagonRecords GetPentagons() const;
+	HexagonRecords GetHexagons() const;
+private:
+	void Validate() const;
+	const FigureFileTable* FindTable(uint64_t amountOfPoints) const;
+private:
+	const unsigned char* _data;
+	uint64_t _size;
+};
+
+template <uint64_t N>
+FigureRecordView<N>::FigureRecordView() : _records(nullptr), _count(0) {}
+
+template <uint64_t N>
+FigureRecordView<N>::FigureRecordView(const Record* records, uint64_t count) : _records(records), _count(count) {}
+
+template <uint64_t N>
+uint64_t FigureRecordView<N>::Size() const noexcept {
+	return _count;
+}
+
+template <uint64_t N>
+bool FigureRecordView<N>::Empty() const noexcept {
+	return _count == 0;
+}
+
+template <uint64_t N>
+const typename FigureRecordView<N>::Record& FigureRecordView<N>::operator[](uint64_t index) const {
+	return _records[index];
+}
+
+template <uint64_t N>
+const typename FigureRecordView<N>::Record* FigureRecordView<N>::begin() const noexcept {
+	return _records;
+}
+
+template <uint64_t N>
+const typename FigureRecordView<N>::Record* FigureRecordView<N>::end() const noexcept {
+	return _records + _count;
+}
+
+template <uint64_t N>
+typename FigureRecordView<N>::FigureType FigureRecordView<N>::GetFigure(uint64_t index) const {
+	if (index >= _count) {
+		throw std::out_of_range("Index out of range");
+	}
+
+	return FigureType(_records[index]);
+}
+
+template <uint64_t N>
+FigureBatch<N> FigureRecordView<N>::ToBatch() const {
+	FigureBatch<N> batch(_count);
+	for (uint64_t i = 0; i < _count; ++i) {
+		batch.PushBack(_records[i]);
+	}
+
+	return batch;
+}
+
+template <uint64_t N>
+void FigureFileWriter::Add(const FigureBatch<N>& batch) {
+	std::vector<Point>& points = GetPoints(N);
+	points.reserve(points.size() + batch.Size() * N);
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		for (uint64_t j = 0; j < N; ++j) {
+			points.push_back(batch.GetPoint(i, j));
+		}
+	}
+}
+
+template <uint64_t N>
+FigureRecordView<N> FigureFileReader::GetRecords() const {
+	const FigureFileTable* table = FindTable(N);
+	if (table == nullptr) {
+		return FigureRecordView<N>();
+	}
+
+	return FigureRecordView<N>(reinterpret_cast<const std::array<Point, N>*>(_data + table->offset), table->count);
+}
+
+#endif
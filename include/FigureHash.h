@@ -0,0 +1,266 @@
+#ifndef FIGURE_HASH_H
+#define FIGURE_HASH_H
+
+#include "Figures.h"
+#include <array>
+#include <cinttypes>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Vertices sorted with Point::operator<, which is the order operator== of the
+// figures compares in. Two figures are equal exactly when their canonical
+// point arrays are equal element by element.
+template <uint64_t N>
+std::array<Point, N> CanonicalPoints(const RegularPolygon<N>& figure) {
+	std::array<Point, N> points = figure.GetPoints();
+	std::sort(points.begin(), points.end());
+
+	return points;
+}
+
+inline uint64_t CombineHash(uint64_t seed, uint64_t value) {
+	value *= 0x9e3779b97f4a7c15ULL;
+	value ^= value >> 32;
+	return (seed ^ value) * 0xff51afd7ed558ccdULL + (seed >> 29);
+}
+
+// Hash of canonical points with every coordinate snapped to the pointEpsilon
+// grid, so figures that differ only by rounding noise well inside a grid cell
+// hash alike. Coordinates within pointEpsilon of each other but on opposite
+// sides of a grid line still hash apart; such near-duplicates survive
+// deduplication.
+template <uint64_t N>
+uint64_t HashCanonicalPoints(const std::array<Point, N>& points) {
+	uint64_t seed = N;
+	for (const Point& point : points) {
+		seed = CombineHash(seed, std::hash<double>()(std::floor(point.x / pointEpsilon) + 0.0));
+		seed = CombineHash(seed, std::hash<double>()(std::floor(point.y / pointEpsilon) + 0.0));
+	}
+
+	return seed;
+}
+
+// Figure together with its canonical points and hash, computed once when it
+// is built; comparing two of them is a linear pass without sorting.
+template <uint64_t N>
+class CanonicalFigure {
+public:
+	explicit CanonicalFigure(const RegularPolygon<N>& figure);
+public:
+	const RegularPolygon<N>& GetFigure() const noexcept;
+	const std::array<Point, N>& GetCanonicalPoints() const noexcept;
+	uint64_t GetHash() const noexcept;
+
+	bool operator==(const CanonicalFigure& other) const;
+	bool operator!=(const CanonicalFigure& other) const;
+private:
+	RegularPolygon<N> _figure;
+	std::array<Point, N> _canonicalPoints;
+	uint64_t _hash;
+};
+
+namespace std {
+
+template <uint64_t N>
+struct hash<RegularPolygon<N>> {
+	size_t operator()(const RegularPolygon<N>& figure) const {
+		return static_cast<size_t>(HashCanonicalPoints(CanonicalPoints(figure)));
+	}
+};
+
+template <uint64_t N>
+struct hash<CanonicalFigure<N>> {
+	size_t operator()(const CanonicalFigure<N>& figure) const noexcept {
+		return static_cast<size_t>(figure.GetHash());
+	}
+};
+
+}
+
+// Hash set of figures that treats figures equal under operator== as the
+// same element.
+template <uint64_t N>
+class FigureSet {
+public:
+	using const_iterator = typename std::unordered_set<CanonicalFigure<N>>::const_iterator;
+public:
+	bool Insert(const RegularPolygon<N>& figure);
+	bool Erase(const RegularPolygon<N>& figure);
+	bool Contains(const RegularPolygon<N>& figure) const;
+
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+	void Reserve(uint64_t count);
+	void Clear() noexcept;
+
+	const_iterator begin() const noexcept;
+	const_iterator end() const noexcept;
+private:
+	std::unordered_set<CanonicalFigure<N>> _figures;
+};
+
+template <uint64_t N, typename Value>
+class FigureMap {
+public:
+	using const_iterator = typename std::unordered_map<CanonicalFigure<N>, Value>::const_iterator;
+public:
+	Value& operator[](const RegularPolygon<N>& figure);
+	const Value* Find(const RegularPolygon<N>& figure) const;
+	bool Erase(const RegularPolygon<N>& figure);
+
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+	void Reserve(uint64_t count);
+	void Clear() noexcept;
+
+	const_iterator begin() const noexcept;
+	const_iterator end() const noexcept;
+private:
+	std::unordered_map<CanonicalFigure<N>, Value> _figures;
+};
+
+// Unique figures of the input in order of first occurrence, in one pass.
+template <uint64_t N>
+std::vector<RegularPolygon<N>> Deduplicate(const std::vector<RegularPolygon<N>>& figures);
+
+template <uint64_t N>
+CanonicalFigure<N>::CanonicalFigure(const RegularPolygon<N>& figure) :
+	_figure(figure), _canonicalPoints(CanonicalPoints(figure)), _hash(HashCanonicalPoints(_canonicalPoints)) {}
+
+template <uint64_t N>
+const RegularPolygon<N>& CanonicalFigure<N>::GetFigure() const noexcept {
+	return _figure;
+}
+
+template <uint64_t N>
+const std::array<Point, N>& CanonicalFigure<N>::GetCanonicalPoints() const noexcept {
+	return _canonicalPoints;
+}
+
+template <uint64_t N>
+uint64_t CanonicalFigure<N>::GetHash() const noexcept {
+	return _hash;
+}
+
+template <uint64_t N>
+bool CanonicalFigure<N>::operator==(const CanonicalFigure& other) const {
+	return _canonicalPoints == other._canonicalPoints;
+}
+
+template <uint64_t N>
+bool CanonicalFigure<N>::operator!=(const CanonicalFigure& other) const {
+	return !(*this == other);
+}
+
+template <uint64_t N>
+bool FigureSet<N>::Insert(const RegularPolygon<N>& figure) {
+	return _figures.emplace(figure).second;
+}
+
+template <uint64_t N>
+bool FigureSet<N>::Erase(const RegularPolygon<N>& figure) {
+	return _figures.erase(CanonicalFigure<N>(figure)) != 0;
+}
+
+template <uint64_t N>
+bool FigureSet<N>::Contains(const RegularPolygon<N>& figure) const {
+	return _figures.find(CanonicalFigure<N>(figure)) != _figures.end();
+}
+
+template <uint64_t N>
+uint64_t FigureSet<N>::Size() const noexcept {
+	return _figures.size();
+}
+
+template <uint64_t N>
+bool FigureSet<N>::Empty() const noexcept {
+	return _figures.empty();
+}
+
+template <uint64_t N>
+void FigureSet<N>::Reserve(uint64_t count) {
+	_figures.reserve(count);
+}
+
+template <uint64_t N>
+void FigureSet<N>::Clear() noexcept {
+	_figures.clear();
+}
+
+template <uint64_t N>
+typename FigureSet<N>::const_iterator FigureSet<N>::begin() const noexcept {
+	return _figures.begin();
+}
+
+template <uint64_t N>
+typename FigureSet<N>::const_iterator FigureSet<N>::end() const noexcept {
+	return _figures.end();
+}
+
+template <uint64_t N, typename Value>
+Value& FigureMap<N, Value>::operator[](const RegularPolygon<N>& figure) {
+	return _figures[CanonicalFigure<N>(figure)];
+}
+
+template <uint64_t N, typename Value>
+const Value* FigureMap<N, Value>::Find(const RegularPolygon<N>& figure) const {
+	auto found = _figures.find(CanonicalFigure<N>(figure));
+
+	return found == _figures.end() ? nullptr : &found->second;
+}
+
+template <uint64_t N, typename Value>
+bool FigureMap<N, Value>::Erase(const RegularPolygon<N>& figure) {
+	return _figures.erase(CanonicalFigure<N>(figure)) != 0;
+}
+
+template <uint64_t N, typename Value>
+uint64_t FigureMap<N, Value>::Size() const noexcept {
+	return _figures.size();
+}
+
+template <uint64_t N, typename Value>
+bool FigureMap<N, Value>::Empty() const noexcept {
+	return _figures.empty();
+}
+
+template <uint64_t N, typename Value>
+void FigureMap<N, Value>::Reserve(uint64_t count) {
+	_figures.reserve(count);
+}
+
+template <uint64_t N, typename Value>
+void FigureMap<N, Value>::Clear() noexcept {
+	_figures.clear();
+}
+
+template <uint64_t N, typename Value>
+typename FigureMap<N, Value>::const_iterator FigureMap<N, Value>::begin() const noexcept {
+	return _figures.begin();
+}
+
+template <uint64_t N, typename Value>
+typename FigureMap<N, Value>::const_iterator FigureMap<N, Value>::end() const noexcept {
+	return _figures.end();
+}
+
+template <uint64_t N>
+std::vector<RegularPolygon<N>> Deduplicate(const std::vector<RegularPolygon<N>>& figures) {
+	FigureSet<N> seen;
+	seen.Reserve(figures.size());
+
+	std::vector<RegularPolygon<N>> unique;
+	for (const RegularPolygon<N>& figure : figures) {
+		if (seen.Insert(figure)) {
+			unique.push_back(figure);
+		}
+	}
+
+	return unique;
+}
+
+#endif
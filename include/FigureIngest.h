@@ -0,0 +1,102 @@
+#ifndef FIGURE_INGEST_H
+#define FIGURE_INGEST_H
+
+#include "Figures.h"
+#include "BoundedQueue.h"
+#include "FigureBatch.h"
+#include "FigureParser.h"
+#include <cinttypes>
+#include <functional>
+#include <string>
+#include <variant>
+#include <vector>
+
+enum class IngestBackend {
+	// io_uring where the kernel offers it, otherwise the thread pool.
+	Automatic,
+	IoUring,
+	ThreadPool
+};
+
+const char* GetBackendName(IngestBackend backend) noexcept;
+
+struct IngestOptions {
+	// Vertices of the figures in text files: 4, 5 or 6. Binary figure files
+	// are detected by their magic and may hold any kind.
+	uint64_t amountOfPoints = 4;
+	// Bytes of a file read at a time.
+	uint64_t readSize = 1 << 20;
+	// Reads kept in flight across all files.
+	uint64_t readsInFlight = 32;
+	// Threads issuing reads for the thread pool backend.
+	uint64_t readerThreads = 8;
+	// Threads parsing completed reads; 0 means one per hardware thread.
+	uint64_t parserThreads = 0;
+	// Figures per batch of binary input.
+	uint64_t chunkFigures = 16384;
+	// Parse errors kept per file; later ones are only counted.
+	uint64_t maxErrors = 100;
+	IngestBackend backend = IngestBackend::Automatic;
+};
+
+// Figures parsed from one read of a text file or one chunk of a binary file.
+// sequence numbers the batches of a file from 0.
+struct IngestBatch {
+	uint64_t file;
+	uint64_t sequence;
+	std::variant<RhombusBatch, PentagonBatch, HexagonBatch> figures;
+};
+
+struct IngestFileReport {
+	std::string path;
+	uint64_t bytes;
+	uint64_t figureCount;
+	uint64_t batchCount;
+	bool binary;
+	std::vector<ParseError> errors;
+	uint64_t errorCount;
+};
+
+struct IngestReport {
+	// The backend that did the reads; never Automatic.
+	IngestBackend backend;
+	// In the order of the paths given.
+	std::vector<IngestFileReport> files;
+};
+
+// Reads many figure files at once and parses them as the reads complete.
+// One thread keeps readsInFlight reads of readSize bytes in flight, walking
+// the files in order, through io_uring or, where that is unavailable, a pool
+// of threads calling pread(). Completed buffers go straight to the parser
+// threads. A text file is parsed read by read in file order with the grammar
+// of TextRecordParser, so numbers and records may span reads; the reads of
+// different files are parsed in parallel. Binary figure files are mapped
+// once their first read shows the magic, as FigureFileReader does, and the
+// rest of their reads are dropped. Memory stays bounded by the buffers in
+// flight whatever the size and number of files.
+class FigureIngest {
+public:
+	using BatchCallback = std::function<void(IngestBatch batch)>;
+public:
+	explicit FigureIngest(const IngestOptions& options = IngestOptions());
+public:
+	// Calls callback for every batch from the parser threads: concurrently
+	// for different files, one at a time and in sequence order for the same
+	// file. Throws std::runtime_error if a file cannot be read or io_uring
+	// was asked for and is unavailable, and std::invalid_argument if a binary
+	// file is malformed; an exception thrown by callback is rethrown. Either
+	// way the remaining files are abandoned. Parse errors in text files do
+	// not throw and are reported per file.
+	IngestReport Run(const std::vector<std::string>& paths, const BatchCallback& callback);
+	// Pushes every batch into batches, which another thread drains, and
+	// closes it when done or failed. Stops early if the consumer closes it.
+	IngestReport Run(const std::vector<std::string>& paths, BoundedQueue<IngestBatch>& batches);
+
+	const IngestOptions& GetOptions() const noexcept;
+
+	static bool IsIoUringAvailable();
+private:
+	IngestOptions _options;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef FIGURE_KERNELS_H
+#define FIGURE_KERNELS_H
+
+#include "Figures.h"
+#include <cinttypes>
+
+// Instruction sets the batch kernels are built for. The best one supported by
+// the running CPU is chosen on first use; Scalar is always available.
+enum class KernelIsa {
+	Scalar,
+	Sse2,
+	Avx2,
+	Avx512
+};
+
+bool IsKernelIsaSupported(KernelIsa isa);
+KernelIsa GetBestKernelIsa();
+KernelIsa GetKernelIsa();
+void SetKernelIsa(KernelIsa isa);
+const char* GetKernelIsaName(KernelIsa isa);
+
+// All kernels take the figures in structure-of-arrays form: xs[i] and ys[i]
+// point to the coordinates of vertex i of count figures. Every instruction set
+// performs the same operations in the same order as the per-object code, so
+// the results are bit-identical whichever kernel runs.
+
+// sides[i][j] receives the length of the side between vertices i and i + 1
+// (the last side closes the figure) of figure j.
+void ComputeSideLengths(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+						uint64_t count, double* const* sides);
+
+void ComputeRhombusAreas(const double* const* xs, const double* const* ys, uint64_t count, double* areas);
+
+void ComputeRegularPolygonAreas(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+								uint64_t count, double* areas);
+
+// Shoelace areas, the same as GetArea(AreaMode::Shoelace) per figure.
+void ComputeShoelaceAreas(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+						  uint64_t count, double* areas);
+
+void ComputeGeometricCenters(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+							 uint64_t count, Point* centers);
+
+// The same area and center kernels on compact coordinates, which are widened
+// to double as they are loaded: float32 exactly, and fixed-point value q to
+// origin.x + step * q for xs and origin.y + step * q for ys. The results are
+// bit-identical to the double kernels on the widened coordinates.
+void ComputeFloatRhombusAreas(const float* const* xs, const float* const* ys, uint64_t count, double* areas);
+void ComputeFloatRegularPolygonAreas(uint64_t amountOfPoints, const float* const* xs, const float* const* ys,
+									 uint64_t count, double* areas);
+void ComputeFloatShoelaceAreas(uint64_t amountOfPoints, const float* const* xs, const float* const* ys,
+							   uint64_t count, double* areas);
+void ComputeFloatGeometricCenters(uint64_t amountOfPoints, const float* const* xs, const float* const* ys,
+								  uint64_t count, Point* centers);
+
+void ComputeFixedPointRhombusAreas(const int32_t* const* xs, const int32_t* const* ys, const Point& origin, double step,
+								   uint64_t count, double* areas);
+void ComputeFixedPointRegularPolygonAreas(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+										  const Point& origin, double step, uint64_t count, double* areas);
+void ComputeFixedPointShoelaceAreas(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+									const Point& origin, double step, uint64_t count, double* areas);
+void ComputeFixedPointGeometricCenters(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+									   const Point& origin, double step, uint64_t count, Point* centers);
+
+// In place, the same as Transform() / Rotate() per figure. TransformPoints
+// maps count points; RotateAboutCenters turns each of count figures by
+// angle radians about its own geometric center.
+void TransformPoints(const AffineTransform& transform, double* xs, double* ys, uint64_t count);
+void RotateAboutCenters(uint64_t amountOfPoints, double* const* xs, double* const* ys, uint64_t count, double angle);
+
+// inside[j] becomes 1 when the outline of amountOfPoints vertices contains
+// the point (xs[j], ys[j]) and 0 otherwise, the same as OutlineContains() per
+// point. Unlike the kernels above this one runs across points, with the
+// outline broadcast to every lane.
+void ContainsPoints(const Point* outline, uint64_t amountOfPoints, const double* xs, const double* ys,
+					uint64_t count, uint8_t* inside);
+
+#endif
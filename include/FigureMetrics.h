@@ -0,0 +1,126 @@
+#ifndef FIGURE_METRICS_H
+#define FIGURE_METRICS_H
+
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <iostream>
+
+// Events the library counts when built with FIGURES_ENABLE_METRICS.
+enum class MetricCounter {
+	RecordsParsed,
+	ParseErrors,
+	FiguresSerialized,
+	AreaComputations,
+	CenterComputations,
+	Comparisons,
+	Copies,
+	Moves,
+	ArenaAllocations,
+	ArenaBlockAllocations
+};
+
+// Timed stages. Each call records its latency and the number of items it
+// handled: bytes for Parse and Flush, figures for Serialize, Areas and
+// Centers, points for Classify.
+enum class MetricStage {
+	Parse,
+	Serialize,
+	Flush,
+	Areas,
+	Centers,
+	Classify
+};
+
+constexpr uint64_t metricCounterCount = static_cast<uint64_t>(MetricCounter::ArenaBlockAllocations) + 1;
+constexpr uint64_t metricStageCount = static_cast<uint64_t>(MetricStage::Classify) + 1;
+
+// Latencies go into power-of-two buckets: bucket 0 holds calls of at most
+// 1ns and bucket i those in (2^(i-1), 2^i] ns. The last bucket also takes
+// everything longer, which is about nine minutes.
+constexpr uint64_t latencyBucketCount = 40;
+
+constexpr bool AreMetricsEnabled() {
+#ifdef FIGURES_ENABLE_METRICS
+	return true;
+#else
+	return false;
+#endif
+}
+
+const char* GetMetricName(MetricCounter counter);
+const char* GetMetricName(MetricStage stage);
+
+struct StageMetrics {
+	uint64_t calls;
+	uint64_t items;
+	uint64_t totalNanoseconds;
+	std::array<uint64_t, latencyBucketCount> buckets;
+
+	static uint64_t GetBucket(uint64_t nanoseconds) noexcept;
+	// Inclusive upper bound of a bucket; the last one is unbounded.
+	static uint64_t GetBucketLimit(uint64_t bucket) noexcept;
+
+	double GetItemsPerSecond() const noexcept;
+	double GetMeanNanoseconds() const noexcept;
+	// Upper bound of the bucket holding the given quantile, or 0 without
+	// calls.
+	uint64_t GetQuantileNanoseconds(double quantile) const noexcept;
+};
+
+// Totals over every thread that has recorded anything since the last
+// ResetMetrics(), including threads that have since exited.
+struct MetricsSnapshot {
+	uint64_t threads;
+	std::array<uint64_t, metricCounterCount> counters;
+	std::array<StageMetrics, metricStageCount> stages;
+
+	uint64_t GetCounter(MetricCounter counter) const noexcept;
+	const StageMetrics& GetStage(MetricStage stage) const noexcept;
+
+	void WriteJson(std::ostream& ostream) const;
+	// Prometheus text exposition format: one counter family for the events,
+	// one for stage items and one histogram of stage latencies in seconds.
+	void WritePrometheus(std::ostream& ostream) const;
+};
+
+// Every thread records into its own block, which only that thread writes,
+// so recording takes no lock and shares no cache line with other threads.
+// A block is registered on the first record of a thread and folded into the
+// totals when the thread exits. Both functions work whether or not the
+// instrumentation is compiled in; the macros below decide that.
+void RecordCount(MetricCounter counter, uint64_t amount = 1) noexcept;
+void RecordLatency(MetricStage stage, uint64_t nanoseconds, uint64_t items) noexcept;
+
+// Safe to call while other threads record.
+MetricsSnapshot TakeMetricsSnapshot();
+// Later snapshots count from here on.
+void ResetMetrics();
+
+// Records the time from construction to destruction as one call of a stage.
+class StageTimer {
+public:
+	StageTimer(MetricStage stage, uint64_t items) noexcept;
+	StageTimer(const StageTimer& other) = delete;
+	~StageTimer() noexcept;
+public:
+	StageTimer& operator=(const StageTimer& other) = delete;
+private:
+	MetricStage _stage;
+	uint64_t _items;
+	std::chrono::steady_clock::time_point _start;
+};
+
+// Instrumentation points. Without FIGURES_ENABLE_METRICS they expand to
+// nothing, so the hot paths carry no cost at all.
+#ifdef FIGURES_ENABLE_METRICS
+#define FIGURES_COUNT(counter) RecordCount(MetricCounter::counter)
+#define FIGURES_COUNT_N(counter, amount) RecordCount(MetricCounter::counter, amount)
+#define FIGURES_TIME_STAGE(stage, items) StageTimer figuresStageTimer(MetricStage::stage, items)
+#else
+#define FIGURES_COUNT(counter) static_cast<void>(0)
+#define FIGURES_COUNT_N(counter, amount) static_cast<void>(0)
+#define FIGURES_TIME_STAGE(stage, items) static_cast<void>(0)
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef FIGURE_OVERLAP_H
+#define FIGURE_OVERLAP_H
+
+#include "Figures.h"
+#include "FigureBatch.h"
+#include "Polygon.h"
+#include "PointClassifier.h"
+#include "ThreadPool.h"
+#include <cinttypes>
+#include <vector>
+
+// Intersection tests and overlap areas of convex outlines: count points given
+// in order around the outline, in either direction. Rhombus, Pentagon and
+// Hexagon built from the vertices of a convex figure qualify; for outlines
+// that are not convex the results are those of no particular shape.
+// IsConvexOutline() tells them apart.
+//
+// Outlines are closed, so outlines that only touch intersect, with an
+// overlap area of 0. Both functions work on offsets from a vertex of the
+// second outline, which keeps their precision for figures far from (0, 0).
+
+// True if the outline turns the same way at every vertex. Repeated and
+// collinear vertices are allowed; an outline with no area is not convex.
+bool IsConvexOutline(const Point* points, uint64_t count);
+
+// Separating axis test: the outlines are disjoint exactly when their boxes
+// or their projections onto the normal of some edge are.
+bool ConvexOutlinesIntersect(const Point* first, uint64_t firstCount, const Point* second, uint64_t secondCount);
+
+// Area of the intersection, found by clipping first with every edge of
+// second (Sutherland-Hodgman) and taking the shoelace area of the result.
+double ConvexOverlapArea(const Point* first, uint64_t firstCount, const Point* second, uint64_t secondCount);
+
+template <uint64_t N, uint64_t M>
+bool Intersects(const RegularPolygon<N>& first, const RegularPolygon<M>& second);
+bool Intersects(const Polygon& first, const Polygon& second);
+
+template <uint64_t N, uint64_t M>
+double OverlapArea(const RegularPolygon<N>& first, const RegularPolygon<M>& second);
+double OverlapArea(const Polygon& first, const Polygon& second);
+
+// Two intersecting figures, first < second, and the area they share.
+struct FigureOverlap {
+	uint64_t first;
+	uint64_t second;
+	double area;
+};
+
+// Every pair of intersecting figures, sorted by (first, second). Sweep and
+// prune in horizontal bands about as high as the average figure: each figure
+// joins every band its box spans, a band is sorted by the left edge of the
+// boxes, and a figure is tested only against the figures of the band whose
+// left edge lies within its own box. The cost follows the number of nearby
+// boxes rather than the square of the figure count, and stays low for
+// uniformly scattered figures, where a single sweep along x would meet a
+// whole column of them. Candidates whose boxes overlap go through
+// ConvexOutlinesIntersect() and ConvexOverlapArea().
+//
+// The sweep runs in chunks of the sorted order on the pool and gives exactly
+// the sequential result. Throws std::invalid_argument for a figure with a
+// coordinate that is not finite.
+std::vector<FigureOverlap> FindOverlaps(const FigureOutlines& figures);
+std::vector<FigureOverlap> FindOverlaps(const FigureOutlines& figures, ThreadPool& pool);
+template <uint64_t N>
+std::vector<FigureOverlap> FindOverlaps(const FigureBatch<N>& batch);
+template <uint64_t N>
+std::vector<FigureOverlap> FindOverlaps(const FigureBatch<N>& batch, ThreadPool& pool);
+
+template <uint64_t N, uint64_t M>
+bool Intersects(const RegularPolygon<N>& first, const RegularPolygon<M>& second) {
+	return ConvexOutlinesIntersect(first.GetPoints().data(), N, second.GetPoints().data(), M);
+}
+
+template <uint64_t N, uint64_t M>
+double OverlapArea(const RegularPolygon<N>& first, const RegularPolygon<M>& second) {
+	return ConvexOverlapArea(first.GetPoints().data(), N, second.GetPoints().data(), M);
+}
+
+template <uint64_t N>
+std::vector<FigureOverlap> FindOverlaps(const FigureBatch<N>& batch) {
+	return FindOverlaps(MakeFigureOutlines(batch));
+}
+
+template <uint64_t N>
+std::vector<FigureOverlap> FindOverlaps(const FigureBatch<N>& batch, ThreadPool& pool) {
+	return FindOverlaps(MakeFigureOutlines(batch), pool);
+}
+
+#endif
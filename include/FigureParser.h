@@ -0,0 +1,164 @@
+#ifndef FIGURE_PARSER_H
+#define FIGURE_PARSER_H
+
+#include "Figures.h"
+#include <array>
+#include <cinttypes>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct ParseError {
+	uint64_t line;
+	uint64_t column;
+	std::string message;
+};
+
+// Splits text into whitespace-separated numbers with exactly the grammar
+// istream >> double accepts in the "C" locale (optional sign, digits with an
+// optional decimal point, optional exponent; no inf, nan or hex) and groups
+// them into records of valuesPerRecord numbers. Input may be fed in chunks of
+// any size; a number split between chunks is stitched back together.
+//
+// Errors never throw: a bad number is recorded with its 1-based line and
+// column, the record being read is dropped and parsing resumes at the next
+// line.
+class TextRecordParser {
+public:
+	explicit TextRecordParser(uint64_t valuesPerRecord);
+public:
+	void Feed(const char* data, uint64_t size);
+	void Finish();
+
+	uint64_t GetValuesPerRecord() const noexcept;
+	uint64_t GetRecordCount() const noexcept;
+
+	// Returns the values of all complete records read so far; the values of
+	// a record still being read stay in the parser.
+	std::vector<double> TakeValues();
+	std::vector<ParseError> TakeErrors();
+private:
+	void Process(const char* begin, const char* end);
+	void AddError(uint64_t line, uint64_t column, const char* message);
+	void Advance(char character);
+private:
+	uint64_t _valuesPerRecord;
+	std::vector<double> _values;
+	std::vector<ParseError> _errors;
+	std::string _pending;
+	uint64_t _line;
+	uint64_t _column;
+	bool _skipLine;
+};
+
+template <typename T>
+struct FigureTextTraits {
+	static constexpr uint64_t amountOfPoints = std::tuple_size<std::decay_t<decltype(std::declval<T>().GetPoints())>>::value;
+};
+
+template <>
+struct FigureTextTraits<Point> {
+	static constexpr uint64_t amountOfPoints = 1;
+};
+
+template <typename T>
+struct ParseResult {
+	std::vector<T> figures;
+	std::vector<ParseError> errors;
+};
+
+// Parses a stream of Points, Rhombuses, Pentagons or Hexagons in the text
+// form their operator>> reads.
+template <typename T>
+class FigureTextParser {
+public:
+	FigureTextParser();
+public:
+	void Feed(const char* data, uint64_t size);
+	void Finish();
+
+	std::vector<T> TakeFigures();
+	std::vector<ParseError> TakeErrors();
+private:
+	static constexpr uint64_t _amountOfPoints = FigureTextTraits<T>::amountOfPoints;
+	TextRecordParser _parser;
+};
+
+template <typename T>
+ParseResult<T> ParseFigures(const char* data, uint64_t size);
+
+template <typename T>
+ParseResult<T> ParseFigures(std::istream& istream, uint64_t chunkSize = 1 << 20);
+
+template <typename T>
+FigureTextParser<T>::FigureTextParser() : _parser(2 * _amountOfPoints) {}
+
+template <typename T>
+void FigureTextParser<T>::Feed(const char* data, uint64_t size) {
+	_parser.Feed(data, size);
+}
+
+template <typename T>
+void FigureTextParser<T>::Finish() {
+	_parser.Finish();
+}
+
+template <typename T>
+std::vector<T> FigureTextParser<T>::TakeFigures() {
+	std::vector<double> values = _parser.TakeValues();
+	std::vector<T> figures;
+	figures.reserve(values.size() / (2 * _amountOfPoints));
+
+	for (uint64_t i = 0; i + 2 * _amountOfPoints <= values.size(); i += 2 * _amountOfPoints) {
+		if constexpr (std::is_same<T, Point>::value) {
+			figures.emplace_back(values[i], values[i + 1]);
+		} else {
+			std::array<Point, _amountOfPoints> points;
+			for (uint64_t j = 0; j < _amountOfPoints; ++j) {
+				points[j] = Point(values[i + 2 * j], values[i + 2 * j + 1]);
+			}
+			figures.emplace_back(points);
+		}
+	}
+
+	return figures;
+}
+
+template <typename T>
+std::vector<ParseError> FigureTextParser<T>::TakeErrors() {
+	return _parser.TakeErrors();
+}
+
+template <typename T>
+ParseResult<T> ParseFigures(const char* data, uint64_t size) {
+	FigureTextParser<T> parser;
+	parser.Feed(data, size);
+	parser.Finish();
+
+	return {parser.TakeFigures(), parser.TakeErrors()};
+}
+
+template <typename T>
+ParseResult<T> ParseFigures(std::istream& istream, uint64_t chunkSize) {
+	FigureTextParser<T> parser;
+	std::vector<char> chunk(chunkSize);
+	ParseResult<T> result;
+
+	while (istream) {
+		istream.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+		parser.Feed(chunk.data(), static_cast<uint64_t>(istream.gcount()));
+
+		std::vector<T> figures = parser.TakeFigures();
+		result.figures.insert(result.figures.end(), figures.begin(), figures.end());
+	}
+	parser.Finish();
+
+	std::vector<T> figures = parser.TakeFigures();
+	result.figures.insert(result.figures.end(), figures.begin(), figures.end());
+	result.errors = parser.TakeErrors();
+
+	return result;
+}
+
+#endif
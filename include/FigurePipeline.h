@@ -0,0 +1,107 @@
+#ifndef FIGURE_PIPELINE_H
+#define FIGURE_PIPELINE_H
+
+#include "Figures.h"
+#include "BoundedQueue.h"
+#include "FigureBatch.h"
+#include "FigureFile.h"
+#include "FigureParser.h"
+#include <cinttypes>
+#include <functional>
+#include <iostream>
+#include <variant>
+#include <vector>
+
+// Area and geometric center of the index-th figure of a stream.
+struct FigureResult {
+	uint64_t index;
+	uint64_t amountOfPoints;
+	double area;
+	Point center;
+};
+
+// Count, sum, minimum and maximum of the areas seen so far, and the
+// topCount largest figures, kept in a bounded heap so that memory does not
+// grow with the input. While empty, the minimum is +infinity and the
+// maximum -infinity.
+class RunningAggregates {
+public:
+	explicit RunningAggregates(uint64_t topCount = 10);
+public:
+	void Add(const FigureResult& result);
+
+	uint64_t GetCount() const noexcept;
+	double GetSum() const noexcept;
+	double GetMin() const noexcept;
+	double GetMax() const noexcept;
+	uint64_t GetTopCount() const noexcept;
+	// Largest first; figures with equal areas in stream order.
+	std::vector<FigureResult> GetTop() const;
+private:
+	static bool Before(const FigureResult& first, const FigureResult& second);
+private:
+	std::vector<FigureResult> _top;
+	uint64_t _topCount;
+	uint64_t _count;
+	double _sum;
+	double _min;
+	double _max;
+};
+
+struct PipelineOptions {
+	// Vertices of the figures in text input: 4, 5 or 6.
+	uint64_t amountOfPoints = 4;
+	// Bytes read from text input at a time.
+	uint64_t readSize = 1 << 20;
+	// Figures per chunk of binary input.
+	uint64_t chunkFigures = 16384;
+	// Chunks buffered between two stages.
+	uint64_t queueCapacity = 4;
+	uint64_t topCount = 10;
+	// Parse errors kept; later ones are only counted.
+	uint64_t maxErrors = 100;
+	// Write a line per figure; otherwise only the aggregates are kept.
+	bool writeFigures = true;
+};
+
+// Streams figures through three stages on their own threads: reading and
+// parsing, computing areas and centers with the batch kernels, and writing
+// a line "index area (x y)" per figure. The stages exchange chunks through
+// bounded queues, so at most a few chunks are in memory whatever the size of
+// the input. Figures are numbered and aggregated across all inputs given to
+// one pipeline.
+class FigurePipeline {
+public:
+	explicit FigurePipeline(const PipelineOptions& options = PipelineOptions());
+public:
+	void ProcessText(std::istream& input, std::ostream& output);
+	// Tables are processed in order of vertex count.
+	void ProcessBinary(const FigureFileReader& reader, std::ostream& output);
+
+	// Writes the aggregates as "key value" lines, then one "top" line per
+	// largest figure.
+	void WriteSummary(std::ostream& output) const;
+
+	const RunningAggregates& GetAggregates() const noexcept;
+	const std::vector<ParseError>& GetErrors() const noexcept;
+	uint64_t GetErrorCount() const noexcept;
+private:
+	using FigureChunk = std::variant<RhombusBatch, PentagonBatch, HexagonBatch>;
+	using ChunkSource = std::function<void(BoundedQueue<FigureChunk>& chunks)>;
+private:
+	void Run(const ChunkSource& source, std::ostream& output);
+	std::vector<FigureResult> Compute(const FigureChunk& chunk);
+	template <uint64_t N>
+	void ReadText(std::istream& input, BoundedQueue<FigureChunk>& chunks);
+	template <uint64_t N>
+	void ReadBinary(const FigureFileReader& reader, BoundedQueue<FigureChunk>& chunks) const;
+	void AddErrors(std::vector<ParseError> errors);
+private:
+	PipelineOptions _options;
+	RunningAggregates _aggregates;
+	std::vector<ParseError> _errors;
+	uint64_t _errorCount;
+	uint64_t _nextIndex;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef FIGURE_PROTOCOL_H
+#define FIGURE_PROTOCOL_H
+
+#include "Figures.h"
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+// Binary request protocol of FigureServer. Every field is little-endian.
+// A frame is a FrameHeader followed by payloadSize bytes of payload, in both
+// directions. Clients may send any number of requests before reading; the
+// server answers the requests of a connection in the order they came, and
+// every response repeats the requestId, opcode and dataset of its request.
+//
+//   opcode        request payload              response payload
+//   ListDatasets  empty                        uint32 count, then per dataset
+//                                              uint64 figures, uint32 length
+//                                              and the name bytes
+//   Areas         uint64 figure indices        one double per index
+//   Centroids     uint64 figure indices        x and y doubles per index
+//   WindowQuery   window: 4 doubles            uint64 indices of the figures
+//                 (minX, minY, maxX, maxY)     whose box intersects it, sorted
+//   Aggregate     empty, or a window           DatasetAggregate of the whole
+//                                              dataset or of the window
+//
+// A response with a status other than Ok carries an error message instead.
+// Frames with a payload over maxPayloadSize end the connection.
+
+enum class FigureOpcode : uint16_t {
+	ListDatasets,
+	Areas,
+	Centroids,
+	WindowQuery,
+	Aggregate
+};
+
+enum class FigureStatus : uint16_t {
+	Ok,
+	UnknownOpcode,
+	UnknownDataset,
+	BadRequest,
+	IndexOutOfRange
+};
+
+struct FrameHeader {
+	uint32_t payloadSize;
+	uint32_t requestId;
+	uint16_t opcode;
+	uint16_t status;
+	uint32_t dataset;
+};
+
+constexpr uint64_t frameHeaderSize = 16;
+constexpr uint64_t maxPayloadSize = 64 << 20;
+
+// Figures are counted by index; the areas and the bounds are those of the
+// figures counted. An empty aggregate has a count of 0, areas of 0 and an
+// empty box.
+struct DatasetAggregate {
+	uint64_t count;
+	double totalArea;
+	double minArea;
+	double maxArea;
+	BoundingBox bounds;
+};
+
+struct DatasetInfo {
+	std::string name;
+	uint64_t figureCount;
+};
+
+const char* GetStatusName(FigureStatus status);
+
+void AppendFrameHeader(std::vector<char>& out, const FrameHeader& header);
+// Reads frameHeaderSize bytes.
+FrameHeader ReadFrameHeader(const char* data);
+
+// Payload encoding. The decoders throw std::invalid_argument if the payload
+// does not have the size its contents need.
+std::vector<char> EncodeIndices(const uint64_t* indices, uint64_t count);
+std::vector<char> EncodeWindow(const BoundingBox& window);
+std::vector<char> EncodeAreas(const double* areas, uint64_t count);
+std::vector<char> EncodeCentroids(const Point* centroids, uint64_t count);
+std::vector<char> EncodeAggregate(const DatasetAggregate& aggregate);
+std::vector<char> EncodeDatasets(const std::vector<DatasetInfo>& datasets);
+
+std::vector<uint64_t> DecodeIndices(const char* payload, uint64_t size);
+BoundingBox DecodeWindow(const char* payload, uint64_t size);
+std::vector<double> DecodeAreas(const char* payload, uint64_t size);
+std::vector<Point> DecodeCentroids(const char* payload, uint64_t size);
+DatasetAggregate DecodeAggregate(const char* payload, uint64_t size);
+std::vector<DatasetInfo> DecodeDatasets(const char* payload, uint64_t size);
+
+#endif
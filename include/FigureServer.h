@@ -0,0 +1,170 @@
+#ifndef FIGURE_SERVER_H
+#define FIGURE_SERVER_H
+
+#include "Figures.h"
+#include "AnyFigure.h"
+#include "BoundedQueue.h"
+#include "FigureProtocol.h"
+#include "SpatialIndex.h"
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Figures kept in memory with everything the server answers from: areas and
+// centroids computed once at load time, an R-tree over the boxes and the
+// aggregate of the whole set. Figures are indexed in FigureArray order.
+class FigureDataset {
+public:
+	explicit FigureDataset(FigureArray figures);
+public:
+	uint64_t Size() const noexcept;
+	const FigureArray& GetFigures() const noexcept;
+	const std::vector<double>& GetAreas() const noexcept;
+	const std::vector<Point>& GetCentroids() const noexcept;
+	const RTree& GetIndex() const noexcept;
+
+	// Indices of the figures whose box intersects window, sorted.
+	std::vector<uint64_t> Query(const BoundingBox& window) const;
+	DatasetAggregate Aggregate() const;
+	// Aggregate of the figures Query(window) returns.
+	DatasetAggregate Aggregate(const BoundingBox& window) const;
+private:
+	DatasetAggregate Aggregate(const uint64_t* indices, uint64_t count) const;
+private:
+	FigureArray _figures;
+	std::vector<double> _areas;
+	std::vector<Point> _centroids;
+	RTree _index;
+	DatasetAggregate _aggregate;
+};
+
+// Loads a binary figure file, or a text file of figures with
+// amountOfPoints vertices in the form operator>> reads. Throws
+// std::runtime_error if the file cannot be read and std::invalid_argument
+// if it holds malformed figures.
+FigureDataset LoadFigureDataset(const std::string& path, uint64_t amountOfPoints = 4);
+
+// Answers the protocol of FigureProtocol.h on a Unix domain socket. One
+// thread accepts connections and waits on all of them with epoll; a
+// connection that becomes readable or writable is handed to one of
+// threadCount workers. The worker reads what the client has sent, answers
+// every complete request in it and writes the responses back in one go, so
+// pipelined requests share system calls. Sockets are non-blocking and a
+// worker returns the connection to the poller when it would wait, so idle
+// clients never hold a worker and any number of them, up to
+// maxConnections, share the workers. Datasets are read-only once the
+// server runs, so workers never lock them.
+class FigureServer {
+public:
+	// Connections beyond this are closed as soon as they are accepted.
+	static constexpr uint64_t maxConnections = 4096;
+public:
+	// threadCount 0 means one worker per hardware thread.
+	explicit FigureServer(std::string socketPath, uint64_t threadCount = 0);
+	FigureServer(const FigureServer& other) = delete;
+	~FigureServer() noexcept;
+public:
+	FigureServer& operator=(const FigureServer& other) = delete;
+public:
+	// Returns the dataset id clients name in requests. Throws
+	// std::logic_error once the server runs.
+	uint32_t AddDataset(std::string name, FigureDataset dataset);
+	const FigureDataset& GetDataset(uint32_t id) const;
+	uint64_t GetDatasetCount() const noexcept;
+
+	const std::string& GetSocketPath() const noexcept;
+	uint64_t GetThreadCount() const noexcept;
+	bool IsRunning() const noexcept;
+
+	// Binds the socket, replacing a stale socket file, and starts the
+	// workers. Throws std::runtime_error if the socket cannot be set up or
+	// another server listens on it, and std::logic_error if the server has
+	// been started before.
+	void Start();
+	// Closes the socket and every open connection and joins the workers;
+	// requests not answered yet are dropped.
+	void Stop();
+
+	// Appends the response frame to request to out.
+	void Handle(const FrameHeader& request, const char* payload, std::vector<char>& out) const;
+private:
+	struct Connection;
+private:
+	void PollLoop();
+	void Accept();
+	void WorkerLoop();
+	// Returns false once the connection is to be closed.
+	bool Serve(Connection& connection);
+	// Returns false if the connection cannot be watched again.
+	bool Rearm(Connection& connection);
+	void Close(Connection& connection);
+	void AppendResponse(const FrameHeader& request, FigureStatus status, const std::vector<char>& payload,
+						std::vector<char>& out) const;
+private:
+	std::string _socketPath;
+	uint64_t _threadCount;
+	std::vector<std::string> _names;
+	std::vector<FigureDataset> _datasets;
+	int _listener;
+	int _epoll;
+	int _wakeUp;
+	bool _started;
+	std::atomic<bool> _running;
+	// Holds each connection at most once, so the poller never waits on it.
+	BoundedQueue<Connection*> _ready;
+	std::mutex _connectionsMutex;
+	std::unordered_map<int, std::unique_ptr<Connection>> _connections;
+	std::thread _poller;
+	std::vector<std::thread> _workers;
+};
+
+struct FigureResponse {
+	FrameHeader header;
+	std::vector<char> payload;
+};
+
+// Connection to a FigureServer. Send() only buffers a request and Receive()
+// flushes the buffer before it waits, so a client keeps many requests in
+// flight by sending several before receiving. The synchronous calls send
+// one request and wait for its answer, dropping responses to earlier Send()
+// calls that were not received yet; they throw std::runtime_error if the
+// server reports an error. Not thread-safe; use one client per thread.
+class FigureClient {
+public:
+	// Throws std::runtime_error if the server cannot be reached.
+	explicit FigureClient(const std::string& socketPath);
+	FigureClient(const FigureClient& other) = delete;
+	~FigureClient() noexcept;
+public:
+	FigureClient& operator=(const FigureClient& other) = delete;
+public:
+	// Returns the request id, which the response repeats.
+	uint32_t Send(FigureOpcode opcode, uint32_t dataset, const std::vector<char>& payload);
+	void Flush();
+	// The next response, in request order. Throws std::runtime_error if the
+	// server closed the connection.
+	FigureResponse Receive();
+
+	std::vector<DatasetInfo> ListDatasets();
+	std::vector<double> Areas(uint32_t dataset, const std::vector<uint64_t>& indices);
+	std::vector<Point> Centroids(uint32_t dataset, const std::vector<uint64_t>& indices);
+	std::vector<uint64_t> WindowQuery(uint32_t dataset, const BoundingBox& window);
+	DatasetAggregate Aggregate(uint32_t dataset);
+	DatasetAggregate Aggregate(uint32_t dataset, const BoundingBox& window);
+private:
+	FigureResponse Call(FigureOpcode opcode, uint32_t dataset, const std::vector<char>& payload);
+	void Fill(uint64_t size);
+private:
+	int _socket;
+	uint32_t _nextId;
+	std::vector<char> _output;
+	std::vector<char> _input;
+	uint64_t _inputOffset;
+};
+
+#endif
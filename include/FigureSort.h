@@ -0,0 +1,91 @@
+#ifndef FIGURE_SORT_H
+#define FIGURE_SORT_H
+
+#include "Figures.h"
+#include "ThreadPool.h"
+#include <array>
+#include <cinttypes>
+#include <vector>
+
+enum class SortOrder {
+	Ascending,
+	Descending
+};
+
+// Ranking works on keys computed once into a contiguous buffer (areas from
+// FigureEngine::Areas() or FigureBatch::Areas(), centers from
+// GeometricCenters()) instead of on the figures, so no virtual call happens
+// inside the sort. Results are permutations: order[i] is the index of the
+// key that goes i-th.
+//
+// The order is total, so every result is the same for any number of
+// threads: equal keys keep their input order, -0 equals +0 and NaN keys come
+// last in both directions. Centers are ordered by x and then by y, exactly;
+// Point::operator< compares with an epsilon, which is not a strict weak
+// ordering.
+
+// Stable LSD radix sort of the key bit patterns, one byte per pass. Passes
+// over a byte that all keys share are skipped, and within a pass every
+// chunk of keys is counted and scattered in parallel.
+std::vector<uint64_t> SortByKey(const double* keys, uint64_t count, SortOrder order = SortOrder::Ascending);
+std::vector<uint64_t> SortByKey(const double* keys, uint64_t count, ThreadPool& pool,
+								SortOrder order = SortOrder::Ascending);
+std::vector<uint64_t> SortByKey(const Point* keys, uint64_t count, SortOrder order = SortOrder::Ascending);
+std::vector<uint64_t> SortByKey(const Point* keys, uint64_t count, ThreadPool& pool,
+								SortOrder order = SortOrder::Ascending);
+
+// The first k entries of SortByKey(keys, count, order), found with a bounded
+// heap per chunk in O(count log k); by default the k largest keys.
+std::vector<uint64_t> TopByKey(const double* keys, uint64_t count, uint64_t k, SortOrder order = SortOrder::Descending);
+std::vector<uint64_t> TopByKey(const double* keys, uint64_t count, uint64_t k, ThreadPool& pool,
+							   SortOrder order = SortOrder::Descending);
+std::vector<uint64_t> TopByKey(const Point* keys, uint64_t count, uint64_t k, SortOrder order = SortOrder::Descending);
+std::vector<uint64_t> TopByKey(const Point* keys, uint64_t count, uint64_t k, ThreadPool& pool,
+							   SortOrder order = SortOrder::Descending);
+
+// Indices of the keys below the threshold followed by the others (NaN
+// included), each part in input order; indices[0, split) is the first part.
+struct KeyPartition {
+	std::vector<uint64_t> indices;
+	uint64_t split;
+};
+
+KeyPartition PartitionByKey(const double* keys, uint64_t count, double threshold);
+KeyPartition PartitionByKey(const double* keys, uint64_t count, double threshold, ThreadPool& pool);
+
+// Streaming top-k: keeps the k best (key, index) pairs pushed so far in a
+// heap with the worst kept pair on top, in the same order as SortByKey.
+// Key is double or Point.
+template <typename Key>
+class TopKSelector {
+public:
+	explicit TopKSelector(uint64_t k, SortOrder order = SortOrder::Descending);
+public:
+	// O(1) for a key that does not make the top, O(log k) otherwise.
+	void Push(const Key& key, uint64_t index);
+	// Throws std::invalid_argument if the selectors rank in different orders.
+	void Merge(const TopKSelector& other);
+
+	uint64_t GetK() const noexcept;
+	uint64_t Size() const noexcept;
+
+	// Best first.
+	std::vector<uint64_t> GetIndices() const;
+private:
+	struct Entry {
+		std::array<uint64_t, 2> key;
+		uint64_t index;
+	};
+private:
+	static bool Before(const Entry& first, const Entry& second) noexcept;
+	void Push(const Entry& entry);
+private:
+	std::vector<Entry> _heap;
+	uint64_t _k;
+	SortOrder _order;
+};
+
+extern template class TopKSelector<double>;
+extern template class TopKSelector<Point>;
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef FIGURE_WRITER_H
+#define FIGURE_WRITER_H
+
+#include "Figures.h"
+#include "FigureBatch.h"
+#include <cinttypes>
+#include <functional>
+#include <vector>
+
+// Formats figures in the text grammar of their operator<< straight into a
+// caller-supplied buffer with std::to_chars, using the shortest representation
+// that reads back to the same double. The buffer is handed to the sink only
+// when it is full or on Flush(), so the sink sees a few large blocks instead
+// of one call per number.
+class FigureTextWriter {
+public:
+	using Sink = std::function<void(const char* data, uint64_t size)>;
+	static constexpr uint64_t minCapacity = 64;
+public:
+	FigureTextWriter(char* buffer, uint64_t capacity, Sink sink);
+	FigureTextWriter(char* buffer, uint64_t capacity, std::ostream& ostream);
+	FigureTextWriter(const FigureTextWriter& other) = delete;
+	~FigureTextWriter() noexcept;
+public:
+	FigureTextWriter& operator=(const FigureTextWriter& other) = delete;
+public:
+	void Write(const Point& point);
+	template <uint64_t N>
+	void Write(const RegularPolygon<N>& polygon);
+	void Write(char character);
+	void Write(double value);
+	void Write(uint64_t value);
+	void Write(const char* text);
+
+	// Writes every figure on a line of its own.
+	template <typename T>
+	void WriteLines(const T* figures, uint64_t count);
+	template <typename T>
+	void WriteLines(const std::vector<T>& figures);
+	template <uint64_t N>
+	void WriteLines(const FigureBatch<N>& batch);
+
+	void Flush();
+	uint64_t GetBytesWritten() const noexcept;
+private:
+	void WriteNumber(double value);
+	void WritePoints(const Point* points, uint64_t count);
+	void Reserve(uint64_t size);
+private:
+	char* _buffer;
+	uint64_t _capacity;
+	uint64_t _used;
+	uint64_t _flushed;
+	Sink _sink;
+};
+
+template <uint64_t N>
+void FigureTextWriter::Write(const RegularPolygon<N>& polygon) {
+	FIGURES_COUNT(FiguresSerialized);
+	WritePoints(polygon.GetPoints().data(), N);
+}
+
+template <typename T>
+void FigureTextWriter::WriteLines(const T* figures, uint64_t count) {
+	FIGURES_TIME_STAGE(Serialize, count);
+	for (uint64_t i = 0; i < count; ++i) {
+		Write(figures[i]);
+		Write('\n');
+	}
+}
+
+template <typename T>
+void FigureTextWriter::WriteLines(const std::vector<T>& figures) {
+	WriteLines(figures.data(), figures.size());
+}
+
+template <uint64_t N>
+void FigureTextWriter::WriteLines(const FigureBatch<N>& batch) {
+	FIGURES_TIME_STAGE(Serialize, batch.Size());
+	FIGURES_COUNT_N(FiguresSerialized, batch.Size());
+	std::array<Point, N> points;
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		for (uint64_t j = 0; j < N; ++j) {
+			points[j] = batch.GetPoint(i, j);
+		}
+		WritePoints(points.data(), N);
+		Write('\n');
+	}
+}
+
+#endif
@@ -1,16 +1,26 @@
 #ifndef FIGURES_H
 #define FIGURES_H
 
+#include "FigureMetrics.h"
 #include <iostream>
 #include <array>
 #include <cinttypes>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Coordinates closer than this compare equal in Point's comparison operators.
+constexpr double pointEpsilon = 1e-6;
 
 struct Point {
 	double x;
 	double y;
 
-	Point();
-	Point(double x, double y);
+	constexpr Point() : x(0), y(0) {}
+	constexpr Point(double x, double y) : x(x), y(y) {}
 
 	bool operator==(const Point& other) const;
 	bool operator!=(const Point& other) const;
@@ -24,100 +34,532 @@ struct Point {
 std::istream& operator>>(std::istream& istream, Point& point);
 std::ostream& operator<<(std::ostream& ostream, const Point& point);
 
+// Closed axis-aligned box, so boxes that only touch intersect. The default
+// box is empty and absorbs whatever is added to it with Expand().
+struct BoundingBox {
+	double minX;
+	double minY;
+	double maxX;
+	double maxY;
+
+	constexpr BoundingBox() :
+		minX(std::numeric_limits<double>::infinity()), minY(std::numeric_limits<double>::infinity()),
+		maxX(-std::numeric_limits<double>::infinity()), maxY(-std::numeric_limits<double>::infinity()) {}
+	constexpr BoundingBox(double minX, double minY, double maxX, double maxY) :
+		minX(minX), minY(minY), maxX(maxX), maxY(maxY) {}
+
+	constexpr bool Empty() const {
+		return !(minX <= maxX && minY <= maxY);
+	}
+
+	constexpr bool Contains(const Point& point) const {
+		return point.x >= minX && point.x <= maxX && point.y >= minY && point.y <= maxY;
+	}
+
+	constexpr bool Intersects(const BoundingBox& other) const {
+		return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+	}
+
+	constexpr void Expand(const Point& point) {
+		minX = point.x < minX ? point.x : minX;
+		minY = point.y < minY ? point.y : minY;
+		maxX = point.x > maxX ? point.x : maxX;
+		maxY = point.y > maxY ? point.y : maxY;
+	}
+
+	constexpr void Expand(const BoundingBox& other) {
+		minX = other.minX < minX ? other.minX : minX;
+		minY = other.minY < minY ? other.minY : minY;
+		maxX = other.maxX > maxX ? other.maxX : maxX;
+		maxY = other.maxY > maxY ? other.maxY : maxY;
+	}
+
+	constexpr Point GetCenter() const {
+		return {minX / 2 + maxX / 2, minY / 2 + maxY / 2};
+	}
+
+	// Squared distance from point to the nearest point of the box; 0 inside.
+	constexpr double DistanceSquared(const Point& point) const {
+		double dx = point.x < minX ? minX - point.x : (point.x > maxX ? point.x - maxX : 0);
+		double dy = point.y < minY ? minY - point.y : (point.y > maxY ? point.y - maxY : 0);
+
+		return dx * dx + dy * dy;
+	}
+};
+
+// Bounding box of the count points of an outline; empty for none.
+constexpr BoundingBox OutlineBox(const Point* points, uint64_t count) {
+	BoundingBox box;
+	for (uint64_t i = 0; i < count; ++i) {
+		box.Expand(points[i]);
+	}
+
+	return box;
+}
+
+// Cosine and sine defined out of line, so that every rotation uses the very
+// same values: the compiler may fold calls to std::cos and std::sin with
+// constant arguments, and not always to what the library returns.
+double FigureCos(double angle);
+double FigureSin(double angle);
+
+// Affine map x' = a * x + b * y + tx, y' = c * x + d * y + ty, i.e. the
+// 2x3 matrix [a b tx; c d ty]. The default transform is the identity.
+struct AffineTransform {
+	double a;
+	double b;
+	double tx;
+	double c;
+	double d;
+	double ty;
+
+	constexpr AffineTransform() : a(1), b(0), tx(0), c(0), d(1), ty(0) {}
+	constexpr AffineTransform(double a, double b, double tx, double c, double d, double ty) :
+		a(a), b(b), tx(tx), c(c), d(d), ty(ty) {}
+
+	static constexpr AffineTransform Translation(double dx, double dy) {
+		return {1, 0, dx, 0, 1, dy};
+	}
+
+	static constexpr AffineTransform Scaling(double sx, double sy) {
+		return {sx, 0, 0, 0, sy, 0};
+	}
+
+	// Counterclockwise by angle radians about the origin.
+	static AffineTransform Rotation(double angle) {
+		return {FigureCos(angle), -FigureSin(angle), 0, FigureSin(angle), FigureCos(angle), 0};
+	}
+
+	// This transform followed by next.
+	constexpr AffineTransform Then(const AffineTransform& next) const {
+		return {next.a * a + next.b * c, next.a * b + next.b * d, next.a * tx + next.b * ty + next.tx,
+				next.c * a + next.d * c, next.c * b + next.d * d, next.c * tx + next.d * ty + next.ty};
+	}
+
+	constexpr Point Apply(const Point& point) const {
+		return {a * point.x + b * point.y + tx, c * point.x + d * point.y + ty};
+	}
+};
+
+// Rotates count points about center by angle radians in place. Working on
+// the offsets from center keeps the precision of figures far from the origin.
+void RotateAbout(Point* points, uint64_t count, const Point& center, double angle);
+
 class Figure {
 public:
 	virtual ~Figure() noexcept = default;
 public:
 	virtual Point GetGeometricCenter() const = 0;
+	// See OutlineContains().
+	virtual bool Contains(const Point& point) const = 0;
+	virtual void Transform(const AffineTransform& transform) = 0;
 public:
 	virtual explicit operator double() const = 0;
 };
 
-class Rhombus: public Figure {
+// Square root that can also run during constant evaluation, where it falls
+// back to Newton's iteration.
+constexpr double FigureSqrt(double value) {
+#if defined(__GNUC__) || defined(__clang__)
+	if (__builtin_is_constant_evaluated()) {
+		if (!(value > 0)) {
+			return value == 0 ? value : std::numeric_limits<double>::quiet_NaN();
+		}
+		if (value > std::numeric_limits<double>::max()) {
+			return value;
+		}
+
+		double root = value > 1 ? value : 1;
+		double previous = 0;
+		while (root != previous) {
+			previous = root;
+			root = (root + value / root) / 2;
+			if (root >= previous) {
+				return previous;
+			}
+		}
+
+		return root;
+	}
+#endif
+	return std::sqrt(value);
+}
+
+// N / 4 * cot(pi / N): the area of a regular N-gon with unit side. The
+// series are evaluated the same way at compile time and at run time, so the
+// batch kernels get exactly the coefficient the figures were built with.
+constexpr double RegularPolygonAreaCoefficient(uint64_t amountOfPoints) {
+	const double angle = 3.141592653589793 / static_cast<double>(amountOfPoints);
+
+	double sine = 0;
+	double cosine = 0;
+	double sineTerm = angle;
+	double cosineTerm = 1;
+	for (uint64_t i = 1; i <= 15; ++i) {
+		sine += sineTerm;
+		cosine += cosineTerm;
+		sineTerm *= -angle * angle / static_cast<double>((2 * i) * (2 * i + 1));
+		cosineTerm *= -angle * angle / static_cast<double>((2 * i - 1) * (2 * i));
+	}
+
+	return static_cast<double>(amountOfPoints) / 4.0 * cosine / sine;
+}
+
+// Absolute value that can also run during constant evaluation.
+constexpr double FigureAbs(double value) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_fabs(value);
+#else
+	return value < 0 ? -value : value;
+#endif
+}
+
+// Area enclosed by count points given in order around the outline: the
+// shoelace formula with every vertex taken relative to the first one, which
+// keeps the products small for figures far from the origin. It needs no
+// square root and is exact for any simple polygon.
+constexpr double ShoelaceArea(const Point* points, uint64_t count) {
+	double twiceArea = 0;
+	for (uint64_t i = 1; i + 1 < count; ++i) {
+		twiceArea += (points[i].x - points[0].x) * (points[i + 1].y - points[0].y) -
+					 (points[i + 1].x - points[0].x) * (points[i].y - points[0].y);
+	}
+
+	return FigureAbs(twiceArea) / 2;
+}
+
+// bounds widened by pointEpsilon on every side. OutlineContains() is false
+// for every point outside the widened bounding box of the outline.
+constexpr BoundingBox ContainmentBox(const BoundingBox& bounds) {
+	return {bounds.minX - pointEpsilon, bounds.minY - pointEpsilon, bounds.maxX + pointEpsilon, bounds.maxY + pointEpsilon};
+}
+
+// The edge tests of OutlineContains(), without the bounding box rejection.
+// Inside is decided by the even-odd rule on a ray towards +x, so the outline
+// may run in either direction and need not be convex. A point also counts
+// when it is closer than pointEpsilon to an edge, the tolerance under which
+// Point's comparison operators call two points equal.
+constexpr bool OutlineEdgesContain(const Point* points, uint64_t count, const Point& point) {
+	constexpr double squaredEpsilon = pointEpsilon * pointEpsilon;
+	bool inside = false;
+	bool onOutline = false;
+
+	for (uint64_t i = 0; i < count; ++i) {
+		const Point& first = points[i];
+		const Point& second = points[i + 1 == count ? 0 : i + 1];
+		double edgeX = second.x - first.x;
+		double edgeY = second.y - first.y;
+		double squaredLength = edgeX * edgeX + edgeY * edgeY;
+
+		double offsetX = point.x - first.x;
+		double offsetY = point.y - first.y;
+		double cross = edgeX * offsetY - edgeY * offsetX;
+		double dot = edgeX * offsetX + edgeY * offsetY;
+
+		bool straddles = (point.y < first.y) != (point.y < second.y);
+		bool crosses = edgeY > 0 ? 0 < cross : cross < 0;
+		inside = inside != (straddles && crosses);
+
+		// Past the second vertex the nearest point is that vertex, which the
+		// next edge tests as its first one.
+		bool nearVertex = offsetX * offsetX + offsetY * offsetY < squaredEpsilon;
+		bool nearEdge = dot < squaredLength && cross * cross < squaredEpsilon * squaredLength;
+		onOutline = onOutline || (dot <= 0 ? nearVertex : nearEdge);
+	}
+
+	return inside || onOutline;
+}
+
+// Whether point lies inside the outline of count points given in order, or
+// on it within pointEpsilon. The batch kernel ContainsPoints() gives the
+// same answer for every point.
+constexpr bool OutlineContains(const Point* points, uint64_t count, const Point& point) {
+	return ContainmentBox(OutlineBox(points, count)).Contains(point) && OutlineEdgesContain(points, count, point);
+}
+
+// Classic is the area operator double() has always returned; see
+// RegularPolygon. Shoelace is the area actually enclosed by the vertices,
+// which differs from Classic for irregular figures and is cheaper.
+enum class AreaMode {
+	Classic,
+	Shoelace
+};
+
+// Calls function(std::integral_constant<uint64_t, I>()) for I = 0 .. N - 1
+// with the loop unrolled at compile time.
+template <typename Function, uint64_t... Indices>
+constexpr void UnrolledForImpl(Function& function, std::integer_sequence<uint64_t, Indices...>) {
+	(function(std::integral_constant<uint64_t, Indices>()), ...);
+}
+
+template <uint64_t N, typename Function>
+constexpr void UnrolledFor(Function&& function) {
+	UnrolledForImpl(function, std::make_integer_sequence<uint64_t, N>());
+}
+
+template <uint64_t N>
+class RegularPolygon;
+
+template <uint64_t N>
+void swap(RegularPolygon<N>& firstPolygon, RegularPolygon<N>& secondPolygon) noexcept;
+
+template <uint64_t N>
+std::istream& operator>>(std::istream& istream, RegularPolygon<N>& polygon);
+template <uint64_t N>
+std::ostream& operator<<(std::ostream& ostream, const RegularPolygon<N>& polygon);
+
+// Figure with N vertices. The area is the one of a regular N-gon built on the
+// shortest side, except for N = 4, which is treated as a rhombus: twice the
+// triangle spanned by its first three vertices. ComputeGeometricCenter() and
+// ComputeArea() are constexpr and work on a bare point array; the members
+// forward to them.
+template <uint64_t N>
+class RegularPolygon: public Figure {
+	static_assert(N >= 3, "A polygon needs at least three points");
+public:
+	static constexpr uint64_t amountOfPoints = N;
+	static constexpr double areaCoefficient = RegularPolygonAreaCoefficient(N);
 public:
-	Rhombus();
-	Rhombus(const Rhombus& other);
-	Rhombus(Rhombus&& moved) noexcept;
+	RegularPolygon();
+	explicit RegularPolygon(const std::array<Point, N>& points);
+	RegularPolygon(const RegularPolygon& other);
+	RegularPolygon(RegularPolygon&& moved) noexcept;
 public:
 	Point GetGeometricCenter() const override;
+	const std::array<Point, N>& GetPoints() const;
+	BoundingBox GetBoundingBox() const;
+	double GetArea(AreaMode mode) const;
+	bool Contains(const Point& point) const override;
+
+	void Transform(const AffineTransform& transform) override;
+	void Translate(double dx, double dy);
+	// Scales about the origin.
+	void Scale(double sx, double sy);
+	// Rotates counterclockwise by angle radians about the geometric center.
+	void Rotate(double angle);
+
+	static constexpr Point ComputeGeometricCenter(const std::array<Point, N>& points);
+	static constexpr BoundingBox ComputeBoundingBox(const std::array<Point, N>& points);
+	static constexpr double ComputeArea(const std::array<Point, N>& points);
+	static constexpr double ComputeShoelaceArea(const std::array<Point, N>& points);
 public:
-	friend void swap(Rhombus& firstRhombus, Rhombus& secondRhombus) noexcept;
+	friend void swap<N>(RegularPolygon& firstPolygon, RegularPolygon& secondPolygon) noexcept;
 public:
-	Rhombus& operator=(const Rhombus& other);
-	Rhombus& operator=(Rhombus&& other) noexcept;
+	RegularPolygon& operator=(const RegularPolygon& other);
+	RegularPolygon& operator=(RegularPolygon&& other) noexcept;
 
-	bool operator==(const Rhombus& other) const;
+	bool operator==(const RegularPolygon& other) const;
 
-	friend std::istream& operator>>(std::istream& istream, Rhombus& rhombus);
-	friend std::ostream& operator<<(std::ostream& ostream, const Rhombus& rhombus);
+	friend std::istream& operator>> <N>(std::istream& istream, RegularPolygon& polygon);
+	friend std::ostream& operator<< <N>(std::ostream& ostream, const RegularPolygon& polygon);
 
 	explicit operator double() const override;
 private:
-	static constexpr uint64_t _amountOfPoints = 4;
-	std::array<Point, _amountOfPoints> _points;
+	static constexpr double SideLength(const Point& first, const Point& second);
+private:
+	std::array<Point, N> _points;
 };
 
-void swap(Rhombus& firstRhombus, Rhombus& secondRhombus) noexcept;
-
-std::istream& operator>>(std::istream& istream, Rhombus& rhombus);
-std::ostream& operator<<(std::ostream& ostream, const Rhombus& rhombus);
-
-class Pentagon: public Figure {
-	public:
-		Pentagon();
-		Pentagon(const Pentagon& other);
-		Pentagon(Pentagon&& moved) noexcept;
-	public:
-		Point GetGeometricCenter() const override;
-	public:
-		friend void swap(Pentagon& firstPentagon, Pentagon& secondPentagon) noexcept;
-	public:
-		Pentagon& operator=(const Pentagon& other);
-		Pentagon& operator=(Pentagon&& other) noexcept;
-	
-		bool operator==(const Pentagon& other) const;
-	
-		friend std::istream& operator>>(std::istream& istream, Pentagon& pentagon);
-		friend std::ostream& operator<<(std::ostream& ostream, const Pentagon& pentagon);
-	
-		explicit operator double() const override;
-	private:
-		static constexpr uint64_t _amountOfPoints = 5;
-		std::array<Point, _amountOfPoints> _points;
-	};
-	
-void swap(Pentagon& firstPentagon, Pentagon& secondPentagon) noexcept;
-
-std::istream& operator>>(std::istream& istream, Pentagon& pentagon);
-std::ostream& operator<<(std::ostream& ostream, const Pentagon& pentagon);
-
-class Hexagon: public Figure {
-	public:
-		Hexagon();
-		Hexagon(const Hexagon& other);
-		Hexagon(Hexagon&& moved) noexcept;
-	public:
-		Point GetGeometricCenter() const override;
-	public:
-		friend void swap(Hexagon& firstHexagon, Hexagon& secondHexagon) noexcept;
-	public:
-		Hexagon& operator=(const Hexagon& other);
-		Hexagon& operator=(Hexagon&& other) noexcept;
-	
-		bool operator==(const Hexagon& other) const;
-	
-		friend std::istream& operator>>(std::istream& istream, Hexagon& hexagon);
-		friend std::ostream& operator<<(std::ostream& ostream, const Hexagon& hexagon);
-	
-		explicit operator double() const override;
-	private:
-		static constexpr uint64_t _amountOfPoints = 6;
-		std::array<Point, _amountOfPoints> _points;
-	};
-	
-void swap(Hexagon& firstHexagon, Hexagon& secondHexagon) noexcept;
-
-std::istream& operator>>(std::istream& istream, Hexagon& hexagon);
-std::ostream& operator<<(std::ostream& ostream, const Hexagon& hexagon);
+using Triangle = RegularPolygon<3>;
+using Rhombus = RegularPolygon<4>;
+using Pentagon = RegularPolygon<5>;
+using Hexagon = RegularPolygon<6>;
+using Octagon = RegularPolygon<8>;
+
+template <uint64_t N>
+RegularPolygon<N>::RegularPolygon() : _points() {}
+
+template <uint64_t N>
+RegularPolygon<N>::RegularPolygon(const std::array<Point, N>& points) : _points(points) {}
+
+template <uint64_t N>
+RegularPolygon<N>::RegularPolygon(const RegularPolygon& other) : Figure(), _points(other._points) {
+	FIGURES_COUNT(Copies);
+}
+
+template <uint64_t N>
+RegularPolygon<N>::RegularPolygon(RegularPolygon&& moved) noexcept : Figure(), _points(moved._points) {
+	FIGURES_COUNT(Moves);
+}
+
+template <uint64_t N>
+Point RegularPolygon<N>::GetGeometricCenter() const {
+	FIGURES_COUNT(CenterComputations);
+	return ComputeGeometricCenter(_points);
+}
+
+template <uint64_t N>
+const std::array<Point, N>& RegularPolygon<N>::GetPoints() const {
+	return _points;
+}
+
+template <uint64_t N>
+BoundingBox RegularPolygon<N>::GetBoundingBox() const {
+	return ComputeBoundingBox(_points);
+}
+
+template <uint64_t N>
+double RegularPolygon<N>::GetArea(AreaMode mode) const {
+	FIGURES_COUNT(AreaComputations);
+	return mode == AreaMode::Shoelace ? ComputeShoelaceArea(_points) : ComputeArea(_points);
+}
+
+template <uint64_t N>
+bool RegularPolygon<N>::Contains(const Point& point) const {
+	return ContainmentBox(ComputeBoundingBox(_points)).Contains(point) && OutlineEdgesContain(_points.data(), N, point);
+}
+
+template <uint64_t N>
+void RegularPolygon<N>::Transform(const AffineTransform& transform) {
+	for (Point& point : _points) {
+		point = transform.Apply(point);
+	}
+}
+
+template <uint64_t N>
+void RegularPolygon<N>::Translate(double dx, double dy) {
+	Transform(AffineTransform::Translation(dx, dy));
+}
+
+template <uint64_t N>
+void RegularPolygon<N>::Scale(double sx, double sy) {
+	Transform(AffineTransform::Scaling(sx, sy));
+}
+
+template <uint64_t N>
+void RegularPolygon<N>::Rotate(double angle) {
+	RotateAbout(_points.data(), N, ComputeGeometricCenter(_points), angle);
+}
+
+template <uint64_t N>
+constexpr Point RegularPolygon<N>::ComputeGeometricCenter(const std::array<Point, N>& points) {
+	double xCenterCoord = 0;
+	double yCenterCoord = 0;
+
+	UnrolledFor<N>([&](auto i) {
+		xCenterCoord += points[i].x;
+		yCenterCoord += points[i].y;
+	});
+
+	return {xCenterCoord / static_cast<double>(N), yCenterCoord / static_cast<double>(N)};
+}
+
+template <uint64_t N>
+constexpr BoundingBox RegularPolygon<N>::ComputeBoundingBox(const std::array<Point, N>& points) {
+	BoundingBox box;
+
+	UnrolledFor<N>([&](auto i) {
+		box.Expand(points[i]);
+	});
+
+	return box;
+}
+
+template <uint64_t N>
+constexpr double RegularPolygon<N>::ComputeArea(const std::array<Point, N>& points) {
+	if constexpr (N == 4) {
+		double firstSide = SideLength(points[0], points[1]);
+		double secondSide = SideLength(points[0], points[2]);
+		double thirdSide = SideLength(points[2], points[1]);
+
+		double halfOfPerimeter = (firstSide + secondSide + thirdSide) / 2.0;
+
+		return 2.0 * FigureSqrt(halfOfPerimeter * (halfOfPerimeter - firstSide) *
+								(halfOfPerimeter - secondSide) * (halfOfPerimeter - thirdSide));
+	} else {
+		double minSide = SideLength(points[0], points[N - 1]);
+
+		UnrolledFor<N - 1>([&](auto i) {
+			double temp = SideLength(points[i], points[i + 1]);
+			if (temp < minSide) {
+				minSide = temp;
+			}
+		});
+
+		if (minSide <= 0) {
+			return 0;
+		}
+
+		return areaCoefficient * minSide * minSide;
+	}
+}
+
+template <uint64_t N>
+constexpr double RegularPolygon<N>::ComputeShoelaceArea(const std::array<Point, N>& points) {
+	return ShoelaceArea(points.data(), N);
+}
+
+template <uint64_t N>
+constexpr double RegularPolygon<N>::SideLength(const Point& first, const Point& second) {
+	return FigureSqrt((first.x - second.x) * (first.x - second.x) + (first.y - second.y) * (first.y - second.y));
+}
+
+template <uint64_t N>
+void swap(RegularPolygon<N>& firstPolygon, RegularPolygon<N>& secondPolygon) noexcept {
+	std::swap(firstPolygon._points, secondPolygon._points);
+}
+
+template <uint64_t N>
+RegularPolygon<N>& RegularPolygon<N>::operator=(const RegularPolygon& other) {
+	if (this != &other) {
+		RegularPolygon copy(other);
+		swap(*this, copy);
+	}
+
+	return *this;
+}
+
+template <uint64_t N>
+RegularPolygon<N>& RegularPolygon<N>::operator=(RegularPolygon&& other) noexcept {
+	if (this != &other) {
+		RegularPolygon moved(std::move(other));
+		swap(*this, moved);
+	}
+
+	return *this;
+}
+
+template <uint64_t N>
+bool RegularPolygon<N>::operator==(const RegularPolygon& other) const {
+	FIGURES_COUNT(Comparisons);
+	std::array<Point, N> lhsCopy = _points;
+	std::array<Point, N> rhsCopy = other._points;
+
+	std::sort(lhsCopy.begin(), lhsCopy.end());
+	std::sort(rhsCopy.begin(), rhsCopy.end());
+
+	return lhsCopy == rhsCopy;
+}
+
+template <uint64_t N>
+std::istream& operator>>(std::istream& istream, RegularPolygon<N>& polygon) {
+	for (uint64_t i = 0; i < N; ++i) {
+		if (!(istream >> polygon._points[i])) {
+			throw std::invalid_argument("Incorrect type provided");
+		}
+	}
+
+	return istream;
+}
+
+template <uint64_t N>
+std::ostream& operator<<(std::ostream& ostream, const RegularPolygon<N>& polygon) {
+	for (uint64_t i = 0; i < N - 1; ++i) {
+		ostream << polygon._points[i] << ' ';
+	}
+	ostream << polygon._points[N - 1];
+
+	return ostream;
+}
+
+template <uint64_t N>
+RegularPolygon<N>::operator double() const {
+	FIGURES_COUNT(AreaComputations);
+	return ComputeArea(_points);
+}
+
+extern template class RegularPolygon<4>;
+extern template class RegularPolygon<5>;
+extern template class RegularPolygon<6>;
 
 #endif
\ No newline at end of file
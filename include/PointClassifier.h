@@ -0,0 +1,111 @@
+#ifndef POINT_CLASSIFIER_H
+#define POINT_CLASSIFIER_H
+
+#include "Figures.h"
+#include "AnyFigure.h"
+#include "FigureBatch.h"
+#include "Polygon.h"
+#include "ThreadPool.h"
+#include <array>
+#include <cinttypes>
+#include <limits>
+#include <vector>
+
+// Classification result of a point that no figure contains.
+constexpr uint64_t noFigure = std::numeric_limits<uint64_t>::max();
+
+// Vertices of many figures in one array: figure i owns the vertices
+// [offsets[i], offsets[i + 1]), given in order around its outline.
+class FigureOutlines {
+public:
+	FigureOutlines();
+public:
+	void Reserve(uint64_t figureCount, uint64_t vertexCount);
+	void PushBack(const Point* points, uint64_t amountOfPoints);
+
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+
+	const Point* GetPoints(uint64_t figureIndex) const;
+	uint64_t GetAmountOfPoints(uint64_t figureIndex) const;
+private:
+	std::vector<Point> _vertices;
+	std::vector<uint64_t> _offsets;
+};
+
+// Outlines in the order of the source collection, which for a FigureArray
+// is its kind-then-insertion order.
+template <uint64_t N>
+FigureOutlines MakeFigureOutlines(const FigureBatch<N>& batch);
+FigureOutlines MakeFigureOutlines(const FigureArray& figures);
+FigureOutlines MakeFigureOutlines(const std::vector<Polygon>& figures);
+
+// Point cloud prepared for hit-testing against many figures. The points are
+// sorted into horizontal rows and by x within a row, so the points in the
+// bounding box of a figure are one contiguous run per row the box spans.
+// Each run goes through the ContainsPoints() kernel, which rejects whole
+// vectors of points by the box before testing any edge, so the cost of a
+// figure follows the number of points near it rather than the cloud size.
+//
+// Points with a NaN coordinate are contained by no figure. Classification on
+// a ThreadPool gives exactly the sequential result.
+class PointClassifier {
+public:
+	static constexpr uint64_t minPointsPerRow = 16;
+public:
+	// Rows are about rowHeight high, but never hold fewer than
+	// minPointsPerRow points on average; rowHeight 0 asks for the most rows.
+	// The height of a typical figure is a good choice.
+	PointClassifier(const Point* points, uint64_t count, double rowHeight = 0);
+public:
+	uint64_t Size() const noexcept;
+	uint64_t GetRowCount() const noexcept;
+
+	// out[i] receives the index of the first figure containing point i, by
+	// OutlineContains(), or noFigure. out holds Size() entries.
+	void Classify(const FigureOutlines& figures, uint64_t* out) const;
+	void Classify(const FigureOutlines& figures, uint64_t* out, ThreadPool& pool) const;
+private:
+	uint64_t RowOf(double y) const;
+	void Classify(const FigureOutlines& figures, uint64_t* out, ThreadPool* pool) const;
+private:
+	// Points in row order; _indices maps them back to the caller's order.
+	std::vector<double> _xs;
+	std::vector<double> _ys;
+	std::vector<uint64_t> _indices;
+	// Row r holds the points [_rowOffsets[r], _rowOffsets[r + 1]).
+	std::vector<uint64_t> _rowOffsets;
+	uint64_t _size;
+	double _minY;
+	double _rowHeight;
+};
+
+// One-shot classification with rows as high as the average figure.
+std::vector<uint64_t> Classify(const Point* points, uint64_t count, const FigureOutlines& figures);
+std::vector<uint64_t> Classify(const Point* points, uint64_t count, const FigureOutlines& figures, ThreadPool& pool);
+template <uint64_t N>
+std::vector<uint64_t> Classify(const Point* points, uint64_t count, const FigureBatch<N>& figures);
+std::vector<uint64_t> Classify(const Point* points, uint64_t count, const FigureArray& figures);
+
+template <uint64_t N>
+FigureOutlines MakeFigureOutlines(const FigureBatch<N>& batch) {
+	FigureOutlines outlines;
+	outlines.Reserve(batch.Size(), batch.Size() * N);
+
+	std::array<Point, N> points;
+	for (uint64_t i = 0; i < batch.Size(); ++i) {
+		for (uint64_t j = 0; j < N; ++j) {
+			points[j] = Point(batch.GetXs(j)[i], batch.GetYs(j)[i]);
+		}
+		outlines.PushBack(points.data(), N);
+	}
+
+	return outlines;
+}
+
+template <uint64_t N>
+std::vector<uint64_t> Classify(const Point* points, uint64_t count, const FigureBatch<N>& figures) {
+	return Classify(points, count, MakeFigureOutlines(figures));
+}
+
+#endif
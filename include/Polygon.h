@@ -0,0 +1,56 @@
+#ifndef POLYGON_H
+#define POLYGON_H
+
+#include "Figures.h"
+#include <cinttypes>
+#include <iostream>
+#include <vector>
+
+// Figure with a vertex count chosen at run time, at least three, given in
+// order around the outline. Its area is the shoelace area, computed by the
+// same code as AreaMode::Shoelace of the fixed-size figures, so it is right
+// for irregular input as well.
+class Polygon: public Figure {
+public:
+	explicit Polygon(uint64_t amountOfPoints = 3);
+	explicit Polygon(std::vector<Point> points);
+	template <uint64_t N>
+	explicit Polygon(const RegularPolygon<N>& polygon);
+	Polygon(const Polygon& other);
+	Polygon(Polygon&& moved) noexcept;
+public:
+	Point GetGeometricCenter() const override;
+	BoundingBox GetBoundingBox() const;
+	bool Contains(const Point& point) const override;
+
+	void Transform(const AffineTransform& transform) override;
+	void Translate(double dx, double dy);
+	// Scales about the origin.
+	void Scale(double sx, double sy);
+	// Rotates counterclockwise by angle radians about the geometric center.
+	void Rotate(double angle);
+
+	uint64_t GetAmountOfPoints() const noexcept;
+	const std::vector<Point>& GetPoints() const noexcept;
+public:
+	friend void swap(Polygon& firstPolygon, Polygon& secondPolygon) noexcept;
+public:
+	Polygon& operator=(const Polygon& other);
+	Polygon& operator=(Polygon&& other) noexcept;
+
+	// Same vertices in any order, like RegularPolygon::operator==.
+	bool operator==(const Polygon& other) const;
+
+	// Reads GetAmountOfPoints() points.
+	friend std::istream& operator>>(std::istream& istream, Polygon& polygon);
+	friend std::ostream& operator<<(std::ostream& ostream, const Polygon& polygon);
+
+	explicit operator double() const override;
+private:
+	std::vector<Point> _points;
+};
+
+template <uint64_t N>
+Polygon::Polygon(const RegularPolygon<N>& polygon) : _points(polygon.GetPoints().begin(), polygon.GetPoints().end()) {}
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "Figures.h"
+#include "AnyFigure.h"
+#include "FigureBatch.h"
+#include "ThreadPool.h"
+#include <cinttypes>
+#include <utility>
+#include <vector>
+
+// Bounding box and centroid of one indexed figure. id is what the caller
+// uses to find the figure again, usually its index in the source collection.
+struct SpatialEntry {
+	BoundingBox box;
+	Point centroid;
+	uint64_t id;
+};
+
+// Ids of two entries whose boxes intersect, first < second.
+using SpatialPair = std::pair<uint64_t, uint64_t>;
+
+template <uint64_t N>
+SpatialEntry MakeSpatialEntry(const RegularPolygon<N>& figure, uint64_t id);
+
+// Entries with ids equal to the figure indexes.
+template <uint64_t N>
+std::vector<SpatialEntry> MakeSpatialEntries(const std::vector<RegularPolygon<N>>& figures);
+template <uint64_t N>
+std::vector<SpatialEntry> MakeSpatialEntries(const FigureBatch<N>& batch);
+std::vector<SpatialEntry> MakeSpatialEntries(const FigureArray& figures);
+
+// R-tree bulk loaded with Sort-Tile-Recursive packing: every node but the
+// last of a level is full and siblings cover compact tiles, which keeps
+// queries close to logarithmic for any distribution and figure size. The
+// tree is immutable; rebuild it when the figures change.
+//
+// Construction on a ThreadPool produces exactly the same tree as the
+// sequential one. Queries are const and may run concurrently.
+class RTree {
+public:
+	static constexpr uint64_t defaultNodeCapacity = 16;
+public:
+	RTree();
+	explicit RTree(std::vector<SpatialEntry> entries, uint64_t nodeCapacity = defaultNodeCapacity);
+	RTree(std::vector<SpatialEntry> entries, ThreadPool& pool, uint64_t nodeCapacity = defaultNodeCapacity);
+public:
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+	uint64_t GetHeight() const noexcept;
+	BoundingBox GetBounds() const noexcept;
+
+	// Ids of the entries whose box intersects window, appended to out in no
+	// particular order.
+	void Query(const BoundingBox& window, std::vector<uint64_t>& out) const;
+	std::vector<uint64_t> Query(const BoundingBox& window) const;
+
+	// Ids of the k entries whose centroid is closest to point, nearest first;
+	// equally distant entries come in id order.
+	std::vector<uint64_t> Nearest(const Point& point, uint64_t k) const;
+
+	// Every pair of entries whose boxes intersect, sorted. These are only
+	// candidates: the figures themselves may still be disjoint.
+	std::vector<SpatialPair> OverlapPairs() const;
+	std::vector<SpatialPair> OverlapPairs(ThreadPool& pool) const;
+private:
+	struct Node {
+		BoundingBox box;
+		uint64_t first;
+		uint64_t count;
+	};
+private:
+	void Build(ThreadPool* pool);
+	template <typename Function>
+	void ForEachIntersecting(const BoundingBox& window, Function&& function) const;
+	void CollectPairs(uint64_t begin, uint64_t end, std::vector<SpatialPair>& pairs) const;
+private:
+	std::vector<SpatialEntry> _entries;
+	// Levels from the leaves up, the root last. Leaves point into _entries,
+	// the other nodes into _nodes.
+	std::vector<Node> _nodes;
+	uint64_t _leafCount;
+	uint64_t _height;
+	uint64_t _nodeCapacity;
+};
+
+// Uniform grid over the centroids, stored as one array sorted by cell. It is
+// cheaper to build than the R-tree and faster on dense data with figures of
+// similar size; a few large figures slow every query down, since windows
+// are widened by the largest distance from a centroid to its box edge.
+class UniformGrid {
+public:
+	UniformGrid();
+	// cellSize 0 picks a size that puts about two figures in a cell.
+	explicit UniformGrid(std::vector<SpatialEntry> entries, double cellSize = 0);
+	UniformGrid(std::vector<SpatialEntry> entries, ThreadPool& pool, double cellSize = 0);
+public:
+	uint64_t Size() const noexcept;
+	bool Empty() const noexcept;
+	double GetCellSize() const noexcept;
+	uint64_t GetColumnCount() const noexcept;
+	uint64_t GetRowCount() const noexcept;
+
+	// Same results as the RTree queries.
+	void Query(const BoundingBox& window, std::vector<uint64_t>& out) const;
+	std::vector<uint64_t> Query(const BoundingBox& window) const;
+	std::vector<uint64_t> Nearest(const Point& point, uint64_t k) const;
+	std::vector<SpatialPair> OverlapPairs() const;
+	std::vector<SpatialPair> OverlapPairs(ThreadPool& pool) const;
+private:
+	void Build(ThreadPool* pool, double cellSize);
+	uint64_t GetColumn(double x) const;
+	uint64_t GetRow(double y) const;
+	template <typename Function>
+	void ForEachIntersecting(const BoundingBox& window, Function&& function) const;
+	void CollectPairs(uint64_t begin, uint64_t end, std::vector<SpatialPair>& pairs) const;
+private:
+	std::vector<SpatialEntry> _entries;
+	std::vector<uint64_t> _cellStarts;
+	BoundingBox _centroidBounds;
+	double _cellSize;
+	double _reach;
+	uint64_t _columns;
+	uint64_t _rows;
+};
+
+template <uint64_t N>
+SpatialEntry MakeSpatialEntry(const RegularPolygon<N>& figure, uint64_t id) {
+	return {figure.GetBoundingBox(), figure.GetGeometricCenter(), id};
+}
+
+template <uint64_t N>
+std::vector<SpatialEntry> MakeSpatialEntries(const std::vector<RegularPolygon<N>>& figures) {
+	std::vector<SpatialEntry> entries;
+	entries.reserve(figures.size());
+	for (uint64_t i = 0; i < figures.size(); ++i) {
+		entries.push_back(MakeSpatialEntry(figures[i], i));
+	}
+
+	return entries;
+}
+
+template <uint64_t N>
+std::vector<SpatialEntry> MakeSpatialEntries(const FigureBatch<N>& batch) {
+	const std::vector<Point> centers = batch.GeometricCenters();
+
+	std::vector<SpatialEntry> entries(batch.Size());
+	for (uint64_t i = 0; i < entries.size(); ++i) {
+		entries[i].centroid = centers[i];
+		entries[i].id = i;
+	}
+	for (uint64_t j = 0; j < N; ++j) {
+		const double* xs = batch.GetXs(j);
+		const double* ys = batch.GetYs(j);
+		for (uint64_t i = 0; i < entries.size(); ++i) {
+			entries[i].box.Expand(Point(xs[i], ys[i]));
+		}
+	}
+
+	return entries;
+}
+
+#endif
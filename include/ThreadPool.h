@@ -0,0 +1,57 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cinttypes>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run chunked loops. Each call to
+// ParallelFor splits the range into equally sized chunks, deals contiguous
+// runs of chunks to the workers and lets idle workers steal chunks from the
+// others, so uneven chunks still keep every thread busy. The calling thread
+// takes part in the work.
+class ThreadPool {
+public:
+	using ChunkTask = std::function<void(uint64_t chunkIndex, uint64_t begin, uint64_t end)>;
+public:
+	// threadCount counts the calling thread; 0 means one per hardware thread.
+	explicit ThreadPool(uint64_t threadCount = 0);
+	ThreadPool(const ThreadPool& other) = delete;
+	~ThreadPool() noexcept;
+public:
+	ThreadPool& operator=(const ThreadPool& other) = delete;
+public:
+	uint64_t GetThreadCount() const noexcept;
+
+	static uint64_t GetChunkCount(uint64_t count, uint64_t chunkSize);
+
+	// Calls task once for every chunk [begin, end) of [0, count) and returns
+	// when all chunks are done. The chunk boundaries depend only on count and
+	// chunkSize, never on the number of threads. The first exception thrown
+	// by a task is rethrown here. A ParallelFor issued from inside a task runs
+	// on the calling thread only.
+	void ParallelFor(uint64_t count, uint64_t chunkSize, const ChunkTask& task);
+	// pool->ParallelFor(), or the same chunks in order on the calling thread
+	// if pool is null.
+	static void RunChunks(ThreadPool* pool, uint64_t count, uint64_t chunkSize, const ChunkTask& task);
+private:
+	struct Job;
+private:
+	void WorkerLoop(uint64_t index);
+	static void RunJob(Job& job, uint64_t index);
+private:
+	std::vector<std::thread> _workers;
+	std::mutex _submitMutex;
+	std::mutex _mutex;
+	std::condition_variable _wakeUp;
+	std::condition_variable _finished;
+	Job* _job;
+	uint64_t _generation;
+	uint64_t _activeWorkers;
+	bool _stopping;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "AnyFigure.h"
+#include <stdexcept>
+
+namespace {
+
+template <typename T>
+double Area(const T& figure) {
+	return figure.T::operator double();
+}
+
+template <typename T>
+Point GeometricCenter(const T& figure) {
+	return figure.T::GetGeometricCenter();
+}
+
+template <typename T>
+bool ContainsPoint(const T& figure, const Point& point) {
+	return figure.T::Contains(point);
+}
+
+}
+
+AnyFigure::AnyFigure() : _figure(Rhombus()) {}
+
+AnyFigure::AnyFigure(const Rhombus& rhombus) : _figure(rhombus) {}
+
+AnyFigure::AnyFigure(const Pentagon& pentagon) : _figure(pentagon) {}
+
+AnyFigure::AnyFigure(const Hexagon& hexagon) : _figure(hexagon) {}
+
+Point AnyFigure::GetGeometricCenter() const {
+	return Visit([](const auto& figure) { return GeometricCenter(figure); });
+}
+
+bool AnyFigure::Contains(const Point& point) const {
+	return Visit([&point](const auto& figure) { return ContainsPoint(figure, point); });
+}
+
+uint64_t AnyFigure::GetAmountOfPoints() const noexcept {
+	return Visit([](const auto& figure) -> uint64_t { return figure.GetPoints().size(); });
+}
+
+const Figure& AnyFigure::AsFigure() const noexcept {
+	return Visit([](const auto& figure) -> const Figure& { return figure; });
+}
+
+bool AnyFigure::operator==(const AnyFigure& other) const {
+	if (_figure.index() != other._figure.index()) {
+		return false;
+	}
+
+	return Visit([&other](const auto& figure) {
+		using T = std::decay_t<decltype(figure)>;
+		return figure == *other.Get<T>();
+	});
+}
+
+bool AnyFigure::operator!=(const AnyFigure& other) const {
+	return !(*this == other);
+}
+
+std::ostream& operator<<(std::ostream& ostream, const AnyFigure& figure) {
+	return figure.Visit([&ostream](const auto& concrete) -> std::ostream& { return ostream << concrete; });
+}
+
+AnyFigure::operator double() const {
+	return Visit([](const auto& figure) { return Area(figure); });
+}
+
+void FigureArray::PushBack(const AnyFigure& figure) {
+	figure.Visit([this](const auto& concrete) { PushBack(concrete); });
+}
+
+void FigureArray::PushBack(const Rhombus& rhombus) {
+	_rhombuses.push_back(rhombus);
+}
+
+void FigureArray::PushBack(const Pentagon& pentagon) {
+	_pentagons.push_back(pentagon);
+}
+
+void FigureArray::PushBack(const Hexagon& hexagon) {
+	_hexagons.push_back(hexagon);
+}
+
+void FigureArray::Clear() noexcept {
+	_rhombuses.clear();
+	_pentagons.clear();
+	_hexagons.clear();
+}
+
+uint64_t FigureArray::Size() const noexcept {
+	return _rhombuses.size() + _pentagons.size() + _hexagons.size();
+}
+
+bool FigureArray::Empty() const noexcept {
+	return Size() == 0;
+}
+
+AnyFigure FigureArray::operator[](uint64_t index) const {
+	if (index < _rhombuses.size()) {
+		return _rhombuses[index];
+	}
+	index -= _rhombuses.size();
+	if (index < _pentagons.size()) {
+		return _pentagons[index];
+	}
+	index -= _pentagons.size();
+	if (index < _hexagons.size()) {
+		return _hexagons[index];
+	}
+
+	throw std::out_of_range("Index out of range");
+}
+
+const std::vector<Rhombus>& FigureArray::GetRhombuses() const noexcept {
+	return _rhombuses;
+}
+
+const std::vector<Pentagon>& FigureArray::GetPentagons() const noexcept {
+	return _pentagons;
+}
+
+const std::vector<Hexagon>& FigureArray::GetHexagons() const noexcept {
+	return _hexagons;
+}
+
+std::vector<double> FigureArray::Areas() const {
+	std::vector<double> areas;
+	areas.reserve(Size());
+	ForEach([&areas](const auto& figure) { areas.push_back(Area(figure)); });
+
+	return areas;
+}
+
+std::vector<Point> FigureArray::GeometricCenters() const {
+	std::vector<Point> centers;
+	centers.reserve(Size());
+	ForEach([&centers](const auto& figure) { centers.push_back(GeometricCenter(figure)); });
+
+	return centers;
+}
+
+double FigureArray::TotalArea() const {
+	double total = 0;
+	ForEach([&total](const auto& figure) { total += Area(figure); });
+
+	return total;
+}
+
+void FigureArray::Transform(const AffineTransform& transform) {
+	for (Rhombus& rhombus : _rhombuses) {
+		rhombus.Rhombus::Transform(transform);
+	}
+	for (Pentagon& pentagon : _pentagons) {
+		pentagon.Pentagon::Transform(transform);
+	}
+	for (Hexagon& hexagon : _hexagons) {
+		hexagon.Hexagon::Transform(transform);
+	}
+}
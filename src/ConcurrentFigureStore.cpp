@@ -0,0 +1,383 @@
+#include "ConcurrentFigureStore.h"
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t maxShardBits = 10;
+// Slot segment k holds firstSegmentSize << k slots, so a shard grows without
+// ever moving a slot a reader may be looking at.
+constexpr uint64_t firstSegmentBits = 10;
+constexpr uint64_t firstSegmentSize = uint64_t(1) << firstSegmentBits;
+constexpr uint64_t maxSegments = 64 - firstSegmentBits - maxShardBits;
+// Retired figures a shard collects after.
+constexpr uint64_t collectThreshold = 64;
+
+using Slot = std::atomic<const StoredFigure*>;
+
+struct SlotPosition {
+	uint64_t segment;
+	uint64_t offset;
+};
+
+uint64_t GetBitLength(uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return value == 0 ? 0 : 64 - static_cast<uint64_t>(__builtin_clzll(value));
+#else
+	uint64_t length = 0;
+	for (; value != 0; value >>= 1) {
+		++length;
+	}
+	return length;
+#endif
+}
+
+SlotPosition GetSlotPosition(uint64_t index) noexcept {
+	const uint64_t shifted = index + firstSegmentSize;
+	const uint64_t segment = GetBitLength(shifted) - 1 - firstSegmentBits;
+
+	return {segment, shifted - (firstSegmentSize << segment)};
+}
+
+StoredFigure* MakeStoredFigure(const AnyFigure& figure) {
+	return new StoredFigure{figure, static_cast<double>(figure), figure.GetGeometricCenter()};
+}
+
+// Threads are dealt shards round-robin on their first insert into any store.
+uint64_t GetThreadShardSeed() {
+	static std::atomic<uint64_t> nextSeed(0);
+	thread_local const uint64_t seed = nextSeed.fetch_add(1, std::memory_order_relaxed);
+
+	return seed;
+}
+
+}
+
+// Entered participants publish (epoch << 1) | 1, the others 0. Padded so that
+// readers on different cores do not share a cache line.
+struct alignas(64) EpochDomain::Participant {
+	std::atomic<uint64_t> state{0};
+	std::atomic<bool> claimed{true};
+	Participant* next = nullptr;
+	// Only touched by the thread that claimed the participant.
+	uint64_t nesting = 0;
+};
+
+EpochDomain::EpochDomain() : _epoch(0), _participants(nullptr) {}
+
+EpochDomain::~EpochDomain() noexcept {
+	Participant* participant = _participants.load(std::memory_order_acquire);
+	while (participant != nullptr) {
+		Participant* next = participant->next;
+		delete participant;
+		participant = next;
+	}
+}
+
+EpochDomain::Participant* EpochDomain::Join() {
+	for (Participant* participant = _participants.load(std::memory_order_acquire); participant != nullptr;
+		 participant = participant->next) {
+		bool claimed = false;
+		if (!participant->claimed.load(std::memory_order_relaxed) &&
+			participant->claimed.compare_exchange_strong(claimed, true, std::memory_order_acquire)) {
+			return participant;
+		}
+	}
+
+	Participant* participant = new Participant();
+	participant->next = _participants.load(std::memory_order_relaxed);
+	while (!_participants.compare_exchange_weak(participant->next, participant, std::memory_order_release,
+												std::memory_order_relaxed)) {
+	}
+
+	return participant;
+}
+
+void EpochDomain::Leave(Participant* participant) noexcept {
+	participant->nesting = 0;
+	participant->state.store(0, std::memory_order_release);
+	participant->claimed.store(false, std::memory_order_release);
+}
+
+// Entering, advancing and the loads and exchanges of the pointers the domain
+// protects are sequentially consistent: a reader's state is then ordered
+// before the pointer it loads, and a writer's unlink before the epoch it
+// retires the object in. Exiting only has to be seen after the reads it
+// ends, so a release store, a plain store on x86, is enough.
+void EpochDomain::Enter(Participant* participant) noexcept {
+	if (participant->nesting++ != 0) {
+		return;
+	}
+
+	const uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+	participant->state.store((epoch << 1) | 1, std::memory_order_seq_cst);
+}
+
+void EpochDomain::Exit(Participant* participant) noexcept {
+	if (--participant->nesting != 0) {
+		return;
+	}
+
+	participant->state.store(0, std::memory_order_release);
+}
+
+uint64_t EpochDomain::GetEpoch() const noexcept {
+	return _epoch.load(std::memory_order_seq_cst);
+}
+
+uint64_t EpochDomain::TryAdvance() noexcept {
+	uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+	for (Participant* participant = _participants.load(std::memory_order_acquire); participant != nullptr;
+		 participant = participant->next) {
+		const uint64_t state = participant->state.load(std::memory_order_seq_cst);
+		if ((state & 1) != 0 && (state >> 1) != epoch) {
+			return epoch;
+		}
+	}
+
+	if (_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst)) {
+		return epoch + 1;
+	}
+
+	return epoch;
+}
+
+bool EpochDomain::IsReclaimable(uint64_t retireEpoch, uint64_t currentEpoch) noexcept {
+	return currentEpoch >= retireEpoch + 2;
+}
+
+struct RetiredFigure {
+	const StoredFigure* figure;
+	uint64_t epoch;
+};
+
+struct alignas(64) ConcurrentFigureStore::Shard {
+	// Held by writers only.
+	std::mutex mutex;
+	// Slots handed out; a reader never looks past it.
+	std::atomic<uint64_t> slotCount{0};
+	std::array<std::atomic<Slot*>, maxSegments> segments{};
+	// Guarded by mutex.
+	std::vector<RetiredFigure> retired;
+};
+
+ConcurrentFigureStore::Reader::Reader(const ConcurrentFigureStore& store) :
+	_store(&store), _participant(store._domain.Join()) {}
+
+ConcurrentFigureStore::Reader::~Reader() noexcept {
+	_store->_domain.Leave(_participant);
+}
+
+std::optional<AnyFigure> ConcurrentFigureStore::Reader::Get(uint64_t id) {
+	std::optional<AnyFigure> result;
+	Visit(id, [&result](const StoredFigure& figure) { result = figure.figure; });
+
+	return result;
+}
+
+std::optional<double> ConcurrentFigureStore::Reader::GetArea(uint64_t id) {
+	std::optional<double> result;
+	Visit(id, [&result](const StoredFigure& figure) { result = figure.area; });
+
+	return result;
+}
+
+std::optional<Point> ConcurrentFigureStore::Reader::GetCenter(uint64_t id) {
+	std::optional<Point> result;
+	Visit(id, [&result](const StoredFigure& figure) { result = figure.center; });
+
+	return result;
+}
+
+bool ConcurrentFigureStore::Reader::Contains(uint64_t id) {
+	return Visit(id, [](const StoredFigure&) {});
+}
+
+void ConcurrentFigureStore::Reader::ForEach(
+	const std::function<void(uint64_t id, const StoredFigure& figure)>& visitor) {
+	const uint64_t shardCount = _store->GetShardCount();
+	for (uint64_t shardIndex = 0; shardIndex < shardCount; ++shardIndex) {
+		// One shard at a time, so a long scan holds back reclamation less.
+		Guard guard(*this);
+		const Shard& shard = _store->_shards[shardIndex];
+		const uint64_t slotCount = shard.slotCount.load(std::memory_order_acquire);
+		for (uint64_t index = 0; index < slotCount; ++index) {
+			const SlotPosition position = GetSlotPosition(index);
+			const Slot* segment = shard.segments[position.segment].load(std::memory_order_acquire);
+			const StoredFigure* figure = segment[position.offset].load(std::memory_order_seq_cst);
+			if (figure != nullptr) {
+				visitor((index << _store->_shardBits) | shardIndex, *figure);
+			}
+		}
+	}
+}
+
+ConcurrentFigureStore::ConcurrentFigureStore(uint64_t shardCount) : _shardBits(0), _size(0), _reclaimed(0) {
+	if (shardCount == 0) {
+		shardCount = std::max<uint64_t>(1, std::thread::hardware_concurrency());
+	}
+	while ((uint64_t(1) << _shardBits) < shardCount) {
+		++_shardBits;
+	}
+	if (_shardBits > maxShardBits) {
+		throw std::invalid_argument("Too many shards");
+	}
+
+	_shards = std::make_unique<Shard[]>(GetShardCount());
+}
+
+ConcurrentFigureStore::~ConcurrentFigureStore() noexcept {
+	for (uint64_t shardIndex = 0; shardIndex < GetShardCount(); ++shardIndex) {
+		Shard& shard = _shards[shardIndex];
+		const uint64_t slotCount = shard.slotCount.load(std::memory_order_relaxed);
+		for (uint64_t index = 0; index < slotCount; ++index) {
+			const SlotPosition position = GetSlotPosition(index);
+			delete shard.segments[position.segment].load(std::memory_order_relaxed)[position.offset].load(
+				std::memory_order_relaxed);
+		}
+		for (std::atomic<Slot*>& segment : shard.segments) {
+			delete[] segment.load(std::memory_order_relaxed);
+		}
+		for (const RetiredFigure& retired : shard.retired) {
+			delete retired.figure;
+		}
+	}
+}
+
+uint64_t ConcurrentFigureStore::Insert(const AnyFigure& figure) {
+	const uint64_t shardIndex = GetThreadShardSeed() & (GetShardCount() - 1);
+	Shard& shard = _shards[shardIndex];
+	StoredFigure* stored = MakeStoredFigure(figure);
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	const uint64_t index = shard.slotCount.load(std::memory_order_relaxed);
+	const SlotPosition position = GetSlotPosition(index);
+	if (position.segment >= maxSegments) {
+		delete stored;
+		throw std::length_error("Figure store shard is full");
+	}
+	Slot* segment = shard.segments[position.segment].load(std::memory_order_relaxed);
+	if (segment == nullptr) {
+		segment = new Slot[firstSegmentSize << position.segment]();
+		shard.segments[position.segment].store(segment, std::memory_order_release);
+	}
+	segment[position.offset].store(stored, std::memory_order_seq_cst);
+	shard.slotCount.store(index + 1, std::memory_order_release);
+	_size.fetch_add(1, std::memory_order_relaxed);
+
+	return (index << _shardBits) | shardIndex;
+}
+
+bool ConcurrentFigureStore::Replace(uint64_t id, const AnyFigure& figure) {
+	std::unique_ptr<StoredFigure> stored(MakeStoredFigure(figure));
+	if (!Exchange(id, stored.get())) {
+		return false;
+	}
+
+	stored.release();
+	return true;
+}
+
+bool ConcurrentFigureStore::Remove(uint64_t id) {
+	if (!Exchange(id, nullptr)) {
+		return false;
+	}
+
+	_size.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+uint64_t ConcurrentFigureStore::Size() const noexcept {
+	return _size.load(std::memory_order_relaxed);
+}
+
+uint64_t ConcurrentFigureStore::GetShardCount() const noexcept {
+	return uint64_t(1) << _shardBits;
+}
+
+void ConcurrentFigureStore::Collect() {
+	for (uint64_t shardIndex = 0; shardIndex < GetShardCount(); ++shardIndex) {
+		Shard& shard = _shards[shardIndex];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		// With the advance in Collect(shard), the epoch moves past everything
+		// retired so far unless a reader is inside.
+		_domain.TryAdvance();
+		Collect(shard);
+	}
+}
+
+uint64_t ConcurrentFigureStore::GetRetiredCount() const {
+	uint64_t count = 0;
+	for (uint64_t shardIndex = 0; shardIndex < GetShardCount(); ++shardIndex) {
+		Shard& shard = _shards[shardIndex];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		count += shard.retired.size();
+	}
+
+	return count;
+}
+
+uint64_t ConcurrentFigureStore::GetReclaimedCount() const noexcept {
+	return _reclaimed.load(std::memory_order_relaxed);
+}
+
+const StoredFigure* ConcurrentFigureStore::Find(uint64_t id) const noexcept {
+	const Shard& shard = GetShard(id);
+	const uint64_t index = GetSlotIndex(id);
+	if (index >= shard.slotCount.load(std::memory_order_acquire)) {
+		return nullptr;
+	}
+
+	const SlotPosition position = GetSlotPosition(index);
+	const Slot* segment = shard.segments[position.segment].load(std::memory_order_acquire);
+	return segment[position.offset].load(std::memory_order_seq_cst);
+}
+
+ConcurrentFigureStore::Shard& ConcurrentFigureStore::GetShard(uint64_t id) const noexcept {
+	return _shards[id & (GetShardCount() - 1)];
+}
+
+uint64_t ConcurrentFigureStore::GetSlotIndex(uint64_t id) const noexcept {
+	return id >> _shardBits;
+}
+
+bool ConcurrentFigureStore::Exchange(uint64_t id, const StoredFigure* figure) {
+	Shard& shard = GetShard(id);
+	const uint64_t index = GetSlotIndex(id);
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	if (index >= shard.slotCount.load(std::memory_order_relaxed)) {
+		return false;
+	}
+	const SlotPosition position = GetSlotPosition(index);
+	Slot& slot = shard.segments[position.segment].load(std::memory_order_relaxed)[position.offset];
+	if (slot.load(std::memory_order_relaxed) == nullptr) {
+		return false;
+	}
+
+	Retire(shard, slot.exchange(figure, std::memory_order_seq_cst));
+	return true;
+}
+
+void ConcurrentFigureStore::Retire(Shard& shard, const StoredFigure* figure) {
+	shard.retired.push_back({figure, _domain.GetEpoch()});
+	if (shard.retired.size() >= collectThreshold) {
+		Collect(shard);
+	}
+}
+
+void ConcurrentFigureStore::Collect(Shard& shard) {
+	const uint64_t epoch = _domain.TryAdvance();
+	// Retired in epoch order, so the reclaimable ones come first.
+	auto kept = shard.retired.begin();
+	while (kept != shard.retired.end() && EpochDomain::IsReclaimable(kept->epoch, epoch)) {
+		delete kept->figure;
+		++kept;
+	}
+	_reclaimed.fetch_add(static_cast<uint64_t>(kept - shard.retired.begin()), std::memory_order_relaxed);
+	shard.retired.erase(shard.retired.begin(), kept);
+}
@@ -0,0 +1,256 @@
+#include "FigureAggregates.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+CompensatedSum::CompensatedSum() noexcept : _sum(0), _compensation(0) {}
+
+void CompensatedSum::Add(double value) noexcept {
+	const double sum = _sum + value;
+	// Whichever of the two is smaller in magnitude lost its low bits.
+	if (std::abs(_sum) >= std::abs(value)) {
+		_compensation += (_sum - sum) + value;
+	} else {
+		_compensation += (value - sum) + _sum;
+	}
+	_sum = sum;
+}
+
+void CompensatedSum::Subtract(double value) noexcept {
+	Add(-value);
+}
+
+void CompensatedSum::Reset() noexcept {
+	_sum = 0;
+	_compensation = 0;
+}
+
+double CompensatedSum::Get() const noexcept {
+	return _sum + _compensation;
+}
+
+FigureAggregates::FigureAggregates(const std::vector<double>& histogramEdges) :
+	_histogramEdges(histogramEdges), _histogram(histogramEdges.size() + 1, 0) {
+	for (uint64_t i = 0; i < _histogramEdges.size(); ++i) {
+		if (!std::isfinite(_histogramEdges[i]) || (i != 0 && !(_histogramEdges[i - 1] < _histogramEdges[i]))) {
+			throw std::invalid_argument("Histogram edges must be finite and strictly increasing");
+		}
+	}
+}
+
+void FigureAggregates::Insert(uint64_t id, const AnyFigure& figure) {
+	if (_entries.count(id) != 0) {
+		throw std::invalid_argument("Figure " + std::to_string(id) + " is already aggregated");
+	}
+
+	BoundingBox box;
+	Entry entry = Measure(figure, box);
+	Add(entry, box);
+	try {
+		_entries.emplace(id, entry);
+	} catch (...) {
+		Subtract(entry);
+		throw;
+	}
+}
+
+void FigureAggregates::Update(uint64_t id, const AnyFigure& figure) {
+	auto found = _entries.find(id);
+	if (found == _entries.end()) {
+		throw std::out_of_range("No figure " + std::to_string(id));
+	}
+
+	BoundingBox box;
+	Entry entry = Measure(figure, box);
+	Entry& old = found->second;
+	// Adding the old figure back after a rejected update could round
+	// differently, so the sums are restored as they were.
+	const CompensatedSum area = _area;
+	const CompensatedSum weightedX = _weightedX;
+	const CompensatedSum weightedY = _weightedY;
+	SubtractSums(old);
+	try {
+		AddSums(entry);
+	} catch (...) {
+		++_histogram[old.bucket];
+		_area = area;
+		_weightedX = weightedX;
+		_weightedY = weightedY;
+		throw;
+	}
+	// The nodes of the old figure are reused, so an update never allocates.
+	entry.areaPosition = Move(_areas, old.areaPosition, entry.area);
+	entry.minXPosition = Move(_minX, old.minXPosition, box.minX);
+	entry.minYPosition = Move(_minY, old.minYPosition, box.minY);
+	entry.maxXPosition = Move(_maxX, old.maxXPosition, box.maxX);
+	entry.maxYPosition = Move(_maxY, old.maxYPosition, box.maxY);
+	old = entry;
+}
+
+void FigureAggregates::Erase(uint64_t id) {
+	auto found = _entries.find(id);
+	if (found == _entries.end()) {
+		throw std::out_of_range("No figure " + std::to_string(id));
+	}
+
+	Subtract(found->second);
+	_entries.erase(found);
+	if (_entries.empty()) {
+		Clear();
+	} else if (!SumsAreFinite()) {
+		// Terms of opposite signs that cancelled each other are gone, and the
+		// rest overflowed: an infinite sum would not come back by subtracting,
+		// so it is recomputed until the figures left fit again.
+		RecomputeSums();
+	}
+}
+
+void FigureAggregates::Clear() noexcept {
+	std::fill(_histogram.begin(), _histogram.end(), 0);
+	_entries.clear();
+	_area.Reset();
+	_weightedX.Reset();
+	_weightedY.Reset();
+	_areas.clear();
+	_minX.clear();
+	_minY.clear();
+	_maxX.clear();
+	_maxY.clear();
+}
+
+bool FigureAggregates::Contains(uint64_t id) const {
+	return _entries.count(id) != 0;
+}
+
+uint64_t FigureAggregates::GetCount() const noexcept {
+	return _entries.size();
+}
+
+double FigureAggregates::GetTotalArea() const noexcept {
+	return _area.Get();
+}
+
+double FigureAggregates::GetMinArea() const noexcept {
+	return _areas.empty() ? std::numeric_limits<double>::infinity() : *_areas.begin();
+}
+
+double FigureAggregates::GetMaxArea() const noexcept {
+	return _areas.empty() ? -std::numeric_limits<double>::infinity() : *_areas.rbegin();
+}
+
+Point FigureAggregates::GetCentroid() const noexcept {
+	const double area = _area.Get();
+	if (area == 0) {
+		return {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()};
+	}
+
+	return {_weightedX.Get() / area, _weightedY.Get() / area};
+}
+
+BoundingBox FigureAggregates::GetBounds() const noexcept {
+	if (_entries.empty()) {
+		return BoundingBox();
+	}
+
+	return {*_minX.begin(), *_minY.begin(), *_maxX.rbegin(), *_maxY.rbegin()};
+}
+
+const std::vector<double>& FigureAggregates::GetHistogramEdges() const noexcept {
+	return _histogramEdges;
+}
+
+const std::vector<uint64_t>& FigureAggregates::GetHistogram() const noexcept {
+	return _histogram;
+}
+
+FigureAggregates::Entry FigureAggregates::Measure(const AnyFigure& figure, BoundingBox& box) const {
+	const double area = static_cast<double>(figure);
+	const Point center = figure.GetGeometricCenter();
+	box = figure.Visit([](const auto& concrete) { return concrete.GetBoundingBox(); });
+	if (!std::isfinite(area) || !std::isfinite(box.minX) || !std::isfinite(box.minY) ||
+		!std::isfinite(box.maxX) || !std::isfinite(box.maxY)) {
+		throw std::invalid_argument("Only figures with finite coordinates and area can be aggregated");
+	}
+	// An infinite weighted center would turn the sums into NaN once the
+	// figure is subtracted again.
+	if (!std::isfinite(area * center.x) || !std::isfinite(area * center.y)) {
+		throw std::invalid_argument("The area times the center of the figure overflows");
+	}
+
+	Entry entry;
+	entry.area = area;
+	entry.center = center;
+	entry.bucket = GetBucket(area);
+	return entry;
+}
+
+void FigureAggregates::Add(Entry& entry, const BoundingBox& box) {
+	AddSums(entry);
+	entry.areaPosition = _areas.insert(entry.area);
+	entry.minXPosition = _minX.insert(box.minX);
+	entry.minYPosition = _minY.insert(box.minY);
+	entry.maxXPosition = _maxX.insert(box.maxX);
+	entry.maxYPosition = _maxY.insert(box.maxY);
+}
+
+void FigureAggregates::Subtract(const Entry& entry) noexcept {
+	SubtractSums(entry);
+	_areas.erase(entry.areaPosition);
+	_minX.erase(entry.minXPosition);
+	_minY.erase(entry.minYPosition);
+	_maxX.erase(entry.maxXPosition);
+	_maxY.erase(entry.maxYPosition);
+}
+
+void FigureAggregates::AddSums(const Entry& entry) {
+	CompensatedSum area = _area;
+	CompensatedSum weightedX = _weightedX;
+	CompensatedSum weightedY = _weightedY;
+	area.Add(entry.area);
+	weightedX.Add(entry.area * entry.center.x);
+	weightedY.Add(entry.area * entry.center.y);
+	if (!std::isfinite(area.Get()) || !std::isfinite(weightedX.Get()) || !std::isfinite(weightedY.Get())) {
+		throw std::invalid_argument("The sums of the aggregated figures overflow");
+	}
+
+	++_histogram[entry.bucket];
+	_area = area;
+	_weightedX = weightedX;
+	_weightedY = weightedY;
+}
+
+void FigureAggregates::SubtractSums(const Entry& entry) noexcept {
+	--_histogram[entry.bucket];
+	_area.Subtract(entry.area);
+	_weightedX.Subtract(entry.area * entry.center.x);
+	_weightedY.Subtract(entry.area * entry.center.y);
+}
+
+bool FigureAggregates::SumsAreFinite() const noexcept {
+	return std::isfinite(_area.Get()) && std::isfinite(_weightedX.Get()) && std::isfinite(_weightedY.Get());
+}
+
+void FigureAggregates::RecomputeSums() noexcept {
+	_area.Reset();
+	_weightedX.Reset();
+	_weightedY.Reset();
+	for (const auto& [id, entry] : _entries) {
+		_area.Add(entry.area);
+		_weightedX.Add(entry.area * entry.center.x);
+		_weightedY.Add(entry.area * entry.center.y);
+	}
+}
+
+uint64_t FigureAggregates::GetBucket(double area) const noexcept {
+	return std::upper_bound(_histogramEdges.begin(), _histogramEdges.end(), area) - _histogramEdges.begin();
+}
+
+std::multiset<double>::iterator FigureAggregates::Move(std::multiset<double>& values,
+													   std::multiset<double>::iterator position, double value) {
+	std::multiset<double>::node_type node = values.extract(position);
+	node.value() = value;
+	return values.insert(std::move(node));
+}
@@ -0,0 +1,69 @@
+#include "FigureArena.h"
+#include <stdexcept>
+
+MonotonicArena::MonotonicArena(uint64_t blockSize) : _blockSize(blockSize), _current(0), _offset(0), _generation(0), _stats() {
+	if (blockSize == 0) {
+		throw std::invalid_argument("Block size must be positive");
+	}
+}
+
+MonotonicArena::~MonotonicArena() noexcept {
+	Release();
+}
+
+void MonotonicArena::Reset() noexcept {
+	_current = 0;
+	_offset = 0;
+	++_generation;
+	++_stats.resets;
+}
+
+void MonotonicArena::Release() noexcept {
+	for (Block& block : _blocks) {
+		::operator delete(block.data, std::align_val_t(alignof(std::max_align_t)));
+	}
+	_blocks.clear();
+	_current = 0;
+	_offset = 0;
+	++_generation;
+	_stats.bytesReserved = 0;
+}
+
+uint64_t MonotonicArena::GetGeneration() const noexcept {
+	return _generation;
+}
+
+const ArenaStats& MonotonicArena::GetStats() const noexcept {
+	return _stats;
+}
+
+void* MonotonicArena::AllocateSlow(uint64_t size, uint64_t alignment) {
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > alignof(std::max_align_t)) {
+		throw std::invalid_argument("Unsupported alignment");
+	}
+
+	// Move on to a block kept from before the last reset if one is big
+	// enough; otherwise insert a fresh block right after the current one.
+	uint64_t next = _current < _blocks.size() ? _current + 1 : _current;
+	while (next < _blocks.size() && _blocks[next].size < size) {
+		++next;
+	}
+
+	if (next == _blocks.size()) {
+		uint64_t blockSize = size > _blockSize ? size : _blockSize;
+		Block block{static_cast<unsigned char*>(::operator new(blockSize, std::align_val_t(alignof(std::max_align_t)))), blockSize};
+		next = _current < _blocks.size() ? _current + 1 : _current;
+		_blocks.insert(_blocks.begin() + static_cast<std::ptrdiff_t>(next), block);
+		++_stats.blockAllocations;
+		FIGURES_COUNT(ArenaBlockAllocations);
+		_stats.bytesReserved += blockSize;
+	}
+
+	_current = next;
+	_offset = size;
+	++_stats.allocations;
+	FIGURES_COUNT(ArenaAllocations);
+	_stats.bytesAllocated += size;
+
+	return _blocks[_current].data;
+}
@@ -0,0 +1,32 @@
+#include "FigureEngine.h"
+#include <stdexcept>
+
+FigureEngine::FigureEngine(uint64_t threadCount, uint64_t chunkSize) : _pool(threadCount), _chunkSize(chunkSize) {
+	if (chunkSize == 0) {
+		throw std::invalid_argument("Chunk size must be positive");
+	}
+}
+
+uint64_t FigureEngine::GetThreadCount() const noexcept {
+	return _pool.GetThreadCount();
+}
+
+uint64_t FigureEngine::GetChunkSize() const noexcept {
+	return _chunkSize;
+}
+
+ThreadPool& FigureEngine::GetThreadPool() noexcept {
+	return _pool;
+}
+
+double FigureEngine::SumInChunkOrder(uint64_t count, const ThreadPool::ChunkTask& fillPartial, std::vector<double>& partials) {
+	partials.assign(ThreadPool::GetChunkCount(count, _chunkSize), 0.0);
+	_pool.ParallelFor(count, _chunkSize, fillPartial);
+
+	double total = 0;
+	for (double partial : partials) {
+		total += partial;
+	}
+
+	return total;
+}
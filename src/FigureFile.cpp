@@ -0,0 +1,244 @@
+#include "FigureFile.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(std::array<Point, 4>) == 4 * sizeof(Point), "Records must be packed Points");
+static_assert(sizeof(std::array<Point, 6>) == 6 * sizeof(Point), "Records must be packed Points");
+
+namespace {
+
+constexpr uint64_t tableAlignment = 16;
+constexpr uint64_t minAmountOfPoints = 4;
+constexpr uint64_t maxAmountOfPoints = 6;
+
+constexpr bool IsLittleEndianHost() {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+	return __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__;
+#else
+	return true;
+#endif
+}
+
+uint64_t AlignUp(uint64_t value) {
+	return (value + tableAlignment - 1) / tableAlignment * tableAlignment;
+}
+
+template <typename T>
+void WriteLittleEndian(std::ostream& ostream, const T* values, uint64_t count) {
+	if (IsLittleEndianHost()) {
+		ostream.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(T)));
+		return;
+	}
+
+	for (uint64_t i = 0; i < count; ++i) {
+		char bytes[sizeof(T)];
+		std::memcpy(bytes, values + i, sizeof(T));
+		for (uint64_t j = 0; j < sizeof(T) / 2; ++j) {
+			std::swap(bytes[j], bytes[sizeof(T) - 1 - j]);
+		}
+		ostream.write(bytes, sizeof(T));
+	}
+}
+
+}
+
+void FigureFileWriter::Add(const Rhombus& rhombus) {
+	const std::array<Point, 4>& points = rhombus.GetPoints();
+	GetPoints(4).insert(GetPoints(4).end(), points.begin(), points.end());
+}
+
+void FigureFileWriter::Add(const Pentagon& pentagon) {
+	const std::array<Point, 5>& points = pentagon.GetPoints();
+	GetPoints(5).insert(GetPoints(5).end(), points.begin(), points.end());
+}
+
+void FigureFileWriter::Add(const Hexagon& hexagon) {
+	const std::array<Point, 6>& points = hexagon.GetPoints();
+	GetPoints(6).insert(GetPoints(6).end(), points.begin(), points.end());
+}
+
+uint64_t FigureFileWriter::GetCount(uint64_t amountOfPoints) const {
+	return GetPoints(amountOfPoints).size() / amountOfPoints;
+}
+
+void FigureFileWriter::Save(const std::string& path) const {
+	std::ofstream ofstream(path, std::ios::binary | std::ios::trunc);
+	if (!ofstream) {
+		throw std::runtime_error("Cannot open " + path + " for writing");
+	}
+
+	Save(ofstream);
+
+	ofstream.close();
+	if (!ofstream) {
+		throw std::runtime_error("Cannot write " + path);
+	}
+}
+
+void FigureFileWriter::Save(std::ostream& ostream) const {
+	FigureFileHeader header{};
+	std::memcpy(header.magic, figureFileMagic, sizeof(header.magic));
+	header.version = figureFileVersion;
+	header.tableCount = static_cast<uint32_t>(_points.size());
+
+	std::array<FigureFileTable, 3> tables{};
+	uint64_t offset = AlignUp(sizeof(FigureFileHeader) + tables.size() * sizeof(FigureFileTable));
+	for (uint64_t i = 0; i < tables.size(); ++i) {
+		tables[i].amountOfPoints = static_cast<uint32_t>(minAmountOfPoints + i);
+		tables[i].count = _points[i].size() / tables[i].amountOfPoints;
+		tables[i].offset = offset;
+		offset = AlignUp(offset + _points[i].size() * sizeof(Point));
+	}
+
+	WriteLittleEndian(ostream, header.magic, sizeof(header.magic));
+	WriteLittleEndian(ostream, &header.version, 1);
+	WriteLittleEndian(ostream, &header.tableCount, 1);
+	WriteLittleEndian(ostream, &header.reserved, 1);
+	for (const FigureFileTable& table : tables) {
+		WriteLittleEndian(ostream, &table.amountOfPoints, 1);
+		WriteLittleEndian(ostream, &table.reserved, 1);
+		WriteLittleEndian(ostream, &table.count, 1);
+		WriteLittleEndian(ostream, &table.offset, 1);
+	}
+
+	uint64_t written = sizeof(FigureFileHeader) + tables.size() * sizeof(FigureFileTable);
+	const char padding[tableAlignment] = {};
+	for (uint64_t i = 0; i < tables.size(); ++i) {
+		ostream.write(padding, static_cast<std::streamsize>(tables[i].offset - written));
+		WriteLittleEndian(ostream, reinterpret_cast<const double*>(_points[i].data()), _points[i].size() * 2);
+		written = tables[i].offset + _points[i].size() * sizeof(Point);
+	}
+
+	if (!ostream) {
+		throw std::runtime_error("Cannot write figure file");
+	}
+}
+
+std::vector<Point>& FigureFileWriter::GetPoints(uint64_t amountOfPoints) {
+	return _points.at(amountOfPoints - minAmountOfPoints);
+}
+
+const std::vector<Point>& FigureFileWriter::GetPoints(uint64_t amountOfPoints) const {
+	return _points.at(amountOfPoints - minAmountOfPoints);
+}
+
+FigureFileReader::FigureFileReader(const std::string& path) : _data(nullptr), _size(0) {
+	if (!IsLittleEndianHost()) {
+		throw std::runtime_error("Zero-copy figure files need a little-endian host");
+	}
+
+	int descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (descriptor < 0) {
+		throw std::runtime_error("Cannot open " + path);
+	}
+
+	struct stat status{};
+	if (fstat(descriptor, &status) != 0) {
+		close(descriptor);
+		throw std::runtime_error("Cannot stat " + path);
+	}
+	_size = static_cast<uint64_t>(status.st_size);
+	if (_size < sizeof(FigureFileHeader)) {
+		close(descriptor);
+		throw std::invalid_argument(path + " is not a figure file");
+	}
+
+	void* mapping = mmap(nullptr, _size, PROT_READ, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (mapping == MAP_FAILED) {
+		throw std::runtime_error("Cannot map " + path);
+	}
+	_data = static_cast<const unsigned char*>(mapping);
+
+	try {
+		Validate();
+	} catch (...) {
+		munmap(const_cast<unsigned char*>(_data), _size);
+		throw;
+	}
+}
+
+FigureFileReader::FigureFileReader(FigureFileReader&& moved) noexcept : _data(moved._data), _size(moved._size) {
+	moved._data = nullptr;
+	moved._size = 0;
+}
+
+FigureFileReader::~FigureFileReader() noexcept {
+	if (_data != nullptr) {
+		munmap(const_cast<unsigned char*>(_data), _size);
+	}
+}
+
+FigureFileReader& FigureFileReader::operator=(FigureFileReader&& other) noexcept {
+	if (this != &other) {
+		FigureFileReader moved(std::move(other));
+		std::swap(_data, moved._data);
+		std::swap(_size, moved._size);
+	}
+
+	return *this;
+}
+
+uint32_t FigureFileReader::GetVersion() const {
+	return reinterpret_cast<const FigureFileHeader*>(_data)->version;
+}
+
+uint64_t FigureFileReader::GetFileSize() const noexcept {
+	return _size;
+}
+
+RhombusRecords FigureFileReader::GetRhombuses() const {
+	return GetRecords<4>();
+}
+
+PentagonRecords FigureFileReader::GetPentagons() const {
+	return GetRecords<5>();
+}
+
+HexagonRecords FigureFileReader::GetHexagons() const {
+	return GetRecords<6>();
+}
+
+void FigureFileReader::Validate() const {
+	const FigureFileHeader* header = reinterpret_cast<const FigureFileHeader*>(_data);
+	if (std::memcmp(header->magic, figureFileMagic, sizeof(header->magic)) != 0) {
+		throw std::invalid_argument("Bad figure file magic");
+	}
+	if (header->version != figureFileVersion) {
+		throw std::invalid_argument("Unsupported figure file version");
+	}
+	if (header->tableCount > (_size - sizeof(FigureFileHeader)) / sizeof(FigureFileTable)) {
+		throw std::invalid_argument("Figure file tables are truncated");
+	}
+
+	const FigureFileTable* tables = reinterpret_cast<const FigureFileTable*>(_data + sizeof(FigureFileHeader));
+	for (uint32_t i = 0; i < header->tableCount; ++i) {
+		const FigureFileTable& table = tables[i];
+		if (table.amountOfPoints < minAmountOfPoints || table.amountOfPoints > maxAmountOfPoints) {
+			continue;
+		}
+
+		uint64_t recordSize = table.amountOfPoints * sizeof(Point);
+		if (table.offset % alignof(Point) != 0 || table.offset > _size ||
+			table.count > (_size - table.offset) / recordSize) {
+			throw std::invalid_argument("Figure file table points outside the file");
+		}
+	}
+}
+
+const FigureFileTable* FigureFileReader::FindTable(uint64_t amountOfPoints) const {
+	const FigureFileHeader* header = reinterpret_cast<const FigureFileHeader*>(_data);
+	const FigureFileTable* tables = reinterpret_cast<const FigureFileTable*>(_data + sizeof(FigureFileHeader));
+	for (uint32_t i = 0; i < header->tableCount; ++i) {
+		if (tables[i].amountOfPoints == amountOfPoints) {
+			return &tables[i];
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,793 @@
+#include "FigureIngest.h"
+#include "FigureFile.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#define FIGURES_IO_URING
+#endif
+#endif
+
+namespace {
+
+constexpr uint64_t maxReadSize = 1 << 30;
+constexpr uint64_t maxReadsInFlight = 4096;
+
+struct ReadRequest {
+	int descriptor;
+	uint64_t offset;
+	char* buffer;
+	uint64_t size;
+	uint64_t tag;
+};
+
+struct ReadCompletion {
+	uint64_t tag;
+	// Bytes read, or -errno.
+	int64_t result;
+};
+
+// Performs reads asynchronously. No more reads than the capacity the engine
+// was made with may be outstanding at a time.
+class ReadEngine {
+public:
+	virtual ~ReadEngine() = default;
+public:
+	virtual void Submit(const ReadRequest& request) = 0;
+	// Waits for the next read to complete, in any order.
+	virtual ReadCompletion Wait() = 0;
+};
+
+class PreadEngine : public ReadEngine {
+public:
+	PreadEngine(uint64_t threadCount, uint64_t capacity) : _requests(capacity), _completions(capacity) {
+		for (uint64_t i = 0; i < threadCount; ++i) {
+			_threads.emplace_back([this]() { Work(); });
+		}
+	}
+
+	~PreadEngine() noexcept override {
+		_requests.Close();
+		for (std::thread& thread : _threads) {
+			thread.join();
+		}
+	}
+public:
+	void Submit(const ReadRequest& request) override {
+		_requests.Push(request);
+	}
+
+	ReadCompletion Wait() override {
+		ReadCompletion completion{0, 0};
+		_completions.Pop(completion);
+		return completion;
+	}
+private:
+	void Work() {
+		ReadRequest request{};
+		while (_requests.Pop(request)) {
+			ssize_t result = 0;
+			do {
+				result = pread(request.descriptor, request.buffer, request.size, static_cast<off_t>(request.offset));
+			} while (result < 0 && errno == EINTR);
+			_completions.Push({request.tag, result < 0 ? -static_cast<int64_t>(errno) : result});
+		}
+	}
+private:
+	BoundedQueue<ReadRequest> _requests;
+	BoundedQueue<ReadCompletion> _completions;
+	std::vector<std::thread> _threads;
+};
+
+#ifdef FIGURES_IO_URING
+
+// io_uring through the raw system calls, so that liburing is not needed:
+// one submission ring of IORING_OP_READ entries and the completion ring,
+// both mapped into the process. Only the reading thread touches the rings.
+class IoUringEngine : public ReadEngine {
+public:
+	explicit IoUringEngine(uint64_t capacity) :
+		_ring(-1), _sqRing(MAP_FAILED), _cqRing(MAP_FAILED), _sqes(MAP_FAILED), _sqRingSize(0), _cqRingSize(0),
+		_sqesSize(0), _unsubmitted(0) {
+		io_uring_params params{};
+		_ring = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(capacity), &params));
+		if (_ring < 0) {
+			throw std::runtime_error(std::string("io_uring is unavailable: ") + std::strerror(errno));
+		}
+
+		try {
+			Map(params);
+			RequireRead();
+		} catch (...) {
+			Unmap();
+			throw;
+		}
+	}
+
+	~IoUringEngine() noexcept override {
+		Unmap();
+	}
+public:
+	void Submit(const ReadRequest& request) override {
+		const unsigned tail = *_sqTail;
+		const unsigned index = tail & *_sqMask;
+		io_uring_sqe& entry = _sqeArray[index];
+		std::memset(&entry, 0, sizeof(entry));
+		entry.opcode = IORING_OP_READ;
+		entry.fd = request.descriptor;
+		entry.addr = reinterpret_cast<uint64_t>(request.buffer);
+		entry.len = static_cast<uint32_t>(request.size);
+		entry.off = request.offset;
+		entry.user_data = request.tag;
+		_sqIndices[index] = index;
+		__atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+		++_unsubmitted;
+	}
+
+	ReadCompletion Wait() override {
+		while (true) {
+			const bool ready = HasCompletion();
+			if (ready && _unsubmitted == 0) {
+				return TakeCompletion();
+			}
+
+			const long submitted = syscall(__NR_io_uring_enter, _ring, _unsubmitted, ready ? 0 : 1,
+										   ready ? 0 : IORING_ENTER_GETEVENTS, nullptr, 0);
+			if (submitted < 0) {
+				if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+					continue;
+				}
+				throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+			}
+			_unsubmitted -= static_cast<unsigned>(submitted);
+		}
+	}
+private:
+	void Map(const io_uring_params& params) {
+		_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (single) {
+			_sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+		}
+
+		_sqRing = mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring,
+					   IORING_OFF_SQ_RING);
+		if (_sqRing == MAP_FAILED) {
+			throw std::runtime_error("Cannot map the io_uring submission ring");
+		}
+		_cqRing = single ? _sqRing
+						 : mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring,
+								IORING_OFF_CQ_RING);
+		if (_cqRing == MAP_FAILED) {
+			throw std::runtime_error("Cannot map the io_uring completion ring");
+		}
+		_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		_sqes = mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES);
+		if (_sqes == MAP_FAILED) {
+			throw std::runtime_error("Cannot map the io_uring submission entries");
+		}
+
+		char* sq = static_cast<char*>(_sqRing);
+		char* cq = static_cast<char*>(_cqRing);
+		_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+		_sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+		_sqIndices = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+		_sqeArray = static_cast<io_uring_sqe*>(_sqes);
+		_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+		_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+		_cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+		_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+	}
+
+	// IORING_OP_READ arrived in Linux 5.6, after io_uring itself.
+	void RequireRead() const {
+		constexpr unsigned opCount = 256;
+		std::vector<unsigned char> storage(sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op));
+		io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+		if (syscall(__NR_io_uring_register, _ring, IORING_REGISTER_PROBE, probe, opCount) < 0 ||
+			probe->last_op < IORING_OP_READ || (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) == 0) {
+			throw std::runtime_error("io_uring does not support reads on this kernel");
+		}
+	}
+
+	void Unmap() noexcept {
+		if (_sqes != MAP_FAILED) {
+			munmap(_sqes, _sqesSize);
+		}
+		if (_cqRing != MAP_FAILED && _cqRing != _sqRing) {
+			munmap(_cqRing, _cqRingSize);
+		}
+		if (_sqRing != MAP_FAILED) {
+			munmap(_sqRing, _sqRingSize);
+		}
+		close(_ring);
+	}
+
+	bool HasCompletion() const {
+		return *_cqHead != __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+	}
+
+	ReadCompletion TakeCompletion() {
+		const unsigned head = *_cqHead;
+		const io_uring_cqe& entry = _cqes[head & *_cqMask];
+		const ReadCompletion completion{entry.user_data, entry.res};
+		__atomic_store_n(_cqHead, head + 1, __ATOMIC_RELEASE);
+
+		return completion;
+	}
+private:
+	int _ring;
+	void* _sqRing;
+	void* _cqRing;
+	void* _sqes;
+	std::size_t _sqRingSize;
+	std::size_t _cqRingSize;
+	std::size_t _sqesSize;
+	unsigned* _sqTail;
+	unsigned* _sqMask;
+	unsigned* _sqIndices;
+	io_uring_sqe* _sqeArray;
+	unsigned* _cqHead;
+	unsigned* _cqTail;
+	unsigned* _cqMask;
+	io_uring_cqe* _cqes;
+	unsigned _unsubmitted;
+};
+
+#endif
+
+std::unique_ptr<ReadEngine> MakeEngine(const IngestOptions& options, IngestBackend& backend) {
+#ifdef FIGURES_IO_URING
+	if (options.backend != IngestBackend::ThreadPool) {
+		try {
+			std::unique_ptr<ReadEngine> engine = std::make_unique<IoUringEngine>(options.readsInFlight);
+			backend = IngestBackend::IoUring;
+			return engine;
+		} catch (const std::runtime_error&) {
+			if (options.backend == IngestBackend::IoUring) {
+				throw;
+			}
+		}
+	}
+#else
+	if (options.backend == IngestBackend::IoUring) {
+		throw std::runtime_error("io_uring is unavailable on this platform");
+	}
+#endif
+
+	backend = IngestBackend::ThreadPool;
+	return std::make_unique<PreadEngine>(options.readerThreads, options.readsInFlight);
+}
+
+// A read of a file, numbered by its place in the file.
+struct Block {
+	uint64_t file;
+	uint64_t index;
+	// Null for the only block of an empty file.
+	char* buffer;
+	uint64_t size;
+};
+
+struct FileState {
+	explicit FileState(std::string path) : report{std::move(path), 0, 0, 0, false, {}, 0} {}
+
+	// Owned by the reading thread.
+	int descriptor = -1;
+	uint64_t size = 0;
+	uint64_t blockCount = 0;
+	uint64_t issued = 0;
+	uint64_t inFlight = 0;
+	// Set once the file turned out to be binary and is mapped instead.
+	std::atomic<bool> dropReads{false};
+
+	// Owned by the parser thread that set busy.
+	std::mutex mutex;
+	std::map<uint64_t, Block> pending;
+	uint64_t nextBlock = 0;
+	bool busy = false;
+	bool done = false;
+	std::unique_ptr<TextRecordParser> parser;
+	IngestFileReport report;
+};
+
+using BatchSink = std::function<bool(IngestBatch batch)>;
+
+// State of one FigureIngest::Run(). The calling thread runs the reads and
+// the parser threads take completed blocks from _blocks. A parser that finds
+// another one busy with the same file leaves its block in the pending map of
+// the file; the busy one parses it when its turn comes, so each file is fed
+// to its parser in order by one thread at a time.
+class IngestRun {
+public:
+	IngestRun(const IngestOptions& options, const std::vector<std::string>& paths, BatchSink sink) :
+		_options(options), _sink(std::move(sink)), _bufferSize(options.readSize),
+		_parserCount(GetParserCount(options)), _bufferCount(options.readsInFlight + 2 * _parserCount),
+		_blocks(_bufferCount + 1), _stopped(false), _inFlight(0) {
+		for (const std::string& path : paths) {
+			_files.push_back(std::make_unique<FileState>(path));
+		}
+
+		_storage.resize(_bufferCount * _bufferSize);
+		for (uint64_t i = 0; i < _bufferCount; ++i) {
+			_free.push_back(_storage.data() + i * _bufferSize);
+		}
+		_reads.resize(options.readsInFlight);
+		for (uint64_t i = 0; i < options.readsInFlight; ++i) {
+			_freeSlots.push_back(options.readsInFlight - 1 - i);
+		}
+	}
+public:
+	IngestReport Execute() {
+		IngestReport report{IngestBackend::Automatic, {}};
+		_engine = MakeEngine(_options, report.backend);
+
+		std::vector<std::thread> parsers;
+		for (uint64_t i = 0; i < _parserCount; ++i) {
+			parsers.emplace_back([this]() { ParseLoop(); });
+		}
+
+		try {
+			ReadLoop();
+		} catch (...) {
+			Fail();
+		}
+		// The kernel or the reading threads may still write into the
+		// buffers, so every read must be back before they go away.
+		try {
+			while (_inFlight > 0) {
+				_engine->Wait();
+				--_inFlight;
+			}
+		} catch (...) {
+			Fail();
+		}
+		_blocks.Close();
+		for (std::thread& parser : parsers) {
+			parser.join();
+		}
+		_engine.reset();
+		for (const std::unique_ptr<FileState>& file : _files) {
+			if (file->descriptor >= 0) {
+				close(file->descriptor);
+			}
+		}
+
+		if (_error) {
+			std::rethrow_exception(_error);
+		}
+		for (const std::unique_ptr<FileState>& file : _files) {
+			report.files.push_back(std::move(file->report));
+		}
+
+		return report;
+	}
+private:
+	struct InFlightRead {
+		Block block;
+		uint64_t filled;
+	};
+private:
+	static uint64_t GetParserCount(const IngestOptions& options) {
+		if (options.parserThreads != 0) {
+			return options.parserThreads;
+		}
+
+		return std::max<uint64_t>(1, std::thread::hardware_concurrency());
+	}
+
+	void ReadLoop() {
+		uint64_t nextFile = 0;
+		while (!_stopped) {
+			while (_inFlight < _options.readsInFlight && nextFile < _files.size() && !_stopped) {
+				FileState& file = *_files[nextFile];
+				if (file.blockCount == 0) {
+					Open(file, nextFile);
+				}
+				if (file.issued == file.blockCount || file.dropReads) {
+					CloseIfIdle(file);
+					++nextFile;
+					continue;
+				}
+
+				char* buffer = TryTakeBuffer();
+				if (buffer == nullptr) {
+					break;
+				}
+				const uint64_t offset = file.issued * _bufferSize;
+				const Block block{nextFile, file.issued, buffer, std::min(_bufferSize, file.size - offset)};
+				const uint64_t slot = _freeSlots.back();
+				_freeSlots.pop_back();
+				_reads[slot] = {block, 0};
+				_engine->Submit({file.descriptor, offset, buffer, block.size, slot});
+				++file.issued;
+				++file.inFlight;
+				++_inFlight;
+			}
+
+			if (_inFlight > 0) {
+				Complete(_engine->Wait());
+			} else if (nextFile == _files.size()) {
+				break;
+			} else {
+				// Every buffer waits to be parsed.
+				WaitForBuffer();
+			}
+		}
+	}
+
+	void Open(FileState& file, uint64_t index) {
+		const std::string& path = file.report.path;
+		file.descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file.descriptor < 0) {
+			throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+		}
+		struct stat status {};
+		if (fstat(file.descriptor, &status) != 0 || !S_ISREG(status.st_mode)) {
+			throw std::runtime_error("Cannot read " + path + ": not a regular file");
+		}
+
+		file.size = static_cast<uint64_t>(status.st_size);
+		file.blockCount = (file.size + _bufferSize - 1) / _bufferSize;
+		if (file.blockCount == 0) {
+			// The parser still has to see the file to report it.
+			file.blockCount = 1;
+			file.issued = 1;
+			_blocks.Push({index, 0, nullptr, 0});
+		}
+	}
+
+	void Complete(const ReadCompletion& completion) {
+		InFlightRead& read = _reads[completion.tag];
+		FileState& file = *_files[read.block.file];
+		if (completion.result == -EINTR || completion.result == -EAGAIN) {
+			Resubmit(file, read, completion.tag);
+			return;
+		}
+		std::string failure;
+		if (completion.result < 0 && !file.dropReads) {
+			failure = "Cannot read " + file.report.path + ": " + std::strerror(static_cast<int>(-completion.result));
+		} else {
+			read.filled += static_cast<uint64_t>(std::max<int64_t>(completion.result, 0));
+			if (completion.result > 0 && read.filled < read.block.size) {
+				Resubmit(file, read, completion.tag);
+				return;
+			}
+			if (read.filled < read.block.size && !file.dropReads) {
+				failure = file.report.path + " was truncated while being read";
+			}
+		}
+
+		// Accounted for before throwing, so that Execute() does not wait for
+		// this read again.
+		--_inFlight;
+		--file.inFlight;
+		_freeSlots.push_back(completion.tag);
+		if (!failure.empty()) {
+			GiveBuffer(read.block.buffer);
+			throw std::runtime_error(failure);
+		}
+		if (file.dropReads || !_blocks.Push(read.block)) {
+			GiveBuffer(read.block.buffer);
+		}
+		if (file.issued == file.blockCount || file.dropReads) {
+			CloseIfIdle(file);
+		}
+	}
+
+	void Resubmit(const FileState& file, const InFlightRead& read, uint64_t tag) {
+		_engine->Submit({file.descriptor, read.block.index * _bufferSize + read.filled, read.block.buffer + read.filled,
+						 read.block.size - read.filled, tag});
+	}
+
+	void CloseIfIdle(FileState& file) {
+		if (file.inFlight == 0 && file.descriptor >= 0) {
+			close(file.descriptor);
+			file.descriptor = -1;
+		}
+	}
+
+	void ParseLoop() {
+		Block block{};
+		while (_blocks.Pop(block)) {
+			try {
+				Parse(block);
+			} catch (...) {
+				Fail();
+			}
+		}
+	}
+
+	void Parse(const Block& block) {
+		FileState& file = *_files[block.file];
+		{
+			std::lock_guard<std::mutex> lock(file.mutex);
+			if (file.done || _stopped) {
+				GiveBuffer(block.buffer);
+				return;
+			}
+			file.pending.emplace(block.index, block);
+			if (file.busy) {
+				return;
+			}
+			file.busy = true;
+		}
+
+		while (true) {
+			Block next{};
+			{
+				std::lock_guard<std::mutex> lock(file.mutex);
+				const auto found = file.pending.find(file.nextBlock);
+				if (file.done || _stopped || found == file.pending.end()) {
+					if (file.done || _stopped) {
+						for (const std::pair<const uint64_t, Block>& entry : file.pending) {
+							GiveBuffer(entry.second.buffer);
+						}
+						file.pending.clear();
+					}
+					file.busy = false;
+					return;
+				}
+				next = found->second;
+				file.pending.erase(found);
+				++file.nextBlock;
+			}
+
+			const bool last = Process(file, next);
+			if (last) {
+				std::lock_guard<std::mutex> lock(file.mutex);
+				file.done = true;
+			}
+		}
+	}
+
+	// Returns true once the file is finished.
+	bool Process(FileState& file, const Block& block) {
+		if (block.index == 0) {
+			if (block.size >= sizeof(figureFileMagic) &&
+				std::memcmp(block.buffer, figureFileMagic, sizeof(figureFileMagic)) == 0) {
+				file.dropReads = true;
+				GiveBuffer(block.buffer);
+				ProcessBinary(file, block.file);
+				return true;
+			}
+			file.parser = std::make_unique<TextRecordParser>(2 * _options.amountOfPoints);
+		}
+
+		const bool last = block.index + 1 == file.blockCount;
+		file.parser->Feed(block.buffer, block.size);
+		file.report.bytes += block.size;
+		GiveBuffer(block.buffer);
+		if (last) {
+			file.parser->Finish();
+		}
+
+		switch (_options.amountOfPoints) {
+		case 4:
+			DeliverText<4>(file, block.file);
+			break;
+		case 5:
+			DeliverText<5>(file, block.file);
+			break;
+		default:
+			DeliverText<6>(file, block.file);
+			break;
+		}
+
+		return last;
+	}
+
+	template <uint64_t N>
+	void DeliverText(FileState& file, uint64_t index) {
+		const std::vector<double> values = file.parser->TakeValues();
+		AddErrors(file.report, file.parser->TakeErrors());
+		if (values.empty()) {
+			return;
+		}
+
+		FigureBatch<N> batch(values.size() / (2 * N));
+		std::array<Point, N> points;
+		for (uint64_t i = 0; i < values.size(); i += 2 * N) {
+			for (uint64_t j = 0; j < N; ++j) {
+				points[j] = Point(values[i + 2 * j], values[i + 2 * j + 1]);
+			}
+			batch.PushBack(points);
+		}
+		Deliver(file, index, std::move(batch));
+	}
+
+	void ProcessBinary(FileState& file, uint64_t index) {
+		const FigureFileReader reader(file.report.path);
+		file.report.binary = true;
+		file.report.bytes = reader.GetFileSize();
+		DeliverBinary<4>(file, index, reader);
+		DeliverBinary<5>(file, index, reader);
+		DeliverBinary<6>(file, index, reader);
+	}
+
+	template <uint64_t N>
+	void DeliverBinary(FileState& file, uint64_t index, const FigureFileReader& reader) {
+		const FigureRecordView<N> records = reader.GetRecords<N>();
+		for (uint64_t begin = 0; begin < records.Size() && !_stopped; begin += _options.chunkFigures) {
+			const uint64_t end = std::min<uint64_t>(begin + _options.chunkFigures, records.Size());
+			FigureBatch<N> batch(end - begin);
+			for (uint64_t i = begin; i < end; ++i) {
+				batch.PushBack(records[i]);
+			}
+			Deliver(file, index, std::move(batch));
+		}
+	}
+
+	template <uint64_t N>
+	void Deliver(FileState& file, uint64_t index, FigureBatch<N> batch) {
+		file.report.figureCount += batch.Size();
+		const uint64_t sequence = file.report.batchCount++;
+		if (!_sink(IngestBatch{index, sequence, std::move(batch)})) {
+			Stop();
+		}
+	}
+
+	void AddErrors(IngestFileReport& report, std::vector<ParseError> errors) const {
+		report.errorCount += errors.size();
+		for (ParseError& error : errors) {
+			if (report.errors.size() >= _options.maxErrors) {
+				break;
+			}
+			report.errors.push_back(std::move(error));
+		}
+	}
+
+	char* TryTakeBuffer() {
+		std::lock_guard<std::mutex> lock(_bufferMutex);
+		if (_free.empty()) {
+			return nullptr;
+		}
+		char* buffer = _free.back();
+		_free.pop_back();
+
+		return buffer;
+	}
+
+	void WaitForBuffer() {
+		std::unique_lock<std::mutex> lock(_bufferMutex);
+		_bufferReturned.wait(lock, [this]() { return !_free.empty() || _stopped; });
+	}
+
+	void GiveBuffer(char* buffer) {
+		if (buffer == nullptr) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(_bufferMutex);
+			_free.push_back(buffer);
+		}
+		_bufferReturned.notify_one();
+	}
+
+	// The first failure stops the run; later ones are dropped.
+	void Fail() {
+		{
+			std::lock_guard<std::mutex> lock(_errorMutex);
+			if (!_error) {
+				_error = std::current_exception();
+			}
+		}
+		Stop();
+	}
+
+	void Stop() {
+		{
+			std::lock_guard<std::mutex> lock(_bufferMutex);
+			_stopped = true;
+		}
+		_bufferReturned.notify_all();
+	}
+private:
+	const IngestOptions& _options;
+	BatchSink _sink;
+	uint64_t _bufferSize;
+	uint64_t _parserCount;
+	// Enough for every read in flight and a few waiting to be parsed. Any
+	// count would do: the block a parser waits for is always read before
+	// the ones it holds.
+	uint64_t _bufferCount;
+	std::vector<std::unique_ptr<FileState>> _files;
+	std::vector<char> _storage;
+	std::mutex _bufferMutex;
+	std::condition_variable _bufferReturned;
+	std::vector<char*> _free;
+	BoundedQueue<Block> _blocks;
+	std::atomic<bool> _stopped;
+	std::mutex _errorMutex;
+	std::exception_ptr _error;
+	// Declared after the buffers, so that it goes first.
+	std::unique_ptr<ReadEngine> _engine;
+	std::vector<InFlightRead> _reads;
+	std::vector<uint64_t> _freeSlots;
+	uint64_t _inFlight;
+};
+
+}
+
+const char* GetBackendName(IngestBackend backend) noexcept {
+	switch (backend) {
+	case IngestBackend::Automatic:
+		return "automatic";
+	case IngestBackend::IoUring:
+		return "io_uring";
+	case IngestBackend::ThreadPool:
+		return "thread pool";
+	}
+
+	return "unknown";
+}
+
+FigureIngest::FigureIngest(const IngestOptions& options) : _options(options) {
+	if (options.amountOfPoints < 4 || options.amountOfPoints > 6) {
+		throw std::invalid_argument("Unsupported amount of points");
+	}
+	if (options.readSize == 0 || options.readsInFlight == 0 || options.readerThreads == 0 ||
+		options.chunkFigures == 0) {
+		throw std::invalid_argument("Ingest sizes must be positive");
+	}
+	if (options.readSize > maxReadSize || options.readsInFlight > maxReadsInFlight) {
+		throw std::invalid_argument("Ingest sizes are too large");
+	}
+}
+
+IngestReport FigureIngest::Run(const std::vector<std::string>& paths, const BatchCallback& callback) {
+	IngestRun run(_options, paths, [&callback](IngestBatch batch) {
+		callback(std::move(batch));
+		return true;
+	});
+
+	return run.Execute();
+}
+
+IngestReport FigureIngest::Run(const std::vector<std::string>& paths, BoundedQueue<IngestBatch>& batches) {
+	IngestReport report;
+	try {
+		IngestRun run(_options, paths, [&batches](IngestBatch batch) { return batches.Push(std::move(batch)); });
+		report = run.Execute();
+	} catch (...) {
+		batches.Close();
+		throw;
+	}
+	batches.Close();
+
+	return report;
+}
+
+const IngestOptions& FigureIngest::GetOptions() const noexcept {
+	return _options;
+}
+
+bool FigureIngest::IsIoUringAvailable() {
+#ifdef FIGURES_IO_URING
+	try {
+		IoUringEngine engine(1);
+		return true;
+	} catch (const std::runtime_error&) {
+		return false;
+	}
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,221 @@
+#include "FigureKernels.h"
+#include "FigureKernelsImpl.h"
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+#include "FigureKernelsGeneric.h"
+
+static_assert(sizeof(Point) == 2 * sizeof(double), "Point must be laid out as two doubles");
+
+std::atomic<int> activeIsa(-1);
+
+const FigureKernelTable& GetKernelTable(KernelIsa isa) {
+	switch (isa) {
+#ifdef FIGURES_X86_KERNELS
+		case KernelIsa::Sse2:
+			return GetSse2Kernels();
+		case KernelIsa::Avx2:
+			return GetAvx2Kernels();
+		case KernelIsa::Avx512:
+			return GetAvx512Kernels();
+#endif
+		default:
+			return MakeKernelTable<ScalarOps>();
+	}
+}
+
+const FigureKernelTable& GetActiveKernels() {
+	return GetKernelTable(GetKernelIsa());
+}
+
+}
+
+const FigureKernelTable& GetScalarKernels() {
+	return MakeKernelTable<ScalarOps>();
+}
+
+bool IsKernelIsaSupported(KernelIsa isa) {
+	switch (isa) {
+		case KernelIsa::Scalar:
+			return true;
+#ifdef FIGURES_X86_KERNELS
+		case KernelIsa::Sse2:
+			return __builtin_cpu_supports("sse2");
+		case KernelIsa::Avx2:
+			return __builtin_cpu_supports("avx2");
+		case KernelIsa::Avx512:
+			return __builtin_cpu_supports("avx512f");
+#endif
+		default:
+			return false;
+	}
+}
+
+KernelIsa GetBestKernelIsa() {
+	for (KernelIsa isa : {KernelIsa::Avx512, KernelIsa::Avx2, KernelIsa::Sse2}) {
+		if (IsKernelIsaSupported(isa)) {
+			return isa;
+		}
+	}
+
+	return KernelIsa::Scalar;
+}
+
+KernelIsa GetKernelIsa() {
+	int isa = activeIsa.load(std::memory_order_relaxed);
+	if (isa < 0) {
+		isa = static_cast<int>(GetBestKernelIsa());
+		activeIsa.store(isa, std::memory_order_relaxed);
+	}
+
+	return static_cast<KernelIsa>(isa);
+}
+
+void SetKernelIsa(KernelIsa isa) {
+	if (!IsKernelIsaSupported(isa)) {
+		throw std::invalid_argument("Instruction set is not supported by this CPU");
+	}
+
+	activeIsa.store(static_cast<int>(isa), std::memory_order_relaxed);
+}
+
+const char* GetKernelIsaName(KernelIsa isa) {
+	switch (isa) {
+		case KernelIsa::Scalar:
+			return "scalar";
+		case KernelIsa::Sse2:
+			return "sse2";
+		case KernelIsa::Avx2:
+			return "avx2";
+		case KernelIsa::Avx512:
+			return "avx512";
+	}
+
+	return "unknown";
+}
+
+void ComputeSideLengths(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+						uint64_t count, double* const* sides) {
+	GetActiveKernels().sideLengths(amountOfPoints, xs, ys, count, sides);
+}
+
+void ComputeRhombusAreas(const double* const* xs, const double* const* ys, uint64_t count, double* areas) {
+	GetActiveKernels().rhombusAreas(xs, ys, count, areas);
+}
+
+void ComputeRegularPolygonAreas(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+								uint64_t count, double* areas) {
+	if (amountOfPoints < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+
+	GetActiveKernels().regularPolygonAreas(amountOfPoints, xs, ys, count, RegularPolygonAreaCoefficient(amountOfPoints), areas);
+}
+
+void ComputeShoelaceAreas(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+						  uint64_t count, double* areas) {
+	if (amountOfPoints < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+
+	GetActiveKernels().shoelaceAreas(amountOfPoints, xs, ys, count, areas);
+}
+
+void ComputeGeometricCenters(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+							 uint64_t count, Point* centers) {
+	GetActiveKernels().geometricCenters(amountOfPoints, xs, ys, count, reinterpret_cast<double*>(centers));
+}
+
+void ComputeFloatRhombusAreas(const float* const* xs, const float* const* ys, uint64_t count, double* areas) {
+	GetActiveKernels().floatRhombusAreas(xs, ys, count, areas);
+}
+
+void ComputeFloatRegularPolygonAreas(uint64_t amountOfPoints, const float* const* xs, const float* const* ys,
+									 uint64_t count, double* areas) {
+	if (amountOfPoints < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+
+	GetActiveKernels().floatRegularPolygonAreas(amountOfPoints, xs, ys, count, RegularPolygonAreaCoefficient(amountOfPoints),
+												areas);
+}
+
+void ComputeFloatShoelaceAreas(uint64_t amountOfPoints, const float* const* xs, const float* const* ys,
+							   uint64_t count, double* areas) {
+	if (amountOfPoints < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+
+	GetActiveKernels().floatShoelaceAreas(amountOfPoints, xs, ys, count, areas);
+}
+
+void ComputeFloatGeometricCenters(uint64_t amountOfPoints, const float* const* xs, const float* const* ys,
+								  uint64_t count, Point* centers) {
+	GetActiveKernels().floatGeometricCenters(amountOfPoints, xs, ys, count, reinterpret_cast<double*>(centers));
+}
+
+void ComputeFixedPointRhombusAreas(const int32_t* const* xs, const int32_t* const* ys, const Point& origin, double step,
+								   uint64_t count, double* areas) {
+	const double decoding[] = {origin.x, origin.y, step};
+	GetActiveKernels().fixedPointRhombusAreas(xs, ys, decoding, count, areas);
+}
+
+void ComputeFixedPointRegularPolygonAreas(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+										  const Point& origin, double step, uint64_t count, double* areas) {
+	if (amountOfPoints < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+
+	const double decoding[] = {origin.x, origin.y, step};
+	GetActiveKernels().fixedPointRegularPolygonAreas(amountOfPoints, xs, ys, decoding, count,
+													 RegularPolygonAreaCoefficient(amountOfPoints), areas);
+}
+
+void ComputeFixedPointShoelaceAreas(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+									const Point& origin, double step, uint64_t count, double* areas) {
+	if (amountOfPoints < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+
+	const double decoding[] = {origin.x, origin.y, step};
+	GetActiveKernels().fixedPointShoelaceAreas(amountOfPoints, xs, ys, decoding, count, areas);
+}
+
+void ComputeFixedPointGeometricCenters(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+									   const Point& origin, double step, uint64_t count, Point* centers) {
+	const double decoding[] = {origin.x, origin.y, step};
+	GetActiveKernels().fixedPointGeometricCenters(amountOfPoints, xs, ys, decoding, count, reinterpret_cast<double*>(centers));
+}
+
+void TransformPoints(const AffineTransform& transform, double* xs, double* ys, uint64_t count) {
+	const double matrix[] = {transform.a, transform.b, transform.tx, transform.c, transform.d, transform.ty};
+	GetActiveKernels().transformPoints(matrix, xs, ys, count);
+}
+
+void RotateAboutCenters(uint64_t amountOfPoints, double* const* xs, double* const* ys, uint64_t count, double angle) {
+	if (amountOfPoints == 0) {
+		throw std::invalid_argument("A figure needs points");
+	}
+
+	GetActiveKernels().rotateAboutCenters(amountOfPoints, xs, ys, count, FigureCos(angle), FigureSin(angle));
+}
+
+void ContainsPoints(const Point* outline, uint64_t amountOfPoints, const double* xs, const double* ys,
+					uint64_t count, uint8_t* inside) {
+	if (amountOfPoints < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+
+	BoundingBox bounds;
+	for (uint64_t i = 0; i < amountOfPoints; ++i) {
+		bounds.Expand(outline[i]);
+	}
+	const BoundingBox widened = ContainmentBox(bounds);
+	const double box[] = {widened.minX, widened.minY, widened.maxX, widened.maxY};
+
+	GetActiveKernels().containsPoints(reinterpret_cast<const double*>(outline), amountOfPoints, box,
+									  pointEpsilon * pointEpsilon, xs, ys, count, inside);
+}
@@ -0,0 +1,58 @@
+#include "FigureKernelsImpl.h"
+#include <cmath>
+#include <immintrin.h>
+
+namespace {
+
+#include "FigureKernelsGeneric.h"
+
+struct Avx2Ops {
+	using Vector = __m256d;
+	using Mask = __m256d;
+	static constexpr uint64_t width = 4;
+
+	static Vector Load(const double* source) { return _mm256_loadu_pd(source); }
+	static Vector LoadFloat(const float* source) { return _mm256_cvtps_pd(_mm_loadu_ps(source)); }
+	static Vector LoadInt32(const int32_t* source) {
+		return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+	}
+	static void Store(double* destination, Vector value) { _mm256_storeu_pd(destination, value); }
+	static Vector Set(double value) { return _mm256_set1_pd(value); }
+	static Vector Add(Vector lhs, Vector rhs) { return _mm256_add_pd(lhs, rhs); }
+	static Vector Sub(Vector lhs, Vector rhs) { return _mm256_sub_pd(lhs, rhs); }
+	static Vector Mul(Vector lhs, Vector rhs) { return _mm256_mul_pd(lhs, rhs); }
+	static Vector Div(Vector lhs, Vector rhs) { return _mm256_div_pd(lhs, rhs); }
+	static Vector Sqrt(Vector value) { return _mm256_sqrt_pd(value); }
+	static Vector Min(Vector lhs, Vector rhs) { return _mm256_min_pd(lhs, rhs); }
+	static Vector Abs(Vector value) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), value); }
+	static Vector ZeroIfNotPositive(Vector condition, Vector value) {
+		return _mm256_andnot_pd(_mm256_cmp_pd(condition, _mm256_setzero_pd(), _CMP_LE_OQ), value);
+	}
+	static void StoreInterleaved(double* destination, Vector xs, Vector ys) {
+		Vector low = _mm256_unpacklo_pd(xs, ys);
+		Vector high = _mm256_unpackhi_pd(xs, ys);
+		_mm256_storeu_pd(destination, _mm256_permute2f128_pd(low, high, 0x20));
+		_mm256_storeu_pd(destination + 4, _mm256_permute2f128_pd(low, high, 0x31));
+	}
+
+	static Mask None() { return _mm256_setzero_pd(); }
+	static Mask Less(Vector lhs, Vector rhs) { return _mm256_cmp_pd(lhs, rhs, _CMP_LT_OQ); }
+	static Mask LessEqual(Vector lhs, Vector rhs) { return _mm256_cmp_pd(lhs, rhs, _CMP_LE_OQ); }
+	static Mask And(Mask lhs, Mask rhs) { return _mm256_and_pd(lhs, rhs); }
+	static Mask AndNot(Mask lhs, Mask rhs) { return _mm256_andnot_pd(lhs, rhs); }
+	static Mask Or(Mask lhs, Mask rhs) { return _mm256_or_pd(lhs, rhs); }
+	static Mask Xor(Mask lhs, Mask rhs) { return _mm256_xor_pd(lhs, rhs); }
+	static bool Any(Mask mask) { return _mm256_movemask_pd(mask) != 0; }
+	static void StoreMask(uint8_t* destination, Mask mask) {
+		int bits = _mm256_movemask_pd(mask);
+		for (int i = 0; i < 4; ++i) {
+			destination[i] = (bits >> i) & 1;
+		}
+	}
+};
+
+}
+
+const FigureKernelTable& GetAvx2Kernels() {
+	return MakeKernelTable<Avx2Ops>();
+}
@@ -0,0 +1,58 @@
+#include "FigureKernelsImpl.h"
+#include <cmath>
+#include <immintrin.h>
+
+namespace {
+
+#include "FigureKernelsGeneric.h"
+
+struct Avx512Ops {
+	using Vector = __m512d;
+	using Mask = __mmask8;
+	static constexpr uint64_t width = 8;
+
+	static Vector Load(const double* source) { return _mm512_loadu_pd(source); }
+	static Vector LoadFloat(const float* source) { return _mm512_cvtps_pd(_mm256_loadu_ps(source)); }
+	static Vector LoadInt32(const int32_t* source) {
+		return _mm512_cvtepi32_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)));
+	}
+	static void Store(double* destination, Vector value) { _mm512_storeu_pd(destination, value); }
+	static Vector Set(double value) { return _mm512_set1_pd(value); }
+	static Vector Add(Vector lhs, Vector rhs) { return _mm512_add_pd(lhs, rhs); }
+	static Vector Sub(Vector lhs, Vector rhs) { return _mm512_sub_pd(lhs, rhs); }
+	static Vector Mul(Vector lhs, Vector rhs) { return _mm512_mul_pd(lhs, rhs); }
+	static Vector Div(Vector lhs, Vector rhs) { return _mm512_div_pd(lhs, rhs); }
+	static Vector Sqrt(Vector value) { return _mm512_sqrt_pd(value); }
+	static Vector Min(Vector lhs, Vector rhs) { return _mm512_min_pd(lhs, rhs); }
+	static Vector Abs(Vector value) { return _mm512_abs_pd(value); }
+	static Vector ZeroIfNotPositive(Vector condition, Vector value) {
+		__mmask8 notPositive = _mm512_cmp_pd_mask(condition, _mm512_setzero_pd(), _CMP_LE_OQ);
+		return _mm512_mask_blend_pd(notPositive, value, _mm512_setzero_pd());
+	}
+	static void StoreInterleaved(double* destination, Vector xs, Vector ys) {
+		const __m512i lowIndices = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+		const __m512i highIndices = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+		_mm512_storeu_pd(destination, _mm512_permutex2var_pd(xs, lowIndices, ys));
+		_mm512_storeu_pd(destination + 8, _mm512_permutex2var_pd(xs, highIndices, ys));
+	}
+
+	static Mask None() { return 0; }
+	static Mask Less(Vector lhs, Vector rhs) { return _mm512_cmp_pd_mask(lhs, rhs, _CMP_LT_OQ); }
+	static Mask LessEqual(Vector lhs, Vector rhs) { return _mm512_cmp_pd_mask(lhs, rhs, _CMP_LE_OQ); }
+	static Mask And(Mask lhs, Mask rhs) { return lhs & rhs; }
+	static Mask AndNot(Mask lhs, Mask rhs) { return ~lhs & rhs; }
+	static Mask Or(Mask lhs, Mask rhs) { return lhs | rhs; }
+	static Mask Xor(Mask lhs, Mask rhs) { return lhs ^ rhs; }
+	static bool Any(Mask mask) { return mask != 0; }
+	static void StoreMask(uint8_t* destination, Mask mask) {
+		for (int i = 0; i < 8; ++i) {
+			destination[i] = (mask >> i) & 1;
+		}
+	}
+};
+
+}
+
+const FigureKernelTable& GetAvx512Kernels() {
+	return MakeKernelTable<Avx512Ops>();
+}
@@ -0,0 +1,416 @@
+#ifndef FIGURE_KERNELS_GENERIC_H
+#define FIGURE_KERNELS_GENERIC_H
+
+// Width-generic kernel bodies. Each instruction set translation unit includes
+// this file inside an anonymous namespace and instantiates the templates with
+// its own Ops, so nothing compiled for a wider instruction set can leak into
+// code that runs on a CPU without it. Ops provides the element-wise
+// operations; the remainder that does not fill a whole vector goes through
+// ScalarOps, which performs the very same operations one double at a time.
+// Comparisons give an Ops::Mask with one flag per element; StoreMask writes
+// them out as bytes that are 0 or 1. LoadFloat and LoadInt32 widen float32
+// and int32 values to doubles, which is exact for both.
+// The includer brings in <cmath> and FigureKernelsImpl.h beforehand.
+
+struct ScalarOps {
+	using Vector = double;
+	using Mask = bool;
+	static constexpr uint64_t width = 1;
+
+	static Vector Load(const double* source) { return *source; }
+	static Vector LoadFloat(const float* source) { return *source; }
+	static Vector LoadInt32(const int32_t* source) { return *source; }
+	static void Store(double* destination, Vector value) { *destination = value; }
+	static Vector Set(double value) { return value; }
+	static Vector Add(Vector lhs, Vector rhs) { return lhs + rhs; }
+	static Vector Sub(Vector lhs, Vector rhs) { return lhs - rhs; }
+	static Vector Mul(Vector lhs, Vector rhs) { return lhs * rhs; }
+	static Vector Div(Vector lhs, Vector rhs) { return lhs / rhs; }
+	static Vector Sqrt(Vector value) { return sqrt(value); }
+	static Vector Min(Vector lhs, Vector rhs) { return lhs < rhs ? lhs : rhs; }
+	static Vector Abs(Vector value) { return fabs(value); }
+	static Vector ZeroIfNotPositive(Vector condition, Vector value) { return condition <= 0 ? 0 : value; }
+	static void StoreInterleaved(double* destination, Vector xs, Vector ys) {
+		destination[0] = xs;
+		destination[1] = ys;
+	}
+
+	static Mask None() { return false; }
+	static Mask Less(Vector lhs, Vector rhs) { return lhs < rhs; }
+	static Mask LessEqual(Vector lhs, Vector rhs) { return lhs <= rhs; }
+	static Mask And(Mask lhs, Mask rhs) { return lhs && rhs; }
+	static Mask AndNot(Mask lhs, Mask rhs) { return !lhs && rhs; }
+	static Mask Or(Mask lhs, Mask rhs) { return lhs || rhs; }
+	static Mask Xor(Mask lhs, Mask rhs) { return lhs != rhs; }
+	static bool Any(Mask mask) { return mask; }
+	static void StoreMask(uint8_t* destination, Mask mask) { *destination = mask; }
+};
+
+// Fixed-point coordinates: value q stands for origin + step * q.
+struct FixedPointCoordinates {
+	const int32_t* const* values;
+	double origin;
+	double step;
+};
+
+// The area and center kernels read vertex i through LoadVertex, so they run
+// unchanged on double, float32 and fixed-point coordinates. Compact values
+// are decoded to exactly the doubles the batches decode them to per figure.
+template <typename Ops>
+typename Ops::Vector LoadVertex(const double* const* values, uint64_t i, uint64_t offset) {
+	return Ops::Load(values[i] + offset);
+}
+
+template <typename Ops>
+typename Ops::Vector LoadVertex(const float* const* values, uint64_t i, uint64_t offset) {
+	return Ops::LoadFloat(values[i] + offset);
+}
+
+template <typename Ops>
+typename Ops::Vector LoadVertex(const FixedPointCoordinates& coordinates, uint64_t i, uint64_t offset) {
+	return Ops::Add(Ops::Set(coordinates.origin), Ops::Mul(Ops::Set(coordinates.step), Ops::LoadInt32(coordinates.values[i] + offset)));
+}
+
+template <typename Ops, typename Coordinates>
+typename Ops::Vector Distance(const Coordinates& xs, const Coordinates& ys, uint64_t first, uint64_t second, uint64_t offset) {
+	typename Ops::Vector dx = Ops::Sub(LoadVertex<Ops>(xs, first, offset), LoadVertex<Ops>(xs, second, offset));
+	typename Ops::Vector dy = Ops::Sub(LoadVertex<Ops>(ys, first, offset), LoadVertex<Ops>(ys, second, offset));
+
+	return Ops::Sqrt(Ops::Add(Ops::Mul(dx, dx), Ops::Mul(dy, dy)));
+}
+
+template <typename Ops>
+void SideLengthsBlock(uint64_t amountOfPoints, const double* const* xs, const double* const* ys, uint64_t offset, double* const* sides) {
+	for (uint64_t i = 0; i < amountOfPoints; ++i) {
+		uint64_t next = i + 1 == amountOfPoints ? 0 : i + 1;
+		Ops::Store(sides[i] + offset, Distance<Ops>(xs, ys, i, next, offset));
+	}
+}
+
+template <typename Ops, typename Coordinates>
+void RhombusAreasBlock(const Coordinates& xs, const Coordinates& ys, uint64_t offset, double* areas) {
+	typename Ops::Vector firstSide = Distance<Ops>(xs, ys, 0, 1, offset);
+	typename Ops::Vector secondSide = Distance<Ops>(xs, ys, 0, 2, offset);
+	typename Ops::Vector thirdSide = Distance<Ops>(xs, ys, 2, 1, offset);
+
+	typename Ops::Vector halfOfPerimeter = Ops::Div(Ops::Add(Ops::Add(firstSide, secondSide), thirdSide), Ops::Set(2.0));
+	typename Ops::Vector product = Ops::Mul(Ops::Mul(Ops::Mul(halfOfPerimeter, Ops::Sub(halfOfPerimeter, firstSide)),
+													 Ops::Sub(halfOfPerimeter, secondSide)),
+											Ops::Sub(halfOfPerimeter, thirdSide));
+
+	Ops::Store(areas + offset, Ops::Mul(Ops::Set(2.0), Ops::Sqrt(product)));
+}
+
+template <typename Ops, typename Coordinates>
+void RegularPolygonAreasBlock(uint64_t amountOfPoints, const Coordinates& xs, const Coordinates& ys, uint64_t offset,
+							  double coefficient, double* areas) {
+	typename Ops::Vector minSide = Distance<Ops>(xs, ys, 0, amountOfPoints - 1, offset);
+	for (uint64_t i = 0; i < amountOfPoints - 1; ++i) {
+		minSide = Ops::Min(Distance<Ops>(xs, ys, i, i + 1, offset), minSide);
+	}
+
+	typename Ops::Vector area = Ops::Mul(Ops::Mul(Ops::Set(coefficient), minSide), minSide);
+
+	Ops::Store(areas + offset, Ops::ZeroIfNotPositive(minSide, area));
+}
+
+template <typename Ops, typename Coordinates>
+void ShoelaceAreasBlock(uint64_t amountOfPoints, const Coordinates& xs, const Coordinates& ys, uint64_t offset, double* areas) {
+	typename Ops::Vector firstX = LoadVertex<Ops>(xs, 0, offset);
+	typename Ops::Vector firstY = LoadVertex<Ops>(ys, 0, offset);
+	typename Ops::Vector twiceArea = Ops::Set(0);
+
+	for (uint64_t i = 1; i + 1 < amountOfPoints; ++i) {
+		typename Ops::Vector term = Ops::Sub(
+			Ops::Mul(Ops::Sub(LoadVertex<Ops>(xs, i, offset), firstX), Ops::Sub(LoadVertex<Ops>(ys, i + 1, offset), firstY)),
+			Ops::Mul(Ops::Sub(LoadVertex<Ops>(xs, i + 1, offset), firstX), Ops::Sub(LoadVertex<Ops>(ys, i, offset), firstY)));
+		twiceArea = Ops::Add(twiceArea, term);
+	}
+
+	Ops::Store(areas + offset, Ops::Div(Ops::Abs(twiceArea), Ops::Set(2.0)));
+}
+
+template <typename Ops, typename Coordinates>
+void GeometricCentersBlock(uint64_t amountOfPoints, const Coordinates& xs, const Coordinates& ys, uint64_t offset, double* centers) {
+	typename Ops::Vector xCenterCoord = Ops::Set(0);
+	typename Ops::Vector yCenterCoord = Ops::Set(0);
+
+	for (uint64_t i = 0; i < amountOfPoints; ++i) {
+		xCenterCoord = Ops::Add(xCenterCoord, LoadVertex<Ops>(xs, i, offset));
+		yCenterCoord = Ops::Add(yCenterCoord, LoadVertex<Ops>(ys, i, offset));
+	}
+
+	typename Ops::Vector divisor = Ops::Set(static_cast<double>(amountOfPoints));
+	Ops::StoreInterleaved(centers + 2 * offset, Ops::Div(xCenterCoord, divisor), Ops::Div(yCenterCoord, divisor));
+}
+
+template <typename Ops>
+void TransformPointsBlock(const double* matrix, double* xs, double* ys, uint64_t offset) {
+	typename Ops::Vector x = Ops::Load(xs + offset);
+	typename Ops::Vector y = Ops::Load(ys + offset);
+
+	Ops::Store(xs + offset, Ops::Add(Ops::Add(Ops::Mul(Ops::Set(matrix[0]), x), Ops::Mul(Ops::Set(matrix[1]), y)),
+									 Ops::Set(matrix[2])));
+	Ops::Store(ys + offset, Ops::Add(Ops::Add(Ops::Mul(Ops::Set(matrix[3]), x), Ops::Mul(Ops::Set(matrix[4]), y)),
+									 Ops::Set(matrix[5])));
+}
+
+template <typename Ops>
+void RotateAboutCentersBlock(uint64_t amountOfPoints, double* const* xs, double* const* ys, uint64_t offset,
+							 double cosine, double sine) {
+	typename Ops::Vector xCenterCoord = Ops::Set(0);
+	typename Ops::Vector yCenterCoord = Ops::Set(0);
+
+	for (uint64_t i = 0; i < amountOfPoints; ++i) {
+		xCenterCoord = Ops::Add(xCenterCoord, Ops::Load(xs[i] + offset));
+		yCenterCoord = Ops::Add(yCenterCoord, Ops::Load(ys[i] + offset));
+	}
+
+	typename Ops::Vector divisor = Ops::Set(static_cast<double>(amountOfPoints));
+	xCenterCoord = Ops::Div(xCenterCoord, divisor);
+	yCenterCoord = Ops::Div(yCenterCoord, divisor);
+
+	typename Ops::Vector cosines = Ops::Set(cosine);
+	typename Ops::Vector sines = Ops::Set(sine);
+	for (uint64_t i = 0; i < amountOfPoints; ++i) {
+		typename Ops::Vector dx = Ops::Sub(Ops::Load(xs[i] + offset), xCenterCoord);
+		typename Ops::Vector dy = Ops::Sub(Ops::Load(ys[i] + offset), yCenterCoord);
+
+		Ops::Store(xs[i] + offset, Ops::Add(xCenterCoord, Ops::Sub(Ops::Mul(cosines, dx), Ops::Mul(sines, dy))));
+		Ops::Store(ys[i] + offset, Ops::Add(yCenterCoord, Ops::Add(Ops::Mul(sines, dx), Ops::Mul(cosines, dy))));
+	}
+}
+
+// box holds minX, minY, maxX, maxY of the outline widened by the epsilon;
+// blocks with no point inside it skip the edge tests.
+template <typename Ops>
+void ContainsPointsBlock(const double* outline, uint64_t amountOfPoints, const double* box, double squaredEpsilon,
+						 const double* xs, const double* ys, uint64_t offset, uint8_t* inside) {
+	typename Ops::Vector x = Ops::Load(xs + offset);
+	typename Ops::Vector y = Ops::Load(ys + offset);
+	typename Ops::Mask inBox = Ops::And(Ops::And(Ops::LessEqual(Ops::Set(box[0]), x), Ops::LessEqual(x, Ops::Set(box[2]))),
+										Ops::And(Ops::LessEqual(Ops::Set(box[1]), y), Ops::LessEqual(y, Ops::Set(box[3]))));
+	if (!Ops::Any(inBox)) {
+		Ops::StoreMask(inside + offset, inBox);
+		return;
+	}
+
+	typename Ops::Vector zero = Ops::Set(0);
+	typename Ops::Mask crossings = Ops::None();
+	typename Ops::Mask onOutline = Ops::None();
+	for (uint64_t i = 0; i < amountOfPoints; ++i) {
+		uint64_t next = i + 1 == amountOfPoints ? 0 : i + 1;
+		double firstX = outline[2 * i];
+		double firstY = outline[2 * i + 1];
+		double edgeX = outline[2 * next] - firstX;
+		double edgeY = outline[2 * next + 1] - firstY;
+		double squaredLength = edgeX * edgeX + edgeY * edgeY;
+
+		typename Ops::Vector offsetX = Ops::Sub(x, Ops::Set(firstX));
+		typename Ops::Vector offsetY = Ops::Sub(y, Ops::Set(firstY));
+		typename Ops::Vector cross = Ops::Sub(Ops::Mul(Ops::Set(edgeX), offsetY), Ops::Mul(Ops::Set(edgeY), offsetX));
+		typename Ops::Vector dot = Ops::Add(Ops::Mul(Ops::Set(edgeX), offsetX), Ops::Mul(Ops::Set(edgeY), offsetY));
+
+		typename Ops::Mask straddles = Ops::Xor(Ops::Less(y, Ops::Set(firstY)), Ops::Less(y, Ops::Set(outline[2 * next + 1])));
+		typename Ops::Mask crosses = edgeY > 0 ? Ops::Less(zero, cross) : Ops::Less(cross, zero);
+		crossings = Ops::Xor(crossings, Ops::And(straddles, crosses));
+
+		typename Ops::Mask nearVertex = Ops::Less(Ops::Add(Ops::Mul(offsetX, offsetX), Ops::Mul(offsetY, offsetY)),
+												  Ops::Set(squaredEpsilon));
+		typename Ops::Mask nearEdge = Ops::And(Ops::Less(dot, Ops::Set(squaredLength)),
+											   Ops::Less(Ops::Mul(cross, cross), Ops::Set(squaredEpsilon * squaredLength)));
+		typename Ops::Mask pastFirst = Ops::LessEqual(dot, zero);
+		onOutline = Ops::Or(onOutline, Ops::Or(Ops::And(pastFirst, nearVertex), Ops::AndNot(pastFirst, nearEdge)));
+	}
+
+	Ops::StoreMask(inside + offset, Ops::And(inBox, Ops::Or(crossings, onOutline)));
+}
+
+template <typename Ops>
+void SideLengths(uint64_t amountOfPoints, const double* const* xs, const double* const* ys, uint64_t count, double* const* sides) {
+	uint64_t j = 0;
+	for (; j + Ops::width <= count; j += Ops::width) {
+		SideLengthsBlock<Ops>(amountOfPoints, xs, ys, j, sides);
+	}
+	for (; j < count; ++j) {
+		SideLengthsBlock<ScalarOps>(amountOfPoints, xs, ys, j, sides);
+	}
+}
+
+template <typename Ops, typename Coordinates>
+void RhombusAreas(const Coordinates& xs, const Coordinates& ys, uint64_t count, double* areas) {
+	uint64_t j = 0;
+	for (; j + Ops::width <= count; j += Ops::width) {
+		RhombusAreasBlock<Ops>(xs, ys, j, areas);
+	}
+	for (; j < count; ++j) {
+		RhombusAreasBlock<ScalarOps>(xs, ys, j, areas);
+	}
+}
+
+template <typename Ops, typename Coordinates>
+void RegularPolygonAreas(uint64_t amountOfPoints, const Coordinates& xs, const Coordinates& ys, uint64_t count,
+						 double coefficient, double* areas) {
+	uint64_t j = 0;
+	for (; j + Ops::width <= count; j += Ops::width) {
+		RegularPolygonAreasBlock<Ops>(amountOfPoints, xs, ys, j, coefficient, areas);
+	}
+	for (; j < count; ++j) {
+		RegularPolygonAreasBlock<ScalarOps>(amountOfPoints, xs, ys, j, coefficient, areas);
+	}
+}
+
+template <typename Ops, typename Coordinates>
+void ShoelaceAreas(uint64_t amountOfPoints, const Coordinates& xs, const Coordinates& ys, uint64_t count, double* areas) {
+	uint64_t j = 0;
+	for (; j + Ops::width <= count; j += Ops::width) {
+		ShoelaceAreasBlock<Ops>(amountOfPoints, xs, ys, j, areas);
+	}
+	for (; j < count; ++j) {
+		ShoelaceAreasBlock<ScalarOps>(amountOfPoints, xs, ys, j, areas);
+	}
+}
+
+template <typename Ops, typename Coordinates>
+void GeometricCenters(uint64_t amountOfPoints, const Coordinates& xs, const Coordinates& ys, uint64_t count, double* centers) {
+	uint64_t j = 0;
+	for (; j + Ops::width <= count; j += Ops::width) {
+		GeometricCentersBlock<Ops>(amountOfPoints, xs, ys, j, centers);
+	}
+	for (; j < count; ++j) {
+		GeometricCentersBlock<ScalarOps>(amountOfPoints, xs, ys, j, centers);
+	}
+}
+
+template <typename Ops>
+void TransformPoints(const double* matrix, double* xs, double* ys, uint64_t count) {
+	uint64_t j = 0;
+	for (; j + Ops::width <= count; j += Ops::width) {
+		TransformPointsBlock<Ops>(matrix, xs, ys, j);
+	}
+	for (; j < count; ++j) {
+		TransformPointsBlock<ScalarOps>(matrix, xs, ys, j);
+	}
+}
+
+template <typename Ops>
+void RotateAboutCenters(uint64_t amountOfPoints, double* const* xs, double* const* ys, uint64_t count,
+						double cosine, double sine) {
+	uint64_t j = 0;
+	for (; j + Ops::width <= count; j += Ops::width) {
+		RotateAboutCentersBlock<Ops>(amountOfPoints, xs, ys, j, cosine, sine);
+	}
+	for (; j < count; ++j) {
+		RotateAboutCentersBlock<ScalarOps>(amountOfPoints, xs, ys, j, cosine, sine);
+	}
+}
+
+template <typename Ops>
+void ContainsPoints(const double* outline, uint64_t amountOfPoints, const double* box, double squaredEpsilon,
+					const double* xs, const double* ys, uint64_t count, uint8_t* inside) {
+	uint64_t j = 0;
+	for (; j + Ops::width <= count; j += Ops::width) {
+		ContainsPointsBlock<Ops>(outline, amountOfPoints, box, squaredEpsilon, xs, ys, j, inside);
+	}
+	for (; j < count; ++j) {
+		ContainsPointsBlock<ScalarOps>(outline, amountOfPoints, box, squaredEpsilon, xs, ys, j, inside);
+	}
+}
+
+// Entry points with the signatures of the kernel table. The double ones are
+// instantiated at the table below.
+template <typename Ops>
+void DoubleRhombusAreas(const double* const* xs, const double* const* ys, uint64_t count, double* areas) {
+	RhombusAreas<Ops>(xs, ys, count, areas);
+}
+
+template <typename Ops>
+void DoubleRegularPolygonAreas(uint64_t amountOfPoints, const double* const* xs, const double* const* ys, uint64_t count,
+							   double coefficient, double* areas) {
+	RegularPolygonAreas<Ops>(amountOfPoints, xs, ys, count, coefficient, areas);
+}
+
+template <typename Ops>
+void DoubleShoelaceAreas(uint64_t amountOfPoints, const double* const* xs, const double* const* ys, uint64_t count, double* areas) {
+	ShoelaceAreas<Ops>(amountOfPoints, xs, ys, count, areas);
+}
+
+template <typename Ops>
+void DoubleGeometricCenters(uint64_t amountOfPoints, const double* const* xs, const double* const* ys, uint64_t count, double* centers) {
+	GeometricCenters<Ops>(amountOfPoints, xs, ys, count, centers);
+}
+
+template <typename Ops>
+void FloatRhombusAreas(const float* const* xs, const float* const* ys, uint64_t count, double* areas) {
+	RhombusAreas<Ops>(xs, ys, count, areas);
+}
+
+template <typename Ops>
+void FloatRegularPolygonAreas(uint64_t amountOfPoints, const float* const* xs, const float* const* ys, uint64_t count,
+							  double coefficient, double* areas) {
+	RegularPolygonAreas<Ops>(amountOfPoints, xs, ys, count, coefficient, areas);
+}
+
+template <typename Ops>
+void FloatShoelaceAreas(uint64_t amountOfPoints, const float* const* xs, const float* const* ys, uint64_t count, double* areas) {
+	ShoelaceAreas<Ops>(amountOfPoints, xs, ys, count, areas);
+}
+
+template <typename Ops>
+void FloatGeometricCenters(uint64_t amountOfPoints, const float* const* xs, const float* const* ys, uint64_t count, double* centers) {
+	GeometricCenters<Ops>(amountOfPoints, xs, ys, count, centers);
+}
+
+template <typename Ops>
+void FixedPointRhombusAreas(const int32_t* const* xs, const int32_t* const* ys, const double* decoding, uint64_t count,
+							double* areas) {
+	RhombusAreas<Ops>(FixedPointCoordinates{xs, decoding[0], decoding[2]}, FixedPointCoordinates{ys, decoding[1], decoding[2]},
+					  count, areas);
+}
+
+template <typename Ops>
+void FixedPointRegularPolygonAreas(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+								   const double* decoding, uint64_t count, double coefficient, double* areas) {
+	RegularPolygonAreas<Ops>(amountOfPoints, FixedPointCoordinates{xs, decoding[0], decoding[2]},
+							 FixedPointCoordinates{ys, decoding[1], decoding[2]}, count, coefficient, areas);
+}
+
+template <typename Ops>
+void FixedPointShoelaceAreas(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+							 const double* decoding, uint64_t count, double* areas) {
+	ShoelaceAreas<Ops>(amountOfPoints, FixedPointCoordinates{xs, decoding[0], decoding[2]},
+					   FixedPointCoordinates{ys, decoding[1], decoding[2]}, count, areas);
+}
+
+template <typename Ops>
+void FixedPointGeometricCenters(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+								const double* decoding, uint64_t count, double* centers) {
+	GeometricCenters<Ops>(amountOfPoints, FixedPointCoordinates{xs, decoding[0], decoding[2]},
+						  FixedPointCoordinates{ys, decoding[1], decoding[2]}, count, centers);
+}
+
+template <typename Ops>
+const FigureKernelTable& MakeKernelTable() {
+	static const FigureKernelTable table = {
+		&SideLengths<Ops>,
+		&DoubleRhombusAreas<Ops>,
+		&DoubleRegularPolygonAreas<Ops>,
+		&DoubleShoelaceAreas<Ops>,
+		&DoubleGeometricCenters<Ops>,
+		&TransformPoints<Ops>,
+		&RotateAboutCenters<Ops>,
+		&ContainsPoints<Ops>,
+		&FloatRhombusAreas<Ops>,
+		&FloatRegularPolygonAreas<Ops>,
+		&FloatShoelaceAreas<Ops>,
+		&FloatGeometricCenters<Ops>,
+		&FixedPointRhombusAreas<Ops>,
+		&FixedPointRegularPolygonAreas<Ops>,
+		&FixedPointShoelaceAreas<Ops>,
+		&FixedPointGeometricCenters<Ops>
+	};
+
+	return table;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef FIGURE_KERNELS_IMPL_H
+#define FIGURE_KERNELS_IMPL_H
+
+#include <cinttypes>
+
+// Per-instruction-set entry points behind the dispatcher in FigureKernels.cpp.
+// Centers are written interleaved as x0 y0 x1 y1 ..., which is the layout of
+// an array of Point.
+struct FigureKernelTable {
+	void (*sideLengths)(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+						uint64_t count, double* const* sides);
+	void (*rhombusAreas)(const double* const* xs, const double* const* ys, uint64_t count, double* areas);
+	void (*regularPolygonAreas)(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+								uint64_t count, double coefficient, double* areas);
+	void (*shoelaceAreas)(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+						  uint64_t count, double* areas);
+	void (*geometricCenters)(uint64_t amountOfPoints, const double* const* xs, const double* const* ys,
+							 uint64_t count, double* centers);
+	// matrix holds a, b, tx, c, d, ty of an AffineTransform.
+	void (*transformPoints)(const double* matrix, double* xs, double* ys, uint64_t count);
+	void (*rotateAboutCenters)(uint64_t amountOfPoints, double* const* xs, double* const* ys, uint64_t count,
+							   double cosine, double sine);
+	// outline holds x0 y0 x1 y1 ..., box minX, minY, maxX, maxY.
+	void (*containsPoints)(const double* outline, uint64_t amountOfPoints, const double* box, double squaredEpsilon,
+						   const double* xs, const double* ys, uint64_t count, uint8_t* inside);
+	// The area and center kernels again on float32 and fixed-point
+	// coordinates. decoding holds the origin x, origin y and step of the
+	// fixed-point ones.
+	void (*floatRhombusAreas)(const float* const* xs, const float* const* ys, uint64_t count, double* areas);
+	void (*floatRegularPolygonAreas)(uint64_t amountOfPoints, const float* const* xs, const float* const* ys,
+									 uint64_t count, double coefficient, double* areas);
+	void (*floatShoelaceAreas)(uint64_t amountOfPoints, const float* const* xs, const float* const* ys,
+							   uint64_t count, double* areas);
+	void (*floatGeometricCenters)(uint64_t amountOfPoints, const float* const* xs, const float* const* ys,
+								  uint64_t count, double* centers);
+	void (*fixedPointRhombusAreas)(const int32_t* const* xs, const int32_t* const* ys, const double* decoding,
+								   uint64_t count, double* areas);
+	void (*fixedPointRegularPolygonAreas)(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+										  const double* decoding, uint64_t count, double coefficient, double* areas);
+	void (*fixedPointShoelaceAreas)(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+									const double* decoding, uint64_t count, double* areas);
+	void (*fixedPointGeometricCenters)(uint64_t amountOfPoints, const int32_t* const* xs, const int32_t* const* ys,
+									   const double* decoding, uint64_t count, double* centers);
+};
+
+const FigureKernelTable& GetScalarKernels();
+
+#ifdef FIGURES_X86_KERNELS
+const FigureKernelTable& GetSse2Kernels();
+const FigureKernelTable& GetAvx2Kernels();
+const FigureKernelTable& GetAvx512Kernels();
+#endif
+
+#endif
@@ -0,0 +1,57 @@
+#include "FigureKernelsImpl.h"
+#include <cmath>
+#include <emmintrin.h>
+
+namespace {
+
+#include "FigureKernelsGeneric.h"
+
+struct Sse2Ops {
+	using Vector = __m128d;
+	using Mask = __m128d;
+	static constexpr uint64_t width = 2;
+
+	static Vector Load(const double* source) { return _mm_loadu_pd(source); }
+	static Vector LoadFloat(const float* source) {
+		return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source))));
+	}
+	static Vector LoadInt32(const int32_t* source) {
+		return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+	}
+	static void Store(double* destination, Vector value) { _mm_storeu_pd(destination, value); }
+	static Vector Set(double value) { return _mm_set1_pd(value); }
+	static Vector Add(Vector lhs, Vector rhs) { return _mm_add_pd(lhs, rhs); }
+	static Vector Sub(Vector lhs, Vector rhs) { return _mm_sub_pd(lhs, rhs); }
+	static Vector Mul(Vector lhs, Vector rhs) { return _mm_mul_pd(lhs, rhs); }
+	static Vector Div(Vector lhs, Vector rhs) { return _mm_div_pd(lhs, rhs); }
+	static Vector Sqrt(Vector value) { return _mm_sqrt_pd(value); }
+	static Vector Min(Vector lhs, Vector rhs) { return _mm_min_pd(lhs, rhs); }
+	static Vector Abs(Vector value) { return _mm_andnot_pd(_mm_set1_pd(-0.0), value); }
+	static Vector ZeroIfNotPositive(Vector condition, Vector value) {
+		return _mm_andnot_pd(_mm_cmple_pd(condition, _mm_setzero_pd()), value);
+	}
+	static void StoreInterleaved(double* destination, Vector xs, Vector ys) {
+		_mm_storeu_pd(destination, _mm_unpacklo_pd(xs, ys));
+		_mm_storeu_pd(destination + 2, _mm_unpackhi_pd(xs, ys));
+	}
+
+	static Mask None() { return _mm_setzero_pd(); }
+	static Mask Less(Vector lhs, Vector rhs) { return _mm_cmplt_pd(lhs, rhs); }
+	static Mask LessEqual(Vector lhs, Vector rhs) { return _mm_cmple_pd(lhs, rhs); }
+	static Mask And(Mask lhs, Mask rhs) { return _mm_and_pd(lhs, rhs); }
+	static Mask AndNot(Mask lhs, Mask rhs) { return _mm_andnot_pd(lhs, rhs); }
+	static Mask Or(Mask lhs, Mask rhs) { return _mm_or_pd(lhs, rhs); }
+	static Mask Xor(Mask lhs, Mask rhs) { return _mm_xor_pd(lhs, rhs); }
+	static bool Any(Mask mask) { return _mm_movemask_pd(mask) != 0; }
+	static void StoreMask(uint8_t* destination, Mask mask) {
+		int bits = _mm_movemask_pd(mask);
+		destination[0] = bits & 1;
+		destination[1] = (bits >> 1) & 1;
+	}
+};
+
+}
+
+const FigureKernelTable& GetSse2Kernels() {
+	return MakeKernelTable<Sse2Ops>();
+}
@@ -0,0 +1,310 @@
+#include "FigureMetrics.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+constexpr std::array<const char*, metricCounterCount> counterNames = {
+	"records_parsed", "parse_errors", "figures_serialized", "area_computations", "center_computations",
+	"comparisons", "copies", "moves", "arena_allocations", "arena_block_allocations"};
+
+constexpr std::array<const char*, metricStageCount> stageNames = {
+	"parse", "serialize", "flush", "areas", "centers", "classify"};
+
+constexpr std::array<double, 3> reportedQuantiles = {0.5, 0.9, 0.99};
+constexpr std::array<const char*, 3> quantileNames = {"p50_ns", "p90_ns", "p99_ns"};
+
+struct ThreadStage {
+	std::atomic<uint64_t> calls;
+	std::atomic<uint64_t> items;
+	std::atomic<uint64_t> totalNanoseconds;
+	std::array<std::atomic<uint64_t>, latencyBucketCount> buckets;
+};
+
+// Written by its own thread only, so an update is a plain load and store
+// rather than a locked read-modify-write; the atomics just let snapshots
+// read the values while they change.
+struct alignas(64) ThreadMetrics {
+	std::array<std::atomic<uint64_t>, metricCounterCount> counters;
+	std::array<ThreadStage, metricStageCount> stages;
+};
+
+void Bump(std::atomic<uint64_t>& value, uint64_t amount) noexcept {
+	value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void AddTo(MetricsSnapshot& totals, const ThreadMetrics& metrics) {
+	for (uint64_t i = 0; i < metricCounterCount; ++i) {
+		totals.counters[i] += metrics.counters[i].load(std::memory_order_relaxed);
+	}
+	for (uint64_t i = 0; i < metricStageCount; ++i) {
+		StageMetrics& total = totals.stages[i];
+		const ThreadStage& stage = metrics.stages[i];
+		total.calls += stage.calls.load(std::memory_order_relaxed);
+		total.items += stage.items.load(std::memory_order_relaxed);
+		total.totalNanoseconds += stage.totalNanoseconds.load(std::memory_order_relaxed);
+		for (uint64_t j = 0; j < latencyBucketCount; ++j) {
+			total.buckets[j] += stage.buckets[j].load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void Subtract(MetricsSnapshot& totals, const MetricsSnapshot& baseline) {
+	for (uint64_t i = 0; i < metricCounterCount; ++i) {
+		totals.counters[i] -= baseline.counters[i];
+	}
+	for (uint64_t i = 0; i < metricStageCount; ++i) {
+		StageMetrics& total = totals.stages[i];
+		const StageMetrics& base = baseline.stages[i];
+		total.calls -= base.calls;
+		total.items -= base.items;
+		total.totalNanoseconds -= base.totalNanoseconds;
+		for (uint64_t j = 0; j < latencyBucketCount; ++j) {
+			total.buckets[j] -= base.buckets[j];
+		}
+	}
+}
+
+// Blocks of running threads, plus what exited threads and the last reset
+// left behind. Resetting only moves the baseline, so it never races with
+// the owners writing their blocks.
+struct MetricsRegistry {
+	std::mutex mutex;
+	std::vector<ThreadMetrics*> live;
+	MetricsSnapshot retired{};
+	MetricsSnapshot baseline{};
+
+	MetricsSnapshot Total() {
+		MetricsSnapshot totals = retired;
+		totals.threads += live.size();
+		for (const ThreadMetrics* metrics : live) {
+			AddTo(totals, *metrics);
+		}
+
+		return totals;
+	}
+};
+
+// Never destroyed, so threads outliving static destruction can still retire.
+MetricsRegistry& GetRegistry() {
+	static MetricsRegistry* registry = new MetricsRegistry();
+	return *registry;
+}
+
+class ThreadMetricsHandle {
+public:
+	ThreadMetricsHandle() : _metrics(new ThreadMetrics()) {
+		MetricsRegistry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.live.push_back(_metrics);
+	}
+
+	ThreadMetricsHandle(const ThreadMetricsHandle& other) = delete;
+
+	~ThreadMetricsHandle() noexcept {
+		MetricsRegistry& registry = GetRegistry();
+		{
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			AddTo(registry.retired, *_metrics);
+			++registry.retired.threads;
+			registry.live.erase(std::find(registry.live.begin(), registry.live.end(), _metrics));
+		}
+		delete _metrics;
+	}
+
+	ThreadMetricsHandle& operator=(const ThreadMetricsHandle& other) = delete;
+
+	ThreadMetrics& Get() noexcept {
+		return *_metrics;
+	}
+private:
+	ThreadMetrics* _metrics;
+};
+
+ThreadMetrics& GetThreadMetrics() {
+	thread_local ThreadMetricsHandle handle;
+	return handle.Get();
+}
+
+void WriteNumber(std::ostream& ostream, double value) {
+	char buffer[32];
+	std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), std::isfinite(value) ? value : 0.0);
+	ostream.write(buffer, result.ptr - buffer);
+}
+
+}
+
+const char* GetMetricName(MetricCounter counter) {
+	return counterNames[static_cast<uint64_t>(counter)];
+}
+
+const char* GetMetricName(MetricStage stage) {
+	return stageNames[static_cast<uint64_t>(stage)];
+}
+
+uint64_t StageMetrics::GetBucket(uint64_t nanoseconds) noexcept {
+	if (nanoseconds <= 1) {
+		return 0;
+	}
+
+	// Bit width of nanoseconds - 1.
+#if defined(__GNUC__)
+	uint64_t bucket = 64 - static_cast<uint64_t>(__builtin_clzll(nanoseconds - 1));
+#else
+	uint64_t bucket = 0;
+	for (uint64_t rest = nanoseconds - 1; rest != 0; rest >>= 1) {
+		++bucket;
+	}
+#endif
+
+	return std::min(bucket, latencyBucketCount - 1);
+}
+
+uint64_t StageMetrics::GetBucketLimit(uint64_t bucket) noexcept {
+	return bucket + 1 < latencyBucketCount ? uint64_t(1) << bucket : UINT64_MAX;
+}
+
+double StageMetrics::GetItemsPerSecond() const noexcept {
+	return totalNanoseconds == 0 ? 0 : static_cast<double>(items) * 1e9 / static_cast<double>(totalNanoseconds);
+}
+
+double StageMetrics::GetMeanNanoseconds() const noexcept {
+	return calls == 0 ? 0 : static_cast<double>(totalNanoseconds) / static_cast<double>(calls);
+}
+
+uint64_t StageMetrics::GetQuantileNanoseconds(double quantile) const noexcept {
+	if (calls == 0) {
+		return 0;
+	}
+
+	const double rank = std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(calls));
+	uint64_t seen = 0;
+	for (uint64_t i = 0; i < latencyBucketCount; ++i) {
+		seen += buckets[i];
+		if (static_cast<double>(seen) >= rank && seen != 0) {
+			return GetBucketLimit(i);
+		}
+	}
+
+	return GetBucketLimit(latencyBucketCount - 1);
+}
+
+uint64_t MetricsSnapshot::GetCounter(MetricCounter counter) const noexcept {
+	return counters[static_cast<uint64_t>(counter)];
+}
+
+const StageMetrics& MetricsSnapshot::GetStage(MetricStage stage) const noexcept {
+	return stages[static_cast<uint64_t>(stage)];
+}
+
+void MetricsSnapshot::WriteJson(std::ostream& ostream) const {
+	ostream << "{\"enabled\":" << (AreMetricsEnabled() ? "true" : "false") << ",\"threads\":" << threads
+			<< ",\"counters\":{";
+	for (uint64_t i = 0; i < metricCounterCount; ++i) {
+		ostream << (i == 0 ? "" : ",") << '"' << counterNames[i] << "\":" << counters[i];
+	}
+
+	ostream << "},\"stages\":{";
+	for (uint64_t i = 0; i < metricStageCount; ++i) {
+		const StageMetrics& stage = stages[i];
+		ostream << (i == 0 ? "" : ",") << '"' << stageNames[i] << "\":{\"calls\":" << stage.calls
+				<< ",\"items\":" << stage.items << ",\"total_ns\":" << stage.totalNanoseconds << ",\"mean_ns\":";
+		WriteNumber(ostream, stage.GetMeanNanoseconds());
+		ostream << ",\"items_per_second\":";
+		WriteNumber(ostream, stage.GetItemsPerSecond());
+		for (uint64_t j = 0; j < reportedQuantiles.size(); ++j) {
+			ostream << ",\"" << quantileNames[j] << "\":" << stage.GetQuantileNanoseconds(reportedQuantiles[j]);
+		}
+
+		// Only the buckets that were hit; le_ns is null for the unbounded one.
+		ostream << ",\"buckets\":[";
+		bool first = true;
+		for (uint64_t j = 0; j < latencyBucketCount; ++j) {
+			if (stage.buckets[j] == 0) {
+				continue;
+			}
+			ostream << (first ? "" : ",") << "{\"le_ns\":";
+			if (j + 1 < latencyBucketCount) {
+				ostream << StageMetrics::GetBucketLimit(j);
+			} else {
+				ostream << "null";
+			}
+			ostream << ",\"count\":" << stage.buckets[j] << '}';
+			first = false;
+		}
+		ostream << "]}";
+	}
+	ostream << "}}\n";
+}
+
+void MetricsSnapshot::WritePrometheus(std::ostream& ostream) const {
+	ostream << "# HELP figures_events_total Events counted by the Figures library.\n"
+			<< "# TYPE figures_events_total counter\n";
+	for (uint64_t i = 0; i < metricCounterCount; ++i) {
+		ostream << "figures_events_total{event=\"" << counterNames[i] << "\"} " << counters[i] << '\n';
+	}
+
+	ostream << "# HELP figures_stage_items_total Bytes, figures or points handled by each stage.\n"
+			<< "# TYPE figures_stage_items_total counter\n";
+	for (uint64_t i = 0; i < metricStageCount; ++i) {
+		ostream << "figures_stage_items_total{stage=\"" << stageNames[i] << "\"} " << stages[i].items << '\n';
+	}
+
+	ostream << "# HELP figures_stage_duration_seconds Latency of one call of each stage.\n"
+			<< "# TYPE figures_stage_duration_seconds histogram\n";
+	for (uint64_t i = 0; i < metricStageCount; ++i) {
+		const StageMetrics& stage = stages[i];
+		uint64_t cumulative = 0;
+		for (uint64_t j = 0; j + 1 < latencyBucketCount; ++j) {
+			cumulative += stage.buckets[j];
+			ostream << "figures_stage_duration_seconds_bucket{stage=\"" << stageNames[i] << "\",le=\"";
+			WriteNumber(ostream, static_cast<double>(StageMetrics::GetBucketLimit(j)) / 1e9);
+			ostream << "\"} " << cumulative << '\n';
+		}
+		ostream << "figures_stage_duration_seconds_bucket{stage=\"" << stageNames[i] << "\",le=\"+Inf\"} "
+				<< stage.calls << '\n';
+		ostream << "figures_stage_duration_seconds_sum{stage=\"" << stageNames[i] << "\"} ";
+		WriteNumber(ostream, static_cast<double>(stage.totalNanoseconds) / 1e9);
+		ostream << "\nfigures_stage_duration_seconds_count{stage=\"" << stageNames[i] << "\"} " << stage.calls << '\n';
+	}
+}
+
+void RecordCount(MetricCounter counter, uint64_t amount) noexcept {
+	Bump(GetThreadMetrics().counters[static_cast<uint64_t>(counter)], amount);
+}
+
+void RecordLatency(MetricStage stage, uint64_t nanoseconds, uint64_t items) noexcept {
+	ThreadStage& metrics = GetThreadMetrics().stages[static_cast<uint64_t>(stage)];
+	Bump(metrics.calls, 1);
+	Bump(metrics.items, items);
+	Bump(metrics.totalNanoseconds, nanoseconds);
+	Bump(metrics.buckets[StageMetrics::GetBucket(nanoseconds)], 1);
+}
+
+MetricsSnapshot TakeMetricsSnapshot() {
+	MetricsRegistry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	MetricsSnapshot snapshot = registry.Total();
+	Subtract(snapshot, registry.baseline);
+
+	return snapshot;
+}
+
+void ResetMetrics() {
+	MetricsRegistry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.baseline = registry.Total();
+}
+
+StageTimer::StageTimer(MetricStage stage, uint64_t items) noexcept :
+	_stage(stage), _items(items), _start(std::chrono::steady_clock::now()) {}
+
+StageTimer::~StageTimer() noexcept {
+	const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - _start;
+	RecordLatency(_stage, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+				  _items);
+}
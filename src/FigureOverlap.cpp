@@ -0,0 +1,314 @@
+#include "FigureOverlap.h"
+#include "FigureSort.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr uint64_t sweepChunkSize = 4096;
+
+double Cross(const Point& edge, const Point& offset) {
+	return edge.x * offset.y - edge.y * offset.x;
+}
+
+Point Offset(const Point& point, const Point& origin) {
+	return {point.x - origin.x, point.y - origin.y};
+}
+
+// Whether the projections onto the normal of some edge of edges are
+// disjoint.
+bool SeparatedByEdges(const Point* edges, uint64_t edgeCount, const Point* other, uint64_t otherCount,
+					  const Point& origin) {
+	for (uint64_t i = 0; i < edgeCount; ++i) {
+		const Point start = Offset(edges[i], origin);
+		const Point end = Offset(edges[i + 1 == edgeCount ? 0 : i + 1], origin);
+		const Point edge(end.x - start.x, end.y - start.y);
+		if (edge.x == 0 && edge.y == 0) {
+			continue;
+		}
+
+		double edgesMin = Cross(edge, start);
+		double edgesMax = edgesMin;
+		for (uint64_t j = 0; j < edgeCount; ++j) {
+			const double projection = Cross(edge, Offset(edges[j], origin));
+			edgesMin = std::min(edgesMin, projection);
+			edgesMax = std::max(edgesMax, projection);
+		}
+
+		double otherMin = Cross(edge, Offset(other[0], origin));
+		double otherMax = otherMin;
+		for (uint64_t j = 1; j < otherCount; ++j) {
+			const double projection = Cross(edge, Offset(other[j], origin));
+			otherMin = std::min(otherMin, projection);
+			otherMax = std::max(otherMax, projection);
+		}
+
+		if (edgesMax < otherMin || otherMax < edgesMin) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Horizontal bands the sweep runs in, about as high as the average figure.
+class SweepBands {
+public:
+	SweepBands(const std::vector<BoundingBox>& boxes) : _minY(0), _height(1), _count(1) {
+		BoundingBox bounds;
+		double totalHeight = 0;
+		for (const BoundingBox& box : boxes) {
+			bounds.Expand(box);
+			totalHeight += box.maxY - box.minY;
+		}
+		if (boxes.empty() || !(totalHeight > 0) || !(bounds.maxY > bounds.minY)) {
+			return;
+		}
+
+		const double averageHeight = totalHeight / static_cast<double>(boxes.size());
+		_minY = bounds.minY;
+		_count = static_cast<uint64_t>(std::min(static_cast<double>(boxes.size()),
+												std::ceil((bounds.maxY - bounds.minY) / averageHeight)));
+		_count = std::max<uint64_t>(_count, 1);
+		_height = (bounds.maxY - bounds.minY) / static_cast<double>(_count);
+	}
+public:
+	uint64_t BandOf(double y) const {
+		const double band = std::floor((y - _minY) / _height);
+		return band <= 0 ? 0 : std::min(_count - 1, static_cast<uint64_t>(band));
+	}
+private:
+	double _minY;
+	double _height;
+	uint64_t _count;
+};
+
+struct SweepEntry {
+	BoundingBox box;
+	uint64_t figure;
+	uint64_t band;
+};
+
+std::vector<FigureOverlap> FindOverlaps(const FigureOutlines& figures, ThreadPool* pool) {
+	const uint64_t count = figures.Size();
+	std::vector<BoundingBox> boxes(count);
+	const uint64_t chunkCount = ThreadPool::GetChunkCount(count, sweepChunkSize);
+	std::vector<uint64_t> chunkEntries(chunkCount);
+	ThreadPool::RunChunks(pool, count, sweepChunkSize, [&](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			const Point* points = figures.GetPoints(i);
+			for (uint64_t j = 0; j < figures.GetAmountOfPoints(i); ++j) {
+				if (!std::isfinite(points[j].x) || !std::isfinite(points[j].y)) {
+					throw std::invalid_argument("Figure coordinates must be finite");
+				}
+			}
+			boxes[i] = OutlineBox(points, figures.GetAmountOfPoints(i));
+		}
+	});
+
+	// Every figure goes into each band its box spans, keyed by (band, left
+	// edge), so one sort puts each band in sweep order.
+	const SweepBands bands(boxes);
+	ThreadPool::RunChunks(pool, count, sweepChunkSize, [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+		uint64_t entries = 0;
+		for (uint64_t i = begin; i < end; ++i) {
+			entries += bands.BandOf(boxes[i].maxY) - bands.BandOf(boxes[i].minY) + 1;
+		}
+		chunkEntries[chunk] = entries;
+	});
+	uint64_t entryCount = 0;
+	for (uint64_t& entries : chunkEntries) {
+		const uint64_t size = entries;
+		entries = entryCount;
+		entryCount += size;
+	}
+
+	std::vector<Point> keys(entryCount);
+	std::vector<SweepEntry> unsorted(entryCount);
+	ThreadPool::RunChunks(pool, count, sweepChunkSize, [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+		uint64_t next = chunkEntries[chunk];
+		for (uint64_t i = begin; i < end; ++i) {
+			for (uint64_t band = bands.BandOf(boxes[i].minY); band <= bands.BandOf(boxes[i].maxY); ++band) {
+				keys[next] = Point(static_cast<double>(band), boxes[i].minX);
+				unsorted[next++] = {boxes[i], i, band};
+			}
+		}
+	});
+
+	const std::vector<uint64_t> order = pool != nullptr ? SortByKey(keys.data(), entryCount, *pool)
+														: SortByKey(keys.data(), entryCount);
+	std::vector<SweepEntry> sorted(entryCount);
+	ThreadPool::RunChunks(pool, entryCount, sweepChunkSize, [&](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			sorted[i] = unsorted[order[i]];
+		}
+	});
+
+	// Two figures sharing several bands are reported only in the band that
+	// holds the lower edge of their common y range.
+	std::vector<std::vector<FigureOverlap>> partials(ThreadPool::GetChunkCount(entryCount, sweepChunkSize));
+	ThreadPool::RunChunks(pool, entryCount, sweepChunkSize, [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			const SweepEntry& entry = sorted[i];
+			for (uint64_t j = i + 1; j < entryCount && sorted[j].band == entry.band && sorted[j].box.minX <= entry.box.maxX;
+				 ++j) {
+				const BoundingBox& other = sorted[j].box;
+				if (other.minY > entry.box.maxY || entry.box.minY > other.maxY ||
+					bands.BandOf(std::max(entry.box.minY, other.minY)) != entry.band) {
+					continue;
+				}
+
+				const uint64_t first = std::min(entry.figure, sorted[j].figure);
+				const uint64_t second = std::max(entry.figure, sorted[j].figure);
+				const Point* firstPoints = figures.GetPoints(first);
+				const uint64_t firstCount = figures.GetAmountOfPoints(first);
+				const Point* secondPoints = figures.GetPoints(second);
+				const uint64_t secondCount = figures.GetAmountOfPoints(second);
+				if (ConvexOutlinesIntersect(firstPoints, firstCount, secondPoints, secondCount)) {
+					partials[chunk].push_back(
+						{first, second, ConvexOverlapArea(firstPoints, firstCount, secondPoints, secondCount)});
+				}
+			}
+		}
+	});
+
+	std::vector<FigureOverlap> overlaps;
+	for (const std::vector<FigureOverlap>& partial : partials) {
+		overlaps.insert(overlaps.end(), partial.begin(), partial.end());
+	}
+	std::sort(overlaps.begin(), overlaps.end(), [](const FigureOverlap& lhs, const FigureOverlap& rhs) {
+		return lhs.first != rhs.first ? lhs.first < rhs.first : lhs.second < rhs.second;
+	});
+
+	return overlaps;
+}
+
+}
+
+bool IsConvexOutline(const Point* points, uint64_t count) {
+	std::vector<Point> edges;
+	for (uint64_t i = 0; i < count; ++i) {
+		const Point edge = Offset(points[i + 1 == count ? 0 : i + 1], points[i]);
+		if (edge.x != 0 || edge.y != 0) {
+			edges.push_back(edge);
+		}
+	}
+	if (edges.size() < 3) {
+		return false;
+	}
+
+	double turn = 0;
+	uint64_t directionChanges = 0;
+	double lastDirection = 0;
+	for (uint64_t i = 0; i < edges.size(); ++i) {
+		const Point& edge = edges[i];
+		const Point& next = edges[i + 1 == edges.size() ? 0 : i + 1];
+		const double cross = Cross(edge, next);
+		if (cross == 0) {
+			if (edge.x * next.x + edge.y * next.y < 0) {
+				return false;
+			}
+		} else if (turn != 0 && (cross > 0) != (turn > 0)) {
+			return false;
+		} else {
+			turn = cross;
+		}
+		if (edge.x != 0) {
+			directionChanges += lastDirection != 0 && (edge.x > 0) != (lastDirection > 0) ? 1 : 0;
+			lastDirection = edge.x;
+		}
+	}
+	for (const Point& edge : edges) {
+		if (edge.x != 0) {
+			directionChanges += (edge.x > 0) != (lastDirection > 0) ? 1 : 0;
+			break;
+		}
+	}
+
+	// A convex outline heads right once and left once; a star turns the same
+	// way at every vertex but winds around more than once.
+	return turn != 0 && directionChanges <= 2;
+}
+
+bool ConvexOutlinesIntersect(const Point* first, uint64_t firstCount, const Point* second, uint64_t secondCount) {
+	if (firstCount == 0 || secondCount == 0 ||
+		!OutlineBox(first, firstCount).Intersects(OutlineBox(second, secondCount))) {
+		return false;
+	}
+
+	const Point& origin = second[0];
+	return !SeparatedByEdges(first, firstCount, second, secondCount, origin) &&
+		   !SeparatedByEdges(second, secondCount, first, firstCount, origin);
+}
+
+double ConvexOverlapArea(const Point* first, uint64_t firstCount, const Point* second, uint64_t secondCount) {
+	if (firstCount < 3 || secondCount < 3) {
+		return 0;
+	}
+
+	const Point& origin = second[0];
+	double twiceArea = 0;
+	for (uint64_t i = 1; i + 1 < secondCount; ++i) {
+		twiceArea += Cross(Offset(second[i], origin), Offset(second[i + 1], origin));
+	}
+	if (twiceArea == 0 || std::isnan(twiceArea)) {
+		return 0;
+	}
+	const double sense = twiceArea > 0 ? 1 : -1;
+
+	// Reused by every call on the thread, so clipping does not allocate once
+	// the buffers have grown.
+	thread_local std::vector<Point> subject;
+	thread_local std::vector<Point> clipped;
+	subject.clear();
+	for (uint64_t i = 0; i < firstCount; ++i) {
+		subject.push_back(Offset(first[i], origin));
+	}
+
+	for (uint64_t i = 0; i < secondCount; ++i) {
+		const Point start = Offset(second[i], origin);
+		const Point end = Offset(second[i + 1 == secondCount ? 0 : i + 1], origin);
+		const Point edge(end.x - start.x, end.y - start.y);
+
+		clipped.clear();
+		for (uint64_t j = 0; j < subject.size(); ++j) {
+			const Point& current = subject[j];
+			const Point& next = subject[j + 1 == subject.size() ? 0 : j + 1];
+			const double currentSide = sense * Cross(edge, Offset(current, start));
+			const double nextSide = sense * Cross(edge, Offset(next, start));
+			if (currentSide >= 0) {
+				clipped.push_back(current);
+			}
+			if ((currentSide >= 0) != (nextSide >= 0)) {
+				const double t = currentSide / (currentSide - nextSide);
+				clipped.emplace_back(current.x + t * (next.x - current.x), current.y + t * (next.y - current.y));
+			}
+		}
+		subject.swap(clipped);
+		if (subject.size() < 3) {
+			return 0;
+		}
+	}
+
+	return ShoelaceArea(subject.data(), subject.size());
+}
+
+bool Intersects(const Polygon& first, const Polygon& second) {
+	return ConvexOutlinesIntersect(first.GetPoints().data(), first.GetAmountOfPoints(), second.GetPoints().data(),
+								   second.GetAmountOfPoints());
+}
+
+double OverlapArea(const Polygon& first, const Polygon& second) {
+	return ConvexOverlapArea(first.GetPoints().data(), first.GetAmountOfPoints(), second.GetPoints().data(),
+							 second.GetAmountOfPoints());
+}
+
+std::vector<FigureOverlap> FindOverlaps(const FigureOutlines& figures) {
+	return FindOverlaps(figures, nullptr);
+}
+
+std::vector<FigureOverlap> FindOverlaps(const FigureOutlines& figures, ThreadPool& pool) {
+	return FindOverlaps(figures, &pool);
+}
@@ -0,0 +1,207 @@
+#include "FigureParser.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+bool IsSpace(char character) {
+	return character == ' ' || (character >= '\t' && character <= '\r');
+}
+
+bool IsDigit(char character) {
+	return character >= '0' && character <= '9';
+}
+
+// Finds the end of the longest prefix istream >> double would consume.
+// Returns nullptr when that prefix is not a number.
+const char* ScanNumber(const char* begin, const char* end) {
+	const char* current = begin;
+	if (current != end && (*current == '+' || *current == '-')) {
+		++current;
+	}
+
+	uint64_t digits = 0;
+	while (current != end && IsDigit(*current)) {
+		++current;
+		++digits;
+	}
+	if (current != end && *current == '.') {
+		++current;
+		while (current != end && IsDigit(*current)) {
+			++current;
+			++digits;
+		}
+	}
+	if (digits == 0) {
+		return nullptr;
+	}
+
+	if (current != end && (*current == 'e' || *current == 'E')) {
+		++current;
+		if (current != end && (*current == '+' || *current == '-')) {
+			++current;
+		}
+
+		uint64_t exponentDigits = 0;
+		while (current != end && IsDigit(*current)) {
+			++current;
+			++exponentDigits;
+		}
+		if (exponentDigits == 0) {
+			return nullptr;
+		}
+	}
+
+	return current;
+}
+
+bool ConvertNumber(const char* begin, const char* end, double& value) {
+	const char* first = *begin == '+' ? begin + 1 : begin;
+	std::from_chars_result result = std::from_chars(first, end, value);
+
+	if (result.ec == std::errc::result_out_of_range) {
+		// istream >> double turns underflow into zero but rejects overflow.
+		const char* exponent = static_cast<const char*>(memchr(first, 'e', end - first));
+		if (exponent == nullptr) {
+			exponent = static_cast<const char*>(memchr(first, 'E', end - first));
+		}
+		if (exponent == nullptr || exponent[1] != '-') {
+			return false;
+		}
+
+		value = *first == '-' ? -0.0 : 0.0;
+		return true;
+	}
+
+	return result.ec == std::errc() && result.ptr == end;
+}
+
+}
+
+TextRecordParser::TextRecordParser(uint64_t valuesPerRecord) : _valuesPerRecord(valuesPerRecord), _line(1), _column(1), _skipLine(false) {
+	if (valuesPerRecord == 0) {
+		throw std::invalid_argument("A record needs at least one value");
+	}
+}
+
+void TextRecordParser::Feed(const char* data, uint64_t size) {
+	FIGURES_TIME_STAGE(Parse, size);
+	const char* begin = data;
+	const char* end = data + size;
+
+	if (!_pending.empty()) {
+		const char* space = begin;
+		while (space != end && !IsSpace(*space)) {
+			++space;
+		}
+
+		_pending.append(begin, space);
+		if (space == end) {
+			return;
+		}
+
+		Process(_pending.data(), _pending.data() + _pending.size());
+		_pending.clear();
+		begin = space;
+	}
+
+	const char* lastSpace = end;
+	while (lastSpace != begin && !IsSpace(*(lastSpace - 1))) {
+		--lastSpace;
+	}
+
+	Process(begin, lastSpace);
+	_pending.assign(lastSpace, end);
+}
+
+void TextRecordParser::Finish() {
+	Process(_pending.data(), _pending.data() + _pending.size());
+	_pending.clear();
+
+	if (_values.size() % _valuesPerRecord != 0) {
+		AddError(_line, _column, "Unexpected end of input");
+	}
+	_skipLine = false;
+}
+
+uint64_t TextRecordParser::GetValuesPerRecord() const noexcept {
+	return _valuesPerRecord;
+}
+
+uint64_t TextRecordParser::GetRecordCount() const noexcept {
+	return _values.size() / _valuesPerRecord;
+}
+
+std::vector<double> TextRecordParser::TakeValues() {
+	uint64_t complete = _values.size() - _values.size() % _valuesPerRecord;
+	std::vector<double> partial(_values.begin() + static_cast<std::ptrdiff_t>(complete), _values.end());
+	_values.resize(complete);
+	FIGURES_COUNT_N(RecordsParsed, complete / _valuesPerRecord);
+
+	std::vector<double> values;
+	values.swap(_values);
+	_values.swap(partial);
+
+	return values;
+}
+
+std::vector<ParseError> TextRecordParser::TakeErrors() {
+	std::vector<ParseError> errors;
+	errors.swap(_errors);
+
+	return errors;
+}
+
+void TextRecordParser::Process(const char* begin, const char* end) {
+	const char* current = begin;
+
+	while (current != end) {
+		if (_skipLine) {
+			const char* newline = static_cast<const char*>(memchr(current, '\n', end - current));
+			if (newline == nullptr) {
+				_column += static_cast<uint64_t>(end - current);
+				return;
+			}
+
+			Advance('\n');
+			current = newline + 1;
+			_skipLine = false;
+			continue;
+		}
+
+		if (IsSpace(*current)) {
+			Advance(*current);
+			++current;
+			continue;
+		}
+
+		const char* tokenEnd = ScanNumber(current, end);
+		double value = 0;
+		if (tokenEnd == nullptr || !ConvertNumber(current, tokenEnd, value)) {
+			AddError(_line, _column, "Incorrect type provided");
+			_skipLine = true;
+			continue;
+		}
+
+		_values.push_back(value);
+		_column += static_cast<uint64_t>(tokenEnd - current);
+		current = tokenEnd;
+	}
+}
+
+void TextRecordParser::AddError(uint64_t line, uint64_t column, const char* message) {
+	_errors.push_back({line, column, message});
+	FIGURES_COUNT(ParseErrors);
+	_values.resize(_values.size() - _values.size() % _valuesPerRecord);
+}
+
+void TextRecordParser::Advance(char character) {
+	if (character == '\n') {
+		++_line;
+		_column = 1;
+	} else {
+		++_column;
+	}
+}
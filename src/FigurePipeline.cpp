@@ -0,0 +1,301 @@
+#include "FigurePipeline.h"
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "FigureWriter.h"
+
+namespace {
+
+constexpr uint64_t writeBufferSize = 1 << 16;
+
+}
+
+RunningAggregates::RunningAggregates(uint64_t topCount) :
+	_topCount(topCount), _count(0), _sum(0), _min(std::numeric_limits<double>::infinity()),
+	_max(-std::numeric_limits<double>::infinity()) {
+	_top.reserve(topCount);
+}
+
+void RunningAggregates::Add(const FigureResult& result) {
+	++_count;
+	_sum += result.area;
+	_min = std::min(_min, result.area);
+	_max = std::max(_max, result.area);
+
+	// _top is a heap with the smallest kept figure on top.
+	if (_top.size() < _topCount) {
+		_top.push_back(result);
+		std::push_heap(_top.begin(), _top.end(), Before);
+	} else if (_topCount != 0 && Before(result, _top.front())) {
+		std::pop_heap(_top.begin(), _top.end(), Before);
+		_top.back() = result;
+		std::push_heap(_top.begin(), _top.end(), Before);
+	}
+}
+
+uint64_t RunningAggregates::GetCount() const noexcept {
+	return _count;
+}
+
+double RunningAggregates::GetSum() const noexcept {
+	return _sum;
+}
+
+double RunningAggregates::GetMin() const noexcept {
+	return _min;
+}
+
+double RunningAggregates::GetMax() const noexcept {
+	return _max;
+}
+
+uint64_t RunningAggregates::GetTopCount() const noexcept {
+	return _topCount;
+}
+
+std::vector<FigureResult> RunningAggregates::GetTop() const {
+	std::vector<FigureResult> top = _top;
+	std::sort(top.begin(), top.end(), Before);
+
+	return top;
+}
+
+bool RunningAggregates::Before(const FigureResult& first, const FigureResult& second) {
+	if (first.area != second.area) {
+		return first.area > second.area;
+	}
+
+	return first.index < second.index;
+}
+
+FigurePipeline::FigurePipeline(const PipelineOptions& options) :
+	_options(options), _aggregates(options.topCount), _errorCount(0), _nextIndex(0) {
+	if (options.amountOfPoints < 4 || options.amountOfPoints > 6) {
+		throw std::invalid_argument("Unsupported amount of points");
+	}
+	if (options.readSize == 0 || options.chunkFigures == 0 || options.queueCapacity == 0) {
+		throw std::invalid_argument("Pipeline sizes must be positive");
+	}
+}
+
+void FigurePipeline::ProcessText(std::istream& input, std::ostream& output) {
+	Run([this, &input](BoundedQueue<FigureChunk>& chunks) {
+		switch (_options.amountOfPoints) {
+		case 4:
+			ReadText<4>(input, chunks);
+			break;
+		case 5:
+			ReadText<5>(input, chunks);
+			break;
+		default:
+			ReadText<6>(input, chunks);
+			break;
+		}
+	}, output);
+}
+
+void FigurePipeline::ProcessBinary(const FigureFileReader& reader, std::ostream& output) {
+	Run([this, &reader](BoundedQueue<FigureChunk>& chunks) {
+		ReadBinary<4>(reader, chunks);
+		ReadBinary<5>(reader, chunks);
+		ReadBinary<6>(reader, chunks);
+	}, output);
+}
+
+void FigurePipeline::WriteSummary(std::ostream& output) const {
+	char buffer[writeBufferSize];
+	FigureTextWriter writer(buffer, sizeof(buffer), output);
+
+	writer.Write("count ");
+	writer.Write(_aggregates.GetCount());
+	writer.Write("\nsum ");
+	writer.Write(_aggregates.GetSum());
+	if (_aggregates.GetCount() != 0) {
+		writer.Write("\nmin ");
+		writer.Write(_aggregates.GetMin());
+		writer.Write("\nmax ");
+		writer.Write(_aggregates.GetMax());
+	}
+	writer.Write("\nerrors ");
+	writer.Write(_errorCount);
+	writer.Write('\n');
+
+	for (const FigureResult& result : _aggregates.GetTop()) {
+		writer.Write("top ");
+		writer.Write(result.index);
+		writer.Write(' ');
+		writer.Write(result.area);
+		writer.Write(' ');
+		writer.Write(result.center);
+		writer.Write('\n');
+	}
+}
+
+const RunningAggregates& FigurePipeline::GetAggregates() const noexcept {
+	return _aggregates;
+}
+
+const std::vector<ParseError>& FigurePipeline::GetErrors() const noexcept {
+	return _errors;
+}
+
+uint64_t FigurePipeline::GetErrorCount() const noexcept {
+	return _errorCount;
+}
+
+void FigurePipeline::Run(const ChunkSource& source, std::ostream& output) {
+	BoundedQueue<FigureChunk> chunks(_options.queueCapacity);
+	BoundedQueue<std::vector<FigureResult>> results(_options.queueCapacity);
+
+	// The first failing stage closes both queues, which stops the others.
+	std::mutex errorMutex;
+	std::exception_ptr error;
+	auto fail = [&]() {
+		{
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+		chunks.Close();
+		results.Close();
+	};
+
+	std::thread reader([&]() {
+		try {
+			source(chunks);
+		} catch (...) {
+			fail();
+		}
+		chunks.Close();
+	});
+
+	std::thread computer([&]() {
+		try {
+			FigureChunk chunk;
+			while (chunks.Pop(chunk)) {
+				if (!results.Push(Compute(chunk))) {
+					break;
+				}
+			}
+		} catch (...) {
+			fail();
+		}
+		results.Close();
+	});
+
+	try {
+		char buffer[writeBufferSize];
+		FigureTextWriter writer(buffer, sizeof(buffer), output);
+		std::vector<FigureResult> chunk;
+		while (results.Pop(chunk)) {
+			if (!_options.writeFigures) {
+				continue;
+			}
+			FIGURES_TIME_STAGE(Serialize, chunk.size());
+			FIGURES_COUNT_N(FiguresSerialized, chunk.size());
+			for (const FigureResult& result : chunk) {
+				writer.Write(result.index);
+				writer.Write(' ');
+				writer.Write(result.area);
+				writer.Write(' ');
+				writer.Write(result.center);
+				writer.Write('\n');
+			}
+			writer.Flush();
+			if (!output) {
+				throw std::runtime_error("Failed to write results");
+			}
+		}
+	} catch (...) {
+		fail();
+	}
+
+	reader.join();
+	computer.join();
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+std::vector<FigureResult> FigurePipeline::Compute(const FigureChunk& chunk) {
+	return std::visit([this](const auto& batch) {
+		const std::vector<double> areas = batch.Areas();
+		const std::vector<Point> centers = batch.GeometricCenters();
+
+		std::vector<FigureResult> results(batch.Size());
+		for (uint64_t i = 0; i < results.size(); ++i) {
+			results[i] = {_nextIndex++, batch.amountOfPoints, areas[i], centers[i]};
+			_aggregates.Add(results[i]);
+		}
+
+		return results;
+	}, chunk);
+}
+
+template <uint64_t N>
+void FigurePipeline::ReadText(std::istream& input, BoundedQueue<FigureChunk>& chunks) {
+	TextRecordParser parser(2 * N);
+	std::vector<char> buffer(_options.readSize);
+
+	auto pushValues = [&]() {
+		const std::vector<double> values = parser.TakeValues();
+		AddErrors(parser.TakeErrors());
+		if (values.empty()) {
+			return true;
+		}
+
+		FigureBatch<N> batch(values.size() / (2 * N));
+		std::array<Point, N> points;
+		for (uint64_t i = 0; i < values.size(); i += 2 * N) {
+			for (uint64_t j = 0; j < N; ++j) {
+				points[j] = Point(values[i + 2 * j], values[i + 2 * j + 1]);
+			}
+			batch.PushBack(points);
+		}
+
+		return chunks.Push(std::move(batch));
+	};
+
+	while (input) {
+		input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		parser.Feed(buffer.data(), static_cast<uint64_t>(input.gcount()));
+		if (!pushValues()) {
+			return;
+		}
+	}
+	if (input.bad()) {
+		throw std::runtime_error("Failed to read input");
+	}
+	parser.Finish();
+	pushValues();
+}
+
+template <uint64_t N>
+void FigurePipeline::ReadBinary(const FigureFileReader& reader, BoundedQueue<FigureChunk>& chunks) const {
+	const FigureRecordView<N> records = reader.GetRecords<N>();
+	for (uint64_t begin = 0; begin < records.Size(); begin += _options.chunkFigures) {
+		const uint64_t end = std::min<uint64_t>(begin + _options.chunkFigures, records.Size());
+
+		FigureBatch<N> batch(end - begin);
+		for (uint64_t i = begin; i < end; ++i) {
+			batch.PushBack(records[i]);
+		}
+		if (!chunks.Push(std::move(batch))) {
+			return;
+		}
+	}
+}
+
+void FigurePipeline::AddErrors(std::vector<ParseError> errors) {
+	_errorCount += errors.size();
+	for (ParseError& error : errors) {
+		if (_errors.size() >= _options.maxErrors) {
+			break;
+		}
+		_errors.push_back(std::move(error));
+	}
+}
@@ -0,0 +1,247 @@
+#include "FigureProtocol.h"
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+constexpr uint64_t windowSize = 4 * sizeof(double);
+constexpr uint64_t aggregateSize = sizeof(uint64_t) + 7 * sizeof(double);
+
+constexpr bool IsLittleEndianHost() {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+	return __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__;
+#else
+	return true;
+#endif
+}
+
+template <typename T>
+void AppendValues(std::vector<char>& out, const T* values, uint64_t count) {
+	static_assert(std::is_arithmetic<T>::value, "Only numbers are encoded");
+	// An empty vector may hand over a null pointer, which memcpy must not get.
+	if (count == 0) {
+		return;
+	}
+	const uint64_t offset = out.size();
+	out.resize(offset + count * sizeof(T));
+	std::memcpy(out.data() + offset, values, count * sizeof(T));
+	if (!IsLittleEndianHost()) {
+		for (uint64_t i = 0; i < count; ++i) {
+			char* bytes = out.data() + offset + i * sizeof(T);
+			for (uint64_t j = 0; j < sizeof(T) / 2; ++j) {
+				std::swap(bytes[j], bytes[sizeof(T) - 1 - j]);
+			}
+		}
+	}
+}
+
+template <typename T>
+void Append(std::vector<char>& out, T value) {
+	AppendValues(out, &value, 1);
+}
+
+template <typename T>
+void ReadValues(const char* data, T* values, uint64_t count) {
+	if (count == 0) {
+		return;
+	}
+	std::memcpy(values, data, count * sizeof(T));
+	if (!IsLittleEndianHost()) {
+		for (uint64_t i = 0; i < count; ++i) {
+			char* bytes = reinterpret_cast<char*>(values + i);
+			for (uint64_t j = 0; j < sizeof(T) / 2; ++j) {
+				std::swap(bytes[j], bytes[sizeof(T) - 1 - j]);
+			}
+		}
+	}
+}
+
+template <typename T>
+T Read(const char* data) {
+	T value;
+	ReadValues(data, &value, 1);
+
+	return value;
+}
+
+void CheckSize(uint64_t size, uint64_t expected) {
+	if (size != expected) {
+		throw std::invalid_argument("Payload has the wrong size");
+	}
+}
+
+template <typename T>
+std::vector<T> DecodeArray(const char* payload, uint64_t size) {
+	if (size % sizeof(T) != 0) {
+		throw std::invalid_argument("Payload has the wrong size");
+	}
+
+	std::vector<T> values(size / sizeof(T));
+	ReadValues(payload, values.data(), values.size());
+
+	return values;
+}
+
+}
+
+const char* GetStatusName(FigureStatus status) {
+	switch (status) {
+		case FigureStatus::Ok:
+			return "ok";
+		case FigureStatus::UnknownOpcode:
+			return "unknown opcode";
+		case FigureStatus::UnknownDataset:
+			return "unknown dataset";
+		case FigureStatus::BadRequest:
+			return "bad request";
+		case FigureStatus::IndexOutOfRange:
+			return "index out of range";
+	}
+
+	return "unknown status";
+}
+
+void AppendFrameHeader(std::vector<char>& out, const FrameHeader& header) {
+	Append(out, header.payloadSize);
+	Append(out, header.requestId);
+	Append(out, header.opcode);
+	Append(out, header.status);
+	Append(out, header.dataset);
+}
+
+FrameHeader ReadFrameHeader(const char* data) {
+	FrameHeader header;
+	header.payloadSize = Read<uint32_t>(data);
+	header.requestId = Read<uint32_t>(data + 4);
+	header.opcode = Read<uint16_t>(data + 8);
+	header.status = Read<uint16_t>(data + 10);
+	header.dataset = Read<uint32_t>(data + 12);
+
+	return header;
+}
+
+std::vector<char> EncodeIndices(const uint64_t* indices, uint64_t count) {
+	std::vector<char> payload;
+	AppendValues(payload, indices, count);
+
+	return payload;
+}
+
+std::vector<char> EncodeWindow(const BoundingBox& window) {
+	const double values[4] = {window.minX, window.minY, window.maxX, window.maxY};
+	std::vector<char> payload;
+	AppendValues(payload, values, 4);
+
+	return payload;
+}
+
+std::vector<char> EncodeAreas(const double* areas, uint64_t count) {
+	std::vector<char> payload;
+	AppendValues(payload, areas, count);
+
+	return payload;
+}
+
+std::vector<char> EncodeCentroids(const Point* centroids, uint64_t count) {
+	std::vector<char> payload;
+	payload.reserve(count * 2 * sizeof(double));
+	for (uint64_t i = 0; i < count; ++i) {
+		Append(payload, centroids[i].x);
+		Append(payload, centroids[i].y);
+	}
+
+	return payload;
+}
+
+std::vector<char> EncodeAggregate(const DatasetAggregate& aggregate) {
+	const double values[7] = {aggregate.totalArea, aggregate.minArea, aggregate.maxArea, aggregate.bounds.minX,
+							  aggregate.bounds.minY, aggregate.bounds.maxX, aggregate.bounds.maxY};
+	std::vector<char> payload;
+	Append(payload, aggregate.count);
+	AppendValues(payload, values, 7);
+
+	return payload;
+}
+
+std::vector<char> EncodeDatasets(const std::vector<DatasetInfo>& datasets) {
+	std::vector<char> payload;
+	Append(payload, static_cast<uint32_t>(datasets.size()));
+	for (const DatasetInfo& dataset : datasets) {
+		Append(payload, dataset.figureCount);
+		Append(payload, static_cast<uint32_t>(dataset.name.size()));
+		payload.insert(payload.end(), dataset.name.begin(), dataset.name.end());
+	}
+
+	return payload;
+}
+
+std::vector<uint64_t> DecodeIndices(const char* payload, uint64_t size) {
+	return DecodeArray<uint64_t>(payload, size);
+}
+
+BoundingBox DecodeWindow(const char* payload, uint64_t size) {
+	CheckSize(size, windowSize);
+	double values[4];
+	ReadValues(payload, values, 4);
+
+	return {values[0], values[1], values[2], values[3]};
+}
+
+std::vector<double> DecodeAreas(const char* payload, uint64_t size) {
+	return DecodeArray<double>(payload, size);
+}
+
+std::vector<Point> DecodeCentroids(const char* payload, uint64_t size) {
+	const std::vector<double> values = DecodeArray<double>(payload, size);
+	if (values.size() % 2 != 0) {
+		throw std::invalid_argument("Payload has the wrong size");
+	}
+
+	std::vector<Point> centroids(values.size() / 2);
+	for (uint64_t i = 0; i < centroids.size(); ++i) {
+		centroids[i] = Point(values[2 * i], values[2 * i + 1]);
+	}
+
+	return centroids;
+}
+
+DatasetAggregate DecodeAggregate(const char* payload, uint64_t size) {
+	CheckSize(size, aggregateSize);
+	double values[7];
+	ReadValues(payload + sizeof(uint64_t), values, 7);
+
+	return {Read<uint64_t>(payload), values[0], values[1], values[2],
+			BoundingBox(values[3], values[4], values[5], values[6])};
+}
+
+std::vector<DatasetInfo> DecodeDatasets(const char* payload, uint64_t size) {
+	if (size < sizeof(uint32_t)) {
+		throw std::invalid_argument("Payload has the wrong size");
+	}
+
+	const uint32_t count = Read<uint32_t>(payload);
+	if (count > size / (sizeof(uint64_t) + sizeof(uint32_t))) {
+		throw std::invalid_argument("Payload has the wrong size");
+	}
+
+	std::vector<DatasetInfo> datasets(count);
+	uint64_t offset = sizeof(uint32_t);
+	for (DatasetInfo& dataset : datasets) {
+		if (size - offset < sizeof(uint64_t) + sizeof(uint32_t)) {
+			throw std::invalid_argument("Payload has the wrong size");
+		}
+		dataset.figureCount = Read<uint64_t>(payload + offset);
+		const uint32_t length = Read<uint32_t>(payload + offset + sizeof(uint64_t));
+		offset += sizeof(uint64_t) + sizeof(uint32_t);
+		if (size - offset < length) {
+			throw std::invalid_argument("Payload has the wrong size");
+		}
+		dataset.name.assign(payload + offset, length);
+		offset += length;
+	}
+	CheckSize(size, offset);
+
+	return datasets;
+}
@@ -0,0 +1,670 @@
+#include "FigureServer.h"
+#include "FigureFile.h"
+#include "FigureParser.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t readSize = 1 << 16;
+constexpr uint64_t pollEventCount = 64;
+
+std::string SystemError(const std::string& message) {
+	return message + ": " + std::strerror(errno);
+}
+
+sockaddr_un MakeAddress(const std::string& path) {
+	sockaddr_un address{};
+	if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+		throw std::invalid_argument("Invalid socket path: " + path);
+	}
+	address.sun_family = AF_UNIX;
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	return address;
+}
+
+int Connect(const std::string& path) {
+	const sockaddr_un address = MakeAddress(path);
+	const int socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (socket < 0) {
+		throw std::runtime_error(SystemError("Cannot create socket"));
+	}
+	if (connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+		const std::string message = SystemError("Cannot connect to " + path);
+		close(socket);
+		throw std::runtime_error(message);
+	}
+
+	return socket;
+}
+
+// A socket file nobody listens on is left over from a server that died.
+bool IsListening(const sockaddr_un& address) {
+	const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (probe < 0) {
+		return false;
+	}
+	const bool listening = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+	close(probe);
+
+	return listening;
+}
+
+// Sends output from offset on until it is all sent or the socket is full;
+// false once the peer is gone.
+bool SendSome(int socket, std::vector<char>& output, uint64_t& offset) {
+	while (offset < output.size()) {
+		const ssize_t sent = send(socket, output.data() + offset, output.size() - offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (sent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+		offset += static_cast<uint64_t>(sent);
+	}
+
+	output.clear();
+	offset = 0;
+	return true;
+}
+
+// Appends what one recv() returns to buffer; false once the peer is gone.
+bool ReceiveSome(int socket, std::vector<char>& buffer) {
+	const uint64_t size = buffer.size();
+	buffer.resize(size + readSize);
+	ssize_t received = 0;
+	do {
+		received = recv(socket, buffer.data() + size, readSize, 0);
+	} while (received < 0 && errno == EINTR);
+	buffer.resize(size + static_cast<uint64_t>(std::max<ssize_t>(received, 0)));
+
+	return received > 0;
+}
+
+std::vector<char> MakeMessage(const char* message) {
+	return std::vector<char>(message, message + std::strlen(message));
+}
+
+template <typename T>
+FigureArray ParseTextFigures(std::istream& istream, const std::string& path) {
+	ParseResult<T> result = ParseFigures<T>(istream);
+	if (!result.errors.empty()) {
+		const ParseError& error = result.errors.front();
+		throw std::invalid_argument(path + ':' + std::to_string(error.line) + ':' + std::to_string(error.column) +
+									": " + error.message);
+	}
+
+	FigureArray figures;
+	for (const T& figure : result.figures) {
+		figures.PushBack(figure);
+	}
+
+	return figures;
+}
+
+}
+
+FigureDataset::FigureDataset(FigureArray figures) :
+	_figures(std::move(figures)), _areas(_figures.Areas()), _centroids(_figures.GeometricCenters()),
+	_index(MakeSpatialEntries(_figures)), _aggregate() {
+	std::vector<uint64_t> indices(_figures.Size());
+	for (uint64_t i = 0; i < indices.size(); ++i) {
+		indices[i] = i;
+	}
+	_aggregate = Aggregate(indices.data(), indices.size());
+}
+
+uint64_t FigureDataset::Size() const noexcept {
+	return _figures.Size();
+}
+
+const FigureArray& FigureDataset::GetFigures() const noexcept {
+	return _figures;
+}
+
+const std::vector<double>& FigureDataset::GetAreas() const noexcept {
+	return _areas;
+}
+
+const std::vector<Point>& FigureDataset::GetCentroids() const noexcept {
+	return _centroids;
+}
+
+const RTree& FigureDataset::GetIndex() const noexcept {
+	return _index;
+}
+
+std::vector<uint64_t> FigureDataset::Query(const BoundingBox& window) const {
+	std::vector<uint64_t> indices = _index.Query(window);
+	std::sort(indices.begin(), indices.end());
+
+	return indices;
+}
+
+DatasetAggregate FigureDataset::Aggregate() const {
+	return _aggregate;
+}
+
+DatasetAggregate FigureDataset::Aggregate(const BoundingBox& window) const {
+	const std::vector<uint64_t> indices = Query(window);
+	return Aggregate(indices.data(), indices.size());
+}
+
+DatasetAggregate FigureDataset::Aggregate(const uint64_t* indices, uint64_t count) const {
+	DatasetAggregate aggregate{count, 0, 0, 0, BoundingBox()};
+	for (uint64_t i = 0; i < count; ++i) {
+		const double area = _areas[indices[i]];
+		aggregate.totalArea += area;
+		aggregate.minArea = i == 0 ? area : std::min(aggregate.minArea, area);
+		aggregate.maxArea = i == 0 ? area : std::max(aggregate.maxArea, area);
+		_figures[indices[i]].Visit([&aggregate](const auto& figure) {
+			aggregate.bounds.Expand(figure.GetBoundingBox());
+		});
+	}
+
+	return aggregate;
+}
+
+FigureDataset LoadFigureDataset(const std::string& path, uint64_t amountOfPoints) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("Cannot open " + path);
+	}
+
+	char magic[sizeof(figureFileMagic)] = {};
+	file.read(magic, sizeof(magic));
+	if (file.gcount() == sizeof(magic) && std::memcmp(magic, figureFileMagic, sizeof(magic)) == 0) {
+		file.close();
+		const FigureFileReader reader(path);
+		FigureArray figures;
+		for (uint64_t i = 0; i < reader.GetRhombuses().Size(); ++i) {
+			figures.PushBack(reader.GetRhombuses().GetFigure(i));
+		}
+		for (uint64_t i = 0; i < reader.GetPentagons().Size(); ++i) {
+			figures.PushBack(reader.GetPentagons().GetFigure(i));
+		}
+		for (uint64_t i = 0; i < reader.GetHexagons().Size(); ++i) {
+			figures.PushBack(reader.GetHexagons().GetFigure(i));
+		}
+		return FigureDataset(std::move(figures));
+	}
+
+	file.clear();
+	file.seekg(0);
+	switch (amountOfPoints) {
+		case 4:
+			return FigureDataset(ParseTextFigures<Rhombus>(file, path));
+		case 5:
+			return FigureDataset(ParseTextFigures<Pentagon>(file, path));
+		case 6:
+			return FigureDataset(ParseTextFigures<Hexagon>(file, path));
+		default:
+			throw std::invalid_argument("Figures must have 4, 5 or 6 points");
+	}
+}
+
+struct FigureServer::Connection {
+	// Held by the worker serving the connection. The kernel already hands
+	// it from one worker to the next through epoll, but that is invisible
+	// to the language and to ThreadSanitizer.
+	std::mutex mutex;
+	int socket;
+	std::vector<char> input;
+	// Responses the client has not taken yet, from outputOffset on.
+	std::vector<char> output;
+	uint64_t outputOffset;
+};
+
+FigureServer::FigureServer(std::string socketPath, uint64_t threadCount) :
+	_socketPath(std::move(socketPath)), _threadCount(threadCount), _listener(-1), _epoll(-1), _wakeUp(-1),
+	_started(false), _running(false), _ready(maxConnections) {
+	if (_threadCount == 0) {
+		_threadCount = std::max<uint64_t>(1, std::thread::hardware_concurrency());
+	}
+	MakeAddress(_socketPath);
+}
+
+FigureServer::~FigureServer() noexcept {
+	Stop();
+}
+
+uint32_t FigureServer::AddDataset(std::string name, FigureDataset dataset) {
+	if (_started) {
+		throw std::logic_error("Datasets must be added before the server starts");
+	}
+
+	_names.push_back(std::move(name));
+	_datasets.push_back(std::move(dataset));
+
+	return static_cast<uint32_t>(_datasets.size() - 1);
+}
+
+const FigureDataset& FigureServer::GetDataset(uint32_t id) const {
+	if (id >= _datasets.size()) {
+		throw std::out_of_range("Index out of range");
+	}
+
+	return _datasets[id];
+}
+
+uint64_t FigureServer::GetDatasetCount() const noexcept {
+	return _datasets.size();
+}
+
+const std::string& FigureServer::GetSocketPath() const noexcept {
+	return _socketPath;
+}
+
+uint64_t FigureServer::GetThreadCount() const noexcept {
+	return _threadCount;
+}
+
+bool FigureServer::IsRunning() const noexcept {
+	return _running;
+}
+
+void FigureServer::Start() {
+	if (_started) {
+		throw std::logic_error("The server has been started before");
+	}
+
+	const sockaddr_un address = MakeAddress(_socketPath);
+	if (IsListening(address)) {
+		throw std::runtime_error("Another server listens on " + _socketPath);
+	}
+	unlink(_socketPath.c_str());
+
+	_listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+	if (_listener < 0) {
+		throw std::runtime_error(SystemError("Cannot create socket"));
+	}
+	_epoll = epoll_create1(EPOLL_CLOEXEC);
+	_wakeUp = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	// The listener is told apart by a null pointer, the wake-up descriptor
+	// by its own address and connections by theirs.
+	epoll_event listenerEvent{};
+	listenerEvent.events = EPOLLIN;
+	listenerEvent.data.ptr = nullptr;
+	epoll_event wakeUpEvent{};
+	wakeUpEvent.events = EPOLLIN;
+	wakeUpEvent.data.ptr = &_wakeUp;
+	if (bind(_listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+		listen(_listener, SOMAXCONN) != 0 || _epoll < 0 || _wakeUp < 0 ||
+		epoll_ctl(_epoll, EPOLL_CTL_ADD, _listener, &listenerEvent) != 0 ||
+		epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeUp, &wakeUpEvent) != 0) {
+		const std::string message = SystemError("Cannot listen on " + _socketPath);
+		for (int* descriptor : {&_listener, &_epoll, &_wakeUp}) {
+			if (*descriptor >= 0) {
+				close(*descriptor);
+				*descriptor = -1;
+			}
+		}
+		throw std::runtime_error(message);
+	}
+
+	_started = true;
+	_running = true;
+	for (uint64_t i = 0; i < _threadCount; ++i) {
+		_workers.emplace_back(&FigureServer::WorkerLoop, this);
+	}
+	_poller = std::thread(&FigureServer::PollLoop, this);
+}
+
+void FigureServer::Stop() {
+	if (!_running.exchange(false)) {
+		return;
+	}
+
+	// Nothing the poller or the workers do blocks, so once the queue is
+	// closed and the poller woken up they all finish.
+	_ready.Close();
+	const uint64_t one = 1;
+	while (write(_wakeUp, &one, sizeof(one)) < 0 && errno == EINTR) {}
+	_poller.join();
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+	_workers.clear();
+
+	close(_listener);
+	_listener = -1;
+	unlink(_socketPath.c_str());
+	for (const std::pair<const int, std::unique_ptr<Connection>>& entry : _connections) {
+		shutdown(entry.first, SHUT_RDWR);
+		close(entry.first);
+	}
+	_connections.clear();
+	close(_epoll);
+	_epoll = -1;
+	close(_wakeUp);
+	_wakeUp = -1;
+}
+
+void FigureServer::Handle(const FrameHeader& request, const char* payload, std::vector<char>& out) const {
+	const FigureOpcode opcode = static_cast<FigureOpcode>(request.opcode);
+	if (opcode == FigureOpcode::ListDatasets) {
+		std::vector<DatasetInfo> datasets;
+		for (uint64_t i = 0; i < _datasets.size(); ++i) {
+			datasets.push_back({_names[i], _datasets[i].Size()});
+		}
+		AppendResponse(request, FigureStatus::Ok, EncodeDatasets(datasets), out);
+		return;
+	}
+	if (request.opcode > static_cast<uint16_t>(FigureOpcode::Aggregate)) {
+		AppendResponse(request, FigureStatus::UnknownOpcode, MakeMessage("Unknown opcode"), out);
+		return;
+	}
+	if (request.dataset >= _datasets.size()) {
+		AppendResponse(request, FigureStatus::UnknownDataset, MakeMessage("Unknown dataset"), out);
+		return;
+	}
+
+	const FigureDataset& dataset = _datasets[request.dataset];
+	try {
+		if (opcode == FigureOpcode::Areas || opcode == FigureOpcode::Centroids) {
+			const std::vector<uint64_t> indices = DecodeIndices(payload, request.payloadSize);
+			for (uint64_t index : indices) {
+				if (index >= dataset.Size()) {
+					AppendResponse(request, FigureStatus::IndexOutOfRange, MakeMessage("Index out of range"), out);
+					return;
+				}
+			}
+
+			if (opcode == FigureOpcode::Areas) {
+				std::vector<double> areas(indices.size());
+				for (uint64_t i = 0; i < indices.size(); ++i) {
+					areas[i] = dataset.GetAreas()[indices[i]];
+				}
+				AppendResponse(request, FigureStatus::Ok, EncodeAreas(areas.data(), areas.size()), out);
+			} else {
+				std::vector<Point> centroids(indices.size());
+				for (uint64_t i = 0; i < indices.size(); ++i) {
+					centroids[i] = dataset.GetCentroids()[indices[i]];
+				}
+				AppendResponse(request, FigureStatus::Ok, EncodeCentroids(centroids.data(), centroids.size()), out);
+			}
+		} else if (opcode == FigureOpcode::WindowQuery) {
+			const std::vector<uint64_t> indices = dataset.Query(DecodeWindow(payload, request.payloadSize));
+			AppendResponse(request, FigureStatus::Ok, EncodeIndices(indices.data(), indices.size()), out);
+		} else {
+			const DatasetAggregate aggregate = request.payloadSize == 0
+												   ? dataset.Aggregate()
+												   : dataset.Aggregate(DecodeWindow(payload, request.payloadSize));
+			AppendResponse(request, FigureStatus::Ok, EncodeAggregate(aggregate), out);
+		}
+	} catch (const std::invalid_argument& exception) {
+		AppendResponse(request, FigureStatus::BadRequest, MakeMessage(exception.what()), out);
+	}
+}
+
+void FigureServer::PollLoop() {
+	epoll_event events[pollEventCount];
+	while (true) {
+		const int count = epoll_wait(_epoll, events, static_cast<int>(pollEventCount), -1);
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return;
+		}
+
+		for (int i = 0; i < count; ++i) {
+			if (events[i].data.ptr == nullptr) {
+				Accept();
+			} else if (events[i].data.ptr == &_wakeUp) {
+				return;
+			} else if (!_ready.Push(static_cast<Connection*>(events[i].data.ptr))) {
+				// Stopping; Stop() closes the connection.
+				return;
+			}
+		}
+	}
+}
+
+void FigureServer::Accept() {
+	while (true) {
+		const int socket = accept4(_listener, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+		if (socket < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			// Out of descriptors: the listener stays readable, so this is
+			// retried after a pause rather than in a busy loop.
+			if (errno == EMFILE || errno == ENFILE) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(_connectionsMutex);
+		if (_connections.size() >= maxConnections) {
+			close(socket);
+			continue;
+		}
+		std::unique_ptr<Connection> connection(new Connection{{}, socket, {}, {}, 0});
+		epoll_event event{};
+		event.events = EPOLLIN | EPOLLONESHOT;
+		event.data.ptr = connection.get();
+		if (epoll_ctl(_epoll, EPOLL_CTL_ADD, socket, &event) != 0) {
+			close(socket);
+			continue;
+		}
+		_connections.emplace(socket, std::move(connection));
+	}
+}
+
+// Connections are armed one-shot, so a connection is with the poller, in the
+// queue or with one worker, never with two threads at once.
+void FigureServer::WorkerLoop() {
+	Connection* connection = nullptr;
+	while (_ready.Pop(connection)) {
+		bool open = false;
+		{
+			std::lock_guard<std::mutex> lock(connection->mutex);
+			open = Serve(*connection) && Rearm(*connection);
+		}
+		if (!open) {
+			Close(*connection);
+		}
+	}
+}
+
+bool FigureServer::Serve(Connection& connection) {
+	// Responses the client was not ready for go out before anything else is
+	// read, so a client that does not read cannot make the server buffer
+	// without bound.
+	if (!SendSome(connection.socket, connection.output, connection.outputOffset)) {
+		return false;
+	}
+	if (!connection.output.empty()) {
+		return true;
+	}
+
+	// One read per turn keeps a busy client from starving the others; if
+	// more is waiting the connection is ready again as soon as it is armed.
+	std::vector<char>& input = connection.input;
+	const uint64_t size = input.size();
+	input.resize(size + readSize);
+	ssize_t received = 0;
+	do {
+		received = recv(connection.socket, input.data() + size, readSize, MSG_DONTWAIT);
+	} while (received < 0 && errno == EINTR);
+	input.resize(size + static_cast<uint64_t>(std::max<ssize_t>(received, 0)));
+	if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+		return false;
+	}
+
+	uint64_t offset = 0;
+	while (input.size() - offset >= frameHeaderSize) {
+		const FrameHeader request = ReadFrameHeader(input.data() + offset);
+		if (request.payloadSize > maxPayloadSize) {
+			return false;
+		}
+		if (input.size() - offset < frameHeaderSize + request.payloadSize) {
+			break;
+		}
+
+		Handle(request, input.data() + offset + frameHeaderSize, connection.output);
+		offset += frameHeaderSize + request.payloadSize;
+	}
+	input.erase(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(offset));
+
+	return SendSome(connection.socket, connection.output, connection.outputOffset);
+}
+
+bool FigureServer::Rearm(Connection& connection) {
+	epoll_event event{};
+	event.events = (connection.output.empty() ? EPOLLIN : EPOLLOUT) | EPOLLONESHOT;
+	event.data.ptr = &connection;
+
+	return epoll_ctl(_epoll, EPOLL_CTL_MOD, connection.socket, &event) == 0;
+}
+
+void FigureServer::Close(Connection& connection) {
+	std::lock_guard<std::mutex> lock(_connectionsMutex);
+	const int socket = connection.socket;
+	epoll_ctl(_epoll, EPOLL_CTL_DEL, socket, nullptr);
+	close(socket);
+	_connections.erase(socket);
+}
+
+void FigureServer::AppendResponse(const FrameHeader& request, FigureStatus status, const std::vector<char>& payload,
+								  std::vector<char>& out) const {
+	FrameHeader response = request;
+	response.payloadSize = static_cast<uint32_t>(payload.size());
+	response.status = static_cast<uint16_t>(status);
+	AppendFrameHeader(out, response);
+	out.insert(out.end(), payload.begin(), payload.end());
+}
+
+FigureClient::FigureClient(const std::string& socketPath) :
+	_socket(Connect(socketPath)), _nextId(0), _output(), _input(), _inputOffset(0) {}
+
+FigureClient::~FigureClient() noexcept {
+	close(_socket);
+}
+
+uint32_t FigureClient::Send(FigureOpcode opcode, uint32_t dataset, const std::vector<char>& payload) {
+	if (payload.size() > maxPayloadSize) {
+		throw std::invalid_argument("Payload is too large");
+	}
+
+	const FrameHeader header{static_cast<uint32_t>(payload.size()), _nextId++, static_cast<uint16_t>(opcode), 0, dataset};
+	AppendFrameHeader(_output, header);
+	_output.insert(_output.end(), payload.begin(), payload.end());
+
+	return header.requestId;
+}
+
+// Reads responses while it writes: the server answers what it has read so
+// far, and a client that only wrote would stall it once the socket buffers
+// fill up with responses nobody reads.
+void FigureClient::Flush() {
+	uint64_t offset = 0;
+	while (offset < _output.size()) {
+		pollfd descriptor{_socket, POLLIN | POLLOUT, 0};
+		if (poll(&descriptor, 1, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw std::runtime_error(SystemError("Cannot send request"));
+		}
+
+		if ((descriptor.revents & (POLLIN | POLLHUP)) != 0 && !ReceiveSome(_socket, _input)) {
+			throw std::runtime_error("The server closed the connection");
+		}
+		if ((descriptor.revents & (POLLOUT | POLLERR)) != 0) {
+			const ssize_t sent = send(_socket, _output.data() + offset, _output.size() - offset,
+									  MSG_NOSIGNAL | MSG_DONTWAIT);
+			if (sent < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+				throw std::runtime_error(SystemError("Cannot send request"));
+			}
+			offset += static_cast<uint64_t>(std::max<ssize_t>(sent, 0));
+		}
+	}
+	_output.clear();
+}
+
+FigureResponse FigureClient::Receive() {
+	Flush();
+
+	Fill(frameHeaderSize);
+	FigureResponse response;
+	response.header = ReadFrameHeader(_input.data() + _inputOffset);
+	Fill(frameHeaderSize + response.header.payloadSize);
+	const char* payload = _input.data() + _inputOffset + frameHeaderSize;
+	response.payload.assign(payload, payload + response.header.payloadSize);
+	_inputOffset += frameHeaderSize + response.header.payloadSize;
+
+	return response;
+}
+
+std::vector<DatasetInfo> FigureClient::ListDatasets() {
+	const FigureResponse response = Call(FigureOpcode::ListDatasets, 0, {});
+	return DecodeDatasets(response.payload.data(), response.payload.size());
+}
+
+std::vector<double> FigureClient::Areas(uint32_t dataset, const std::vector<uint64_t>& indices) {
+	const FigureResponse response = Call(FigureOpcode::Areas, dataset, EncodeIndices(indices.data(), indices.size()));
+	return DecodeAreas(response.payload.data(), response.payload.size());
+}
+
+std::vector<Point> FigureClient::Centroids(uint32_t dataset, const std::vector<uint64_t>& indices) {
+	const FigureResponse response = Call(FigureOpcode::Centroids, dataset,
+										 EncodeIndices(indices.data(), indices.size()));
+	return DecodeCentroids(response.payload.data(), response.payload.size());
+}
+
+std::vector<uint64_t> FigureClient::WindowQuery(uint32_t dataset, const BoundingBox& window) {
+	const FigureResponse response = Call(FigureOpcode::WindowQuery, dataset, EncodeWindow(window));
+	return DecodeIndices(response.payload.data(), response.payload.size());
+}
+
+DatasetAggregate FigureClient::Aggregate(uint32_t dataset) {
+	const FigureResponse response = Call(FigureOpcode::Aggregate, dataset, {});
+	return DecodeAggregate(response.payload.data(), response.payload.size());
+}
+
+DatasetAggregate FigureClient::Aggregate(uint32_t dataset, const BoundingBox& window) {
+	const FigureResponse response = Call(FigureOpcode::Aggregate, dataset, EncodeWindow(window));
+	return DecodeAggregate(response.payload.data(), response.payload.size());
+}
+
+FigureResponse FigureClient::Call(FigureOpcode opcode, uint32_t dataset, const std::vector<char>& payload) {
+	const uint32_t id = Send(opcode, dataset, payload);
+	FigureResponse response = Receive();
+	while (response.header.requestId != id) {
+		response = Receive();
+	}
+	if (response.header.status != static_cast<uint16_t>(FigureStatus::Ok)) {
+		throw std::runtime_error(std::string(GetStatusName(static_cast<FigureStatus>(response.header.status))) + ": " +
+								 std::string(response.payload.begin(), response.payload.end()));
+	}
+
+	return response;
+}
+
+void FigureClient::Fill(uint64_t size) {
+	if (_inputOffset > 0 && _inputOffset + size > _input.size()) {
+		_input.erase(_input.begin(), _input.begin() + static_cast<std::ptrdiff_t>(_inputOffset));
+		_inputOffset = 0;
+	}
+	while (_input.size() - _inputOffset < size) {
+		if (!ReceiveSome(_socket, _input)) {
+			throw std::runtime_error("The server closed the connection");
+		}
+	}
+}
@@ -0,0 +1,331 @@
+#include "FigureSort.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr uint64_t sortChunkSize = 1 << 16;
+constexpr uint64_t radixBuckets = 256;
+// Below this many keys a comparison sort beats setting up the passes.
+constexpr uint64_t smallSortSize = 1024;
+// Chunks of TopByKey hold at least this many times k keys, which bounds the
+// heaps of all chunks together by a fraction of the input.
+constexpr uint64_t topChunkFactor = 16;
+
+// Maps a key to an unsigned integer with the same order, flipped for
+// Descending. NaN maps to the largest value in both directions.
+uint64_t OrderedBits(double value, SortOrder order) {
+	if (std::isnan(value)) {
+		return std::numeric_limits<uint64_t>::max();
+	}
+	if (value == 0) {
+		value = 0;
+	}
+
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	bits = (bits >> 63) != 0 ? ~bits : bits | (uint64_t(1) << 63);
+
+	return order == SortOrder::Ascending ? bits : ~bits;
+}
+
+std::array<uint64_t, 1> MakeKey(double key, SortOrder order) {
+	return {OrderedBits(key, order)};
+}
+
+std::array<uint64_t, 2> MakeKey(const Point& key, SortOrder order) {
+	if (std::isnan(key.x) || std::isnan(key.y)) {
+		return {std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max()};
+	}
+
+	return {OrderedBits(key.x, order), OrderedBits(key.y, order)};
+}
+
+template <uint64_t Words>
+struct RadixItem {
+	std::array<uint64_t, Words> key;
+	uint64_t index;
+};
+
+// A byte needs a pass only if some keys differ in it, which shows in the
+// bitwise OR and AND of all keys.
+template <uint64_t Words>
+std::array<uint64_t, Words> FindVaryingBits(const std::vector<RadixItem<Words>>& items, ThreadPool* pool) {
+	const uint64_t chunkCount = ThreadPool::GetChunkCount(items.size(), sortChunkSize);
+	std::vector<std::array<uint64_t, Words>> ors(chunkCount);
+	std::vector<std::array<uint64_t, Words>> ands(chunkCount);
+	ThreadPool::RunChunks(pool, items.size(), sortChunkSize, [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+		std::array<uint64_t, Words> anyBits = items[begin].key;
+		std::array<uint64_t, Words> allBits = items[begin].key;
+		for (uint64_t i = begin + 1; i < end; ++i) {
+			for (uint64_t w = 0; w < Words; ++w) {
+				anyBits[w] |= items[i].key[w];
+				allBits[w] &= items[i].key[w];
+			}
+		}
+		ors[chunk] = anyBits;
+		ands[chunk] = allBits;
+	});
+
+	std::array<uint64_t, Words> varying;
+	for (uint64_t w = 0; w < Words; ++w) {
+		uint64_t anyBits = 0;
+		uint64_t allBits = std::numeric_limits<uint64_t>::max();
+		for (uint64_t chunk = 0; chunk < chunkCount; ++chunk) {
+			anyBits |= ors[chunk][w];
+			allBits &= ands[chunk][w];
+		}
+		varying[w] = anyBits ^ allBits;
+	}
+
+	return varying;
+}
+
+template <uint64_t Words>
+void RadixSort(std::vector<RadixItem<Words>>& items, ThreadPool* pool) {
+	const uint64_t count = items.size();
+	if (count <= smallSortSize) {
+		std::sort(items.begin(), items.end(), [](const RadixItem<Words>& lhs, const RadixItem<Words>& rhs) {
+			return lhs.key != rhs.key ? lhs.key < rhs.key : lhs.index < rhs.index;
+		});
+		return;
+	}
+
+	const std::array<uint64_t, Words> varying = FindVaryingBits(items, pool);
+	const uint64_t chunkCount = ThreadPool::GetChunkCount(count, sortChunkSize);
+	std::vector<std::array<uint64_t, radixBuckets>> offsets(chunkCount);
+	std::vector<RadixItem<Words>> buffer(count);
+
+	// Least significant byte first: the last word holds the least
+	// significant part of the key.
+	for (uint64_t pass = 0; pass < 8 * Words; ++pass) {
+		const uint64_t word = Words - 1 - pass / 8;
+		const uint64_t shift = 8 * (pass % 8);
+		if (((varying[word] >> shift) & (radixBuckets - 1)) == 0) {
+			continue;
+		}
+
+		ThreadPool::RunChunks(pool, count, sortChunkSize, [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+			std::array<uint64_t, radixBuckets>& histogram = offsets[chunk];
+			histogram.fill(0);
+			for (uint64_t i = begin; i < end; ++i) {
+				++histogram[(items[i].key[word] >> shift) & (radixBuckets - 1)];
+			}
+		});
+
+		// Digit-major, then chunk order, which keeps the pass stable.
+		uint64_t offset = 0;
+		for (uint64_t digit = 0; digit < radixBuckets; ++digit) {
+			for (uint64_t chunk = 0; chunk < chunkCount; ++chunk) {
+				const uint64_t size = offsets[chunk][digit];
+				offsets[chunk][digit] = offset;
+				offset += size;
+			}
+		}
+
+		ThreadPool::RunChunks(pool, count, sortChunkSize, [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+			std::array<uint64_t, radixBuckets>& next = offsets[chunk];
+			for (uint64_t i = begin; i < end; ++i) {
+				buffer[next[(items[i].key[word] >> shift) & (radixBuckets - 1)]++] = items[i];
+			}
+		});
+		items.swap(buffer);
+	}
+}
+
+template <typename Key>
+std::vector<uint64_t> Sort(const Key* keys, uint64_t count, ThreadPool* pool, SortOrder order) {
+	constexpr uint64_t words = std::tuple_size<decltype(MakeKey(std::declval<Key>(), order))>::value;
+	std::vector<RadixItem<words>> items(count);
+	ThreadPool::RunChunks(pool, count, sortChunkSize, [&](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			items[i] = {MakeKey(keys[i], order), i};
+		}
+	});
+
+	RadixSort(items, pool);
+
+	std::vector<uint64_t> indices(count);
+	ThreadPool::RunChunks(pool, count, sortChunkSize, [&](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			indices[i] = items[i].index;
+		}
+	});
+
+	return indices;
+}
+
+template <typename Key>
+std::vector<uint64_t> Top(const Key* keys, uint64_t count, uint64_t k, ThreadPool* pool, SortOrder order) {
+	if (k >= count / 2) {
+		std::vector<uint64_t> indices = Sort(keys, count, pool, order);
+		indices.resize(std::min(k, count));
+		return indices;
+	}
+
+	const uint64_t chunkSize = std::max(sortChunkSize, topChunkFactor * k);
+	std::vector<TopKSelector<Key>> selectors(ThreadPool::GetChunkCount(count, chunkSize), TopKSelector<Key>(k, order));
+	ThreadPool::RunChunks(pool, count, chunkSize, [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			selectors[chunk].Push(keys[i], i);
+		}
+	});
+
+	TopKSelector<Key> top(k, order);
+	for (const TopKSelector<Key>& selector : selectors) {
+		top.Merge(selector);
+	}
+
+	return top.GetIndices();
+}
+
+KeyPartition Partition(const double* keys, uint64_t count, double threshold, ThreadPool* pool) {
+	const uint64_t chunkCount = ThreadPool::GetChunkCount(count, sortChunkSize);
+	std::vector<uint64_t> belowCounts(chunkCount);
+	ThreadPool::RunChunks(pool, count, sortChunkSize, [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+		uint64_t below = 0;
+		for (uint64_t i = begin; i < end; ++i) {
+			below += keys[i] < threshold ? 1 : 0;
+		}
+		belowCounts[chunk] = below;
+	});
+
+	uint64_t split = 0;
+	for (uint64_t chunk = 0; chunk < chunkCount; ++chunk) {
+		split += belowCounts[chunk];
+	}
+
+	KeyPartition partition{std::vector<uint64_t>(count), split};
+	std::vector<uint64_t> belowOffsets(chunkCount);
+	uint64_t below = 0;
+	for (uint64_t chunk = 0; chunk < chunkCount; ++chunk) {
+		belowOffsets[chunk] = below;
+		below += belowCounts[chunk];
+	}
+
+	ThreadPool::RunChunks(pool, count, sortChunkSize, [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+		uint64_t nextBelow = belowOffsets[chunk];
+		uint64_t nextAbove = split + begin - belowOffsets[chunk];
+		for (uint64_t i = begin; i < end; ++i) {
+			if (keys[i] < threshold) {
+				partition.indices[nextBelow++] = i;
+			} else {
+				partition.indices[nextAbove++] = i;
+			}
+		}
+	});
+
+	return partition;
+}
+
+}
+
+std::vector<uint64_t> SortByKey(const double* keys, uint64_t count, SortOrder order) {
+	return Sort(keys, count, nullptr, order);
+}
+
+std::vector<uint64_t> SortByKey(const double* keys, uint64_t count, ThreadPool& pool, SortOrder order) {
+	return Sort(keys, count, &pool, order);
+}
+
+std::vector<uint64_t> SortByKey(const Point* keys, uint64_t count, SortOrder order) {
+	return Sort(keys, count, nullptr, order);
+}
+
+std::vector<uint64_t> SortByKey(const Point* keys, uint64_t count, ThreadPool& pool, SortOrder order) {
+	return Sort(keys, count, &pool, order);
+}
+
+std::vector<uint64_t> TopByKey(const double* keys, uint64_t count, uint64_t k, SortOrder order) {
+	return Top(keys, count, k, nullptr, order);
+}
+
+std::vector<uint64_t> TopByKey(const double* keys, uint64_t count, uint64_t k, ThreadPool& pool, SortOrder order) {
+	return Top(keys, count, k, &pool, order);
+}
+
+std::vector<uint64_t> TopByKey(const Point* keys, uint64_t count, uint64_t k, SortOrder order) {
+	return Top(keys, count, k, nullptr, order);
+}
+
+std::vector<uint64_t> TopByKey(const Point* keys, uint64_t count, uint64_t k, ThreadPool& pool, SortOrder order) {
+	return Top(keys, count, k, &pool, order);
+}
+
+KeyPartition PartitionByKey(const double* keys, uint64_t count, double threshold) {
+	return Partition(keys, count, threshold, nullptr);
+}
+
+KeyPartition PartitionByKey(const double* keys, uint64_t count, double threshold, ThreadPool& pool) {
+	return Partition(keys, count, threshold, &pool);
+}
+
+template <typename Key>
+TopKSelector<Key>::TopKSelector(uint64_t k, SortOrder order) : _heap(), _k(k), _order(order) {}
+
+template <typename Key>
+void TopKSelector<Key>::Push(const Key& key, uint64_t index) {
+	std::array<uint64_t, 2> words = {};
+	const auto ordered = MakeKey(key, _order);
+	std::copy(ordered.begin(), ordered.end(), words.begin());
+	Push(Entry{words, index});
+}
+
+template <typename Key>
+void TopKSelector<Key>::Merge(const TopKSelector& other) {
+	if (other._order != _order) {
+		throw std::invalid_argument("Selectors rank in different orders");
+	}
+
+	for (const Entry& entry : other._heap) {
+		Push(entry);
+	}
+}
+
+template <typename Key>
+uint64_t TopKSelector<Key>::GetK() const noexcept {
+	return _k;
+}
+
+template <typename Key>
+uint64_t TopKSelector<Key>::Size() const noexcept {
+	return _heap.size();
+}
+
+template <typename Key>
+std::vector<uint64_t> TopKSelector<Key>::GetIndices() const {
+	std::vector<Entry> sorted = _heap;
+	std::sort(sorted.begin(), sorted.end(), Before);
+
+	std::vector<uint64_t> indices(sorted.size());
+	for (uint64_t i = 0; i < sorted.size(); ++i) {
+		indices[i] = sorted[i].index;
+	}
+
+	return indices;
+}
+
+template <typename Key>
+bool TopKSelector<Key>::Before(const Entry& first, const Entry& second) noexcept {
+	return first.key != second.key ? first.key < second.key : first.index < second.index;
+}
+
+// _heap has the worst kept entry on top.
+template <typename Key>
+void TopKSelector<Key>::Push(const Entry& entry) {
+	if (_heap.size() < _k) {
+		_heap.push_back(entry);
+		std::push_heap(_heap.begin(), _heap.end(), Before);
+	} else if (_k != 0 && Before(entry, _heap.front())) {
+		std::pop_heap(_heap.begin(), _heap.end(), Before);
+		_heap.back() = entry;
+		std::push_heap(_heap.begin(), _heap.end(), Before);
+	}
+}
+
+template class TopKSelector<double>;
+template class TopKSelector<Point>;
@@ -0,0 +1,96 @@
+#include "FigureWriter.h"
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+
+// Longest shortest-round-trip double, e.g. "-2.2250738585072014e-308".
+constexpr uint64_t maxNumberLength = 24;
+constexpr uint64_t maxPointLength = 2 * maxNumberLength + 3;
+
+}
+
+FigureTextWriter::FigureTextWriter(char* buffer, uint64_t capacity, Sink sink) :
+	_buffer(buffer), _capacity(capacity), _used(0), _flushed(0), _sink(std::move(sink)) {
+	if (buffer == nullptr || capacity < minCapacity) {
+		throw std::invalid_argument("Writer buffer is too small");
+	}
+}
+
+FigureTextWriter::FigureTextWriter(char* buffer, uint64_t capacity, std::ostream& ostream) :
+	FigureTextWriter(buffer, capacity, [&ostream](const char* data, uint64_t size) {
+		ostream.write(data, static_cast<std::streamsize>(size));
+	}) {}
+
+FigureTextWriter::~FigureTextWriter() noexcept {
+	try {
+		Flush();
+	} catch (...) {
+	}
+}
+
+void FigureTextWriter::Write(const Point& point) {
+	WritePoints(&point, 1);
+}
+
+void FigureTextWriter::Write(char character) {
+	Reserve(1);
+	_buffer[_used++] = character;
+}
+
+void FigureTextWriter::Write(double value) {
+	Reserve(maxNumberLength);
+	WriteNumber(value);
+}
+
+void FigureTextWriter::Write(uint64_t value) {
+	Reserve(maxNumberLength);
+	std::to_chars_result result = std::to_chars(_buffer + _used, _buffer + _capacity, value);
+	_used = static_cast<uint64_t>(result.ptr - _buffer);
+}
+
+void FigureTextWriter::Write(const char* text) {
+	for (; *text != '\0'; ++text) {
+		Write(*text);
+	}
+}
+
+void FigureTextWriter::Flush() {
+	if (_used == 0) {
+		return;
+	}
+
+	FIGURES_TIME_STAGE(Flush, _used);
+	_sink(_buffer, _used);
+	_flushed += _used;
+	_used = 0;
+}
+
+uint64_t FigureTextWriter::GetBytesWritten() const noexcept {
+	return _flushed + _used;
+}
+
+void FigureTextWriter::WriteNumber(double value) {
+	std::to_chars_result result = std::to_chars(_buffer + _used, _buffer + _capacity, value);
+	_used = static_cast<uint64_t>(result.ptr - _buffer);
+}
+
+void FigureTextWriter::WritePoints(const Point* points, uint64_t count) {
+	for (uint64_t i = 0; i < count; ++i) {
+		Reserve(maxPointLength + 1);
+		if (i != 0) {
+			_buffer[_used++] = ' ';
+		}
+		_buffer[_used++] = '(';
+		WriteNumber(points[i].x);
+		_buffer[_used++] = ' ';
+		WriteNumber(points[i].y);
+		_buffer[_used++] = ')';
+	}
+}
+
+void FigureTextWriter::Reserve(uint64_t size) {
+	if (_capacity - _used < size) {
+		Flush();
+	}
+}
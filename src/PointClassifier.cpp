@@ -0,0 +1,316 @@
+#include "PointClassifier.h"
+#include "FigureKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint64_t rowChunkSize = 16;
+// Points handed to the kernel are rounded up to this many, the width of the
+// widest instruction set, so short runs still fill whole vectors. The extra
+// points are neighbours in the sorted arrays and their results are ignored.
+constexpr uint64_t kernelBlockSize = 8;
+
+struct RowEntry {
+	BoundingBox box;
+	uint64_t figure;
+	uint64_t firstVertex;
+	uint64_t amountOfPoints;
+};
+
+// Index of the first of count sorted values that is not less than value (or
+// greater than it, for upper). The loop has no data-dependent branch, which
+// matters on the short, unpredictable searches made for every figure.
+template <bool upper>
+uint64_t SearchSorted(const double* values, uint64_t count, double value) {
+	if (count == 0) {
+		return 0;
+	}
+
+	const double* base = values;
+	while (count > 1) {
+		uint64_t half = count / 2;
+		base = (upper ? !(value < base[half]) : base[half] < value) ? base + half : base;
+		count -= half;
+	}
+
+	return static_cast<uint64_t>(base - values) + ((upper ? !(value < *base) : *base < value) ? 1 : 0);
+}
+
+double AverageHeight(const FigureOutlines& figures) {
+	double totalHeight = 0;
+	uint64_t count = 0;
+	for (uint64_t i = 0; i < figures.Size(); ++i) {
+		BoundingBox box = ContainmentBox(OutlineBox(figures.GetPoints(i), figures.GetAmountOfPoints(i)));
+		double height = box.maxY - box.minY;
+		if (std::isfinite(height)) {
+			totalHeight += height;
+			++count;
+		}
+	}
+
+	return count == 0 ? 0 : totalHeight / static_cast<double>(count);
+}
+
+}
+
+FigureOutlines::FigureOutlines() : _vertices(), _offsets(1, 0) {}
+
+void FigureOutlines::Reserve(uint64_t figureCount, uint64_t vertexCount) {
+	_vertices.reserve(vertexCount);
+	_offsets.reserve(figureCount + 1);
+}
+
+void FigureOutlines::PushBack(const Point* points, uint64_t amountOfPoints) {
+	if (amountOfPoints < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+
+	_vertices.insert(_vertices.end(), points, points + amountOfPoints);
+	_offsets.push_back(_vertices.size());
+}
+
+uint64_t FigureOutlines::Size() const noexcept {
+	return _offsets.size() - 1;
+}
+
+bool FigureOutlines::Empty() const noexcept {
+	return Size() == 0;
+}
+
+const Point* FigureOutlines::GetPoints(uint64_t figureIndex) const {
+	if (figureIndex >= Size()) {
+		throw std::out_of_range("Index out of range");
+	}
+
+	return _vertices.data() + _offsets[figureIndex];
+}
+
+uint64_t FigureOutlines::GetAmountOfPoints(uint64_t figureIndex) const {
+	if (figureIndex >= Size()) {
+		throw std::out_of_range("Index out of range");
+	}
+
+	return _offsets[figureIndex + 1] - _offsets[figureIndex];
+}
+
+FigureOutlines MakeFigureOutlines(const FigureArray& figures) {
+	FigureOutlines outlines;
+	outlines.Reserve(figures.Size(), 4 * figures.GetRhombuses().size() + 5 * figures.GetPentagons().size() +
+										 6 * figures.GetHexagons().size());
+	figures.ForEach([&outlines](const auto& figure) {
+		outlines.PushBack(figure.GetPoints().data(), figure.GetPoints().size());
+	});
+
+	return outlines;
+}
+
+FigureOutlines MakeFigureOutlines(const std::vector<Polygon>& figures) {
+	FigureOutlines outlines;
+	for (const Polygon& figure : figures) {
+		outlines.PushBack(figure.GetPoints().data(), figure.GetAmountOfPoints());
+	}
+
+	return outlines;
+}
+
+PointClassifier::PointClassifier(const Point* points, uint64_t count, double rowHeight) :
+	_xs(), _ys(), _indices(), _rowOffsets(), _size(count), _minY(0), _rowHeight(0) {
+	std::vector<uint64_t> valid;
+	valid.reserve(count);
+	double maxY = 0;
+	for (uint64_t i = 0; i < count; ++i) {
+		if (std::isnan(points[i].x) || std::isnan(points[i].y)) {
+			continue;
+		}
+		if (valid.empty() || points[i].y < _minY) {
+			_minY = points[i].y;
+		}
+		if (valid.empty() || points[i].y > maxY) {
+			maxY = points[i].y;
+		}
+		valid.push_back(i);
+	}
+
+	const uint64_t maxRowCount = std::max<uint64_t>(1, valid.size() / minPointsPerRow);
+	const double span = maxY - _minY;
+	uint64_t rowCount = maxRowCount;
+	if (!(span > 0)) {
+		rowCount = 1;
+	} else if (rowHeight > 0 && span / rowHeight < static_cast<double>(maxRowCount)) {
+		rowCount = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(span / rowHeight)));
+	}
+	_rowHeight = span / static_cast<double>(rowCount);
+	_rowOffsets.assign(rowCount + 1, 0);
+
+	// Counting sort by row, then by x within each row.
+	std::vector<uint64_t> rows(valid.size());
+	for (uint64_t i = 0; i < valid.size(); ++i) {
+		rows[i] = RowOf(points[valid[i]].y);
+		++_rowOffsets[rows[i] + 1];
+	}
+	for (uint64_t r = 0; r < rowCount; ++r) {
+		_rowOffsets[r + 1] += _rowOffsets[r];
+	}
+
+	struct SortedPoint {
+		double x;
+		double y;
+		uint64_t index;
+	};
+	std::vector<SortedPoint> sorted(valid.size());
+	std::vector<uint64_t> next(_rowOffsets.begin(), _rowOffsets.end() - 1);
+	for (uint64_t i = 0; i < valid.size(); ++i) {
+		const Point& point = points[valid[i]];
+		sorted[next[rows[i]]++] = {point.x, point.y, valid[i]};
+	}
+	for (uint64_t r = 0; r < rowCount; ++r) {
+		std::sort(sorted.begin() + _rowOffsets[r], sorted.begin() + _rowOffsets[r + 1],
+				  [](const SortedPoint& lhs, const SortedPoint& rhs) { return lhs.x < rhs.x; });
+	}
+
+	_xs.resize(sorted.size());
+	_ys.resize(sorted.size());
+	_indices.resize(sorted.size());
+	for (uint64_t i = 0; i < sorted.size(); ++i) {
+		_xs[i] = sorted[i].x;
+		_ys[i] = sorted[i].y;
+		_indices[i] = sorted[i].index;
+	}
+}
+
+uint64_t PointClassifier::Size() const noexcept {
+	return _size;
+}
+
+uint64_t PointClassifier::GetRowCount() const noexcept {
+	return _rowOffsets.size() - 1;
+}
+
+void PointClassifier::Classify(const FigureOutlines& figures, uint64_t* out) const {
+	Classify(figures, out, nullptr);
+}
+
+void PointClassifier::Classify(const FigureOutlines& figures, uint64_t* out, ThreadPool& pool) const {
+	Classify(figures, out, &pool);
+}
+
+// The mapping only grows with y, so a point inside a box lies in a row
+// between the rows of the box edges.
+uint64_t PointClassifier::RowOf(double y) const {
+	double row = (y - _minY) / _rowHeight;
+	if (!(row > 0)) {
+		return 0;
+	}
+	if (row >= static_cast<double>(GetRowCount() - 1)) {
+		return GetRowCount() - 1;
+	}
+
+	return static_cast<uint64_t>(row);
+}
+
+void PointClassifier::Classify(const FigureOutlines& figures, uint64_t* out, ThreadPool* pool) const {
+	FIGURES_TIME_STAGE(Classify, _size);
+	std::fill(out, out + _size, noFigure);
+
+	// Figures copied into every row they span, box and vertices alike, so a
+	// row reads its figures from one contiguous block whatever their order in
+	// the source. Within a row they keep figure order, so the first figure to
+	// claim a point is the one with the lowest index.
+	const uint64_t rowCount = GetRowCount();
+	std::vector<BoundingBox> boxes(figures.Size());
+	std::vector<uint64_t> entryOffsets(rowCount + 1, 0);
+	for (uint64_t i = 0; i < figures.Size(); ++i) {
+		boxes[i] = ContainmentBox(OutlineBox(figures.GetPoints(i), figures.GetAmountOfPoints(i)));
+		if (boxes[i].Empty()) {
+			continue;
+		}
+		for (uint64_t r = RowOf(boxes[i].minY); r <= RowOf(boxes[i].maxY); ++r) {
+			++entryOffsets[r + 1];
+		}
+	}
+	for (uint64_t r = 0; r < rowCount; ++r) {
+		entryOffsets[r + 1] += entryOffsets[r];
+	}
+
+	std::vector<RowEntry> entries(entryOffsets[rowCount]);
+	std::vector<uint64_t> next(entryOffsets.begin(), entryOffsets.end() - 1);
+	for (uint64_t i = 0; i < figures.Size(); ++i) {
+		if (boxes[i].Empty()) {
+			continue;
+		}
+		for (uint64_t r = RowOf(boxes[i].minY); r <= RowOf(boxes[i].maxY); ++r) {
+			entries[next[r]++] = {boxes[i], i, 0, figures.GetAmountOfPoints(i)};
+		}
+	}
+
+	uint64_t vertexCount = 0;
+	for (RowEntry& entry : entries) {
+		entry.firstVertex = vertexCount;
+		vertexCount += entry.amountOfPoints;
+	}
+	std::vector<Point> vertices(vertexCount);
+	for (const RowEntry& entry : entries) {
+		const Point* points = figures.GetPoints(entry.figure);
+		std::copy(points, points + entry.amountOfPoints, vertices.begin() + entry.firstVertex);
+	}
+
+	// Labels are kept in row order while the figures are tested, which keeps
+	// the writes next to the points just read.
+	std::vector<uint64_t> labels(_indices.size(), noFigure);
+	auto classifyRows = [&](uint64_t, uint64_t begin, uint64_t end) {
+		std::vector<uint8_t> inside;
+		for (uint64_t r = begin; r < end; ++r) {
+			const uint64_t rowBegin = _rowOffsets[r];
+			const uint64_t rowSize = _rowOffsets[r + 1] - rowBegin;
+			for (uint64_t k = entryOffsets[r]; k < entryOffsets[r + 1]; ++k) {
+				const RowEntry& entry = entries[k];
+				const uint64_t first = rowBegin + SearchSorted<false>(_xs.data() + rowBegin, rowSize, entry.box.minX);
+				const uint64_t last = rowBegin + SearchSorted<true>(_xs.data() + rowBegin, rowSize, entry.box.maxX);
+				if (first >= last) {
+					continue;
+				}
+
+				const uint64_t blocks = (last - first + kernelBlockSize - 1) / kernelBlockSize;
+				const uint64_t count = std::min<uint64_t>(_xs.size() - first, blocks * kernelBlockSize);
+				inside.resize(count);
+				ContainsPoints(vertices.data() + entry.firstVertex, entry.amountOfPoints, _xs.data() + first,
+							   _ys.data() + first, count, inside.data());
+				for (uint64_t j = 0; j < last - first; ++j) {
+					if (inside[j] != 0 && labels[first + j] == noFigure) {
+						labels[first + j] = entry.figure;
+					}
+				}
+			}
+		}
+	};
+
+	if (pool == nullptr) {
+		classifyRows(0, 0, rowCount);
+	} else {
+		pool->ParallelFor(rowCount, rowChunkSize, classifyRows);
+	}
+
+	for (uint64_t i = 0; i < _indices.size(); ++i) {
+		out[_indices[i]] = labels[i];
+	}
+}
+
+std::vector<uint64_t> Classify(const Point* points, uint64_t count, const FigureOutlines& figures) {
+	std::vector<uint64_t> labels(count);
+	PointClassifier(points, count, AverageHeight(figures)).Classify(figures, labels.data());
+
+	return labels;
+}
+
+std::vector<uint64_t> Classify(const Point* points, uint64_t count, const FigureOutlines& figures, ThreadPool& pool) {
+	std::vector<uint64_t> labels(count);
+	PointClassifier(points, count, AverageHeight(figures)).Classify(figures, labels.data(), pool);
+
+	return labels;
+}
+
+std::vector<uint64_t> Classify(const Point* points, uint64_t count, const FigureArray& figures) {
+	return Classify(points, count, MakeFigureOutlines(figures));
+}
@@ -0,0 +1,136 @@
+#include "Polygon.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+Polygon::Polygon(uint64_t amountOfPoints) : _points(amountOfPoints) {
+	if (amountOfPoints < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+}
+
+Polygon::Polygon(std::vector<Point> points) : _points(std::move(points)) {
+	if (_points.size() < 3) {
+		throw std::invalid_argument("A polygon needs at least three points");
+	}
+}
+
+Polygon::Polygon(const Polygon& other) : Figure(), _points(other._points) {
+	FIGURES_COUNT(Copies);
+}
+
+Polygon::Polygon(Polygon&& moved) noexcept : Figure(), _points(std::move(moved._points)) {
+	FIGURES_COUNT(Moves);
+}
+
+Point Polygon::GetGeometricCenter() const {
+	FIGURES_COUNT(CenterComputations);
+	double xCenterCoord = 0;
+	double yCenterCoord = 0;
+
+	for (const Point& point : _points) {
+		xCenterCoord += point.x;
+		yCenterCoord += point.y;
+	}
+
+	const double count = static_cast<double>(_points.size());
+
+	return {xCenterCoord / count, yCenterCoord / count};
+}
+
+BoundingBox Polygon::GetBoundingBox() const {
+	return OutlineBox(_points.data(), _points.size());
+}
+
+bool Polygon::Contains(const Point& point) const {
+	return ContainmentBox(GetBoundingBox()).Contains(point) && OutlineEdgesContain(_points.data(), _points.size(), point);
+}
+
+void Polygon::Transform(const AffineTransform& transform) {
+	for (Point& point : _points) {
+		point = transform.Apply(point);
+	}
+}
+
+void Polygon::Translate(double dx, double dy) {
+	Transform(AffineTransform::Translation(dx, dy));
+}
+
+void Polygon::Scale(double sx, double sy) {
+	Transform(AffineTransform::Scaling(sx, sy));
+}
+
+void Polygon::Rotate(double angle) {
+	RotateAbout(_points.data(), _points.size(), GetGeometricCenter(), angle);
+}
+
+uint64_t Polygon::GetAmountOfPoints() const noexcept {
+	return _points.size();
+}
+
+const std::vector<Point>& Polygon::GetPoints() const noexcept {
+	return _points;
+}
+
+void swap(Polygon& firstPolygon, Polygon& secondPolygon) noexcept {
+	std::swap(firstPolygon._points, secondPolygon._points);
+}
+
+Polygon& Polygon::operator=(const Polygon& other) {
+	if (this != &other) {
+		Polygon copy(other);
+		swap(*this, copy);
+	}
+
+	return *this;
+}
+
+Polygon& Polygon::operator=(Polygon&& other) noexcept {
+	if (this != &other) {
+		Polygon moved(std::move(other));
+		swap(*this, moved);
+	}
+
+	return *this;
+}
+
+bool Polygon::operator==(const Polygon& other) const {
+	FIGURES_COUNT(Comparisons);
+	if (_points.size() != other._points.size()) {
+		return false;
+	}
+
+	std::vector<Point> lhsCopy = _points;
+	std::vector<Point> rhsCopy = other._points;
+
+	std::sort(lhsCopy.begin(), lhsCopy.end());
+	std::sort(rhsCopy.begin(), rhsCopy.end());
+
+	return lhsCopy == rhsCopy;
+}
+
+std::istream& operator>>(std::istream& istream, Polygon& polygon) {
+	for (Point& point : polygon._points) {
+		if (!(istream >> point)) {
+			throw std::invalid_argument("Incorrect type provided");
+		}
+	}
+
+	return istream;
+}
+
+std::ostream& operator<<(std::ostream& ostream, const Polygon& polygon) {
+	for (uint64_t i = 0; i < polygon._points.size(); ++i) {
+		if (i != 0) {
+			ostream << ' ';
+		}
+		ostream << polygon._points[i];
+	}
+
+	return ostream;
+}
+
+Polygon::operator double() const {
+	FIGURES_COUNT(AreaComputations);
+	return ShoelaceArea(_points.data(), _points.size());
+}
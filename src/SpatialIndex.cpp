@@ -0,0 +1,546 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint64_t parallelChunkSize = 4096;
+
+void ValidateEntries(const std::vector<SpatialEntry>& entries) {
+	for (const SpatialEntry& entry : entries) {
+		if (entry.box.Empty() || !std::isfinite(entry.box.minX) || !std::isfinite(entry.box.minY) ||
+			!std::isfinite(entry.box.maxX) || !std::isfinite(entry.box.maxY) ||
+			!std::isfinite(entry.centroid.x) || !std::isfinite(entry.centroid.y)) {
+			throw std::invalid_argument("Invalid spatial entry");
+		}
+	}
+}
+
+double CentroidDistanceSquared(const SpatialEntry& entry, const Point& point) {
+	double dx = entry.centroid.x - point.x;
+	double dy = entry.centroid.y - point.y;
+
+	return dx * dx + dy * dy;
+}
+
+// Pairs of every chunk are collected separately and sorted at the end, so
+// the result does not depend on the number of threads.
+std::vector<SpatialPair> CollectPairsInChunks(uint64_t count, ThreadPool* pool,
+											   const std::function<void(uint64_t, uint64_t, std::vector<SpatialPair>&)>& collect) {
+	std::vector<SpatialPair> pairs;
+	if (pool == nullptr) {
+		collect(0, count, pairs);
+	} else {
+		std::vector<std::vector<SpatialPair>> partials(ThreadPool::GetChunkCount(count, parallelChunkSize));
+		pool->ParallelFor(count, parallelChunkSize, [&collect, &partials](uint64_t chunk, uint64_t begin, uint64_t end) {
+			collect(begin, end, partials[chunk]);
+		});
+		for (const std::vector<SpatialPair>& partial : partials) {
+			pairs.insert(pairs.end(), partial.begin(), partial.end());
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+
+	return pairs;
+}
+
+SpatialPair MakePair(uint64_t first, uint64_t second) {
+	return first < second ? SpatialPair(first, second) : SpatialPair(second, first);
+}
+
+// Nodes must cover the centroids too, which is what the k-NN search measures.
+BoundingBox ItemBox(const SpatialEntry& entry) {
+	BoundingBox box = entry.box;
+	box.Expand(entry.centroid);
+
+	return box;
+}
+
+template <typename Item>
+BoundingBox ItemBox(const Item& item) {
+	return item.box;
+}
+
+template <typename Item>
+bool LessByCenterX(const Item& first, const Item& second) {
+	return first.box.GetCenter().x < second.box.GetCenter().x;
+}
+
+template <typename Item>
+bool LessByCenterY(const Item& first, const Item& second) {
+	return first.box.GetCenter().y < second.box.GetCenter().y;
+}
+
+// Reorders items so that every run of sliceSize items holds the ones with
+// the smallest x of what follows, without sorting inside the runs.
+template <typename Item>
+void PartitionSlices(Item* begin, Item* end, uint64_t sliceSize) {
+	const uint64_t count = end - begin;
+	if (count <= sliceSize) {
+		return;
+	}
+
+	const uint64_t middle = (count + sliceSize - 1) / sliceSize / 2 * sliceSize;
+	std::nth_element(begin, begin + middle, end, LessByCenterX<Item>);
+	PartitionSlices(begin, begin + middle, sliceSize);
+	PartitionSlices(begin + middle, end, sliceSize);
+}
+
+// One level of Sort-Tile-Recursive packing: items are cut into vertical
+// slices of about sqrt(parent count) parents each, every slice is sorted by
+// y and runs of capacity items become one parent. Parent i covers items
+// [i * capacity, ...), offset by offset in the parents' child indexes.
+template <typename Node, typename Item>
+void PackLevel(std::vector<Item>& items, uint64_t capacity, uint64_t offset, ThreadPool* pool, std::vector<Node>& parents) {
+	const uint64_t parentCount = (items.size() + capacity - 1) / capacity;
+	const uint64_t sliceSize = static_cast<uint64_t>(std::ceil(std::sqrt(static_cast<double>(parentCount)))) * capacity;
+	const uint64_t sliceCount = (items.size() + sliceSize - 1) / sliceSize;
+
+	PartitionSlices(items.data(), items.data() + items.size(), sliceSize);
+	ThreadPool::RunChunks(pool, sliceCount, 1, [&items, sliceSize](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t slice = begin; slice < end; ++slice) {
+			const uint64_t first = slice * sliceSize;
+			const uint64_t last = std::min<uint64_t>(first + sliceSize, items.size());
+			std::sort(items.begin() + first, items.begin() + last, LessByCenterY<Item>);
+		}
+	});
+
+	parents.assign(parentCount, Node());
+	ThreadPool::RunChunks(pool, parentCount, parallelChunkSize / capacity + 1, [&](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t parent = begin; parent < end; ++parent) {
+			const uint64_t first = parent * capacity;
+			const uint64_t count = std::min<uint64_t>(capacity, items.size() - first);
+
+			BoundingBox box;
+			for (uint64_t i = first; i < first + count; ++i) {
+				box.Expand(ItemBox(items[i]));
+			}
+			parents[parent] = {box, offset + first, count};
+		}
+	});
+}
+
+}
+
+std::vector<SpatialEntry> MakeSpatialEntries(const FigureArray& figures) {
+	std::vector<SpatialEntry> entries;
+	entries.reserve(figures.Size());
+	figures.ForEach([&entries](const auto& figure) {
+		entries.push_back(MakeSpatialEntry(figure, entries.size()));
+	});
+
+	return entries;
+}
+
+RTree::RTree() : _leafCount(0), _height(0), _nodeCapacity(defaultNodeCapacity) {}
+
+RTree::RTree(std::vector<SpatialEntry> entries, uint64_t nodeCapacity) :
+	_entries(std::move(entries)), _leafCount(0), _height(0), _nodeCapacity(nodeCapacity) {
+	Build(nullptr);
+}
+
+RTree::RTree(std::vector<SpatialEntry> entries, ThreadPool& pool, uint64_t nodeCapacity) :
+	_entries(std::move(entries)), _leafCount(0), _height(0), _nodeCapacity(nodeCapacity) {
+	Build(&pool);
+}
+
+uint64_t RTree::Size() const noexcept {
+	return _entries.size();
+}
+
+bool RTree::Empty() const noexcept {
+	return _entries.empty();
+}
+
+uint64_t RTree::GetHeight() const noexcept {
+	return _height;
+}
+
+BoundingBox RTree::GetBounds() const noexcept {
+	return _nodes.empty() ? BoundingBox() : _nodes.back().box;
+}
+
+void RTree::Query(const BoundingBox& window, std::vector<uint64_t>& out) const {
+	ForEachIntersecting(window, [this, &out](uint64_t position) { out.push_back(_entries[position].id); });
+}
+
+std::vector<uint64_t> RTree::Query(const BoundingBox& window) const {
+	std::vector<uint64_t> ids;
+	Query(window, ids);
+
+	return ids;
+}
+
+std::vector<uint64_t> RTree::Nearest(const Point& point, uint64_t k) const {
+	// Best-first search. On equal distance nodes are opened before entries
+	// are reported, so no equally distant entry with a smaller id is missed.
+	struct Candidate {
+		double distance;
+		bool isEntry;
+		uint64_t index;
+		uint64_t id;
+
+		bool operator>(const Candidate& other) const {
+			if (distance != other.distance) {
+				return distance > other.distance;
+			}
+			if (isEntry != other.isEntry) {
+				return isEntry;
+			}
+			return id > other.id;
+		}
+	};
+
+	std::vector<uint64_t> ids;
+	if (_nodes.empty() || k == 0) {
+		return ids;
+	}
+
+	std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+	queue.push({_nodes.back().box.DistanceSquared(point), false, _nodes.size() - 1, 0});
+	while (!queue.empty() && ids.size() < k) {
+		const Candidate candidate = queue.top();
+		queue.pop();
+
+		if (candidate.isEntry) {
+			ids.push_back(candidate.id);
+			continue;
+		}
+
+		const Node& node = _nodes[candidate.index];
+		for (uint64_t i = node.first; i < node.first + node.count; ++i) {
+			if (candidate.index < _leafCount) {
+				queue.push({CentroidDistanceSquared(_entries[i], point), true, i, _entries[i].id});
+			} else {
+				queue.push({_nodes[i].box.DistanceSquared(point), false, i, 0});
+			}
+		}
+	}
+
+	return ids;
+}
+
+std::vector<SpatialPair> RTree::OverlapPairs() const {
+	return CollectPairsInChunks(_entries.size(), nullptr, [this](uint64_t begin, uint64_t end, std::vector<SpatialPair>& pairs) {
+		CollectPairs(begin, end, pairs);
+	});
+}
+
+std::vector<SpatialPair> RTree::OverlapPairs(ThreadPool& pool) const {
+	return CollectPairsInChunks(_entries.size(), &pool, [this](uint64_t begin, uint64_t end, std::vector<SpatialPair>& pairs) {
+		CollectPairs(begin, end, pairs);
+	});
+}
+
+void RTree::Build(ThreadPool* pool) {
+	if (_nodeCapacity < 2) {
+		throw std::invalid_argument("Node capacity must be at least 2");
+	}
+	ValidateEntries(_entries);
+	if (_entries.empty()) {
+		return;
+	}
+
+	std::vector<Node> level;
+	PackLevel(_entries, _nodeCapacity, 0, pool, level);
+	_leafCount = level.size();
+	_height = 1;
+
+	while (level.size() > 1) {
+		std::vector<Node> parents;
+		PackLevel(level, _nodeCapacity, _nodes.size(), pool, parents);
+		_nodes.insert(_nodes.end(), level.begin(), level.end());
+		level.swap(parents);
+		++_height;
+	}
+	_nodes.push_back(level.front());
+}
+
+template <typename Function>
+void RTree::ForEachIntersecting(const BoundingBox& window, Function&& function) const {
+	if (_nodes.empty() || !_nodes.back().box.Intersects(window)) {
+		return;
+	}
+
+	std::vector<uint64_t> stack;
+	stack.reserve(_height * _nodeCapacity);
+	stack.push_back(_nodes.size() - 1);
+	while (!stack.empty()) {
+		const uint64_t index = stack.back();
+		stack.pop_back();
+
+		const Node& node = _nodes[index];
+		for (uint64_t i = node.first; i < node.first + node.count; ++i) {
+			if (index < _leafCount) {
+				if (_entries[i].box.Intersects(window)) {
+					function(i);
+				}
+			} else if (_nodes[i].box.Intersects(window)) {
+				stack.push_back(i);
+			}
+		}
+	}
+}
+
+void RTree::CollectPairs(uint64_t begin, uint64_t end, std::vector<SpatialPair>& pairs) const {
+	for (uint64_t i = begin; i < end; ++i) {
+		ForEachIntersecting(_entries[i].box, [this, i, &pairs](uint64_t position) {
+			if (position > i) {
+				pairs.push_back(MakePair(_entries[i].id, _entries[position].id));
+			}
+		});
+	}
+}
+
+UniformGrid::UniformGrid() : _cellStarts(2, 0), _cellSize(1), _reach(0), _columns(1), _rows(1) {}
+
+UniformGrid::UniformGrid(std::vector<SpatialEntry> entries, double cellSize) :
+	_entries(std::move(entries)), _cellSize(1), _reach(0), _columns(1), _rows(1) {
+	Build(nullptr, cellSize);
+}
+
+UniformGrid::UniformGrid(std::vector<SpatialEntry> entries, ThreadPool& pool, double cellSize) :
+	_entries(std::move(entries)), _cellSize(1), _reach(0), _columns(1), _rows(1) {
+	Build(&pool, cellSize);
+}
+
+uint64_t UniformGrid::Size() const noexcept {
+	return _entries.size();
+}
+
+bool UniformGrid::Empty() const noexcept {
+	return _entries.empty();
+}
+
+double UniformGrid::GetCellSize() const noexcept {
+	return _cellSize;
+}
+
+uint64_t UniformGrid::GetColumnCount() const noexcept {
+	return _columns;
+}
+
+uint64_t UniformGrid::GetRowCount() const noexcept {
+	return _rows;
+}
+
+void UniformGrid::Query(const BoundingBox& window, std::vector<uint64_t>& out) const {
+	ForEachIntersecting(window, [this, &out](uint64_t position) { out.push_back(_entries[position].id); });
+}
+
+std::vector<uint64_t> UniformGrid::Query(const BoundingBox& window) const {
+	std::vector<uint64_t> ids;
+	Query(window, ids);
+
+	return ids;
+}
+
+std::vector<uint64_t> UniformGrid::Nearest(const Point& point, uint64_t k) const {
+	using Candidate = std::pair<double, uint64_t>;
+
+	std::vector<uint64_t> ids;
+	if (_entries.empty() || k == 0) {
+		return ids;
+	}
+	k = std::min<uint64_t>(k, _entries.size());
+
+	// The best k candidates so far, the worst on top.
+	std::priority_queue<Candidate> best;
+	auto visitCells = [&](uint64_t row, uint64_t firstColumn, uint64_t lastColumn) {
+		const uint64_t end = _cellStarts[row * _columns + lastColumn + 1];
+		for (uint64_t i = _cellStarts[row * _columns + firstColumn]; i < end; ++i) {
+			const Candidate candidate(CentroidDistanceSquared(_entries[i], point), _entries[i].id);
+			if (best.size() < k) {
+				best.push(candidate);
+			} else if (candidate < best.top()) {
+				best.pop();
+				best.push(candidate);
+			}
+		}
+	};
+
+	// Rings of cells around the one of point, until nothing outside the
+	// visited square can beat the k-th candidate.
+	const int64_t column = static_cast<int64_t>(GetColumn(point.x));
+	const int64_t row = static_cast<int64_t>(GetRow(point.y));
+	const int64_t lastColumn = static_cast<int64_t>(_columns) - 1;
+	const int64_t lastRow = static_cast<int64_t>(_rows) - 1;
+	for (int64_t ring = 0; ; ++ring) {
+		const int64_t firstColumn = std::max<int64_t>(column - ring, 0);
+		const int64_t endColumn = std::min<int64_t>(column + ring, lastColumn);
+		for (int64_t y = std::max<int64_t>(row - ring, 0); y <= std::min<int64_t>(row + ring, lastRow); ++y) {
+			if (y == row - ring || y == row + ring) {
+				visitCells(y, firstColumn, endColumn);
+				continue;
+			}
+			if (column - ring >= 0) {
+				visitCells(y, column - ring, column - ring);
+			}
+			if (column + ring <= lastColumn) {
+				visitCells(y, column + ring, column + ring);
+			}
+		}
+
+		double bound = std::numeric_limits<double>::infinity();
+		if (column - ring > 0) {
+			bound = std::min(bound, point.x - (_centroidBounds.minX + static_cast<double>(column - ring) * _cellSize));
+		}
+		if (column + ring < lastColumn) {
+			bound = std::min(bound, _centroidBounds.minX + static_cast<double>(column + ring + 1) * _cellSize - point.x);
+		}
+		if (row - ring > 0) {
+			bound = std::min(bound, point.y - (_centroidBounds.minY + static_cast<double>(row - ring) * _cellSize));
+		}
+		if (row + ring < lastRow) {
+			bound = std::min(bound, _centroidBounds.minY + static_cast<double>(row + ring + 1) * _cellSize - point.y);
+		}
+
+		if (bound == std::numeric_limits<double>::infinity()) {
+			break;
+		}
+		bound = std::max(bound, 0.0);
+		if (best.size() == k && best.top().first < bound * bound) {
+			break;
+		}
+	}
+
+	ids.resize(best.size());
+	for (uint64_t i = ids.size(); i > 0; --i) {
+		ids[i - 1] = best.top().second;
+		best.pop();
+	}
+
+	return ids;
+}
+
+std::vector<SpatialPair> UniformGrid::OverlapPairs() const {
+	return CollectPairsInChunks(_entries.size(), nullptr, [this](uint64_t begin, uint64_t end, std::vector<SpatialPair>& pairs) {
+		CollectPairs(begin, end, pairs);
+	});
+}
+
+std::vector<SpatialPair> UniformGrid::OverlapPairs(ThreadPool& pool) const {
+	return CollectPairsInChunks(_entries.size(), &pool, [this](uint64_t begin, uint64_t end, std::vector<SpatialPair>& pairs) {
+		CollectPairs(begin, end, pairs);
+	});
+}
+
+void UniformGrid::Build(ThreadPool* pool, double cellSize) {
+	if (!(cellSize >= 0) || !std::isfinite(cellSize)) {
+		throw std::invalid_argument("Cell size must be positive");
+	}
+	ValidateEntries(_entries);
+
+	_cellStarts.assign(2, 0);
+	if (_entries.empty()) {
+		_cellSize = cellSize > 0 ? cellSize : 1;
+		return;
+	}
+
+	for (const SpatialEntry& entry : _entries) {
+		_centroidBounds.Expand(entry.centroid);
+		_reach = std::max({_reach, entry.centroid.x - entry.box.minX, entry.box.maxX - entry.centroid.x,
+						   entry.centroid.y - entry.box.minY, entry.box.maxY - entry.centroid.y});
+	}
+
+	const double width = _centroidBounds.maxX - _centroidBounds.minX;
+	const double height = _centroidBounds.maxY - _centroidBounds.minY;
+	if (!std::isfinite(width) || !std::isfinite(height)) {
+		throw std::invalid_argument("Figures are spread too far for a grid");
+	}
+
+	const double size = static_cast<double>(_entries.size());
+	if (cellSize == 0) {
+		const double cells = std::max(1.0, size / 2);
+		cellSize = std::sqrt(width * height / cells);
+		if (!(cellSize > 0)) {
+			cellSize = std::max(width, height) / cells;
+		}
+		if (!(cellSize > 0)) {
+			cellSize = 1;
+		}
+	}
+	// Too small a cell size would allocate more cells than figures.
+	while ((std::floor(width / cellSize) + 1) * (std::floor(height / cellSize) + 1) > 4 * size + 16) {
+		cellSize *= 2;
+	}
+	_cellSize = cellSize;
+	_columns = static_cast<uint64_t>(std::floor(width / cellSize)) + 1;
+	_rows = static_cast<uint64_t>(std::floor(height / cellSize)) + 1;
+
+	std::vector<uint64_t> cells(_entries.size());
+	ThreadPool::RunChunks(pool, _entries.size(), parallelChunkSize, [this, &cells](uint64_t, uint64_t begin, uint64_t end) {
+		for (uint64_t i = begin; i < end; ++i) {
+			cells[i] = GetRow(_entries[i].centroid.y) * _columns + GetColumn(_entries[i].centroid.x);
+		}
+	});
+
+	// Counting sort by cell; entries of a cell keep their input order.
+	_cellStarts.assign(_columns * _rows + 1, 0);
+	for (uint64_t cell : cells) {
+		++_cellStarts[cell + 1];
+	}
+	for (uint64_t i = 1; i < _cellStarts.size(); ++i) {
+		_cellStarts[i] += _cellStarts[i - 1];
+	}
+
+	std::vector<uint64_t> next(_cellStarts.begin(), _cellStarts.end() - 1);
+	std::vector<SpatialEntry> sorted(_entries.size());
+	for (uint64_t i = 0; i < _entries.size(); ++i) {
+		sorted[next[cells[i]]++] = _entries[i];
+	}
+	_entries.swap(sorted);
+}
+
+uint64_t UniformGrid::GetColumn(double x) const {
+	const double column = std::floor((x - _centroidBounds.minX) / _cellSize);
+	if (!(column > 0)) {
+		return 0;
+	}
+
+	return column >= static_cast<double>(_columns - 1) ? _columns - 1 : static_cast<uint64_t>(column);
+}
+
+uint64_t UniformGrid::GetRow(double y) const {
+	const double row = std::floor((y - _centroidBounds.minY) / _cellSize);
+	if (!(row > 0)) {
+		return 0;
+	}
+
+	return row >= static_cast<double>(_rows - 1) ? _rows - 1 : static_cast<uint64_t>(row);
+}
+
+template <typename Function>
+void UniformGrid::ForEachIntersecting(const BoundingBox& window, Function&& function) const {
+	// A box that meets window has its centroid within _reach of it.
+	const BoundingBox widened(window.minX - _reach, window.minY - _reach, window.maxX + _reach, window.maxY + _reach);
+	if (_entries.empty() || window.Empty() || !widened.Intersects(_centroidBounds)) {
+		return;
+	}
+
+	const uint64_t firstColumn = GetColumn(widened.minX);
+	const uint64_t lastColumn = GetColumn(widened.maxX);
+	const uint64_t lastRow = GetRow(widened.maxY);
+	for (uint64_t row = GetRow(widened.minY); row <= lastRow; ++row) {
+		const uint64_t end = _cellStarts[row * _columns + lastColumn + 1];
+		for (uint64_t i = _cellStarts[row * _columns + firstColumn]; i < end; ++i) {
+			if (_entries[i].box.Intersects(window)) {
+				function(i);
+			}
+		}
+	}
+}
+
+void UniformGrid::CollectPairs(uint64_t begin, uint64_t end, std::vector<SpatialPair>& pairs) const {
+	for (uint64_t i = begin; i < end; ++i) {
+		ForEachIntersecting(_entries[i].box, [this, i, &pairs](uint64_t position) {
+			if (position > i) {
+				pairs.push_back(MakePair(_entries[i].id, _entries[position].id));
+			}
+		});
+	}
+}
@@ -0,0 +1,182 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <stdexcept>
+
+namespace {
+
+thread_local const ThreadPool* currentPool = nullptr;
+
+}
+
+struct ThreadPool::Job {
+	struct Queue {
+		std::mutex mutex;
+		std::deque<uint64_t> chunks;
+	};
+
+	const ChunkTask* task;
+	uint64_t count;
+	uint64_t chunkSize;
+	std::vector<Queue> queues;
+	std::mutex exceptionMutex;
+	std::exception_ptr exception;
+
+	Job(const ChunkTask& task, uint64_t count, uint64_t chunkSize, uint64_t threadCount) :
+		task(&task), count(count), chunkSize(chunkSize), queues(threadCount) {}
+};
+
+ThreadPool::ThreadPool(uint64_t threadCount) : _job(nullptr), _generation(0), _activeWorkers(0), _stopping(false) {
+	if (threadCount == 0) {
+		threadCount = std::thread::hardware_concurrency();
+	}
+	if (threadCount == 0) {
+		threadCount = 1;
+	}
+
+	for (uint64_t i = 1; i < threadCount; ++i) {
+		_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_wakeUp.notify_all();
+
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+}
+
+uint64_t ThreadPool::GetThreadCount() const noexcept {
+	return _workers.size() + 1;
+}
+
+uint64_t ThreadPool::GetChunkCount(uint64_t count, uint64_t chunkSize) {
+	return chunkSize == 0 ? 0 : (count + chunkSize - 1) / chunkSize;
+}
+
+void ThreadPool::RunChunks(ThreadPool* pool, uint64_t count, uint64_t chunkSize, const ChunkTask& task) {
+	if (pool != nullptr) {
+		pool->ParallelFor(count, chunkSize, task);
+		return;
+	}
+
+	for (uint64_t chunk = 0; chunk < GetChunkCount(count, chunkSize); ++chunk) {
+		task(chunk, chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+	}
+}
+
+void ThreadPool::ParallelFor(uint64_t count, uint64_t chunkSize, const ChunkTask& task) {
+	if (chunkSize == 0) {
+		throw std::invalid_argument("Chunk size must be positive");
+	}
+
+	uint64_t chunkCount = GetChunkCount(count, chunkSize);
+	if (currentPool != nullptr || _workers.empty() || chunkCount <= 1) {
+		for (uint64_t i = 0; i < chunkCount; ++i) {
+			task(i, i * chunkSize, std::min(count, (i + 1) * chunkSize));
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> submitLock(_submitMutex);
+	Job job(task, count, chunkSize, GetThreadCount());
+	for (uint64_t i = 0; i < chunkCount; ++i) {
+		job.queues[i * job.queues.size() / chunkCount].chunks.push_back(i);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_job = &job;
+		++_generation;
+	}
+	_wakeUp.notify_all();
+
+	currentPool = this;
+	RunJob(job, 0);
+	currentPool = nullptr;
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_finished.wait(lock, [this] { return _activeWorkers == 0; });
+		_job = nullptr;
+	}
+
+	if (job.exception) {
+		std::rethrow_exception(job.exception);
+	}
+}
+
+void ThreadPool::WorkerLoop(uint64_t index) {
+	currentPool = this;
+	uint64_t seenGeneration = 0;
+
+	while (true) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_wakeUp.wait(lock, [this, seenGeneration] { return _stopping || _generation != seenGeneration; });
+		if (_stopping) {
+			return;
+		}
+
+		seenGeneration = _generation;
+		Job* job = _job;
+		if (job == nullptr) {
+			continue;
+		}
+		++_activeWorkers;
+		lock.unlock();
+
+		RunJob(*job, index);
+
+		lock.lock();
+		if (--_activeWorkers == 0) {
+			_finished.notify_all();
+		}
+	}
+}
+
+void ThreadPool::RunJob(Job& job, uint64_t index) {
+	uint64_t queueCount = job.queues.size();
+
+	while (true) {
+		uint64_t chunk = 0;
+		bool found = false;
+
+		for (uint64_t i = 0; i < queueCount && !found; ++i) {
+			Job::Queue& queue = job.queues[(index + i) % queueCount];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.chunks.empty()) {
+				continue;
+			}
+
+			// Own chunks are taken from the front to keep memory access
+			// sequential; stolen ones from the back, far from the owner.
+			if (i == 0) {
+				chunk = queue.chunks.front();
+				queue.chunks.pop_front();
+			} else {
+				chunk = queue.chunks.back();
+				queue.chunks.pop_back();
+			}
+			found = true;
+		}
+
+		if (!found) {
+			return;
+		}
+
+		try {
+			(*job.task)(chunk, chunk * job.chunkSize, std::min(job.count, (chunk + 1) * job.chunkSize));
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(job.exceptionMutex);
+			if (!job.exception) {
+				job.exception = std::current_exception();
+			}
+		}
+	}
+}
@@ -0,0 +1,274 @@
+#include "FigureServer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* const usage =
+	"Usage: figure_loadgen --socket PATH [options]\n"
+	"Sends random requests to a figure_server and reports throughput and\n"
+	"latency percentiles. Latency runs from queueing a request to reading its\n"
+	"response, so it includes the wait behind the requests in flight.\n"
+	"\n"
+	"  --socket PATH                          socket of the server\n"
+	"  --dataset ID                           dataset to query (default 0)\n"
+	"  --op areas|centroids|window|aggregate  request type (default areas)\n"
+	"  --connections N                        parallel connections (default 1)\n"
+	"  --requests N                           requests per connection (default 10000)\n"
+	"  --batch N                              figures per areas or centroids request (default 64)\n"
+	"  --depth N                              requests in flight per connection (default 16)\n"
+	"  --window FRACTION                      window side as a fraction of the bounds (default 0.01)\n"
+	"  --help                                 show this message\n";
+
+struct Arguments {
+	std::string socketPath;
+	uint32_t dataset = 0;
+	FigureOpcode opcode = FigureOpcode::Areas;
+	uint64_t connections = 1;
+	uint64_t requests = 10000;
+	uint64_t batch = 64;
+	uint64_t depth = 16;
+	double window = 0.01;
+};
+
+struct ConnectionResult {
+	std::vector<uint64_t> latencies;
+	uint64_t errors = 0;
+	std::string failure;
+};
+
+uint64_t ParseCount(const std::string& value) {
+	uint64_t result = 0;
+	try {
+		std::size_t used = 0;
+		result = std::stoull(value, &used);
+		if (used != value.size() || value[0] == '-') {
+			throw std::invalid_argument(value);
+		}
+	} catch (const std::exception&) {
+		throw std::invalid_argument("Invalid number: " + value);
+	}
+
+	return result;
+}
+
+double ParseFraction(const std::string& value) {
+	double result = 0;
+	try {
+		std::size_t used = 0;
+		result = std::stod(value, &used);
+		if (used != value.size() || !(result > 0 && result <= 1)) {
+			throw std::invalid_argument(value);
+		}
+	} catch (const std::exception&) {
+		throw std::invalid_argument("Invalid fraction: " + value);
+	}
+
+	return result;
+}
+
+FigureOpcode ParseOpcode(const std::string& value) {
+	if (value == "areas") {
+		return FigureOpcode::Areas;
+	}
+	if (value == "centroids") {
+		return FigureOpcode::Centroids;
+	}
+	if (value == "window") {
+		return FigureOpcode::WindowQuery;
+	}
+	if (value == "aggregate") {
+		return FigureOpcode::Aggregate;
+	}
+
+	throw std::invalid_argument("Unknown request type: " + value);
+}
+
+Arguments ParseArguments(int argc, char** argv) {
+	Arguments arguments;
+	for (int i = 1; i < argc; ++i) {
+		const std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) {
+				throw std::invalid_argument("Missing value for " + argument);
+			}
+			return argv[++i];
+		};
+
+		if (argument == "--socket") {
+			arguments.socketPath = value();
+		} else if (argument == "--dataset") {
+			arguments.dataset = static_cast<uint32_t>(ParseCount(value()));
+		} else if (argument == "--op") {
+			arguments.opcode = ParseOpcode(value());
+		} else if (argument == "--connections") {
+			arguments.connections = std::max<uint64_t>(1, ParseCount(value()));
+		} else if (argument == "--requests") {
+			arguments.requests = ParseCount(value());
+		} else if (argument == "--batch") {
+			arguments.batch = std::max<uint64_t>(1, ParseCount(value()));
+		} else if (argument == "--depth") {
+			arguments.depth = std::max<uint64_t>(1, ParseCount(value()));
+		} else if (argument == "--window") {
+			arguments.window = ParseFraction(value());
+		} else {
+			throw std::invalid_argument("Unknown option: " + argument);
+		}
+	}
+	if (arguments.socketPath.empty()) {
+		throw std::invalid_argument("Missing --socket");
+	}
+
+	return arguments;
+}
+
+std::vector<char> MakePayload(const Arguments& arguments, uint64_t figureCount, const BoundingBox& bounds,
+							  std::mt19937_64& generator) {
+	if (arguments.opcode == FigureOpcode::Areas || arguments.opcode == FigureOpcode::Centroids) {
+		std::uniform_int_distribution<uint64_t> index(0, figureCount - 1);
+		std::vector<uint64_t> indices(arguments.batch);
+		for (uint64_t& value : indices) {
+			value = index(generator);
+		}
+		return EncodeIndices(indices.data(), indices.size());
+	}
+	if (arguments.opcode == FigureOpcode::Aggregate && arguments.window >= 1) {
+		return {};
+	}
+
+	const double width = (bounds.maxX - bounds.minX) * arguments.window;
+	const double height = (bounds.maxY - bounds.minY) * arguments.window;
+	std::uniform_real_distribution<double> x(bounds.minX, std::max(bounds.minX, bounds.maxX - width));
+	std::uniform_real_distribution<double> y(bounds.minY, std::max(bounds.minY, bounds.maxY - height));
+	const double minX = x(generator);
+	const double minY = y(generator);
+
+	return EncodeWindow(BoundingBox(minX, minY, minX + width, minY + height));
+}
+
+// Keeps depth requests in flight until requests responses have come back.
+void RunConnection(const Arguments& arguments, uint64_t figureCount, const BoundingBox& bounds, uint64_t seed,
+				   ConnectionResult& result) {
+	try {
+		FigureClient client(arguments.socketPath);
+		std::mt19937_64 generator(seed);
+		std::deque<std::chrono::steady_clock::time_point> sendTimes;
+		result.latencies.reserve(arguments.requests);
+
+		uint64_t sent = 0;
+		while (result.latencies.size() < arguments.requests) {
+			while (sent < arguments.requests && sendTimes.size() < arguments.depth) {
+				client.Send(arguments.opcode, arguments.dataset, MakePayload(arguments, figureCount, bounds, generator));
+				sendTimes.push_back(std::chrono::steady_clock::now());
+				++sent;
+			}
+
+			const FigureResponse response = client.Receive();
+			const auto latency = std::chrono::steady_clock::now() - sendTimes.front();
+			sendTimes.pop_front();
+			result.latencies.push_back(
+				static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+			if (response.header.status != static_cast<uint16_t>(FigureStatus::Ok)) {
+				++result.errors;
+			}
+		}
+	} catch (const std::exception& exception) {
+		result.failure = exception.what();
+	}
+}
+
+double Percentile(const std::vector<uint64_t>& sorted, double fraction) {
+	if (sorted.empty()) {
+		return 0;
+	}
+
+	const uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+	return static_cast<double>(sorted[rank]) / 1000;
+}
+
+}
+
+int main(int argc, char** argv) {
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--help") == 0) {
+			std::cout << usage;
+			return 0;
+		}
+	}
+
+	Arguments arguments;
+	try {
+		arguments = ParseArguments(argc, argv);
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n' << usage;
+		return 2;
+	}
+
+	try {
+		std::vector<DatasetInfo> datasets;
+		BoundingBox bounds;
+		{
+			// Closed before the load starts, so that only the load
+			// connections are measured.
+			FigureClient probe(arguments.socketPath);
+			datasets = probe.ListDatasets();
+			if (arguments.dataset >= datasets.size()) {
+				throw std::invalid_argument("The server has no dataset " + std::to_string(arguments.dataset));
+			}
+			if (datasets[arguments.dataset].figureCount == 0) {
+				throw std::invalid_argument("Dataset " + datasets[arguments.dataset].name + " is empty");
+			}
+			bounds = probe.Aggregate(arguments.dataset).bounds;
+		}
+		const uint64_t figureCount = datasets[arguments.dataset].figureCount;
+
+		std::vector<ConnectionResult> results(arguments.connections);
+		std::vector<std::thread> threads;
+		const auto start = std::chrono::steady_clock::now();
+		for (uint64_t i = 0; i < arguments.connections; ++i) {
+			threads.emplace_back(RunConnection, std::cref(arguments), figureCount, std::cref(bounds), 1000 + i,
+								 std::ref(results[i]));
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::vector<uint64_t> latencies;
+		uint64_t errors = 0;
+		for (const ConnectionResult& result : results) {
+			if (!result.failure.empty()) {
+				throw std::runtime_error(result.failure);
+			}
+			latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+			errors += result.errors;
+		}
+		std::sort(latencies.begin(), latencies.end());
+
+		const bool batched = arguments.opcode == FigureOpcode::Areas || arguments.opcode == FigureOpcode::Centroids;
+		const double requestsPerSecond = static_cast<double>(latencies.size()) / seconds;
+		std::cout << "dataset " << datasets[arguments.dataset].name << ", " << arguments.connections
+				  << " connections, depth " << arguments.depth << '\n'
+				  << "requests " << latencies.size() << ", errors " << errors << ", seconds " << seconds << '\n'
+				  << "requests/s " << requestsPerSecond;
+		if (batched) {
+			std::cout << ", figures/s " << requestsPerSecond * static_cast<double>(arguments.batch);
+		}
+		std::cout << '\n'
+				  << "latency us p50 " << Percentile(latencies, 0.5) << ", p90 " << Percentile(latencies, 0.9)
+				  << ", p99 " << Percentile(latencies, 0.99) << ", max " << Percentile(latencies, 1) << '\n';
+		return errors == 0 ? 0 : 1;
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n';
+		return 1;
+	}
+}
@@ -0,0 +1,140 @@
+#include "FigureServer.h"
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <pthread.h>
+
+namespace {
+
+const char* const usage =
+	"Usage: figure_server --socket PATH [options] NAME=FILE...\n"
+	"Loads every FILE once as the dataset NAME (ids in command line order) and\n"
+	"answers requests on the Unix socket PATH until SIGINT or SIGTERM.\n"
+	"\n"
+	"  --socket PATH                    socket to listen on\n"
+	"  --threads N                      worker threads (default one per hardware thread);\n"
+	"                                   they take turns on all open connections\n"
+	"  --type rhombus|pentagon|hexagon  figures in text files (default rhombus);\n"
+	"                                   binary figure files are detected\n"
+	"  --help                           show this message\n";
+
+struct Arguments {
+	std::string socketPath;
+	uint64_t threadCount = 0;
+	uint64_t amountOfPoints = 4;
+	std::vector<std::pair<std::string, std::string>> datasets;
+};
+
+uint64_t ParseCount(const std::string& value) {
+	uint64_t result = 0;
+	try {
+		std::size_t used = 0;
+		result = std::stoull(value, &used);
+		if (used != value.size() || value[0] == '-') {
+			throw std::invalid_argument(value);
+		}
+	} catch (const std::exception&) {
+		throw std::invalid_argument("Invalid number: " + value);
+	}
+
+	return result;
+}
+
+uint64_t ParseType(const std::string& value) {
+	if (value == "rhombus") {
+		return 4;
+	}
+	if (value == "pentagon") {
+		return 5;
+	}
+	if (value == "hexagon") {
+		return 6;
+	}
+
+	throw std::invalid_argument("Unknown figure type: " + value);
+}
+
+Arguments ParseArguments(int argc, char** argv) {
+	Arguments arguments;
+	for (int i = 1; i < argc; ++i) {
+		const std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) {
+				throw std::invalid_argument("Missing value for " + argument);
+			}
+			return argv[++i];
+		};
+
+		if (argument == "--socket") {
+			arguments.socketPath = value();
+		} else if (argument == "--threads") {
+			arguments.threadCount = ParseCount(value());
+		} else if (argument == "--type") {
+			arguments.amountOfPoints = ParseType(value());
+		} else if (argument.size() > 1 && argument[0] == '-') {
+			throw std::invalid_argument("Unknown option: " + argument);
+		} else {
+			const std::size_t separator = argument.find('=');
+			if (separator == std::string::npos || separator == 0 || separator + 1 == argument.size()) {
+				throw std::invalid_argument("Datasets are given as NAME=FILE: " + argument);
+			}
+			arguments.datasets.emplace_back(argument.substr(0, separator), argument.substr(separator + 1));
+		}
+	}
+	if (arguments.socketPath.empty()) {
+		throw std::invalid_argument("Missing --socket");
+	}
+
+	return arguments;
+}
+
+}
+
+int main(int argc, char** argv) {
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--help") == 0) {
+			std::cout << usage;
+			return 0;
+		}
+	}
+
+	Arguments arguments;
+	try {
+		arguments = ParseArguments(argc, argv);
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n' << usage;
+		return 2;
+	}
+
+	// Blocked before any thread starts, so every thread inherits the mask and
+	// the signals are only taken by sigwait() below.
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+	try {
+		FigureServer server(arguments.socketPath, arguments.threadCount);
+		for (const std::pair<std::string, std::string>& dataset : arguments.datasets) {
+			const uint32_t id = server.AddDataset(dataset.first, LoadFigureDataset(dataset.second, arguments.amountOfPoints));
+			std::cerr << "dataset " << id << ' ' << dataset.first << ": " << server.GetDataset(id).Size() << " figures\n";
+		}
+
+		server.Start();
+		std::cerr << "listening on " << server.GetSocketPath() << " with " << server.GetThreadCount() << " threads\n";
+
+		int signal = 0;
+		sigwait(&signals, &signal);
+		server.Stop();
+		return 0;
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n';
+		return 1;
+	}
+}
@@ -1,3 +1,153 @@
 #include "Figures.h"
+#include "FigureFile.h"
+#include "FigurePipeline.h"
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
-int main() {}
\ No newline at end of file
+namespace {
+
+const char* const usage =
+	"Usage: main [options] [file...]\n"
+	"Reads figures from the files, or from standard input if none is given or\n"
+	"for \"-\", and writes \"index area (x y)\" per figure followed by a summary.\n"
+	"\n"
+	"  --type rhombus|pentagon|hexagon  figures in text input (default rhombus)\n"
+	"  --binary                         inputs are binary figure files\n"
+	"  --top K                          largest figures listed in the summary (default 10)\n"
+	"  --read-size BYTES                text read at a time (default 1048576)\n"
+	"  --summary-only                   write the summary only\n"
+	"  --help                           show this message\n";
+
+struct Arguments {
+	PipelineOptions options;
+	bool binary = false;
+	std::vector<std::string> inputs;
+};
+
+uint64_t ParseCount(const std::string& value) {
+	uint64_t result = 0;
+	try {
+		std::size_t used = 0;
+		result = std::stoull(value, &used);
+		if (used != value.size() || value[0] == '-') {
+			throw std::invalid_argument(value);
+		}
+	} catch (const std::exception&) {
+		throw std::invalid_argument("Invalid number: " + value);
+	}
+
+	return result;
+}
+
+uint64_t ParseType(const std::string& value) {
+	if (value == "rhombus") {
+		return 4;
+	}
+	if (value == "pentagon") {
+		return 5;
+	}
+	if (value == "hexagon") {
+		return 6;
+	}
+
+	throw std::invalid_argument("Unknown figure type: " + value);
+}
+
+Arguments ParseArguments(int argc, char** argv) {
+	Arguments arguments;
+	for (int i = 1; i < argc; ++i) {
+		const std::string argument = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc) {
+				throw std::invalid_argument("Missing value for " + argument);
+			}
+			return argv[++i];
+		};
+
+		if (argument == "--type") {
+			arguments.options.amountOfPoints = ParseType(value());
+		} else if (argument == "--binary") {
+			arguments.binary = true;
+		} else if (argument == "--top") {
+			arguments.options.topCount = ParseCount(value());
+		} else if (argument == "--read-size") {
+			arguments.options.readSize = ParseCount(value());
+		} else if (argument == "--summary-only") {
+			arguments.options.writeFigures = false;
+		} else if (argument.size() > 1 && argument[0] == '-') {
+			throw std::invalid_argument("Unknown option: " + argument);
+		} else {
+			arguments.inputs.push_back(argument);
+		}
+	}
+	if (arguments.inputs.empty()) {
+		arguments.inputs.emplace_back("-");
+	}
+
+	return arguments;
+}
+
+void ReportErrors(const FigurePipeline& pipeline, uint64_t& reported, const std::string& input) {
+	const std::vector<ParseError>& errors = pipeline.GetErrors();
+	for (; reported < errors.size(); ++reported) {
+		std::cerr << (input == "-" ? "<stdin>" : input) << ':' << errors[reported].line << ':'
+				  << errors[reported].column << ": " << errors[reported].message << '\n';
+	}
+}
+
+}
+
+int main(int argc, char** argv) {
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--help") == 0) {
+			std::cout << usage;
+			return 0;
+		}
+	}
+
+	Arguments arguments;
+	try {
+		arguments = ParseArguments(argc, argv);
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n' << usage;
+		return 2;
+	}
+
+	std::ios::sync_with_stdio(false);
+	try {
+		FigurePipeline pipeline(arguments.options);
+		uint64_t reported = 0;
+		for (const std::string& input : arguments.inputs) {
+			if (arguments.binary) {
+				if (input == "-") {
+					throw std::invalid_argument("Binary input must be a file");
+				}
+				pipeline.ProcessBinary(FigureFileReader(input), std::cout);
+			} else if (input == "-") {
+				pipeline.ProcessText(std::cin, std::cout);
+			} else {
+				std::ifstream file(input, std::ios::binary);
+				if (!file) {
+					throw std::runtime_error("Failed to open " + input);
+				}
+				pipeline.ProcessText(file, std::cout);
+			}
+			ReportErrors(pipeline, reported, input);
+		}
+
+		pipeline.WriteSummary(std::cout);
+		std::cout.flush();
+		if (pipeline.GetErrorCount() > reported) {
+			std::cerr << pipeline.GetErrorCount() - reported << " more errors\n";
+		}
+		return pipeline.GetErrorCount() == 0 && std::cout ? 0 : 1;
+	} catch (const std::exception& exception) {
+		std::cerr << exception.what() << '\n';
+		return 1;
+	}
+}
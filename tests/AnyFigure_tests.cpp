@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "AnyFigure.h"
+
+static Rhombus MakeRhombus() {
+    Rhombus rhombus;
+    std::istringstream is("0 1 1 0 0 -1 -1 0");
+    is >> rhombus;
+    return rhombus;
+}
+
+static Hexagon MakeHexagon() {
+    Hexagon hexagon;
+    std::istringstream is("1 0 0.5 0.866 -0.5 0.866 -1 0 -0.5 -0.866 0.5 -0.866");
+    is >> hexagon;
+    return hexagon;
+}
+
+TEST(AnyFigureTests, DefaultConstructor) {
+    const AnyFigure figure;
+    EXPECT_TRUE(figure.Holds<Rhombus>());
+    EXPECT_EQ(figure.GetAmountOfPoints(), 4);
+    EXPECT_DOUBLE_EQ(static_cast<double>(figure), 0.0);
+}
+
+TEST(AnyFigureTests, MatchesHeldFigure) {
+    const Hexagon hexagon = MakeHexagon();
+    const AnyFigure figure(hexagon);
+    EXPECT_TRUE(figure.Holds<Hexagon>());
+    EXPECT_FALSE(figure.Holds<Pentagon>());
+    EXPECT_EQ(figure.Get<Rhombus>(), nullptr);
+    EXPECT_EQ(figure.GetAmountOfPoints(), 6);
+    EXPECT_EQ(static_cast<double>(figure), static_cast<double>(hexagon));
+    EXPECT_TRUE(figure.GetGeometricCenter() == hexagon.GetGeometricCenter());
+    EXPECT_EQ(static_cast<double>(figure.AsFigure()), static_cast<double>(hexagon));
+}
+
+TEST(AnyFigureTests, Contains) {
+    const AnyFigure figure(MakeRhombus());
+    EXPECT_TRUE(figure.Contains(Point(0.25, 0.25)));
+    EXPECT_TRUE(figure.Contains(Point(1, 0)));
+    EXPECT_FALSE(figure.Contains(Point(0.75, 0.75)));
+}
+
+TEST(AnyFigureTests, ComparisonOperators) {
+    const AnyFigure rhombus(MakeRhombus());
+    const AnyFigure sameRhombus(MakeRhombus());
+    const AnyFigure hexagon(MakeHexagon());
+    EXPECT_TRUE(rhombus == sameRhombus);
+    EXPECT_TRUE(rhombus != hexagon);
+    EXPECT_FALSE(rhombus == AnyFigure());
+}
+
+TEST(AnyFigureTests, OutputStreamOperator) {
+    std::ostringstream expected;
+    expected << MakeRhombus();
+    std::ostringstream os;
+    os << AnyFigure(MakeRhombus());
+    EXPECT_EQ(os.str(), expected.str());
+}
+
+TEST(FigureArrayTypedTests, StoresKindsSeparately) {
+    FigureArray figures;
+    figures.PushBack(AnyFigure(MakeHexagon()));
+    figures.PushBack(MakeRhombus());
+    figures.PushBack(Pentagon());
+    figures.PushBack(AnyFigure(MakeRhombus()));
+    EXPECT_EQ(figures.Size(), 4);
+    EXPECT_EQ(figures.GetRhombuses().size(), 2);
+    EXPECT_EQ(figures.GetPentagons().size(), 1);
+    EXPECT_EQ(figures.GetHexagons().size(), 1);
+    EXPECT_TRUE(figures[0].Holds<Rhombus>());
+    EXPECT_TRUE(figures[2].Holds<Pentagon>());
+    EXPECT_TRUE(figures[3].Holds<Hexagon>());
+    EXPECT_THROW(figures[4], std::out_of_range);
+}
+
+TEST(FigureArrayTypedTests, AreasCentersAndTotal) {
+    FigureArray figures;
+    figures.PushBack(MakeHexagon());
+    figures.PushBack(MakeRhombus());
+    const std::vector<double> areas = figures.Areas();
+    const std::vector<Point> centers = figures.GeometricCenters();
+    ASSERT_EQ(areas.size(), 2);
+    EXPECT_EQ(areas[0], static_cast<double>(MakeRhombus()));
+    EXPECT_EQ(areas[1], static_cast<double>(MakeHexagon()));
+    EXPECT_TRUE(centers[1] == MakeHexagon().GetGeometricCenter());
+    EXPECT_DOUBLE_EQ(figures.TotalArea(), areas[0] + areas[1]);
+
+    figures.Clear();
+    EXPECT_TRUE(figures.Empty());
+    EXPECT_DOUBLE_EQ(figures.TotalArea(), 0.0);
+}
+
+TEST(FigureArrayTypedTests, Transform) {
+    FigureArray figures;
+    figures.PushBack(Rhombus({Point(0, 1), Point(1, 0), Point(0, -1), Point(-1, 0)}));
+    figures.PushBack(Hexagon());
+    figures.Transform(AffineTransform::Translation(3, 4));
+    EXPECT_TRUE(figures[0].GetGeometricCenter() == Point(3, 4));
+    EXPECT_TRUE(figures[1].GetGeometricCenter() == Point(3, 4));
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "BoundedQueue.h"
+
+TEST(BoundedQueueTests, FirstInFirstOut) {
+    BoundedQueue<int> queue(3);
+    EXPECT_TRUE(queue.Push(1));
+    EXPECT_TRUE(queue.Push(2));
+    EXPECT_EQ(queue.Size(), 2);
+
+    int value = 0;
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 1);
+    queue.Close();
+    EXPECT_FALSE(queue.Push(3));
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(queue.Pop(value));
+    EXPECT_TRUE(queue.IsClosed());
+}
+
+TEST(BoundedQueueTests, ProducerWaitsForConsumer) {
+    BoundedQueue<std::vector<int>> queue(2);
+    std::thread producer([&queue]() {
+        for (int i = 0; i < 1000; ++i) {
+            EXPECT_LE(queue.Size(), 2);
+            queue.Push(std::vector<int>(3, i));
+        }
+        queue.Close();
+    });
+
+    std::vector<int> chunk;
+    int expected = 0;
+    while (queue.Pop(chunk)) {
+        EXPECT_EQ(chunk, std::vector<int>(3, expected));
+        ++expected;
+    }
+    producer.join();
+    EXPECT_EQ(expected, 1000);
+}
+
+TEST(BoundedQueueTests, CloseWakesBlockedProducer) {
+    BoundedQueue<int> queue(1);
+    queue.Push(1);
+    std::thread producer([&queue]() { EXPECT_FALSE(queue.Push(2)); });
+    queue.Close();
+    producer.join();
+    EXPECT_THROW(BoundedQueue<int>(0), std::invalid_argument);
+}
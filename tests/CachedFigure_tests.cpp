@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "CachedFigure.h"
+
+namespace {
+
+const Hexagon hexagon({Point(0, 0), Point(2, 0), Point(3, 1), Point(2, 2), Point(0, 2), Point(-1, 1)});
+const Hexagon otherHexagon({Point(0, 0), Point(4, 0), Point(6, 2), Point(4, 4), Point(0, 4), Point(-2, 2)});
+
+}
+
+TEST(CachedFigureTests, ValuesMatchPlainFigure) {
+    const CachedHexagon cached(hexagon);
+    EXPECT_FALSE(cached.IsAreaCached());
+    EXPECT_EQ(static_cast<double>(cached), static_cast<double>(hexagon));
+    EXPECT_TRUE(cached.IsAreaCached());
+    EXPECT_EQ(static_cast<double>(cached), static_cast<double>(hexagon));
+
+    EXPECT_TRUE(cached.GetGeometricCenter() == hexagon.GetGeometricCenter());
+    EXPECT_TRUE(cached.IsCenterCached());
+    EXPECT_EQ(cached.GetBoundingBox().minX, -1);
+    EXPECT_EQ(cached.GetBoundingBox().maxX, 3);
+    EXPECT_TRUE(cached.IsBoundingBoxCached());
+
+    const Figure& figure = cached;
+    EXPECT_EQ(static_cast<double>(figure), static_cast<double>(hexagon));
+}
+
+TEST(CachedFigureTests, MutationInvalidates) {
+    CachedHexagon cached(hexagon);
+    static_cast<void>(static_cast<double>(cached));
+    cached = otherHexagon;
+    EXPECT_FALSE(cached.IsAreaCached());
+    EXPECT_EQ(static_cast<double>(cached), static_cast<double>(otherHexagon));
+
+    CachedHexagon other(hexagon);
+    static_cast<void>(other.GetGeometricCenter());
+    swap(cached, other);
+    EXPECT_FALSE(cached.IsCenterCached());
+    EXPECT_FALSE(other.IsAreaCached());
+    EXPECT_EQ(static_cast<double>(cached), static_cast<double>(hexagon));
+    EXPECT_EQ(static_cast<double>(other), static_cast<double>(otherHexagon));
+
+    cached = other;
+    EXPECT_TRUE(cached == other);
+    EXPECT_EQ(static_cast<double>(cached), static_cast<double>(otherHexagon));
+
+    std::istringstream is("0 0 2 0 3 1 2 2 0 2 -1 1");
+    is >> cached;
+    EXPECT_FALSE(cached.IsAreaCached());
+    EXPECT_EQ(static_cast<double>(cached), static_cast<double>(hexagon));
+
+    std::ostringstream os;
+    os << cached;
+    std::ostringstream expected;
+    expected << hexagon;
+    EXPECT_EQ(os.str(), expected.str());
+}
+
+TEST(CachedFigureTests, CopyKeepsCache) {
+    CachedRhombus cached({Point(0, 1), Point(1, 0), Point(0, -1), Point(-1, 0)});
+    static_cast<void>(static_cast<double>(cached));
+    const CachedRhombus copy(cached);
+    EXPECT_TRUE(copy.IsAreaCached());
+    EXPECT_FALSE(copy.IsCenterCached());
+    EXPECT_EQ(static_cast<double>(copy), static_cast<double>(cached));
+}
+
+TEST(CachedFigureTests, ConcurrentFirstAccess) {
+    const CachedPentagon cached(Pentagon({Point(0, 0), Point(2, 0), Point(3, 2), Point(1, 3), Point(-1, 2)}));
+    const double expected = static_cast<double>(cached.GetFigure());
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&cached, expected]() {
+            for (int j = 0; j < 1000; ++j) {
+                EXPECT_EQ(static_cast<double>(cached), expected);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(cached.IsAreaCached());
+}
+
+TEST(CachedFigureTests, PlainLayoutUnchanged) {
+    EXPECT_EQ(sizeof(Hexagon), sizeof(Figure) + sizeof(std::array<Point, 6>));
+}
+
+TEST(CachedFigureTests, TransformInvalidates) {
+    CachedHexagon cached(hexagon);
+    static_cast<void>(static_cast<double>(cached));
+    static_cast<void>(cached.GetBoundingBox());
+    cached.Transform(AffineTransform::Scaling(2, 2));
+    EXPECT_FALSE(cached.IsAreaCached());
+    EXPECT_EQ(cached.GetBoundingBox().maxX, 6);
+    EXPECT_EQ(static_cast<double>(cached), 4 * static_cast<double>(hexagon));
+
+    cached.Rotate(1);
+    EXPECT_FALSE(cached.IsBoundingBoxCached());
+}
+
+TEST(CachedFigureTests, ContainsLikeWrappedFigure) {
+    const CachedHexagon cached(hexagon);
+    for (const Point& point : {Point(1, 1), Point(3, 1), Point(2.5, 1.5), Point(-1, 0), Point(10, 10)}) {
+        EXPECT_EQ(cached.Contains(point), hexagon.Contains(point));
+    }
+    EXPECT_TRUE(cached.IsBoundingBoxCached());
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "CompactFigureBatch.h"
+#include "TestFigures.h"
+
+namespace {
+
+class IsaGuard {
+public:
+    IsaGuard() : _saved(GetKernelIsa()) {}
+    ~IsaGuard() { SetKernelIsa(_saved); }
+private:
+    KernelIsa _saved;
+};
+
+template <typename Compact>
+void ExpectLikeDecodedFigures(const Compact& compact) {
+    IsaGuard guard;
+    for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2, KernelIsa::Avx512}) {
+        if (!IsKernelIsaSupported(isa)) {
+            continue;
+        }
+        SetKernelIsa(isa);
+        SCOPED_TRACE(GetKernelIsaName(isa));
+
+        const std::vector<double> areas = compact.Areas();
+        const std::vector<double> shoelaceAreas = compact.Areas(AreaMode::Shoelace);
+        const std::vector<Point> centers = compact.GeometricCenters();
+        for (uint64_t i = 0; i < compact.Size(); ++i) {
+            const auto figure = compact.GetFigure(i);
+            ASSERT_EQ(areas[i], static_cast<double>(figure)) << i;
+            ASSERT_EQ(shoelaceAreas[i], figure.GetArea(AreaMode::Shoelace)) << i;
+            ASSERT_EQ(centers[i].x, figure.GetGeometricCenter().x) << i;
+            ASSERT_EQ(centers[i].y, figure.GetGeometricCenter().y) << i;
+        }
+    }
+}
+
+double Distance(const Point& first, const Point& second) {
+    return std::hypot(first.x - second.x, first.y - second.y);
+}
+
+// The documented bounds, plus room for the rounding of the double
+// arithmetic itself.
+template <uint64_t N, typename Compact>
+void ExpectWithinErrorBounds(const FigureBatch<N>& batch, const Compact& compact) {
+    const double error = compact.GetCoordinateError();
+    const double r = std::sqrt(2.0) * error;
+    const std::vector<double> areas = batch.Areas();
+    const std::vector<double> compactAreas = compact.Areas();
+    const std::vector<double> shoelaceAreas = batch.Areas(AreaMode::Shoelace);
+    const std::vector<double> compactShoelaceAreas = compact.Areas(AreaMode::Shoelace);
+    const std::vector<Point> centers = batch.GeometricCenters();
+    const std::vector<Point> compactCenters = compact.GeometricCenters();
+
+    for (uint64_t i = 0; i < batch.Size(); ++i) {
+        const std::array<Point, N> points = batch.GetFigure(i).GetPoints();
+        double perimeter = 0;
+        double shortestSide = Distance(points[0], points[N - 1]);
+        for (uint64_t j = 0; j < N; ++j) {
+            const double side = Distance(points[j], points[(j + 1) % N]);
+            perimeter += side;
+            shortestSide = std::min(shortestSide, side);
+        }
+        const double rounding = 1e-9 * (std::fabs(areas[i]) + std::fabs(shoelaceAreas[i]) + 1);
+
+        double classicBound = 0;
+        if (N == 4) {
+            const double triangle = Distance(points[0], points[1]) + Distance(points[1], points[2]) +
+                                    Distance(points[2], points[0]);
+            classicBound = 2 * r * triangle + 3 * r * r;
+        } else {
+            classicBound = RegularPolygonAreaCoefficient(N) * (4 * r * shortestSide + 4 * r * r);
+        }
+        EXPECT_LE(std::fabs(compactAreas[i] - areas[i]), classicBound + rounding) << i;
+        EXPECT_LE(std::fabs(compactShoelaceAreas[i] - shoelaceAreas[i]), r * perimeter + N * r * r / 2 + rounding) << i;
+
+        const double centerRounding = 1e-15 * (std::fabs(centers[i].x) + std::fabs(centers[i].y));
+        EXPECT_LE(std::fabs(compactCenters[i].x - centers[i].x), error + centerRounding) << i;
+        EXPECT_LE(std::fabs(compactCenters[i].y - centers[i].y), error + centerRounding) << i;
+    }
+}
+
+}
+
+TEST(CompactFigureBatchTests, FloatKernelsMatchDecodedFigures) {
+    ExpectLikeDecodedFigures(FloatFigureBatch<4>(MakeScatteredBatch<4>(1003, Point(0, 0), 1000, 50, 71)));
+    ExpectLikeDecodedFigures(FloatFigureBatch<5>(MakeScatteredBatch<5>(1003, Point(0, 0), 1000, 50, 72)));
+    ExpectLikeDecodedFigures(FloatFigureBatch<6>(MakeScatteredBatch<6>(1003, Point(0, 0), 1000, 50, 73)));
+}
+
+TEST(CompactFigureBatchTests, FixedPointKernelsMatchDecodedFigures) {
+    ExpectLikeDecodedFigures(FixedPointFigureBatch<4>(MakeScatteredBatch<4>(1003, Point(3e5, -2e5), 1000, 50, 74)));
+    ExpectLikeDecodedFigures(FixedPointFigureBatch<5>(MakeScatteredBatch<5>(1003, Point(3e5, -2e5), 1000, 50, 75)));
+    ExpectLikeDecodedFigures(FixedPointFigureBatch<6>(MakeScatteredBatch<6>(1003, Point(3e5, -2e5), 1000, 50, 76)));
+}
+
+TEST(CompactFigureBatchTests, WithinDocumentedErrorBounds) {
+    for (const Point& center : {Point(0, 0), Point(3e5, -2e5)}) {
+        const RhombusBatch rhombuses = MakeScatteredBatch<4>(500, center, 1000, 20, 77);
+        const HexagonBatch hexagons = MakeScatteredBatch<6>(500, center, 1000, 20, 78);
+        ExpectWithinErrorBounds(rhombuses, FloatFigureBatch<4>(rhombuses));
+        ExpectWithinErrorBounds(rhombuses, FixedPointFigureBatch<4>(rhombuses));
+        ExpectWithinErrorBounds(hexagons, FloatFigureBatch<6>(hexagons));
+        ExpectWithinErrorBounds(hexagons, FixedPointFigureBatch<6>(hexagons));
+    }
+
+    // Far from (0, 0) fixed point keeps its precision and float does not.
+    const RhombusBatch far = MakeScatteredBatch<4>(10, Point(3e5, -2e5), 1000, 20, 79);
+    EXPECT_LT(FixedPointFigureBatch<4>(far).GetCoordinateError(), 1e-6);
+    EXPECT_GT(FloatFigureBatch<4>(far).GetCoordinateError(), 1e-3);
+}
+
+TEST(CompactFigureBatchTests, Conversions) {
+    const Rhombus rhombus({Point(0, 0), Point(2, 0.5), Point(2, 2), Point(-0.25, 2)});
+    FloatFigureBatch<4> floats;
+    floats.PushBack(rhombus);
+    EXPECT_EQ(floats.Size(), 1u);
+    EXPECT_TRUE(floats.GetFigure(0) == rhombus);
+    EXPECT_EQ(floats.GetXs(1)[0], 2.0f);
+    EXPECT_EQ(floats.ToFigureBatch().GetPoint(0, 3).x, -0.25);
+    EXPECT_THROW(floats.GetPoint(1, 0), std::out_of_range);
+    EXPECT_THROW(floats.PushBack({Point(1e300, 0), Point(), Point(), Point()}), std::invalid_argument);
+    EXPECT_EQ(floats.Size(), 1u);
+    floats.Clear();
+    EXPECT_TRUE(floats.Empty());
+
+    FixedPointFigureBatch<4> fixed(Point(10, 10), 0.25);
+    fixed.PushBack(rhombus);
+    EXPECT_EQ(fixed.GetXs(0)[0], -40);
+    EXPECT_EQ(fixed.GetYs(1)[0], -38);
+    EXPECT_TRUE(fixed.GetFigure(0) == rhombus);
+    EXPECT_EQ(fixed.ToFigureBatch().GetPoint(0, 1).y, 0.5);
+    EXPECT_THROW(fixed.PushBack({Point(1e9, 0), Point(), Point(), Point()}), std::invalid_argument);
+    EXPECT_THROW(fixed.PushBack({Point(std::nan(""), 0), Point(), Point(), Point()}), std::invalid_argument);
+    EXPECT_EQ(fixed.Size(), 1u);
+    EXPECT_THROW(FixedPointFigureBatch<4>(Point(), 0), std::invalid_argument);
+    EXPECT_THROW(FixedPointFigureBatch<4>(Point(INFINITY, 0), 1), std::invalid_argument);
+
+    RhombusBatch batch;
+    batch.PushBack(rhombus);
+    batch.PushBack(Rhombus({Point(-6, 4), Point(-5, 4), Point(-5, 5), Point(-6, 5)}));
+    const FixedPointFigureBatch<4> fitted(batch);
+    EXPECT_EQ(fitted.GetOrigin().x, -2);
+    EXPECT_EQ(fitted.GetOrigin().y, 2.5);
+    EXPECT_EQ(fitted.GetXs(0)[1], -2147483646);
+    EXPECT_EQ(fitted.GetXs(0)[0], 2147483646 / 2);
+    EXPECT_LE(std::fabs(fitted.GetPoint(1, 2).y - 5), fitted.GetCoordinateError());
+
+    RhombusBatch single;
+    single.PushBack(Rhombus({Point(7, 7), Point(7, 7), Point(7, 7), Point(7, 7)}));
+    EXPECT_EQ(FixedPointFigureBatch<4>(single).GetPoint(0, 2).x, 7);
+    EXPECT_TRUE(FixedPointFigureBatch<4>(RhombusBatch()).Empty());
+}
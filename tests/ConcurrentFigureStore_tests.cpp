@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include "ConcurrentFigureStore.h"
+
+namespace {
+
+// Square whose first vertex has x = key, so a reader can tell which slot a
+// figure was written for.
+Rhombus MakeSquare(double key, double side) {
+    return Rhombus({Point(key, 0), Point(key + side, 0), Point(key + side, side), Point(key, side)});
+}
+
+}
+
+TEST(ConcurrentFigureStoreTests, InsertReplaceRemove) {
+    ConcurrentFigureStore store(3);
+    EXPECT_EQ(store.GetShardCount(), 4u);
+    EXPECT_THROW(ConcurrentFigureStore(5000), std::invalid_argument);
+
+    std::vector<uint64_t> ids;
+    for (uint64_t i = 0; i < 3000; ++i) {
+        ids.push_back(store.Insert(MakeSquare(static_cast<double>(i), 2)));
+    }
+    const uint64_t hexagonId = store.Insert(Hexagon());
+    EXPECT_EQ(store.Size(), 3001u);
+
+    ConcurrentFigureStore::Reader reader(store);
+    for (uint64_t i = 0; i < ids.size(); i += 7) {
+        const std::optional<AnyFigure> figure = reader.Get(ids[i]);
+        ASSERT_TRUE(figure.has_value());
+        EXPECT_EQ(*figure, AnyFigure(MakeSquare(static_cast<double>(i), 2)));
+        EXPECT_DOUBLE_EQ(*reader.GetArea(ids[i]), 4);
+        EXPECT_EQ(*reader.GetCenter(ids[i]), Point(static_cast<double>(i) + 1, 1));
+    }
+    EXPECT_TRUE(reader.Get(hexagonId)->Holds<Hexagon>());
+    EXPECT_FALSE(reader.Contains(hexagonId + (uint64_t(1) << 40)));
+
+    EXPECT_TRUE(store.Replace(ids[5], MakeSquare(5, 3)));
+    EXPECT_DOUBLE_EQ(*reader.GetArea(ids[5]), 9);
+    EXPECT_TRUE(store.Remove(ids[6]));
+    EXPECT_FALSE(store.Remove(ids[6]));
+    EXPECT_FALSE(store.Replace(ids[6], MakeSquare(6, 1)));
+    EXPECT_FALSE(reader.GetArea(ids[6]).has_value());
+    EXPECT_EQ(store.Size(), 3000u);
+
+    // Ids are never reused.
+    const uint64_t newId = store.Insert(MakeSquare(-1, 1));
+    for (uint64_t id : ids) {
+        EXPECT_NE(id, newId);
+    }
+
+    uint64_t visited = 0;
+    double total = 0;
+    reader.ForEach([&](uint64_t id, const StoredFigure& figure) {
+        EXPECT_TRUE(reader.Contains(id));
+        ++visited;
+        total += figure.area;
+    });
+    EXPECT_EQ(visited, 3001u);
+    EXPECT_DOUBLE_EQ(total, 2998 * 4 + 9 + 1 + static_cast<double>(Hexagon()));
+}
+
+TEST(ConcurrentFigureStoreTests, ReaderHoldsBackReclamation) {
+    ConcurrentFigureStore store(1);
+    const uint64_t id = store.Insert(MakeSquare(0, 1));
+    {
+        ConcurrentFigureStore::Reader reader(store);
+        reader.Visit(id, [&](const StoredFigure& figure) {
+            for (int i = 0; i < 500; ++i) {
+                store.Replace(id, MakeSquare(0, 2 + i));
+            }
+            store.Collect();
+            // Still readable although replaced long ago.
+            EXPECT_DOUBLE_EQ(figure.area, 1);
+            EXPECT_EQ(store.GetReclaimedCount(), 0u);
+            EXPECT_EQ(store.GetRetiredCount(), 500u);
+        });
+        EXPECT_DOUBLE_EQ(*reader.GetArea(id), 501 * 501);
+    }
+
+    store.Collect();
+    EXPECT_EQ(store.GetRetiredCount(), 0u);
+    EXPECT_EQ(store.GetReclaimedCount(), 500u);
+
+    // Readers left behind are reused rather than piling up.
+    EpochDomain domain;
+    EpochDomain::Participant* first = domain.Join();
+    domain.Leave(first);
+    EXPECT_EQ(domain.Join(), first);
+    domain.Enter(first);
+    const uint64_t epoch = domain.TryAdvance();
+    EXPECT_EQ(domain.TryAdvance(), epoch);
+    domain.Exit(first);
+    EXPECT_EQ(domain.TryAdvance(), epoch + 1);
+    EXPECT_TRUE(EpochDomain::IsReclaimable(epoch - 1, epoch + 1));
+    domain.Leave(first);
+}
+
+// Writers insert, replace and remove while readers check that every figure
+// they see is whole and belongs to the id they asked for. Meant to be run
+// under ThreadSanitizer too (FIGURES_SANITIZE_THREAD).
+TEST(ConcurrentFigureStoreTests, ConcurrentReadersAndWriters) {
+    constexpr uint64_t writerCount = 3;
+    constexpr uint64_t readerCount = 3;
+    constexpr uint64_t figuresPerWriter = 3000;
+    ConcurrentFigureStore store(2);
+
+    std::vector<std::vector<uint64_t>> ids(writerCount);
+    std::atomic<uint64_t> published(0);
+    std::vector<std::atomic<uint64_t>> publishedIds(writerCount * figuresPerWriter);
+    std::atomic<bool> writing(true);
+    std::atomic<uint64_t> replaced(0);
+    std::atomic<uint64_t> removed(0);
+
+    std::vector<std::thread> writers;
+    for (uint64_t w = 0; w < writerCount; ++w) {
+        writers.emplace_back([&, w]() {
+            std::mt19937_64 generator(w);
+            for (uint64_t i = 0; i < figuresPerWriter; ++i) {
+                const uint64_t id = store.Insert(MakeSquare(-1, 1));
+                ids[w].push_back(id);
+                // Replaced straight away so that readers see a keyed figure.
+                store.Replace(id, MakeSquare(static_cast<double>(id), 1));
+                replaced.fetch_add(1);
+                publishedIds[published.fetch_add(1)].store(id);
+
+                const uint64_t other = ids[w][generator() % ids[w].size()];
+                const double side = static_cast<double>(generator() % 5 + 1);
+                if (generator() % 4 == 0) {
+                    removed.fetch_add(store.Remove(other) ? 1 : 0);
+                } else if (store.Replace(other, MakeSquare(static_cast<double>(other), side))) {
+                    replaced.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    std::atomic<uint64_t> reads(0);
+    std::vector<std::thread> readers;
+    for (uint64_t r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&, r]() {
+            ConcurrentFigureStore::Reader reader(store);
+            std::mt19937_64 generator(100 + r);
+            while (writing.load()) {
+                const uint64_t count = std::min<uint64_t>(published.load(), publishedIds.size());
+                if (count == 0) {
+                    continue;
+                }
+                // An entry may still be 0 while being written, which names a
+                // real slot and is checked just the same.
+                const uint64_t id = publishedIds[generator() % count].load();
+                reader.Visit(id, [&](const StoredFigure& figure) {
+                    const Rhombus* square = figure.figure.Get<Rhombus>();
+                    ASSERT_NE(square, nullptr);
+                    const double key = square->GetPoints()[0].x;
+                    EXPECT_TRUE(key == static_cast<double>(id) || key == -1) << id << ' ' << key;
+                    EXPECT_EQ(figure.area, static_cast<double>(*square));
+                    EXPECT_EQ(figure.center, square->GetGeometricCenter());
+                });
+                reads.fetch_add(1, std::memory_order_relaxed);
+                if (generator() % 512 == 0) {
+                    uint64_t seen = 0;
+                    reader.ForEach([&](uint64_t, const StoredFigure&) { ++seen; });
+                    EXPECT_LE(seen, writerCount * figuresPerWriter);
+                }
+            }
+        });
+    }
+
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+    writing.store(false);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(store.Size(), writerCount * figuresPerWriter - removed.load());
+    store.Collect();
+    EXPECT_EQ(store.GetRetiredCount(), 0u);
+    EXPECT_EQ(store.GetReclaimedCount(), replaced.load() + removed.load());
+
+    ConcurrentFigureStore::Reader reader(store);
+    uint64_t live = 0;
+    for (const std::vector<uint64_t>& writerIds : ids) {
+        for (uint64_t id : writerIds) {
+            live += reader.Contains(id) ? 1 : 0;
+        }
+    }
+    EXPECT_EQ(live, store.Size());
+}
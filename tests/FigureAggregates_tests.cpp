@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "FigureAggregates.h"
+#include "TestFigures.h"
+
+TEST(CompensatedSumTests, KeepsSmallTermsNextToLargeOnes) {
+    CompensatedSum sum;
+    double naive = 0;
+    sum.Add(1e16);
+    naive += 1e16;
+    for (int i = 0; i < 1000; ++i) {
+        sum.Add(1);
+        naive += 1;
+    }
+    sum.Subtract(1e16);
+    naive -= 1e16;
+    EXPECT_EQ(sum.Get(), 1000);
+    EXPECT_NE(naive, 1000);
+
+    sum.Reset();
+    EXPECT_EQ(sum.Get(), 0);
+}
+
+TEST(FigureAggregatesTests, InsertUpdateErase) {
+    FigureAggregates aggregates({2, 10});
+    EXPECT_EQ(aggregates.GetCount(), 0u);
+    EXPECT_EQ(aggregates.GetMinArea(), std::numeric_limits<double>::infinity());
+    EXPECT_TRUE(aggregates.GetBounds().Empty());
+    EXPECT_TRUE(std::isnan(aggregates.GetCentroid().x));
+
+    aggregates.Insert(1, MakeSquare(0, 0, 1));
+    aggregates.Insert(2, MakeSquare(4, 0, 2));
+    aggregates.Insert(7, MakeSquare(-3, 5, 4));
+    EXPECT_EQ(aggregates.GetCount(), 3u);
+    EXPECT_DOUBLE_EQ(aggregates.GetTotalArea(), 21);
+    EXPECT_DOUBLE_EQ(aggregates.GetMinArea(), 1);
+    EXPECT_DOUBLE_EQ(aggregates.GetMaxArea(), 16);
+    EXPECT_DOUBLE_EQ(aggregates.GetCentroid().x, (0.5 * 1 + 5 * 4 + -1 * 16) / 21);
+    EXPECT_DOUBLE_EQ(aggregates.GetCentroid().y, (0.5 * 1 + 1 * 4 + 7 * 16) / 21);
+    EXPECT_EQ(aggregates.GetBounds().minX, -3);
+    EXPECT_EQ(aggregates.GetBounds().maxY, 9);
+    EXPECT_EQ(aggregates.GetHistogram(), (std::vector<uint64_t>{1, 1, 1}));
+
+    // The figures that made the extremes leave.
+    aggregates.Update(7, MakeSquare(1, 1, 1));
+    aggregates.Erase(1);
+    EXPECT_EQ(aggregates.GetCount(), 2u);
+    EXPECT_DOUBLE_EQ(aggregates.GetTotalArea(), 5);
+    EXPECT_DOUBLE_EQ(aggregates.GetMinArea(), 1);
+    EXPECT_DOUBLE_EQ(aggregates.GetMaxArea(), 4);
+    EXPECT_EQ(aggregates.GetBounds().minX, 1);
+    EXPECT_EQ(aggregates.GetBounds().minY, 0);
+    EXPECT_EQ(aggregates.GetBounds().maxX, 6);
+    EXPECT_EQ(aggregates.GetBounds().maxY, 2);
+    EXPECT_EQ(aggregates.GetHistogram(), (std::vector<uint64_t>{1, 1, 0}));
+    EXPECT_FALSE(aggregates.Contains(1));
+    EXPECT_TRUE(aggregates.Contains(7));
+
+    aggregates.Insert(3, Hexagon());
+    EXPECT_DOUBLE_EQ(aggregates.GetTotalArea(), 5 + static_cast<double>(Hexagon()));
+
+    aggregates.Clear();
+    EXPECT_EQ(aggregates.GetCount(), 0u);
+    EXPECT_EQ(aggregates.GetTotalArea(), 0);
+    EXPECT_EQ(aggregates.GetHistogram(), (std::vector<uint64_t>{0, 0, 0}));
+}
+
+TEST(FigureAggregatesTests, RejectsBadInput) {
+    EXPECT_THROW(FigureAggregates({1, 1}), std::invalid_argument);
+    EXPECT_THROW(FigureAggregates({std::nan("")}), std::invalid_argument);
+
+    FigureAggregates aggregates;
+    aggregates.Insert(1, MakeSquare(0, 0, 1));
+    EXPECT_THROW(aggregates.Insert(1, MakeSquare(0, 0, 2)), std::invalid_argument);
+    EXPECT_THROW(aggregates.Update(2, MakeSquare(0, 0, 2)), std::out_of_range);
+    EXPECT_THROW(aggregates.Erase(2), std::out_of_range);
+
+    // A rejected update keeps the old figure.
+    const double infinity = std::numeric_limits<double>::infinity();
+    EXPECT_THROW(aggregates.Update(1, MakeSquare(infinity, 0, 1)), std::invalid_argument);
+    EXPECT_EQ(aggregates.GetCount(), 1u);
+    EXPECT_DOUBLE_EQ(aggregates.GetTotalArea(), 1);
+    EXPECT_EQ(aggregates.GetBounds().maxX, 1);
+    EXPECT_EQ(aggregates.GetHistogram(), std::vector<uint64_t>{1});
+
+    // Area and center are finite, their product is not.
+    Hexagon huge({Point(0, 0), Point(2, 0), Point(3, 1), Point(2, 2), Point(0, 2), Point(-1, 1)});
+    huge.Scale(1e150, 1e150);
+    ASSERT_TRUE(std::isfinite(static_cast<double>(huge)));
+    ASSERT_TRUE(std::isfinite(huge.GetGeometricCenter().x));
+    EXPECT_THROW(aggregates.Insert(2, huge), std::invalid_argument);
+    EXPECT_THROW(aggregates.Update(1, huge), std::invalid_argument);
+    EXPECT_FALSE(aggregates.Contains(2));
+    EXPECT_DOUBLE_EQ(aggregates.GetTotalArea(), 1);
+    EXPECT_DOUBLE_EQ(aggregates.GetCentroid().x, 0.5);
+    EXPECT_DOUBLE_EQ(aggregates.GetCentroid().y, 0.5);
+
+    // Each product fits, the sum of two does not.
+    const double scale = 2.7e102;
+    Hexagon large({Point(0, 0), Point(2, 0), Point(3, 1), Point(2, 2), Point(0, 2), Point(-1, 1)});
+    large.Scale(scale, scale);
+    ASSERT_TRUE(std::isfinite(static_cast<double>(large) * large.GetGeometricCenter().x));
+    aggregates.Clear();
+    aggregates.Insert(1, large);
+    EXPECT_THROW(aggregates.Insert(2, large), std::invalid_argument);
+    aggregates.Insert(2, MakeSquare(0, 0, 1));
+    EXPECT_THROW(aggregates.Update(2, large), std::invalid_argument);
+    EXPECT_EQ(aggregates.GetCount(), 2u);
+    EXPECT_EQ(aggregates.GetHistogram(), std::vector<uint64_t>{2});
+    aggregates.Erase(2);
+    EXPECT_DOUBLE_EQ(aggregates.GetCentroid().x, scale);
+    EXPECT_DOUBLE_EQ(aggregates.GetCentroid().y, scale);
+
+    // The two mirrored figures only fit together with the first one.
+    Hexagon mirrored({Point(0, 0), Point(2, 0), Point(3, 1), Point(2, 2), Point(0, 2), Point(-1, 1)});
+    mirrored.Scale(-scale, -scale);
+    aggregates.Insert(2, mirrored);
+    aggregates.Insert(3, mirrored);
+    aggregates.Erase(1);
+    EXPECT_FALSE(std::isfinite(aggregates.GetCentroid().x));
+    aggregates.Erase(2);
+    EXPECT_DOUBLE_EQ(aggregates.GetCentroid().x, -scale);
+    EXPECT_DOUBLE_EQ(aggregates.GetCentroid().y, -scale);
+}
+
+// Many random changes mixing huge and tiny figures must end where
+// aggregating the surviving figures from scratch does.
+TEST(FigureAggregatesTests, MatchesRecomputationAfterManyChanges) {
+    std::mt19937_64 generator(5);
+    std::uniform_real_distribution<double> position(-1000, 1000);
+    std::uniform_real_distribution<double> exponent(-4, 4);
+    FigureAggregates aggregates({0.01, 1, 100});
+    std::map<uint64_t, Rhombus> figures;
+
+    for (uint64_t i = 0; i < 20000; ++i) {
+        const uint64_t id = generator() % 500;
+        const Rhombus square = MakeSquare(position(generator), position(generator), std::pow(10, exponent(generator)));
+        if (figures.count(id) == 0) {
+            aggregates.Insert(id, square);
+            figures.emplace(id, square);
+        } else if (generator() % 3 == 0) {
+            aggregates.Erase(id);
+            figures.erase(id);
+        } else {
+            aggregates.Update(id, square);
+            figures.at(id) = square;
+        }
+    }
+
+    FigureAggregates fresh({0.01, 1, 100});
+    for (const auto& [id, square] : figures) {
+        fresh.Insert(id, square);
+    }
+    EXPECT_EQ(aggregates.GetCount(), figures.size());
+    EXPECT_NEAR(aggregates.GetTotalArea(), fresh.GetTotalArea(), fresh.GetTotalArea() * 1e-15);
+    EXPECT_NEAR(aggregates.GetCentroid().x, fresh.GetCentroid().x, 1e-9);
+    EXPECT_NEAR(aggregates.GetCentroid().y, fresh.GetCentroid().y, 1e-9);
+    EXPECT_EQ(aggregates.GetMinArea(), fresh.GetMinArea());
+    EXPECT_EQ(aggregates.GetMaxArea(), fresh.GetMaxArea());
+    EXPECT_EQ(aggregates.GetBounds().minX, fresh.GetBounds().minX);
+    EXPECT_EQ(aggregates.GetBounds().maxY, fresh.GetBounds().maxY);
+    EXPECT_EQ(aggregates.GetHistogram(), fresh.GetHistogram());
+
+    // Emptied, it starts again from exactly 0.
+    for (const auto& [id, square] : figures) {
+        aggregates.Erase(id);
+    }
+    EXPECT_EQ(aggregates.GetTotalArea(), 0);
+    aggregates.Insert(1, MakeSquare(0, 0, 3));
+    EXPECT_EQ(aggregates.GetTotalArea(), static_cast<double>(MakeSquare(0, 0, 3)));
+    EXPECT_EQ(aggregates.GetCentroid(), Point(1.5, 1.5));
+}
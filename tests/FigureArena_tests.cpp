@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <vector>
+#include "FigureArena.h"
+#include "Figures.h"
+
+TEST(MonotonicArenaTests, AllocatesAligned) {
+    MonotonicArena arena(256);
+    for (uint64_t alignment : {1, 2, 4, 8, 16}) {
+        void* memory = arena.Allocate(3, alignment);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(memory) % alignment, 0);
+    }
+    EXPECT_EQ(arena.GetStats().allocations, 5);
+    EXPECT_EQ(arena.GetStats().blockAllocations, 1);
+    EXPECT_THROW(arena.Allocate(8, 3), std::invalid_argument);
+}
+
+TEST(MonotonicArenaTests, CreateFigures) {
+    MonotonicArena arena;
+    Rhombus* rhombus = arena.Create<Rhombus>();
+    std::istringstream is("0 1 1 0 0 -1 -1 0");
+    is >> *rhombus;
+    Figure* figure = arena.Create<Hexagon>();
+    EXPECT_NEAR(static_cast<double>(*rhombus), 2.0, 0.01);
+    EXPECT_DOUBLE_EQ(static_cast<double>(*figure), 0.0);
+}
+
+TEST(MonotonicArenaTests, OversizedAllocation) {
+    MonotonicArena arena(64);
+    void* memory = arena.Allocate(1000);
+    EXPECT_NE(memory, nullptr);
+    EXPECT_EQ(arena.GetStats().bytesReserved, 1000);
+}
+
+TEST(MonotonicArenaTests, WarmResetDoesNotAllocate) {
+    MonotonicArena arena(4096);
+    auto request = [&arena]() {
+        for (int i = 0; i < 1000; ++i) {
+            arena.Create<Pentagon>();
+        }
+    };
+
+    request();
+    const uint64_t blocks = arena.GetStats().blockAllocations;
+    const uint64_t reserved = arena.GetStats().bytesReserved;
+    EXPECT_GT(blocks, 1);
+    for (int i = 0; i < 10; ++i) {
+        arena.Reset();
+        request();
+    }
+    EXPECT_EQ(arena.GetStats().blockAllocations, blocks);
+    EXPECT_EQ(arena.GetStats().bytesReserved, reserved);
+    EXPECT_EQ(arena.GetStats().resets, 10);
+
+    arena.Release();
+    EXPECT_EQ(arena.GetStats().bytesReserved, 0);
+}
+
+TEST(ObjectPoolTests, ReusesDestroyedSlots) {
+    MonotonicArena arena;
+    ObjectPool<Hexagon> pool(arena);
+    Hexagon* first = pool.Create();
+    Hexagon* second = pool.Create();
+    EXPECT_NE(first, second);
+    EXPECT_EQ(pool.GetLiveCount(), 2);
+
+    pool.Destroy(first);
+    EXPECT_EQ(pool.GetLiveCount(), 1);
+    const uint64_t allocations = arena.GetStats().allocations;
+    Hexagon* third = pool.Create();
+    EXPECT_EQ(third, first);
+    EXPECT_EQ(arena.GetStats().allocations, allocations);
+
+    pool.Reset();
+    EXPECT_EQ(pool.GetLiveCount(), 0);
+}
+
+TEST(ObjectPoolTests, WarmResetDoesNotGrowTheArena) {
+    MonotonicArena arena(4096);
+    ObjectPool<Hexagon> pool(arena);
+    uint64_t reserved = 0;
+    for (int round = 0; round < 20; ++round) {
+        std::vector<Hexagon*> hexagons;
+        for (int i = 0; i < 1000; ++i) {
+            hexagons.push_back(pool.Create());
+        }
+        for (int i = 0; i < 1000; i += 3) {
+            pool.Destroy(hexagons[i]);
+        }
+        pool.Create();
+        // Every live object has a slot of its own.
+        std::sort(hexagons.begin(), hexagons.end());
+        EXPECT_EQ(std::adjacent_find(hexagons.begin(), hexagons.end()), hexagons.end());
+        pool.Reset();
+        if (round == 0) {
+            reserved = arena.GetStats().bytesReserved;
+        }
+        EXPECT_EQ(arena.GetStats().bytesReserved, reserved);
+    }
+}
+
+TEST(ObjectPoolTests, PoolsShareAnArena) {
+    MonotonicArena arena;
+    ObjectPool<Rhombus> rhombuses(arena);
+    ObjectPool<Hexagon> hexagons(arena);
+    Rhombus* rhombus = rhombuses.Create();
+    hexagons.Destroy(hexagons.Create());
+
+    // Resetting one pool leaves the other's objects and the arena alone.
+    hexagons.Reset();
+    Hexagon* hexagon = hexagons.Create();
+    EXPECT_NE(static_cast<void*>(hexagon), static_cast<void*>(rhombus));
+    EXPECT_EQ(arena.GetStats().resets, 0);
+    EXPECT_EQ(rhombuses.GetLiveCount(), 1);
+
+    // Resetting the arena drops every pool's objects and free slots, so no
+    // slot is handed out twice.
+    rhombuses.Destroy(rhombus);
+    arena.Reset();
+    EXPECT_EQ(rhombuses.GetLiveCount(), 0);
+    EXPECT_EQ(hexagons.GetLiveCount(), 0);
+    Rhombus* fresh = rhombuses.Create();
+    void* other = arena.Allocate(sizeof(Rhombus), alignof(Rhombus));
+    EXPECT_NE(static_cast<void*>(fresh), other);
+    EXPECT_NE(static_cast<void*>(hexagons.Create()), static_cast<void*>(fresh));
+    EXPECT_EQ(rhombuses.GetLiveCount(), 1);
+}
+
+TEST(ArenaAllocatorTests, VectorInArena) {
+    MonotonicArena arena;
+    std::vector<Figure*, ArenaAllocator<Figure*>> figures{ArenaAllocator<Figure*>(arena)};
+    for (int i = 0; i < 100; ++i) {
+        figures.push_back(arena.Create<Rhombus>());
+    }
+    EXPECT_EQ(figures.size(), 100);
+    EXPECT_GE(arena.GetStats().allocations, 100);
+    EXPECT_TRUE(ArenaAllocator<int>(arena) == ArenaAllocator<double>(arena));
+}
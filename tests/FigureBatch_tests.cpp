@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <array>
+#include <random>
+#include "FigureBatch.h"
+
+template <uint64_t N>
+static std::array<Point, N> RandomPoints(std::mt19937_64& generator) {
+    std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+    std::array<Point, N> points;
+    for (uint64_t i = 0; i < N; ++i) {
+        points[i] = Point(distribution(generator), distribution(generator));
+    }
+    return points;
+}
+
+template <uint64_t N>
+static void ExpectMatchesPerObject(uint64_t count) {
+    std::mt19937_64 generator(52);
+    FigureBatch<N> batch(count);
+    std::vector<typename FigureBatch<N>::FigureType> figures;
+    for (uint64_t i = 0; i < count; ++i) {
+        figures.emplace_back(RandomPoints<N>(generator));
+        batch.PushBack(figures.back());
+    }
+
+    std::vector<double> areas = batch.Areas();
+    std::vector<Point> centers = batch.GeometricCenters();
+    ASSERT_EQ(areas.size(), count);
+    ASSERT_EQ(centers.size(), count);
+    for (uint64_t i = 0; i < count; ++i) {
+        EXPECT_EQ(areas[i], static_cast<double>(figures[i]));
+        EXPECT_EQ(centers[i].x, figures[i].GetGeometricCenter().x);
+        EXPECT_EQ(centers[i].y, figures[i].GetGeometricCenter().y);
+    }
+}
+
+TEST(FigureBatchTests, DefaultConstructor) {
+    const RhombusBatch batch;
+    EXPECT_TRUE(batch.Empty());
+    EXPECT_EQ(batch.Size(), 0);
+    EXPECT_TRUE(batch.Areas().empty());
+}
+
+TEST(FigureBatchTests, PushBackAndGetFigure) {
+    Rhombus rhombus;
+    std::istringstream is("0 1 1 0 0 -1 -1 0");
+    is >> rhombus;
+    RhombusBatch batch;
+    batch.PushBack(rhombus);
+    EXPECT_EQ(batch.Size(), 1);
+    EXPECT_TRUE(batch.GetFigure(0) == rhombus);
+    EXPECT_DOUBLE_EQ(batch.GetPoint(0, 1).x, 1.0);
+    EXPECT_THROW(batch.GetPoint(1, 0), std::out_of_range);
+    EXPECT_THROW(batch.GetPoint(0, 4), std::out_of_range);
+}
+
+TEST(FigureBatchTests, ClearKeepsBatchUsable) {
+    PentagonBatch batch;
+    batch.PushBack(Pentagon());
+    batch.Clear();
+    EXPECT_TRUE(batch.Empty());
+    batch.PushBack(Pentagon());
+    EXPECT_EQ(batch.Size(), 1);
+}
+
+TEST(FigureBatchTests, DegenerateFiguresHaveZeroArea) {
+    HexagonBatch batch;
+    batch.PushBack(Hexagon());
+    EXPECT_DOUBLE_EQ(batch.Areas()[0], 0.0);
+}
+
+TEST(FigureBatchTests, RhombusMatchesPerObject) {
+    ExpectMatchesPerObject<4>(1000);
+}
+
+TEST(FigureBatchTests, PentagonMatchesPerObject) {
+    ExpectMatchesPerObject<5>(1000);
+}
+
+TEST(FigureBatchTests, HexagonMatchesPerObject) {
+    ExpectMatchesPerObject<6>(1000);
+}
+
+TEST(FigureBatchTests, TriangleMatchesPerObject) {
+    ExpectMatchesPerObject<3>(1000);
+}
+
+TEST(FigureBatchTests, OctagonMatchesPerObject) {
+    ExpectMatchesPerObject<8>(1000);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "FigureEngine.h"
+
+static std::vector<std::unique_ptr<Figure>> MakeFigures(uint64_t count) {
+    std::mt19937_64 generator(52);
+    std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+    std::vector<std::unique_ptr<Figure>> figures;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (i % 3 == 0) {
+            std::array<Point, 4> points;
+            for (Point& point : points) {
+                point = Point(distribution(generator), distribution(generator));
+            }
+            figures.push_back(std::make_unique<Rhombus>(points));
+        } else if (i % 3 == 1) {
+            std::array<Point, 5> points;
+            for (Point& point : points) {
+                point = Point(distribution(generator), distribution(generator));
+            }
+            figures.push_back(std::make_unique<Pentagon>(points));
+        } else {
+            std::array<Point, 6> points;
+            for (Point& point : points) {
+                point = Point(distribution(generator), distribution(generator));
+            }
+            figures.push_back(std::make_unique<Hexagon>(points));
+        }
+    }
+    return figures;
+}
+
+TEST(FigureEngineTests, AreasAndCentersMatchPerObject) {
+    std::vector<std::unique_ptr<Figure>> figures = MakeFigures(5000);
+    FigureEngine engine(4, 64);
+    std::vector<double> areas = engine.Areas(figures);
+    std::vector<Point> centers = engine.GeometricCenters(figures);
+    for (uint64_t i = 0; i < figures.size(); ++i) {
+        EXPECT_EQ(areas[i], static_cast<double>(*figures[i]));
+        EXPECT_TRUE(centers[i] == figures[i]->GetGeometricCenter());
+    }
+}
+
+TEST(FigureEngineTests, TotalAreaIsReproducible) {
+    std::vector<std::unique_ptr<Figure>> figures = MakeFigures(20000);
+    const double single = FigureEngine(1, 128).TotalArea(figures);
+    const double multiple = FigureEngine(4, 128).TotalArea(figures);
+    EXPECT_EQ(single, multiple);
+    EXPECT_GT(single, 0.0);
+}
+
+TEST(FigureEngineTests, BatchMatchesPerObject) {
+    std::vector<std::unique_ptr<Figure>> figures = MakeFigures(3000);
+    PentagonBatch batch;
+    std::vector<const Figure*> pentagons;
+    for (const std::unique_ptr<Figure>& figure : figures) {
+        if (const Pentagon* pentagon = dynamic_cast<const Pentagon*>(figure.get())) {
+            batch.PushBack(*pentagon);
+            pentagons.push_back(pentagon);
+        }
+    }
+
+    FigureEngine engine(3, 100);
+    EXPECT_EQ(engine.Areas(batch), engine.Areas(pentagons));
+    EXPECT_EQ(engine.TotalArea(batch), engine.TotalArea(pentagons));
+    std::vector<Point> centers = engine.GeometricCenters(batch);
+    for (uint64_t i = 0; i < pentagons.size(); ++i) {
+        EXPECT_TRUE(centers[i] == pentagons[i]->GetGeometricCenter());
+    }
+}
+
+TEST(FigureEngineTests, ParallelTransformsMatchSequential) {
+    std::vector<std::unique_ptr<Figure>> figures = MakeFigures(3000);
+    std::vector<std::unique_ptr<Figure>> expected = MakeFigures(3000);
+    const AffineTransform transform = AffineTransform::Rotation(2).Then(AffineTransform::Translation(5, -5));
+    FigureEngine engine(4, 64);
+    engine.Transform(figures, transform);
+    for (uint64_t i = 0; i < figures.size(); ++i) {
+        expected[i]->Transform(transform);
+        ASSERT_EQ(static_cast<double>(*figures[i]), static_cast<double>(*expected[i])) << i;
+        ASSERT_EQ(figures[i]->GetGeometricCenter().x, expected[i]->GetGeometricCenter().x) << i;
+    }
+
+    HexagonBatch batch;
+    for (uint64_t i = 2; i < figures.size(); i += 3) {
+        batch.PushBack(dynamic_cast<const Hexagon&>(*figures[i]));
+    }
+    HexagonBatch sequential = batch;
+    engine.Transform(batch, transform);
+    engine.Rotate(batch, 0.7);
+    sequential.Transform(transform);
+    sequential.Rotate(0.7);
+    for (uint64_t i = 0; i < batch.Size(); ++i) {
+        for (uint64_t j = 0; j < 6; ++j) {
+            ASSERT_EQ(batch.GetPoint(i, j).x, sequential.GetPoint(i, j).x);
+            ASSERT_EQ(batch.GetPoint(i, j).y, sequential.GetPoint(i, j).y);
+        }
+    }
+}
+
+TEST(FigureEngineTests, EmptyCollection) {
+    FigureEngine engine(2);
+    std::vector<const Figure*> figures;
+    EXPECT_TRUE(engine.Areas(figures).empty());
+    EXPECT_DOUBLE_EQ(engine.TotalArea(figures), 0.0);
+    EXPECT_THROW(FigureEngine(2, 0), std::invalid_argument);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "FigureFile.h"
+
+static std::string TempPath(const std::string& name) {
+    return ::testing::TempDir() + name;
+}
+
+TEST(FigureFileTests, RoundTrip) {
+    Rhombus rhombus;
+    std::istringstream is1("0 1 1 0 0 -1 -1 0");
+    is1 >> rhombus;
+    Pentagon pentagon;
+    std::istringstream is2("0 1 0.951 0.309 0.588 -0.809 -0.588 -0.809 -0.951 0.309");
+    is2 >> pentagon;
+
+    FigureFileWriter writer;
+    writer.Add(rhombus);
+    writer.Add(rhombus);
+    writer.Add(pentagon);
+    EXPECT_EQ(writer.GetCount(4), 2);
+    EXPECT_EQ(writer.GetCount(5), 1);
+    const std::string path = TempPath("round_trip.figb");
+    writer.Save(path);
+
+    const FigureFileReader reader(path);
+    EXPECT_EQ(reader.GetVersion(), figureFileVersion);
+    ASSERT_EQ(reader.GetRhombuses().Size(), 2);
+    ASSERT_EQ(reader.GetPentagons().Size(), 1);
+    EXPECT_TRUE(reader.GetHexagons().Empty());
+    EXPECT_TRUE(reader.GetRhombuses().GetFigure(1) == rhombus);
+    EXPECT_TRUE(reader.GetPentagons().GetFigure(0) == pentagon);
+    EXPECT_DOUBLE_EQ(reader.GetRhombuses()[0][1].x, 1.0);
+    EXPECT_THROW(reader.GetRhombuses().GetFigure(2), std::out_of_range);
+    std::remove(path.c_str());
+}
+
+TEST(FigureFileTests, RecordsAreAlignedAndIterable) {
+    FigureFileWriter writer;
+    writer.Add(Pentagon());
+    writer.Add(Hexagon());
+    const std::string path = TempPath("aligned.figb");
+    writer.Save(path);
+
+    const FigureFileReader reader(path);
+    const HexagonRecords hexagons = reader.GetHexagons();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(hexagons.begin()) % alignof(Point), 0);
+    uint64_t count = 0;
+    for (const std::array<Point, 6>& record : hexagons) {
+        EXPECT_TRUE(record[0] == Point());
+        ++count;
+    }
+    EXPECT_EQ(count, 1);
+    std::remove(path.c_str());
+}
+
+TEST(FigureFileTests, ToBatch) {
+    FigureFileWriter writer;
+    RhombusBatch batch;
+    batch.PushBack(Rhombus({Point(0, 1), Point(1, 0), Point(0, -1), Point(-1, 0)}));
+    writer.Add(batch);
+    const std::string path = TempPath("batch.figb");
+    writer.Save(path);
+
+    const FigureFileReader reader(path);
+    EXPECT_NEAR(reader.GetRhombuses().ToBatch().Areas()[0], 2.0, 1e-9);
+    std::remove(path.c_str());
+}
+
+TEST(FigureFileTests, MoveReader) {
+    FigureFileWriter writer;
+    writer.Add(Rhombus());
+    const std::string path = TempPath("move.figb");
+    writer.Save(path);
+
+    FigureFileReader reader(path);
+    FigureFileReader moved(std::move(reader));
+    EXPECT_EQ(moved.GetRhombuses().Size(), 1);
+    std::remove(path.c_str());
+}
+
+TEST(FigureFileTests, MissingFile) {
+    EXPECT_THROW(FigureFileReader(TempPath("does_not_exist.figb")), std::runtime_error);
+}
+
+TEST(FigureFileTests, InvalidMagic) {
+    const std::string path = TempPath("bad_magic.figb");
+    std::ofstream(path, std::ios::binary) << "NOTAFIGUREFILE!!";
+    EXPECT_THROW(FigureFileReader{path}, std::invalid_argument);
+    std::remove(path.c_str());
+}
+
+TEST(FigureFileTests, TruncatedData) {
+    FigureFileWriter writer;
+    writer.Add(Hexagon());
+    std::ostringstream os;
+    writer.Save(os);
+    const std::string bytes = os.str();
+
+    const std::string path = TempPath("truncated.figb");
+    std::ofstream(path, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+    EXPECT_THROW(FigureFileReader{path}, std::invalid_argument);
+    std::remove(path.c_str());
+}
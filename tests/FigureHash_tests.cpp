@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "FigureHash.h"
+
+static Rhombus MakeRhombus(const std::string& text) {
+    Rhombus rhombus;
+    std::istringstream is(text);
+    is >> rhombus;
+    return rhombus;
+}
+
+TEST(FigureHashTests, CanonicalPointsAreSorted) {
+    const Rhombus rhombus = MakeRhombus("0 1 1 0 0 -1 -1 0");
+    const std::array<Point, 4> points = CanonicalPoints(rhombus);
+    EXPECT_TRUE(points[0] == Point(-1, 0));
+    EXPECT_TRUE(points[1] == Point(0, -1));
+    EXPECT_TRUE(points[3] == Point(1, 0));
+}
+
+TEST(FigureHashTests, EqualFiguresHashAlike) {
+    const Rhombus first = MakeRhombus("0 1 1 0 0 -1 -1 0");
+    const Rhombus rotated = MakeRhombus("1 0 0 -1 -1 0 0 1");
+    const Rhombus other = MakeRhombus("0 2 2 0 0 -2 -2 0");
+    ASSERT_TRUE(first == rotated);
+    EXPECT_EQ(std::hash<Rhombus>()(first), std::hash<Rhombus>()(rotated));
+    EXPECT_NE(std::hash<Rhombus>()(first), std::hash<Rhombus>()(other));
+}
+
+TEST(FigureHashTests, CanonicalFigureEquality) {
+    const CanonicalFigure<4> first(MakeRhombus("0 1 1 0 0 -1 -1 0"));
+    const CanonicalFigure<4> second(MakeRhombus("-1 0 0 1 1 0 0 -1"));
+    const CanonicalFigure<4> third(MakeRhombus("0 2 2 0 0 -2 -2 0"));
+    EXPECT_TRUE(first == second);
+    EXPECT_TRUE(first != third);
+    EXPECT_EQ(first.GetHash(), second.GetHash());
+}
+
+TEST(FigureSetTests, InsertEraseContains) {
+    FigureSet<4> figures;
+    EXPECT_TRUE(figures.Insert(MakeRhombus("0 1 1 0 0 -1 -1 0")));
+    EXPECT_FALSE(figures.Insert(MakeRhombus("0 -1 -1 0 0 1 1 0")));
+    EXPECT_TRUE(figures.Insert(MakeRhombus("0 2 2 0 0 -2 -2 0")));
+    EXPECT_EQ(figures.Size(), 2);
+    EXPECT_TRUE(figures.Contains(MakeRhombus("1 0 0 1 -1 0 0 -1")));
+
+    EXPECT_TRUE(figures.Erase(MakeRhombus("0 1 1 0 0 -1 -1 0")));
+    EXPECT_FALSE(figures.Erase(MakeRhombus("0 1 1 0 0 -1 -1 0")));
+    EXPECT_EQ(figures.Size(), 1);
+
+    uint64_t count = 0;
+    for (const CanonicalFigure<4>& figure : figures) {
+        EXPECT_NEAR(static_cast<double>(figure.GetFigure()), 8.0, 1e-9);
+        ++count;
+    }
+    EXPECT_EQ(count, 1);
+}
+
+TEST(FigureMapTests, CountsEqualFigures) {
+    FigureMap<4, int> counts;
+    ++counts[MakeRhombus("0 1 1 0 0 -1 -1 0")];
+    ++counts[MakeRhombus("-1 0 0 -1 1 0 0 1")];
+    ++counts[MakeRhombus("0 2 2 0 0 -2 -2 0")];
+    EXPECT_EQ(counts.Size(), 2);
+    ASSERT_NE(counts.Find(MakeRhombus("0 1 1 0 0 -1 -1 0")), nullptr);
+    EXPECT_EQ(*counts.Find(MakeRhombus("0 1 1 0 0 -1 -1 0")), 2);
+    EXPECT_EQ(counts.Find(MakeRhombus("0 3 3 0 0 -3 -3 0")), nullptr);
+    EXPECT_TRUE(counts.Erase(MakeRhombus("0 2 2 0 0 -2 -2 0")));
+    EXPECT_EQ(counts.Size(), 1);
+}
+
+TEST(FigureSetTests, DeduplicateKeepsFirstOccurrence) {
+    std::vector<Hexagon> figures;
+    for (int i = 0; i < 1000; ++i) {
+        std::array<Point, 6> points;
+        for (int j = 0; j < 6; ++j) {
+            points[j] = Point(i % 10 + j, (j * 7) % 6);
+        }
+        std::rotate(points.begin(), points.begin() + i % 6, points.end());
+        figures.emplace_back(points);
+    }
+
+    const std::vector<Hexagon> unique = Deduplicate(figures);
+    ASSERT_EQ(unique.size(), 10);
+    for (uint64_t i = 0; i < unique.size(); ++i) {
+        EXPECT_TRUE(unique[i] == figures[i]);
+    }
+}
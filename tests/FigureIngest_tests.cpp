@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "FigureFile.h"
+#include "FigureIngest.h"
+#include "TestFigures.h"
+
+namespace {
+
+std::string MakePath(const std::string& name) {
+    return "/tmp/figures_ingest_" + std::to_string(getpid()) + "_" + name;
+}
+
+void WriteFile(const std::string& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary);
+    file << text;
+}
+
+std::vector<IngestBackend> GetBackends() {
+    std::vector<IngestBackend> backends = {IngestBackend::ThreadPool};
+    if (FigureIngest::IsIoUringAvailable()) {
+        backends.push_back(IngestBackend::IoUring);
+    }
+    return backends;
+}
+
+// Figures of every file in batch order, checking that the batches of a file
+// arrive in sequence.
+class Collector {
+public:
+    explicit Collector(uint64_t fileCount) : _rhombuses(fileCount), _hexagons(fileCount), _sequences(fileCount) {}
+
+    void Add(IngestBatch batch) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        EXPECT_EQ(batch.sequence, _sequences[batch.file]++);
+        if (const RhombusBatch* rhombuses = std::get_if<RhombusBatch>(&batch.figures)) {
+            for (uint64_t i = 0; i < rhombuses->Size(); ++i) {
+                _rhombuses[batch.file].push_back(rhombuses->GetFigure(i));
+            }
+        } else if (const HexagonBatch* hexagons = std::get_if<HexagonBatch>(&batch.figures)) {
+            for (uint64_t i = 0; i < hexagons->Size(); ++i) {
+                _hexagons[batch.file].push_back(hexagons->GetFigure(i));
+            }
+        }
+    }
+
+    const std::vector<Rhombus>& GetRhombuses(uint64_t file) const {
+        return _rhombuses[file];
+    }
+
+    const std::vector<Hexagon>& GetHexagons(uint64_t file) const {
+        return _hexagons[file];
+    }
+private:
+    std::mutex _mutex;
+    std::vector<std::vector<Rhombus>> _rhombuses;
+    std::vector<std::vector<Hexagon>> _hexagons;
+    std::vector<uint64_t> _sequences;
+};
+
+}
+
+TEST(FigureIngestTests, ParsesManyTextFilesLikeTheParser) {
+    std::vector<std::string> paths;
+    std::vector<std::string> texts;
+    for (uint64_t i = 0; i < 24; ++i) {
+        paths.push_back(MakePath("text" + std::to_string(i)));
+        texts.push_back(MakeFigureText(i * 7, i, 3));
+        WriteFile(paths.back(), texts.back());
+    }
+    // Errors must be reported with their place in the whole file, not in a read.
+    texts[5] += "1 2 3 x 5 6 7 8\n1 1 2 1 2 2 1 2\n";
+    WriteFile(paths[5], texts[5]);
+
+    for (IngestBackend backend : GetBackends()) {
+        for (uint64_t readSize : {7, 64, 1 << 20}) {
+            IngestOptions options;
+            options.readSize = readSize;
+            options.readsInFlight = 5;
+            options.readerThreads = 3;
+            options.parserThreads = 3;
+            options.backend = backend;
+
+            Collector collector(paths.size());
+            const IngestReport report = FigureIngest(options).Run(paths, [&](IngestBatch batch) {
+                collector.Add(std::move(batch));
+            });
+            EXPECT_EQ(report.backend, backend);
+            ASSERT_EQ(report.files.size(), paths.size());
+            for (uint64_t i = 0; i < paths.size(); ++i) {
+                const ParseResult<Rhombus> expected = ParseFigures<Rhombus>(texts[i].data(), texts[i].size());
+                EXPECT_EQ(collector.GetRhombuses(i), expected.figures) << paths[i] << ' ' << readSize;
+                EXPECT_EQ(report.files[i].path, paths[i]);
+                EXPECT_EQ(report.files[i].bytes, texts[i].size());
+                EXPECT_EQ(report.files[i].figureCount, expected.figures.size());
+                EXPECT_FALSE(report.files[i].binary);
+                ASSERT_EQ(report.files[i].errorCount, expected.errors.size());
+                for (uint64_t j = 0; j < expected.errors.size(); ++j) {
+                    EXPECT_EQ(report.files[i].errors[j].line, expected.errors[j].line);
+                    EXPECT_EQ(report.files[i].errors[j].column, expected.errors[j].column);
+                }
+            }
+            EXPECT_EQ(report.files[0].batchCount, 0u);
+            EXPECT_EQ(report.files[5].errorCount, 1u);
+        }
+    }
+
+    for (const std::string& path : paths) {
+        std::remove(path.c_str());
+    }
+}
+
+TEST(FigureIngestTests, MapsBinaryFiles) {
+    const std::string binaryPath = MakePath("binary");
+    const std::string textPath = MakePath("hexagons");
+    FigureFileWriter writer;
+    for (uint64_t i = 0; i < 100; ++i) {
+        const double x = static_cast<double>(i);
+        writer.Add(Rhombus({Point(x, 0), Point(x + 1, 0), Point(x + 1, 1), Point(x, 1)}));
+    }
+    writer.Add(Hexagon());
+    writer.Save(binaryPath);
+    WriteFile(textPath, "0 0 2 0 3 1 2 2 0 2 -1 1\n");
+
+    for (IngestBackend backend : GetBackends()) {
+        IngestOptions options;
+        options.amountOfPoints = 6;
+        options.readSize = 256;
+        options.chunkFigures = 30;
+        options.backend = backend;
+
+        Collector collector(2);
+        const IngestReport report = FigureIngest(options).Run({binaryPath, textPath}, [&](IngestBatch batch) {
+            collector.Add(std::move(batch));
+        });
+        EXPECT_TRUE(report.files[0].binary);
+        EXPECT_EQ(report.files[0].figureCount, 101u);
+        EXPECT_EQ(report.files[0].batchCount, 5u);
+        ASSERT_EQ(collector.GetRhombuses(0).size(), 100u);
+        EXPECT_EQ(collector.GetRhombuses(0)[99].GetPoints()[0], Point(99, 0));
+        EXPECT_EQ(collector.GetHexagons(0), std::vector<Hexagon>{Hexagon()});
+        EXPECT_EQ(collector.GetHexagons(1).size(), 1u);
+    }
+
+    std::remove(binaryPath.c_str());
+    std::remove(textPath.c_str());
+}
+
+TEST(FigureIngestTests, StreamsBatchesThroughAQueue) {
+    const std::string path = MakePath("queue");
+    const std::string text = MakeFigureText(2000, 7, 3);
+    WriteFile(path, text);
+
+    IngestOptions options;
+    options.readSize = 4096;
+    options.parserThreads = 2;
+    BoundedQueue<IngestBatch> batches(2);
+    uint64_t figureCount = 0;
+    std::thread consumer([&]() {
+        IngestBatch batch;
+        while (batches.Pop(batch)) {
+            figureCount += std::get<RhombusBatch>(batch.figures).Size();
+        }
+    });
+    const IngestReport report = FigureIngest(options).Run({path, path}, batches);
+    consumer.join();
+    EXPECT_TRUE(batches.IsClosed());
+    EXPECT_EQ(figureCount, 4000u);
+    EXPECT_EQ(report.files[1].figureCount, 2000u);
+
+    // A consumer that closes the queue stops the ingest early.
+    BoundedQueue<IngestBatch> first(1);
+    std::thread closer([&]() {
+        IngestBatch batch;
+        first.Pop(batch);
+        first.Close();
+    });
+    const IngestReport partial = FigureIngest(options).Run(std::vector<std::string>(20, path), first);
+    closer.join();
+    uint64_t delivered = 0;
+    for (const IngestFileReport& file : partial.files) {
+        delivered += file.figureCount;
+    }
+    EXPECT_LT(delivered, 20 * 2000u);
+
+    std::remove(path.c_str());
+}
+
+TEST(FigureIngestTests, ReportsFailures) {
+    const std::string path = MakePath("failure");
+    WriteFile(path, MakeFigureText(100, 3, 3));
+    const std::string emptyPath = MakePath("empty");
+    WriteFile(emptyPath, "");
+
+    EXPECT_THROW(FigureIngest(IngestOptions{3}), std::invalid_argument);
+    IngestOptions zero;
+    zero.readsInFlight = 0;
+    EXPECT_THROW(FigureIngest{zero}, std::invalid_argument);
+
+    for (IngestBackend backend : GetBackends()) {
+        IngestOptions options;
+        options.readSize = 64;
+        options.backend = backend;
+        FigureIngest ingest(options);
+
+        const IngestReport empty = ingest.Run({emptyPath}, [](IngestBatch) { FAIL(); });
+        EXPECT_EQ(empty.files[0].bytes, 0u);
+        EXPECT_EQ(empty.files[0].batchCount, 0u);
+
+        EXPECT_THROW(ingest.Run({path, path + ".missing"}, [](IngestBatch) {}), std::runtime_error);
+        EXPECT_THROW(ingest.Run({"/tmp"}, [](IngestBatch) {}), std::runtime_error);
+        EXPECT_THROW(ingest.Run({path, path}, [](IngestBatch) { throw std::logic_error("stop"); }),
+                     std::logic_error);
+    }
+
+    std::remove(path.c_str());
+    std::remove(emptyPath.c_str());
+}
+
+// A file that ends before the size stat() gave for it, as files under /sys
+// do, or one truncated while being read, must fail rather than hang.
+TEST(FigureIngestTests, ReportsFilesShorterThanTheirSize) {
+    const std::string path = MakePath("shrinking");
+    WriteFile(path, MakeFigureText(5000, 4, 3));
+
+    for (IngestBackend backend : GetBackends()) {
+        IngestOptions options;
+        options.readSize = 64;
+        options.readsInFlight = 2;
+        options.parserThreads = 1;
+        options.chunkFigures = 1;
+        options.backend = backend;
+
+        // The reads are at most a few buffers ahead of the first batch.
+        bool truncated = false;
+        EXPECT_THROW(FigureIngest(options).Run({path}, [&](IngestBatch) {
+            if (!truncated) {
+                truncated = true;
+                ASSERT_EQ(truncate(path.c_str(), 0), 0);
+            }
+        }), std::runtime_error);
+        WriteFile(path, MakeFigureText(5000, 4, 3));
+    }
+
+    const char* const sysfsPath = "/sys/kernel/mm/transparent_hugepage/enabled";
+    if (access(sysfsPath, R_OK) == 0) {
+        for (IngestBackend backend : GetBackends()) {
+            IngestOptions options;
+            options.backend = backend;
+            EXPECT_THROW(FigureIngest(options).Run({sysfsPath}, [](IngestBatch) {}), std::runtime_error);
+        }
+    }
+
+    std::remove(path.c_str());
+}
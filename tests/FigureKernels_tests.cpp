@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "FigureBatch.h"
+#include "FigureKernels.h"
+
+class KernelIsaGuard {
+public:
+    KernelIsaGuard() : _saved(GetKernelIsa()) {}
+    ~KernelIsaGuard() { SetKernelIsa(_saved); }
+private:
+    KernelIsa _saved;
+};
+
+template <uint64_t N>
+static FigureBatch<N> MakeBatch(uint64_t count, std::vector<typename FigureBatch<N>::FigureType>& figures) {
+    std::mt19937_64 generator(52);
+    std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+    FigureBatch<N> batch(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        std::array<Point, N> points;
+        for (uint64_t j = 0; j < N; ++j) {
+            points[j] = Point(distribution(generator), distribution(generator));
+        }
+        if (i % 7 == 0) {
+            points[1] = points[0];
+        }
+        figures.emplace_back(points);
+        batch.PushBack(figures.back());
+    }
+    return batch;
+}
+
+template <uint64_t N>
+static void ExpectAllIsasMatchPerObject() {
+    KernelIsaGuard guard;
+    std::vector<typename FigureBatch<N>::FigureType> figures;
+    const FigureBatch<N> batch = MakeBatch<N>(1003, figures);
+
+    for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2, KernelIsa::Avx512}) {
+        if (!IsKernelIsaSupported(isa)) {
+            continue;
+        }
+        SetKernelIsa(isa);
+        SCOPED_TRACE(GetKernelIsaName(isa));
+
+        std::vector<double> areas = batch.Areas();
+        std::vector<double> shoelaceAreas = batch.Areas(AreaMode::Shoelace);
+        std::vector<Point> centers = batch.GeometricCenters();
+        for (uint64_t i = 0; i < figures.size(); ++i) {
+            ASSERT_EQ(areas[i], static_cast<double>(figures[i])) << i;
+            ASSERT_EQ(shoelaceAreas[i], figures[i].GetArea(AreaMode::Shoelace)) << i;
+            ASSERT_EQ(centers[i].x, figures[i].GetGeometricCenter().x) << i;
+            ASSERT_EQ(centers[i].y, figures[i].GetGeometricCenter().y) << i;
+        }
+    }
+}
+
+TEST(FigureKernelsTests, ScalarAlwaysSupported) {
+    EXPECT_TRUE(IsKernelIsaSupported(KernelIsa::Scalar));
+    EXPECT_TRUE(IsKernelIsaSupported(GetBestKernelIsa()));
+    EXPECT_STREQ(GetKernelIsaName(KernelIsa::Avx2), "avx2");
+}
+
+TEST(FigureKernelsTests, ShoelaceAreasOfAnyVertexCount) {
+    KernelIsaGuard guard;
+    std::mt19937_64 generator(53);
+    std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+    const uint64_t count = 37;
+    for (uint64_t amountOfPoints : {3, 7, 12}) {
+        std::vector<std::vector<double>> xs(amountOfPoints, std::vector<double>(count));
+        std::vector<std::vector<double>> ys(amountOfPoints, std::vector<double>(count));
+        std::vector<const double*> xPointers;
+        std::vector<const double*> yPointers;
+        for (uint64_t i = 0; i < amountOfPoints; ++i) {
+            for (uint64_t j = 0; j < count; ++j) {
+                xs[i][j] = distribution(generator);
+                ys[i][j] = distribution(generator);
+            }
+            xPointers.push_back(xs[i].data());
+            yPointers.push_back(ys[i].data());
+        }
+
+        for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2, KernelIsa::Avx512}) {
+            if (!IsKernelIsaSupported(isa)) {
+                continue;
+            }
+            SetKernelIsa(isa);
+            std::vector<double> areas(count);
+            ComputeShoelaceAreas(amountOfPoints, xPointers.data(), yPointers.data(), count, areas.data());
+            for (uint64_t j = 0; j < count; ++j) {
+                std::vector<Point> points;
+                for (uint64_t i = 0; i < amountOfPoints; ++i) {
+                    points.emplace_back(xs[i][j], ys[i][j]);
+                }
+                ASSERT_EQ(areas[j], ShoelaceArea(points.data(), points.size())) << GetKernelIsaName(isa);
+            }
+        }
+    }
+    EXPECT_THROW(ComputeShoelaceAreas(2, nullptr, nullptr, 0, nullptr), std::invalid_argument);
+}
+
+template <uint64_t N>
+static void ExpectAllIsasTransformLikePerObject() {
+    KernelIsaGuard guard;
+    std::vector<typename FigureBatch<N>::FigureType> figures;
+    const FigureBatch<N> original = MakeBatch<N>(1003, figures);
+    const AffineTransform transform = AffineTransform::Rotation(0.3).Then(AffineTransform(1.5, 0.25, -7, 0.5, 2, 11));
+
+    for (auto& figure : figures) {
+        figure.Transform(transform);
+        figure.Rotate(-1.1);
+    }
+
+    for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2, KernelIsa::Avx512}) {
+        if (!IsKernelIsaSupported(isa)) {
+            continue;
+        }
+        SetKernelIsa(isa);
+        SCOPED_TRACE(GetKernelIsaName(isa));
+
+        FigureBatch<N> batch = original;
+        batch.Transform(transform);
+        batch.Rotate(-1.1);
+        for (uint64_t i = 0; i < figures.size(); ++i) {
+            for (uint64_t j = 0; j < N; ++j) {
+                ASSERT_EQ(batch.GetPoint(i, j).x, figures[i].GetPoints()[j].x) << i;
+                ASSERT_EQ(batch.GetPoint(i, j).y, figures[i].GetPoints()[j].y) << i;
+            }
+        }
+    }
+}
+
+TEST(FigureKernelsTests, TransformAndRotate) {
+    ExpectAllIsasTransformLikePerObject<4>();
+    ExpectAllIsasTransformLikePerObject<6>();
+}
+
+TEST(FigureKernelsTests, TransformRanges) {
+    std::vector<Rhombus> figures;
+    RhombusBatch batch = MakeBatch<4>(10, figures);
+    batch.Translate(1, 0);
+    batch.Transform(AffineTransform::Translation(0, 1), 2, 5);
+    batch.Rotate(0.5, 5, 5);
+    EXPECT_EQ(batch.GetPoint(1, 0).y, figures[1].GetPoints()[0].y);
+    EXPECT_EQ(batch.GetPoint(2, 0).y, figures[2].GetPoints()[0].y + 1);
+    EXPECT_EQ(batch.GetPoint(5, 0).x, figures[5].GetPoints()[0].x + 1);
+    EXPECT_THROW(batch.Transform(AffineTransform(), 4, 11), std::out_of_range);
+    EXPECT_THROW(batch.Rotate(1, 5, 4), std::out_of_range);
+}
+
+TEST(FigureKernelsTests, ContainsPointsLikePerObject) {
+    KernelIsaGuard guard;
+    std::vector<Hexagon> figures;
+    MakeBatch<6>(20, figures);
+    std::mt19937_64 generator(54);
+    std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+    std::uniform_real_distribution<double> nudge(-2 * pointEpsilon, 2 * pointEpsilon);
+
+    for (const Hexagon& figure : figures) {
+        const std::array<Point, 6>& outline = figure.GetPoints();
+        std::vector<double> xs;
+        std::vector<double> ys;
+        for (uint64_t i = 0; i < 600; ++i) {
+            const Point& vertex = outline[i % 6];
+            const Point& next = outline[(i + 1) % 6];
+            switch (i % 3) {
+                case 0:
+                    xs.push_back(distribution(generator));
+                    ys.push_back(distribution(generator));
+                    break;
+                case 1:
+                    xs.push_back(vertex.x + nudge(generator));
+                    ys.push_back(vertex.y + nudge(generator));
+                    break;
+                default:
+                    xs.push_back((vertex.x + next.x) / 2 + nudge(generator));
+                    ys.push_back((vertex.y + next.y) / 2 + nudge(generator));
+            }
+        }
+
+        for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2, KernelIsa::Avx512}) {
+            if (!IsKernelIsaSupported(isa)) {
+                continue;
+            }
+            SetKernelIsa(isa);
+            std::vector<uint8_t> inside(xs.size());
+            ContainsPoints(outline.data(), 6, xs.data(), ys.data(), xs.size(), inside.data());
+            for (uint64_t j = 0; j < xs.size(); ++j) {
+                ASSERT_EQ(inside[j] != 0, figure.Contains(Point(xs[j], ys[j]))) << GetKernelIsaName(isa) << ' ' << j;
+                ASSERT_EQ(inside[j] != 0, OutlineContains(outline.data(), 6, Point(xs[j], ys[j])));
+            }
+        }
+    }
+    EXPECT_THROW(ContainsPoints(nullptr, 2, nullptr, nullptr, 0, nullptr), std::invalid_argument);
+}
+
+TEST(FigureKernelsTests, SetKernelIsa) {
+    KernelIsaGuard guard;
+    SetKernelIsa(KernelIsa::Scalar);
+    EXPECT_EQ(GetKernelIsa(), KernelIsa::Scalar);
+}
+
+TEST(FigureKernelsTests, RhombusAreasAndCenters) {
+    ExpectAllIsasMatchPerObject<4>();
+}
+
+TEST(FigureKernelsTests, PentagonAreasAndCenters) {
+    ExpectAllIsasMatchPerObject<5>();
+}
+
+TEST(FigureKernelsTests, HexagonAreasAndCenters) {
+    ExpectAllIsasMatchPerObject<6>();
+}
+
+TEST(FigureKernelsTests, SideLengths) {
+    KernelIsaGuard guard;
+    std::vector<Hexagon> figures;
+    const HexagonBatch batch = MakeBatch<6>(37, figures);
+    for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2, KernelIsa::Avx512}) {
+        if (!IsKernelIsaSupported(isa)) {
+            continue;
+        }
+        SetKernelIsa(isa);
+        std::array<std::vector<double>, 6> sides;
+        std::array<double*, 6> pointers;
+        for (uint64_t i = 0; i < 6; ++i) {
+            sides[i].resize(batch.Size());
+            pointers[i] = sides[i].data();
+        }
+        batch.SideLengths(pointers.data());
+        for (uint64_t j = 0; j < batch.Size(); ++j) {
+            const std::array<Point, 6>& points = figures[j].GetPoints();
+            for (uint64_t i = 0; i < 6; ++i) {
+                const Point& next = points[(i + 1) % 6];
+                EXPECT_DOUBLE_EQ(sides[i][j], std::hypot(points[i].x - next.x, points[i].y - next.y));
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FigureBatch.h"
+#include "FigureMetrics.h"
+#include "Figures.h"
+
+TEST(FigureMetricsTests, LatencyBuckets) {
+    EXPECT_EQ(StageMetrics::GetBucket(0), 0u);
+    EXPECT_EQ(StageMetrics::GetBucket(1), 0u);
+    EXPECT_EQ(StageMetrics::GetBucket(2), 1u);
+    EXPECT_EQ(StageMetrics::GetBucket(3), 2u);
+    EXPECT_EQ(StageMetrics::GetBucket(4), 2u);
+    EXPECT_EQ(StageMetrics::GetBucket(5), 3u);
+    EXPECT_EQ(StageMetrics::GetBucket(UINT64_MAX), latencyBucketCount - 1);
+    for (uint64_t bucket = 0; bucket + 1 < latencyBucketCount; ++bucket) {
+        EXPECT_EQ(StageMetrics::GetBucket(StageMetrics::GetBucketLimit(bucket)), bucket);
+    }
+    EXPECT_EQ(StageMetrics::GetBucketLimit(latencyBucketCount - 1), UINT64_MAX);
+}
+
+TEST(FigureMetricsTests, SumsThreadsAndResets) {
+    ResetMetrics();
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (uint64_t i = 0; i < 1000; ++i) {
+                RecordCount(MetricCounter::Comparisons);
+            }
+            RecordCount(MetricCounter::Copies, 5);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (uint64_t i = 0; i < 90; ++i) {
+        RecordLatency(MetricStage::Parse, 100, 10);
+    }
+    for (uint64_t i = 0; i < 10; ++i) {
+        RecordLatency(MetricStage::Parse, 5000, 10);
+    }
+
+    MetricsSnapshot snapshot = TakeMetricsSnapshot();
+    EXPECT_GE(snapshot.threads, 5u);
+    EXPECT_EQ(snapshot.GetCounter(MetricCounter::Comparisons), 4000u);
+    EXPECT_EQ(snapshot.GetCounter(MetricCounter::Copies), 20u);
+    const StageMetrics& parse = snapshot.GetStage(MetricStage::Parse);
+    EXPECT_EQ(parse.calls, 100u);
+    EXPECT_EQ(parse.items, 1000u);
+    EXPECT_EQ(parse.totalNanoseconds, 59000u);
+    EXPECT_DOUBLE_EQ(parse.GetMeanNanoseconds(), 590.0);
+    EXPECT_DOUBLE_EQ(parse.GetItemsPerSecond(), 1000 * 1e9 / 59000);
+    EXPECT_EQ(parse.GetQuantileNanoseconds(0.5), 128u);
+    EXPECT_EQ(parse.GetQuantileNanoseconds(0.9), 128u);
+    EXPECT_EQ(parse.GetQuantileNanoseconds(0.99), 8192u);
+    EXPECT_EQ(snapshot.GetStage(MetricStage::Flush).GetQuantileNanoseconds(0.5), 0u);
+
+    ResetMetrics();
+    RecordCount(MetricCounter::Comparisons);
+    snapshot = TakeMetricsSnapshot();
+    EXPECT_EQ(snapshot.GetCounter(MetricCounter::Comparisons), 1u);
+    EXPECT_EQ(snapshot.GetCounter(MetricCounter::Copies), 0u);
+    EXPECT_EQ(snapshot.GetStage(MetricStage::Parse).calls, 0u);
+}
+
+TEST(FigureMetricsTests, Export) {
+    ResetMetrics();
+    RecordCount(MetricCounter::Moves, 3);
+    RecordLatency(MetricStage::Areas, 1000, 64);
+    const MetricsSnapshot snapshot = TakeMetricsSnapshot();
+
+    std::ostringstream json;
+    snapshot.WriteJson(json);
+    EXPECT_NE(json.str().find("\"moves\":3"), std::string::npos);
+    EXPECT_NE(json.str().find("\"areas\":{\"calls\":1,\"items\":64,\"total_ns\":1000"), std::string::npos);
+    EXPECT_NE(json.str().find("\"buckets\":[{\"le_ns\":1024,\"count\":1}]"), std::string::npos);
+    EXPECT_EQ(json.str().find("nan"), std::string::npos);
+
+    std::ostringstream prometheus;
+    snapshot.WritePrometheus(prometheus);
+    const std::string text = prometheus.str();
+    EXPECT_NE(text.find("# TYPE figures_stage_duration_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("figures_events_total{event=\"moves\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("figures_stage_items_total{stage=\"areas\"} 64\n"), std::string::npos);
+    EXPECT_NE(text.find("figures_stage_duration_seconds_bucket{stage=\"areas\",le=\"5.12e-07\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("figures_stage_duration_seconds_bucket{stage=\"areas\",le=\"1.024e-06\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("figures_stage_duration_seconds_bucket{stage=\"areas\",le=\"+Inf\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("figures_stage_duration_seconds_sum{stage=\"areas\"} 1e-06\n"), std::string::npos);
+    EXPECT_NE(text.find("figures_stage_duration_seconds_count{stage=\"areas\"} 1\n"), std::string::npos);
+}
+
+TEST(FigureMetricsTests, InstrumentationFollowsBuildOption) {
+    ResetMetrics();
+    const Rhombus rhombus({Point(0, 0), Point(2, 0), Point(2, 2), Point(0, 2)});
+    Rhombus copy(rhombus);
+    Rhombus moved(std::move(copy));
+    EXPECT_TRUE(moved == rhombus);
+    EXPECT_DOUBLE_EQ(static_cast<double>(rhombus), 4.0);
+    RhombusBatch batch;
+    batch.PushBack(rhombus);
+    batch.PushBack(moved);
+    EXPECT_EQ(batch.Areas().size(), 2u);
+
+    const MetricsSnapshot snapshot = TakeMetricsSnapshot();
+    const uint64_t expected = AreMetricsEnabled() ? 1 : 0;
+    EXPECT_EQ(snapshot.GetCounter(MetricCounter::Copies), expected);
+    EXPECT_EQ(snapshot.GetCounter(MetricCounter::Moves), expected);
+    EXPECT_EQ(snapshot.GetCounter(MetricCounter::Comparisons), expected);
+    EXPECT_EQ(snapshot.GetCounter(MetricCounter::AreaComputations), 3 * expected);
+    EXPECT_EQ(snapshot.GetStage(MetricStage::Areas).calls, expected);
+    EXPECT_EQ(snapshot.GetStage(MetricStage::Areas).items, 2 * expected);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "FigureOverlap.h"
+#include "TestFigures.h"
+
+namespace {
+
+double IntervalOverlap(double firstMin, double firstMax, double secondMin, double secondMax) {
+    return std::max(0.0, std::min(firstMax, secondMax) - std::max(firstMin, secondMin));
+}
+
+}
+
+TEST(FigureOverlapTests, Convexity) {
+    const Hexagon hexagon = MakeRegular<6>(Point(1, 2), 3, 0.1);
+    EXPECT_TRUE(IsConvexOutline(hexagon.GetPoints().data(), 6));
+    const std::array<Point, 5> clockwise = {Point(0, 0), Point(0, 1), Point(1, 1), Point(1, 1), Point(1, 0)};
+    EXPECT_TRUE(IsConvexOutline(clockwise.data(), 5));
+    const std::array<Point, 4> dart = {Point(0, 0), Point(2, 1), Point(0, 2), Point(0.5, 1)};
+    EXPECT_FALSE(IsConvexOutline(dart.data(), 4));
+    const std::array<Point, 4> bowtie = {Point(0, 0), Point(1, 1), Point(1, 0), Point(0, 1)};
+    EXPECT_FALSE(IsConvexOutline(bowtie.data(), 4));
+    const std::array<Point, 3> line = {Point(0, 0), Point(1, 1), Point(2, 2)};
+    EXPECT_FALSE(IsConvexOutline(line.data(), 3));
+
+    std::array<Point, 5> pentagram;
+    for (uint64_t i = 0; i < 5; ++i) {
+        const double angle = 4 * 3.141592653589793 * static_cast<double>(i) / 5;
+        pentagram[i] = Point(std::cos(angle), std::sin(angle));
+    }
+    EXPECT_FALSE(IsConvexOutline(pentagram.data(), 5));
+}
+
+TEST(FigureOverlapTests, IntersectionAndArea) {
+    const Rhombus square = MakeRectangle(0, 0, 2, 2);
+    EXPECT_TRUE(Intersects(square, square));
+    EXPECT_DOUBLE_EQ(OverlapArea(square, square), 4.0);
+    EXPECT_DOUBLE_EQ(OverlapArea(square, MakeRectangle(1, 1, 3, 3)), 1.0);
+    EXPECT_DOUBLE_EQ(OverlapArea(MakeRectangle(0.5, 0.5, 1, 1), square), 0.25);
+
+    // Touching figures intersect and share no area.
+    const Rhombus neighbour = MakeRectangle(2, 0, 4, 2);
+    EXPECT_TRUE(Intersects(square, neighbour));
+    EXPECT_EQ(OverlapArea(square, neighbour), 0.0);
+
+    // The boxes overlap, but the diagonal edge separates the figures.
+    const Rhombus diamond({Point(2, 3.5), Point(3.5, 2), Point(5, 3.5), Point(3.5, 5)});
+    EXPECT_FALSE(Intersects(square, diamond));
+    EXPECT_FALSE(Intersects(diamond, square));
+    EXPECT_EQ(OverlapArea(square, diamond), 0.0);
+
+    const Hexagon hexagon = MakeRegular<6>(Point(1, 1), 0.5, 0);
+    EXPECT_TRUE(Intersects(square, hexagon));
+    EXPECT_NEAR(OverlapArea(square, hexagon), hexagon.GetArea(AreaMode::Shoelace), 1e-15);
+    EXPECT_NEAR(OverlapArea(hexagon, square), hexagon.GetArea(AreaMode::Shoelace), 1e-15);
+
+    const Pentagon pentagon = MakeRegular<5>(Point(2, 1), 1, 3.141592653589793 / 2);
+    EXPECT_TRUE(Intersects(pentagon, square));
+    EXPECT_NEAR(OverlapArea(pentagon, square), pentagon.GetArea(AreaMode::Shoelace) / 2, 1e-12);
+
+    const Polygon triangle({Point(0, 0), Point(4, 0), Point(0, 4)});
+    EXPECT_TRUE(Intersects(triangle, Polygon(square)));
+    EXPECT_DOUBLE_EQ(OverlapArea(Polygon(square), triangle), 4.0);
+    EXPECT_FALSE(Intersects(Polygon({Point(3, 3), Point(5, 3), Point(5, 5)}), triangle));
+}
+
+// Overlaps of rectangles are known exactly and do not change when both
+// rectangles are rotated and moved far from (0, 0).
+TEST(FigureOverlapTests, MatchesRotatedRectangles) {
+    std::mt19937_64 generator(91);
+    std::uniform_real_distribution<double> position(-5, 5);
+    std::uniform_real_distribution<double> size(0.1, 6);
+    std::uniform_real_distribution<double> angle(0, 6.283185307179586);
+    for (uint64_t i = 0; i < 2000; ++i) {
+        const double firstX = position(generator);
+        const double firstY = position(generator);
+        const double secondX = position(generator);
+        const double secondY = position(generator);
+        Rhombus first = MakeRectangle(firstX, firstY, firstX + size(generator), firstY + size(generator));
+        Rhombus second = MakeRectangle(secondX, secondY, secondX + size(generator), secondY + size(generator));
+        const BoundingBox firstBox = first.GetBoundingBox();
+        const BoundingBox secondBox = second.GetBoundingBox();
+        const double expected = IntervalOverlap(firstBox.minX, firstBox.maxX, secondBox.minX, secondBox.maxX) *
+                                IntervalOverlap(firstBox.minY, firstBox.maxY, secondBox.minY, secondBox.maxY);
+
+        const AffineTransform transform = AffineTransform::Rotation(angle(generator)).Then(
+            AffineTransform::Translation(3e5, -7e4));
+        first.Transform(transform);
+        second.Transform(transform);
+        EXPECT_NEAR(OverlapArea(first, second), expected, 1e-8) << i;
+        EXPECT_NEAR(OverlapArea(second, first), expected, 1e-8) << i;
+        if (expected > 1e-6) {
+            EXPECT_TRUE(Intersects(first, second)) << i;
+        }
+        if (!Intersects(first, second)) {
+            EXPECT_EQ(OverlapArea(first, second), 0.0) << i;
+        }
+    }
+}
+
+TEST(FigureOverlapTests, SweepFindsEveryPair) {
+    std::mt19937_64 generator(92);
+    std::uniform_real_distribution<double> position(0, 100);
+    std::uniform_real_distribution<double> radius(0.2, 2);
+    std::uniform_real_distribution<double> phase(0, 1);
+    HexagonBatch batch;
+    for (uint64_t i = 0; i < 3000; ++i) {
+        batch.PushBack(MakeRegular<6>(Point(position(generator), position(generator)), radius(generator),
+                                      phase(generator)));
+    }
+    // A figure covering many others and an exact duplicate.
+    batch.PushBack(MakeRegular<6>(Point(50, 50), 20, 0));
+    batch.PushBack(batch.GetFigure(7));
+
+    std::vector<FigureOverlap> expected;
+    for (uint64_t i = 0; i < batch.Size(); ++i) {
+        for (uint64_t j = i + 1; j < batch.Size(); ++j) {
+            if (Intersects(batch.GetFigure(i), batch.GetFigure(j))) {
+                expected.push_back({i, j, OverlapArea(batch.GetFigure(i), batch.GetFigure(j))});
+            }
+        }
+    }
+    ASSERT_GT(expected.size(), 1000u);
+
+    ThreadPool pool(4);
+    for (const std::vector<FigureOverlap>& overlaps : {FindOverlaps(batch), FindOverlaps(batch, pool)}) {
+        ASSERT_EQ(overlaps.size(), expected.size());
+        for (uint64_t i = 0; i < overlaps.size(); ++i) {
+            EXPECT_EQ(overlaps[i].first, expected[i].first) << i;
+            EXPECT_EQ(overlaps[i].second, expected[i].second) << i;
+            EXPECT_EQ(overlaps[i].area, expected[i].area) << i;
+        }
+    }
+
+    FigureOutlines outlines;
+    EXPECT_TRUE(FindOverlaps(outlines).empty());
+    const std::array<Point, 3> invalid = {Point(0, 0), Point(NAN, 1), Point(1, 0)};
+    outlines.PushBack(invalid.data(), 3);
+    EXPECT_THROW(FindOverlaps(outlines), std::invalid_argument);
+}
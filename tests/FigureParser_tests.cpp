@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "FigureParser.h"
+
+TEST(FigureParserTests, ParsePoints) {
+    const std::string text = "5.2 6.66\n-1 +2\t.5 5.\n1e3 -2.5E-2";
+    ParseResult<Point> result = ParseFigures<Point>(text.data(), text.size());
+    ASSERT_TRUE(result.errors.empty());
+    ASSERT_EQ(result.figures.size(), 4);
+    EXPECT_DOUBLE_EQ(result.figures[0].x, 5.2);
+    EXPECT_DOUBLE_EQ(result.figures[0].y, 6.66);
+    EXPECT_DOUBLE_EQ(result.figures[1].y, 2.0);
+    EXPECT_DOUBLE_EQ(result.figures[2].x, 0.5);
+    EXPECT_DOUBLE_EQ(result.figures[2].y, 5.0);
+    EXPECT_DOUBLE_EQ(result.figures[3].x, 1000.0);
+    EXPECT_DOUBLE_EQ(result.figures[3].y, -0.025);
+}
+
+TEST(FigureParserTests, ParseRhombuses) {
+    const std::string text = "0 1 1 0 0 -1 -1 0\n0 2 2 0 0 -2 -2 0\n";
+    ParseResult<Rhombus> result = ParseFigures<Rhombus>(text.data(), text.size());
+    ASSERT_TRUE(result.errors.empty());
+    ASSERT_EQ(result.figures.size(), 2);
+
+    Rhombus expected;
+    std::istringstream is("0 2 2 0 0 -2 -2 0");
+    is >> expected;
+    EXPECT_TRUE(result.figures[1] == expected);
+}
+
+TEST(FigureParserTests, MatchesStreamExtraction) {
+    struct Case {
+        std::string text;
+        std::vector<double> values;
+        bool error;
+    };
+    const std::vector<Case> cases = {
+        {"5.", {5.0}, false}, {".5", {0.5}, false}, {"+3", {3.0}, false}, {"-.5e-3", {-0.0005}, false},
+        {"00012", {12.0}, false}, {"1e-400", {0.0}, false}, {"1e-310", {1e-310}, false},
+        {"1-2", {1.0, -2.0}, false}, {"1.5.5", {1.5, 0.5}, false}, {"1e", {}, true}, {"1e+", {}, true},
+        {"1e400", {}, true}, {".", {}, true}, {"-", {}, true}, {"+-5", {}, true}, {"inf", {}, true},
+        {"nan", {}, true}, {"abc", {}, true}, {"0x10", {0.0}, true}, {"1,5", {1.0}, true}
+    };
+
+    for (const Case& testCase : cases) {
+        SCOPED_TRACE(testCase.text);
+        std::istringstream is(testCase.text);
+        std::vector<double> extracted;
+        double value = 0;
+        while (is >> value) {
+            extracted.push_back(value);
+        }
+        ASSERT_EQ(extracted, testCase.values);
+
+        TextRecordParser parser(1);
+        parser.Feed(testCase.text.data(), testCase.text.size());
+        parser.Finish();
+        EXPECT_EQ(parser.TakeValues(), testCase.values);
+        EXPECT_EQ(parser.TakeErrors().empty(), !testCase.error);
+    }
+}
+
+TEST(FigureParserTests, ChunkBoundaries) {
+    const std::string text = "0.125 1e2 -3.5\n4 5.75 -6e-1 7 8\n";
+    for (uint64_t chunkSize = 1; chunkSize <= text.size(); ++chunkSize) {
+        FigureTextParser<Rhombus> parser;
+        for (uint64_t i = 0; i < text.size(); i += chunkSize) {
+            parser.Feed(text.data() + i, std::min<uint64_t>(chunkSize, text.size() - i));
+        }
+        parser.Finish();
+        std::vector<Rhombus> figures = parser.TakeFigures();
+        ASSERT_EQ(figures.size(), 1) << chunkSize;
+        EXPECT_TRUE(figures[0].GetPoints()[0] == Point(0.125, 100.0));
+        EXPECT_TRUE(figures[0].GetPoints()[3] == Point(7, 8));
+        EXPECT_TRUE(parser.TakeErrors().empty());
+    }
+}
+
+TEST(FigureParserTests, ErrorsHaveLineAndColumn) {
+    const std::string text = "0 1 1 0 0 -1 -1 0\n0 1 1 abc 0 -1 -1 0\n0 2 2 0 0 -2 -2 0\n";
+    ParseResult<Rhombus> result = ParseFigures<Rhombus>(text.data(), text.size());
+    ASSERT_EQ(result.errors.size(), 1);
+    EXPECT_EQ(result.errors[0].line, 2);
+    EXPECT_EQ(result.errors[0].column, 7);
+    EXPECT_EQ(result.errors[0].message, "Incorrect type provided");
+    EXPECT_EQ(result.figures.size(), 2);
+}
+
+TEST(FigureParserTests, UnexpectedEndOfInput) {
+    const std::string text = "0 1 1 0 0 -1";
+    ParseResult<Rhombus> result = ParseFigures<Rhombus>(text.data(), text.size());
+    EXPECT_TRUE(result.figures.empty());
+    ASSERT_EQ(result.errors.size(), 1);
+    EXPECT_EQ(result.errors[0].message, "Unexpected end of input");
+}
+
+TEST(FigureParserTests, ParseFromStream) {
+    std::ostringstream os;
+    for (int i = 0; i < 1000; ++i) {
+        os << "1 0 0.5 0.866 -0.5 0.866 -1 0 -0.5 -0.866 0.5 -0.866\n";
+    }
+    std::istringstream is(os.str());
+    ParseResult<Hexagon> result = ParseFigures<Hexagon>(is, 64);
+    EXPECT_TRUE(result.errors.empty());
+    ASSERT_EQ(result.figures.size(), 1000);
+    EXPECT_NEAR(static_cast<double>(result.figures[999]), 2.598, 0.01);
+}
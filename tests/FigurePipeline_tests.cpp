@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include "FigurePipeline.h"
+#include "TestFigures.h"
+
+TEST(RunningAggregatesTests, CountSumMinMaxTop) {
+    RunningAggregates aggregates(3);
+    EXPECT_EQ(aggregates.GetCount(), 0);
+    EXPECT_EQ(aggregates.GetMin(), std::numeric_limits<double>::infinity());
+
+    const double areas[] = {5, 1, 7, 7, 3, 9, 2};
+    for (uint64_t i = 0; i < 7; ++i) {
+        aggregates.Add({i, 4, areas[i], Point()});
+    }
+    EXPECT_EQ(aggregates.GetCount(), 7);
+    EXPECT_EQ(aggregates.GetSum(), 34);
+    EXPECT_EQ(aggregates.GetMin(), 1);
+    EXPECT_EQ(aggregates.GetMax(), 9);
+
+    const std::vector<FigureResult> top = aggregates.GetTop();
+    ASSERT_EQ(top.size(), 3);
+    EXPECT_EQ(top[0].index, 5);
+    EXPECT_EQ(top[1].index, 2);
+    EXPECT_EQ(top[2].index, 3);
+}
+
+TEST(FigurePipelineTests, TextMatchesFigures) {
+    const std::string text = MakeFigureText(5000, 1);
+    PipelineOptions options;
+    options.readSize = 4096;
+    options.queueCapacity = 2;
+    FigurePipeline pipeline(options);
+
+    std::istringstream input(text);
+    std::ostringstream output;
+    pipeline.ProcessText(input, output);
+
+    std::istringstream figures(text);
+    std::istringstream lines(output.str());
+    double sum = 0;
+    for (uint64_t i = 0; i < 5000; ++i) {
+        Rhombus rhombus;
+        figures >> rhombus;
+        const double area = static_cast<double>(rhombus);
+        sum += area;
+
+        uint64_t index = 0;
+        double writtenArea = 0;
+        char open = 0;
+        Point center;
+        char close = 0;
+        ASSERT_TRUE(lines >> index >> writtenArea >> open >> center.x >> center.y >> close);
+        EXPECT_EQ(index, i);
+        EXPECT_EQ(writtenArea, area);
+        EXPECT_EQ(center.x, rhombus.GetGeometricCenter().x);
+        EXPECT_EQ(center.y, rhombus.GetGeometricCenter().y);
+    }
+    EXPECT_EQ(pipeline.GetAggregates().GetCount(), 5000);
+    EXPECT_EQ(pipeline.GetAggregates().GetSum(), sum);
+    EXPECT_EQ(pipeline.GetErrorCount(), 0);
+}
+
+TEST(FigurePipelineTests, ErrorsAndSummary) {
+    PipelineOptions options;
+    options.amountOfPoints = 5;
+    options.topCount = 1;
+    options.maxErrors = 1;
+    options.writeFigures = false;
+    FigurePipeline pipeline(options);
+
+    std::istringstream input("0 0 2 0 2 2 1 3 0 2\nx 1\n0 0 1 0 1 1 0 1 0 0\ny\n");
+    std::ostringstream output;
+    pipeline.ProcessText(input, output);
+    EXPECT_TRUE(output.str().empty());
+    EXPECT_EQ(pipeline.GetErrorCount(), 2);
+    ASSERT_EQ(pipeline.GetErrors().size(), 1);
+    EXPECT_EQ(pipeline.GetErrors()[0].line, 2);
+
+    std::ostringstream summary;
+    pipeline.WriteSummary(summary);
+    EXPECT_EQ(summary.str().rfind("count 2\n", 0), 0);
+    EXPECT_NE(summary.str().find("errors 2\ntop 0 "), std::string::npos);
+}
+
+TEST(FigurePipelineTests, BinaryInput) {
+    const std::string path = ::testing::TempDir() + "pipeline_test.figb";
+    const Rhombus rhombus({Point(0, 1), Point(1, 0), Point(0, -1), Point(-1, 0)});
+    FigureFileWriter file;
+    for (int i = 0; i < 100; ++i) {
+        file.Add(rhombus);
+    }
+    file.Add(Hexagon());
+    file.Save(path);
+
+    PipelineOptions options;
+    options.chunkFigures = 7;
+    FigurePipeline pipeline(options);
+    std::ostringstream output;
+    pipeline.ProcessBinary(FigureFileReader(path), output);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(pipeline.GetAggregates().GetCount(), 101);
+    EXPECT_EQ(pipeline.GetAggregates().GetMax(), static_cast<double>(rhombus));
+    EXPECT_EQ(pipeline.GetAggregates().GetMin(), 0);
+    EXPECT_EQ(pipeline.GetAggregates().GetTop()[0].index, 0);
+
+    std::istringstream lines(output.str());
+    std::string line;
+    std::string last;
+    uint64_t count = 0;
+    while (std::getline(lines, line)) {
+        EXPECT_EQ(line.substr(0, line.find(' ')), std::to_string(count));
+        last = line;
+        ++count;
+    }
+    EXPECT_EQ(count, 101);
+    EXPECT_EQ(last, "100 0 (0 0)");
+}
+
+TEST(FigurePipelineTests, InvalidOptions) {
+    PipelineOptions options;
+    options.amountOfPoints = 3;
+    EXPECT_THROW(FigurePipeline pipeline(options), std::invalid_argument);
+    options.amountOfPoints = 4;
+    options.queueCapacity = 0;
+    EXPECT_THROW(FigurePipeline pipeline(options), std::invalid_argument);
+}
+
+TEST(FigurePipelineTests, FailedOutputStopsPipeline) {
+    const std::string text = MakeFigureText(20000, 2);
+    PipelineOptions options;
+    options.readSize = 1024;
+    FigurePipeline pipeline(options);
+    std::istringstream input(text);
+    std::ostringstream output;
+    output.setstate(std::ios::badbit);
+    EXPECT_THROW(pipeline.ProcessText(input, output), std::runtime_error);
+}
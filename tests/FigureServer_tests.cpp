@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "FigureFile.h"
+#include "FigureServer.h"
+#include "TestFigures.h"
+
+namespace {
+
+std::string MakeSocketPath(const std::string& name) {
+    return "/tmp/figures_" + std::to_string(getpid()) + "_" + name + ".sock";
+}
+
+FrameHeader MakeRequest(FigureOpcode opcode, uint32_t dataset, uint64_t payloadSize) {
+    return {static_cast<uint32_t>(payloadSize), 7, static_cast<uint16_t>(opcode), 0, dataset};
+}
+
+}
+
+TEST(FigureServerTests, ProtocolRoundTrip) {
+    std::vector<char> frame;
+    AppendFrameHeader(frame, {12, 34, 3, 4, 56});
+    ASSERT_EQ(frame.size(), frameHeaderSize);
+    EXPECT_EQ(frame[0], 12);
+    EXPECT_EQ(frame[4], 34);
+    const FrameHeader header = ReadFrameHeader(frame.data());
+    EXPECT_EQ(header.payloadSize, 12u);
+    EXPECT_EQ(header.requestId, 34u);
+    EXPECT_EQ(header.opcode, 3u);
+    EXPECT_EQ(header.status, 4u);
+    EXPECT_EQ(header.dataset, 56u);
+
+    const std::vector<uint64_t> indices = {0, 5, UINT64_MAX};
+    std::vector<char> payload = EncodeIndices(indices.data(), indices.size());
+    EXPECT_EQ(DecodeIndices(payload.data(), payload.size()), indices);
+    EXPECT_THROW(DecodeIndices(payload.data(), payload.size() - 1), std::invalid_argument);
+
+    // An empty result has no data to copy from.
+    payload = EncodeIndices(nullptr, 0);
+    EXPECT_TRUE(payload.empty());
+    EXPECT_TRUE(DecodeIndices(payload.data(), payload.size()).empty());
+    EXPECT_TRUE(DecodeAreas(nullptr, 0).empty());
+
+    payload = EncodeWindow(BoundingBox(1, 2, 3, 4));
+    const BoundingBox window = DecodeWindow(payload.data(), payload.size());
+    EXPECT_EQ(window.minX, 1);
+    EXPECT_EQ(window.maxY, 4);
+
+    const std::vector<Point> centroids = {Point(1.5, -2), Point(0, 1e300)};
+    payload = EncodeCentroids(centroids.data(), centroids.size());
+    const std::vector<Point> decoded = DecodeCentroids(payload.data(), payload.size());
+    ASSERT_EQ(decoded.size(), 2u);
+    EXPECT_EQ(decoded[1].y, 1e300);
+
+    payload = EncodeAggregate({3, 10, 1, 6, BoundingBox(0, 0, 5, 5)});
+    const DatasetAggregate aggregate = DecodeAggregate(payload.data(), payload.size());
+    EXPECT_EQ(aggregate.count, 3u);
+    EXPECT_EQ(aggregate.maxArea, 6);
+    EXPECT_EQ(aggregate.bounds.maxX, 5);
+
+    payload = EncodeDatasets({{"first", 10}, {"", 0}});
+    const std::vector<DatasetInfo> datasets = DecodeDatasets(payload.data(), payload.size());
+    ASSERT_EQ(datasets.size(), 2u);
+    EXPECT_EQ(datasets[0].name, "first");
+    EXPECT_EQ(datasets[0].figureCount, 10u);
+    EXPECT_THROW(DecodeDatasets(payload.data(), payload.size() - 1), std::invalid_argument);
+}
+
+TEST(FigureServerTests, DatasetAnswers) {
+    const FigureArray figures = MakeFigureArray(500, 101);
+    const FigureDataset dataset(figures);
+    EXPECT_EQ(dataset.Size(), 500u);
+    EXPECT_EQ(dataset.GetAreas(), figures.Areas());
+
+    const BoundingBox window(20, 20, 40, 30);
+    std::vector<uint64_t> expected;
+    DatasetAggregate aggregate{0, 0, 0, 0, BoundingBox()};
+    for (uint64_t i = 0; i < figures.Size(); ++i) {
+        figures[i].Visit([&](const auto& figure) {
+            if (figure.GetBoundingBox().Intersects(window)) {
+                expected.push_back(i);
+                aggregate.totalArea += static_cast<double>(figure);
+                aggregate.bounds.Expand(figure.GetBoundingBox());
+            }
+        });
+    }
+    EXPECT_EQ(dataset.Query(window), expected);
+    EXPECT_EQ(dataset.Aggregate(window).count, expected.size());
+    EXPECT_EQ(dataset.Aggregate(window).totalArea, aggregate.totalArea);
+    EXPECT_EQ(dataset.Aggregate(window).bounds.minX, aggregate.bounds.minX);
+    EXPECT_EQ(dataset.Aggregate().count, 500u);
+    EXPECT_EQ(dataset.Aggregate(BoundingBox(-5, -5, -4, -4)).count, 0u);
+
+    FigureServer server(MakeSocketPath("handle"), 1);
+    server.AddDataset("figures", FigureDataset(figures));
+    const uint64_t index = 3;
+    std::vector<char> out;
+    server.Handle(MakeRequest(FigureOpcode::Areas, 0, 8), reinterpret_cast<const char*>(&index), out);
+    server.Handle(MakeRequest(FigureOpcode::Areas, 0, 7), reinterpret_cast<const char*>(&index), out);
+    server.Handle(MakeRequest(FigureOpcode::Areas, 1, 0), nullptr, out);
+    server.Handle(MakeRequest(static_cast<FigureOpcode>(99), 0, 0), nullptr, out);
+    const uint64_t outside = 500;
+    server.Handle(MakeRequest(FigureOpcode::Centroids, 0, 8), reinterpret_cast<const char*>(&outside), out);
+
+    std::vector<FigureStatus> statuses;
+    for (uint64_t offset = 0; offset < out.size();) {
+        const FrameHeader header = ReadFrameHeader(out.data() + offset);
+        EXPECT_EQ(header.requestId, 7u);
+        statuses.push_back(static_cast<FigureStatus>(header.status));
+        if (statuses.size() == 1) {
+            EXPECT_EQ(DecodeAreas(out.data() + offset + frameHeaderSize, header.payloadSize),
+                      std::vector<double>{figures.Areas()[3]});
+        }
+        offset += frameHeaderSize + header.payloadSize;
+    }
+    EXPECT_EQ(statuses, (std::vector<FigureStatus>{FigureStatus::Ok, FigureStatus::BadRequest,
+                                                   FigureStatus::UnknownDataset, FigureStatus::UnknownOpcode,
+                                                   FigureStatus::IndexOutOfRange}));
+}
+
+TEST(FigureServerTests, LoadsTextAndBinaryFiles) {
+    const std::string textPath = MakeSocketPath("text") + ".txt";
+    const std::string binaryPath = MakeSocketPath("binary") + ".figb";
+    {
+        std::ofstream text(textPath);
+        text << "0 0 2 0 2 2 0 2\n1 1 4 1 4 4 1 4\n";
+        FigureFileWriter writer;
+        writer.Add(Rhombus({Point(0, 0), Point(1, 0), Point(1, 1), Point(0, 1)}));
+        writer.Add(Hexagon());
+        writer.Save(binaryPath);
+    }
+
+    const FigureDataset text = LoadFigureDataset(textPath);
+    EXPECT_EQ(text.Size(), 2u);
+    EXPECT_DOUBLE_EQ(text.GetAreas()[1], 9);
+    const FigureDataset binary = LoadFigureDataset(binaryPath, 6);
+    EXPECT_EQ(binary.Size(), 2u);
+    EXPECT_DOUBLE_EQ(binary.GetAreas()[0], 1);
+    EXPECT_THROW(LoadFigureDataset(textPath, 6), std::invalid_argument);
+    EXPECT_THROW(LoadFigureDataset(textPath + ".missing"), std::runtime_error);
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+}
+
+TEST(FigureServerTests, ServesPipelinedRequests) {
+    const FigureArray figures = MakeFigureArray(5000, 102);
+    FigureServer server(MakeSocketPath("serve"), 3);
+    server.AddDataset("empty", FigureDataset(FigureArray()));
+    const uint32_t id = server.AddDataset("figures", FigureDataset(figures));
+    server.Start();
+    EXPECT_TRUE(server.IsRunning());
+    EXPECT_THROW(server.AddDataset("late", FigureDataset(FigureArray())), std::logic_error);
+    EXPECT_THROW(FigureServer(server.GetSocketPath(), 1).Start(), std::runtime_error);
+
+    FigureClient client(server.GetSocketPath());
+    const std::vector<DatasetInfo> datasets = client.ListDatasets();
+    ASSERT_EQ(datasets.size(), 2u);
+    EXPECT_EQ(datasets[1].name, "figures");
+    EXPECT_EQ(datasets[1].figureCount, 5000u);
+
+    const std::vector<double> areas = figures.Areas();
+    const std::vector<Point> centers = figures.GeometricCenters();
+    const std::vector<uint64_t> indices = {4999, 0, 17, 17};
+    const std::vector<double> answered = client.Areas(id, indices);
+    const std::vector<Point> centroids = client.Centroids(id, indices);
+    for (uint64_t i = 0; i < indices.size(); ++i) {
+        EXPECT_EQ(answered[i], areas[indices[i]]);
+        EXPECT_EQ(centroids[i].x, centers[indices[i]].x);
+        EXPECT_EQ(centroids[i].y, centers[indices[i]].y);
+    }
+    const BoundingBox window(10, 10, 30, 15);
+    EXPECT_EQ(client.WindowQuery(id, window), server.GetDataset(id).Query(window));
+    EXPECT_EQ(client.Aggregate(id).totalArea, server.GetDataset(id).Aggregate().totalArea);
+    EXPECT_EQ(client.Aggregate(id, window).count, server.GetDataset(id).Aggregate(window).count);
+    EXPECT_EQ(client.Aggregate(0).count, 0u);
+    EXPECT_THROW(client.Areas(id, {5000}), std::runtime_error);
+    EXPECT_THROW(client.Areas(9, {0}), std::runtime_error);
+
+    // Many requests in flight, larger than one read, answered in order.
+    std::vector<uint32_t> ids;
+    std::vector<uint64_t> batch(4000);
+    for (uint64_t i = 0; i < 200; ++i) {
+        for (uint64_t j = 0; j < batch.size(); ++j) {
+            batch[j] = (i * 31 + j) % figures.Size();
+        }
+        ids.push_back(client.Send(FigureOpcode::Areas, id, EncodeIndices(batch.data(), batch.size())));
+    }
+    for (uint64_t i = 0; i < ids.size(); ++i) {
+        const FigureResponse response = client.Receive();
+        ASSERT_EQ(response.header.requestId, ids[i]);
+        ASSERT_EQ(response.header.status, static_cast<uint16_t>(FigureStatus::Ok));
+        const std::vector<double> values = DecodeAreas(response.payload.data(), response.payload.size());
+        ASSERT_EQ(values.size(), batch.size());
+        EXPECT_EQ(values[5], areas[(i * 31 + 5) % figures.Size()]);
+    }
+
+    // Concurrent clients next to the open one.
+    std::vector<std::thread> threads;
+    std::vector<double> totals(2);
+    for (uint64_t t = 0; t < 2; ++t) {
+        threads.emplace_back([&server, &totals, id, t]() {
+            FigureClient other(server.GetSocketPath());
+            for (uint64_t i = 0; i < 100; ++i) {
+                totals[t] += other.Areas(id, {i})[0];
+            }
+        });
+    }
+    client.Areas(id, {0});
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(totals[0], totals[1]);
+
+    // Stopping closes the connections that are still open.
+    server.Stop();
+    EXPECT_FALSE(server.IsRunning());
+    EXPECT_THROW(client.ListDatasets(), std::runtime_error);
+    EXPECT_THROW(FigureClient(server.GetSocketPath()), std::runtime_error);
+    EXPECT_THROW(server.Start(), std::logic_error);
+}
+
+// Idle clients must not hold the workers: one worker answers a client
+// behind many that connected first and never send, and Stop() returns with
+// all of them still open.
+TEST(FigureServerTests, ServesMoreClientsThanWorkers) {
+    FigureServer server(MakeSocketPath("idle"), 1);
+    const uint32_t id = server.AddDataset("figures", FigureDataset(MakeFigureArray(100, 103)));
+    server.Start();
+
+    std::vector<std::unique_ptr<FigureClient>> idle;
+    for (uint64_t i = 0; i < 100; ++i) {
+        idle.push_back(std::make_unique<FigureClient>(server.GetSocketPath()));
+    }
+    idle[0]->Send(FigureOpcode::ListDatasets, 0, {});
+    idle[0]->Flush();
+
+    FigureClient client(server.GetSocketPath());
+    EXPECT_EQ(client.ListDatasets().size(), 1u);
+    EXPECT_EQ(client.Areas(id, {99}), std::vector<double>{server.GetDataset(id).GetAreas()[99]});
+    EXPECT_EQ(idle[0]->Receive().header.status, static_cast<uint16_t>(FigureStatus::Ok));
+
+    server.Stop();
+    EXPECT_THROW(idle[1]->ListDatasets(), std::runtime_error);
+}
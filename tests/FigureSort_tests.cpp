@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "FigureEngine.h"
+#include "FigureSort.h"
+#include "TestFigures.h"
+
+namespace {
+
+// Many ties, both zeros, infinities and NaN.
+std::vector<double> MakeKeys(uint64_t count, uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<int> kind(0, 19);
+    std::uniform_int_distribution<int> small(-20, 20);
+    std::uniform_real_distribution<double> value(-1e6, 1e6);
+    std::vector<double> keys(count);
+    for (double& key : keys) {
+        switch (kind(generator)) {
+        case 0:
+            key = std::nan("");
+            break;
+        case 1:
+            key = -0.0;
+            break;
+        case 2:
+            key = std::numeric_limits<double>::infinity();
+            break;
+        case 3:
+            key = -std::numeric_limits<double>::infinity();
+            break;
+        case 4:
+        case 5:
+        case 6:
+        case 7:
+            key = small(generator);
+            break;
+        default:
+            key = value(generator);
+        }
+    }
+    return keys;
+}
+
+// The documented order, spelled out with comparisons.
+bool Before(double first, double second, SortOrder order) {
+    if (std::isnan(first) || std::isnan(second)) {
+        return !std::isnan(first) && std::isnan(second);
+    }
+    return order == SortOrder::Ascending ? first < second : first > second;
+}
+
+bool Before(const Point& first, const Point& second, SortOrder order) {
+    const bool firstNan = std::isnan(first.x) || std::isnan(first.y);
+    const bool secondNan = std::isnan(second.x) || std::isnan(second.y);
+    if (firstNan || secondNan) {
+        return !firstNan && secondNan;
+    }
+    if (first.x != second.x) {
+        return Before(first.x, second.x, order);
+    }
+    return Before(first.y, second.y, order);
+}
+
+template <typename Key>
+std::vector<uint64_t> ReferenceSort(const std::vector<Key>& keys, SortOrder order) {
+    std::vector<uint64_t> indices(keys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(), [&keys, order](uint64_t first, uint64_t second) {
+        return Before(keys[first], keys[second], order);
+    });
+    return indices;
+}
+
+}
+
+TEST(FigureSortTests, SortMatchesStableSort) {
+    ThreadPool pool(4);
+    for (uint64_t count : {0, 1, 7, 1000, 200000}) {
+        const std::vector<double> keys = MakeKeys(count, count + 81);
+        for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+            const std::vector<uint64_t> expected = ReferenceSort(keys, order);
+            EXPECT_EQ(SortByKey(keys.data(), count, order), expected) << count;
+            EXPECT_EQ(SortByKey(keys.data(), count, pool, order), expected) << count;
+        }
+    }
+}
+
+TEST(FigureSortTests, SortsCentersByXThenY) {
+    ThreadPool pool(3);
+    const std::vector<double> xs = MakeKeys(150000, 82);
+    std::vector<Point> centers(xs.size());
+    std::mt19937_64 generator(83);
+    std::uniform_int_distribution<int> y(-3, 3);
+    for (uint64_t i = 0; i < xs.size(); ++i) {
+        // Few distinct x values, so y decides often.
+        centers[i] = Point(std::isnan(xs[i]) ? xs[i] : std::round(xs[i] / 1e5), y(generator));
+    }
+    centers[5].y = std::nan("");
+
+    for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+        const std::vector<uint64_t> expected = ReferenceSort(centers, order);
+        EXPECT_EQ(SortByKey(centers.data(), centers.size(), order), expected);
+        EXPECT_EQ(SortByKey(centers.data(), centers.size(), pool, order), expected);
+    }
+}
+
+TEST(FigureSortTests, TopIsSortPrefix) {
+    ThreadPool pool(4);
+    const std::vector<double> keys = MakeKeys(300000, 84);
+    for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+        const std::vector<uint64_t> sorted = ReferenceSort(keys, order);
+        for (uint64_t k : {0, 1, 10, 5000, 200000, 400000}) {
+            std::vector<uint64_t> expected(sorted.begin(), sorted.begin() + std::min<uint64_t>(k, keys.size()));
+            EXPECT_EQ(TopByKey(keys.data(), keys.size(), k, order), expected) << k;
+            EXPECT_EQ(TopByKey(keys.data(), keys.size(), k, pool, order), expected) << k;
+        }
+    }
+
+    const std::vector<Point> centers = {Point(1, 2), Point(3, 0), Point(1, 5), Point(3, 0)};
+    EXPECT_EQ(TopByKey(centers.data(), centers.size(), 2), (std::vector<uint64_t>{1, 3}));
+    EXPECT_EQ(TopByKey(centers.data(), centers.size(), 2, SortOrder::Ascending), (std::vector<uint64_t>{0, 2}));
+}
+
+TEST(FigureSortTests, SelectorStreamsAndMerges) {
+    const std::vector<double> keys = MakeKeys(10000, 85);
+    const std::vector<uint64_t> sorted = ReferenceSort(keys, SortOrder::Descending);
+
+    TopKSelector<double> first(25);
+    TopKSelector<double> second(25);
+    for (uint64_t i = 0; i < keys.size(); ++i) {
+        (i % 3 == 0 ? first : second).Push(keys[i], i);
+    }
+    EXPECT_EQ(first.Size(), 25u);
+    first.Merge(second);
+    EXPECT_EQ(first.GetK(), 25u);
+    EXPECT_EQ(first.GetIndices(), std::vector<uint64_t>(sorted.begin(), sorted.begin() + 25));
+
+    TopKSelector<double> few(10, SortOrder::Ascending);
+    few.Push(2, 0);
+    few.Push(-0.0, 1);
+    few.Push(0.0, 2);
+    EXPECT_EQ(few.Size(), 3u);
+    EXPECT_EQ(few.GetIndices(), (std::vector<uint64_t>{1, 2, 0}));
+    EXPECT_THROW(few.Merge(second), std::invalid_argument);
+
+    TopKSelector<Point> none(0);
+    none.Push(Point(1, 1), 0);
+    EXPECT_TRUE(none.GetIndices().empty());
+}
+
+TEST(FigureSortTests, PartitionIsStable) {
+    ThreadPool pool(4);
+    const std::vector<double> keys = MakeKeys(200000, 86);
+    std::vector<uint64_t> below;
+    std::vector<uint64_t> above;
+    for (uint64_t i = 0; i < keys.size(); ++i) {
+        (keys[i] < 0.5 ? below : above).push_back(i);
+    }
+    std::vector<uint64_t> expected = below;
+    expected.insert(expected.end(), above.begin(), above.end());
+
+    for (const KeyPartition& partition : {PartitionByKey(keys.data(), keys.size(), 0.5),
+                                          PartitionByKey(keys.data(), keys.size(), 0.5, pool)}) {
+        EXPECT_EQ(partition.split, below.size());
+        EXPECT_EQ(partition.indices, expected);
+    }
+    EXPECT_EQ(PartitionByKey(keys.data(), 0, 0.5).split, 0u);
+}
+
+TEST(FigureSortTests, EngineRanksFigures) {
+    FigureEngine engine(4, 1000);
+    RhombusBatch batch;
+    std::vector<std::unique_ptr<Figure>> figures;
+    std::mt19937_64 generator(87);
+    std::uniform_int_distribution<int> size(1, 50);
+    std::uniform_real_distribution<double> position(-100, 100);
+    for (uint64_t i = 0; i < 20000; ++i) {
+        const double side = size(generator);
+        const Point corner(position(generator), position(generator));
+        const Rhombus rhombus = MakeSquare(corner.x, corner.y, side);
+        batch.PushBack(rhombus);
+        figures.push_back(std::make_unique<Rhombus>(rhombus));
+    }
+
+    const std::vector<double> areas = batch.Areas();
+    const std::vector<Point> centers = batch.GeometricCenters();
+    EXPECT_EQ(engine.SortByArea(batch), ReferenceSort(areas, SortOrder::Ascending));
+    EXPECT_EQ(engine.SortByArea(figures, SortOrder::Descending), ReferenceSort(areas, SortOrder::Descending));
+    EXPECT_EQ(engine.SortByCenter(batch), ReferenceSort(centers, SortOrder::Ascending));
+
+    const std::vector<uint64_t> top = engine.TopByArea(figures, 100);
+    const std::vector<uint64_t> sorted = ReferenceSort(areas, SortOrder::Descending);
+    EXPECT_EQ(top, std::vector<uint64_t>(sorted.begin(), sorted.begin() + 100));
+
+    const KeyPartition partition = engine.PartitionByArea(batch, 400);
+    for (uint64_t i = 0; i < partition.indices.size(); ++i) {
+        EXPECT_EQ(areas[partition.indices[i]] < 400, i < partition.split) << i;
+    }
+}
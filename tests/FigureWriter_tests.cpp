@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include "FigureWriter.h"
+
+TEST(FigureWriterTests, PointMatchesStreamOutput) {
+    std::string output;
+    char buffer[FigureTextWriter::minCapacity];
+    {
+        FigureTextWriter writer(buffer, sizeof(buffer), [&output](const char* data, uint64_t size) {
+            output.append(data, size);
+        });
+        writer.Write(Point(5, 2));
+    }
+    EXPECT_EQ(output, "(5 2)");
+}
+
+TEST(FigureWriterTests, FiguresMatchStreamOutput) {
+    Rhombus rhombus;
+    std::istringstream is1("0 1 1 0 0 -1 -1 0");
+    is1 >> rhombus;
+    Hexagon hexagon;
+    std::istringstream is2("1 0 0.5 0.866 -0.5 0.866 -1 0 -0.5 -0.866 0.5 -0.866");
+    is2 >> hexagon;
+
+    std::ostringstream expected;
+    expected << rhombus << '\n' << hexagon << '\n';
+
+    std::ostringstream os;
+    std::vector<char> buffer(4096);
+    FigureTextWriter writer(buffer.data(), buffer.size(), os);
+    writer.Write(rhombus);
+    writer.Write('\n');
+    writer.Write(hexagon);
+    writer.Write('\n');
+    writer.Flush();
+    EXPECT_EQ(os.str(), expected.str());
+    EXPECT_EQ(writer.GetBytesWritten(), expected.str().size());
+}
+
+TEST(FigureWriterTests, ShortestRoundTrip) {
+    std::mt19937_64 generator(52);
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    std::vector<Point> points;
+    for (int i = 0; i < 10000; ++i) {
+        points.emplace_back(distribution(generator), distribution(generator));
+    }
+
+    std::ostringstream os;
+    char buffer[FigureTextWriter::minCapacity];
+    FigureTextWriter writer(buffer, sizeof(buffer), os);
+    writer.WriteLines(points);
+    writer.Flush();
+
+    std::istringstream is(os.str());
+    std::string line;
+    for (const Point& point : points) {
+        ASSERT_TRUE(std::getline(is, line));
+        double x = 0;
+        double y = 0;
+        ASSERT_EQ(std::sscanf(line.c_str(), "(%lf %lf)", &x, &y), 2);
+        EXPECT_EQ(x, point.x);
+        EXPECT_EQ(y, point.y);
+    }
+}
+
+TEST(FigureWriterTests, WriteBatchLines) {
+    PentagonBatch batch;
+    batch.PushBack(Pentagon());
+    batch.PushBack(Pentagon());
+    std::ostringstream os;
+    char buffer[128];
+    FigureTextWriter writer(buffer, sizeof(buffer), os);
+    writer.WriteLines(batch);
+    writer.Flush();
+    EXPECT_EQ(os.str(), "(0 0) (0 0) (0 0) (0 0) (0 0)\n(0 0) (0 0) (0 0) (0 0) (0 0)\n");
+}
+
+TEST(FigureWriterTests, BufferTooSmall) {
+    char buffer[8];
+    std::ostringstream os;
+    EXPECT_THROW(FigureTextWriter(buffer, sizeof(buffer), os), std::invalid_argument);
+}
+
+TEST(FigureWriterTests, WriteNumbersAndText) {
+    std::ostringstream os;
+    char buffer[FigureTextWriter::minCapacity];
+    {
+        FigureTextWriter writer(buffer, sizeof(buffer), os);
+        for (int i = 0; i < 10; ++i) {
+            writer.Write("value ");
+            writer.Write(static_cast<uint64_t>(18446744073709551615ULL));
+            writer.Write(' ');
+            writer.Write(-0.1);
+            writer.Write('\n');
+        }
+    }
+    std::string expected;
+    for (int i = 0; i < 10; ++i) {
+        expected += "value 18446744073709551615 -0.1\n";
+    }
+    EXPECT_EQ(os.str(), expected);
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <sstream>
 #include <array>
+#include <type_traits>
 #include "Figures.h"
 
 TEST(PointStructTests, DefaultConstructor) {
@@ -374,4 +375,109 @@ TEST(FigureArrayTests, AddMultipleFigures) {
         Point c = arr[i].GetGeometricCenter();
         EXPECT_DOUBLE_EQ(c.x, 0.0);
     }
-}
\ No newline at end of file
+}
+TEST(RegularPolygonTests, AliasesAreInstantiations) {
+    EXPECT_TRUE((std::is_same<Rhombus, RegularPolygon<4>>::value));
+    EXPECT_TRUE((std::is_same<Pentagon, RegularPolygon<5>>::value));
+    EXPECT_TRUE((std::is_same<Hexagon, RegularPolygon<6>>::value));
+    EXPECT_EQ(Hexagon::amountOfPoints, 6);
+}
+
+TEST(RegularPolygonTests, AreaCoefficientMatchesTrigonometry) {
+    for (uint64_t n = 3; n <= 12; ++n) {
+        const double expected = n / 4.0 * cos(acos(-1.0) / n) / sin(acos(-1.0) / n);
+        EXPECT_NEAR(RegularPolygonAreaCoefficient(n), expected, 1e-15 * expected);
+    }
+}
+
+TEST(RegularPolygonTests, ConstexprCenterAndArea) {
+    constexpr std::array<Point, 4> square = {Point(0, 0), Point(2, 0), Point(2, 2), Point(0, 2)};
+    constexpr Point center = Rhombus::ComputeGeometricCenter(square);
+    constexpr double area = Rhombus::ComputeArea(square);
+    static_assert(center.x == 1.0 && center.y == 1.0, "constexpr center");
+    static_assert(area > 3.999999 && area < 4.000001, "constexpr area");
+    EXPECT_DOUBLE_EQ(area, static_cast<double>(Rhombus(square)));
+}
+
+TEST(RegularPolygonTests, TriangleArea) {
+    Triangle triangle;
+    std::istringstream is("0 0 1 0 0.5 0.8660254037844386");
+    is >> triangle;
+    EXPECT_NEAR(static_cast<double>(triangle), sqrt(3.0) / 4.0, 1e-12);
+    EXPECT_NEAR(triangle.GetGeometricCenter().y, 0.288675, 1e-6);
+}
+
+TEST(RegularPolygonTests, OctagonArea) {
+    std::array<Point, 8> points;
+    for (uint64_t i = 0; i < 8; ++i) {
+        points[i] = Point(cos(i * acos(-1.0) / 4), sin(i * acos(-1.0) / 4));
+    }
+    const Octagon octagon(points);
+    EXPECT_NEAR(static_cast<double>(octagon), 2.0 * sqrt(2.0), 1e-12);
+    const Point center = octagon.GetGeometricCenter();
+    EXPECT_NEAR(center.x, 0.0, 1e-12);
+    EXPECT_NEAR(center.y, 0.0, 1e-12);
+
+    std::ostringstream os;
+    os << Octagon();
+    EXPECT_EQ(os.str(), "(0 0) (0 0) (0 0) (0 0) (0 0) (0 0) (0 0) (0 0)");
+}
+
+TEST(RegularPolygonTests, ShoelaceAreaMode) {
+    constexpr std::array<Point, 4> square = {Point(0, 0), Point(3, 0), Point(3, 3), Point(0, 3)};
+    static_assert(Rhombus::ComputeShoelaceArea(square) == 9);
+
+    const Hexagon irregular({Point(0, 0), Point(10, 0), Point(10, 1), Point(5, 1), Point(1, 1), Point(0, 1)});
+    EXPECT_EQ(irregular.GetArea(AreaMode::Shoelace), 10);
+    EXPECT_EQ(irregular.GetArea(AreaMode::Classic), static_cast<double>(irregular));
+    EXPECT_NE(irregular.GetArea(AreaMode::Classic), 10);
+}
+
+TEST(RegularPolygonTests, AffineTransforms) {
+    Rhombus rhombus({Point(0, 1), Point(1, 0), Point(0, -1), Point(-1, 0)});
+    rhombus.Translate(2, 3);
+    EXPECT_TRUE(rhombus.GetGeometricCenter() == Point(2, 3));
+    rhombus.Scale(2, 1);
+    EXPECT_TRUE(rhombus.GetPoints()[1] == Point(6, 3));
+
+    rhombus.Rotate(3.141592653589793 / 2);
+    EXPECT_TRUE(rhombus.GetGeometricCenter() == Point(4, 3));
+    EXPECT_TRUE(rhombus.GetPoints()[1] == Point(4, 5));
+
+    const AffineTransform shear(1, 2, 0, 0, 1, 0);
+    const AffineTransform combined = shear.Then(AffineTransform::Translation(1, -1));
+    const Point moved = combined.Apply(Point(1, 1));
+    EXPECT_EQ(moved.x, 4);
+    EXPECT_EQ(moved.y, 0);
+    static_assert(AffineTransform().Apply(Point(3, 4)).y == 4);
+
+    Figure& figure = rhombus;
+    figure.Transform(AffineTransform::Scaling(0.5, 0.5));
+    EXPECT_TRUE(rhombus.GetGeometricCenter() == Point(2, 1.5));
+}
+
+TEST(RegularPolygonTests, Contains) {
+    constexpr std::array<Point, 4> square = {Point(0, 0), Point(4, 0), Point(4, 4), Point(0, 4)};
+    static_assert(OutlineContains(square.data(), 4, Point(2, 2)));
+    static_assert(!OutlineContains(square.data(), 4, Point(5, 2)));
+
+    const Rhombus rhombus(square);
+    EXPECT_TRUE(rhombus.Contains(Point(1, 3)));
+    EXPECT_TRUE(rhombus.Contains(Point(4, 2)));
+    EXPECT_TRUE(rhombus.Contains(Point(0, 0)));
+    EXPECT_TRUE(rhombus.Contains(Point(4 + 0.5 * pointEpsilon, 2)));
+    EXPECT_TRUE(rhombus.Contains(Point(-0.5 * pointEpsilon, -0.5 * pointEpsilon)));
+    EXPECT_FALSE(rhombus.Contains(Point(4 + 2 * pointEpsilon, 2)));
+    EXPECT_FALSE(rhombus.Contains(Point(-pointEpsilon, -pointEpsilon)));
+    EXPECT_FALSE(rhombus.Contains(Point(2, std::nan(""))));
+
+    // Clockwise and concave outlines work the same way.
+    const Hexagon notch({Point(0, 0), Point(0, 4), Point(4, 4), Point(4, 0), Point(2, 2), Point(1, 0)});
+    EXPECT_TRUE(notch.Contains(Point(1, 3)));
+    EXPECT_TRUE(notch.Contains(Point(0.5, 0.25)));
+    EXPECT_FALSE(notch.Contains(Point(2, 1)));
+    EXPECT_FALSE(notch.Contains(Point(3, 0.5)));
+
+    const Figure& figure = notch;
+    EXPECT_TRUE(figure.Contains(Point(2, 2)));
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "PointClassifier.h"
+#include "TestFigures.h"
+
+namespace {
+
+std::vector<Point> MakePoints(uint64_t count, uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> position(-5.0, 105.0);
+    std::vector<Point> points;
+    for (uint64_t i = 0; i < count; ++i) {
+        points.emplace_back(position(generator), position(generator));
+    }
+    return points;
+}
+
+std::vector<uint64_t> BruteForce(const std::vector<Point>& points, const FigureOutlines& figures) {
+    std::vector<uint64_t> labels(points.size(), noFigure);
+    for (uint64_t i = 0; i < points.size(); ++i) {
+        for (uint64_t j = 0; j < figures.Size(); ++j) {
+            if (OutlineContains(figures.GetPoints(j), figures.GetAmountOfPoints(j), points[i])) {
+                labels[i] = j;
+                break;
+            }
+        }
+    }
+    return labels;
+}
+
+}
+
+TEST(PointClassifierTests, MatchesBruteForce) {
+    const HexagonBatch batch = MakeHexagons(300, 61, 0.5, 4.0);
+    const FigureOutlines figures = MakeFigureOutlines(batch);
+    std::vector<Point> points = MakePoints(20000, 62);
+    // Vertices and their neighbourhood, where the epsilon rules decide.
+    for (uint64_t i = 0; i < 50; ++i) {
+        const Point& vertex = figures.GetPoints(i)[i % 6];
+        points.push_back(vertex);
+        points.emplace_back(vertex.x + 0.5 * pointEpsilon, vertex.y);
+        points.emplace_back(vertex.x + 2 * pointEpsilon, vertex.y);
+    }
+
+    const std::vector<uint64_t> expected = BruteForce(points, figures);
+    EXPECT_EQ(Classify(points.data(), points.size(), batch), expected);
+    for (double rowHeight : {0.0, 1.0, 1000.0}) {
+        const PointClassifier classifier(points.data(), points.size(), rowHeight);
+        std::vector<uint64_t> labels(points.size());
+        classifier.Classify(figures, labels.data());
+        EXPECT_EQ(labels, expected) << rowHeight;
+    }
+
+    uint64_t hits = 0;
+    for (uint64_t label : expected) {
+        hits += label != noFigure;
+    }
+    EXPECT_GT(hits, 1000u);
+}
+
+TEST(PointClassifierTests, ParallelMatchesSequential) {
+    const FigureOutlines figures = MakeFigureOutlines(MakeHexagons(500, 63, 0.5, 4.0));
+    const std::vector<Point> points = MakePoints(50000, 64);
+    ThreadPool pool(4);
+    EXPECT_EQ(Classify(points.data(), points.size(), figures, pool), Classify(points.data(), points.size(), figures));
+}
+
+TEST(PointClassifierTests, RowCount) {
+    const std::vector<Point> points = MakePoints(1600, 65);
+    EXPECT_EQ(PointClassifier(points.data(), points.size()).GetRowCount(), 100u);
+    EXPECT_EQ(PointClassifier(points.data(), points.size(), 1000).GetRowCount(), 1u);
+    EXPECT_EQ(PointClassifier(points.data(), points.size(), 11).GetRowCount(), 10u);
+    EXPECT_EQ(PointClassifier(points.data(), 3).GetRowCount(), 1u);
+    EXPECT_EQ(PointClassifier(nullptr, 0).GetRowCount(), 1u);
+}
+
+TEST(PointClassifierTests, FirstFigureWinsAndNanIsOutside) {
+    FigureArray figures;
+    figures.PushBack(Hexagon({Point(0, 0), Point(2, 0), Point(3, 1), Point(2, 2), Point(0, 2), Point(-1, 1)}));
+    figures.PushBack(Rhombus({Point(0, 0), Point(4, 0), Point(4, 4), Point(0, 4)}));
+    const std::vector<Point> points = {Point(1, 1), Point(3.5, 3.5), Point(9, 9), Point(std::nan(""), 1), Point(-0.5, 1)};
+
+    const std::vector<uint64_t> labels = Classify(points.data(), points.size(), figures);
+    EXPECT_EQ(labels, (std::vector<uint64_t>{0, 0, noFigure, noFigure, 1}));
+
+    FigureOutlines outlines = MakeFigureOutlines(figures);
+    EXPECT_EQ(outlines.Size(), 2u);
+    EXPECT_EQ(outlines.GetAmountOfPoints(1), 6u);
+    EXPECT_THROW(outlines.GetPoints(2), std::out_of_range);
+    EXPECT_THROW(outlines.PushBack(points.data(), 2), std::invalid_argument);
+
+    const std::vector<Polygon> polygons = {Polygon(std::vector<Point>{Point(5, 5), Point(10, 5), Point(10, 10)})};
+    EXPECT_EQ(Classify(points.data(), points.size(), MakeFigureOutlines(polygons))[2], 0u);
+}
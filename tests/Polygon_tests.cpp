@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include "Polygon.h"
+
+TEST(PolygonTests, ShoelaceArea) {
+    const Polygon square({Point(0, 0), Point(2, 0), Point(2, 2), Point(0, 2)});
+    EXPECT_EQ(static_cast<double>(square), 4);
+
+    const Polygon clockwise({Point(0, 2), Point(2, 2), Point(2, 0), Point(0, 0)});
+    EXPECT_EQ(static_cast<double>(clockwise), 4);
+
+    // Concave L shape of three unit squares.
+    const Polygon shape({Point(0, 0), Point(2, 0), Point(2, 1), Point(1, 1), Point(1, 2), Point(0, 2)});
+    EXPECT_EQ(static_cast<double>(shape), 3);
+    EXPECT_EQ(shape.GetAmountOfPoints(), 6);
+
+    const Polygon farAway({Point(1e9, 1e9), Point(1e9 + 1, 1e9), Point(1e9 + 1, 1e9 + 1), Point(1e9, 1e9 + 1)});
+    EXPECT_EQ(static_cast<double>(farAway), 1);
+}
+
+TEST(PolygonTests, MatchesFixedSizeFigures) {
+    const Pentagon pentagon({Point(0, 0), Point(4, 0), Point(5, 3), Point(2, 5), Point(-1, 3)});
+    const Polygon polygon(pentagon);
+    EXPECT_EQ(static_cast<double>(polygon), pentagon.GetArea(AreaMode::Shoelace));
+    EXPECT_EQ(polygon.GetGeometricCenter().x, pentagon.GetGeometricCenter().x);
+    EXPECT_EQ(polygon.GetGeometricCenter().y, pentagon.GetGeometricCenter().y);
+    EXPECT_EQ(polygon.GetBoundingBox().maxY, 5);
+    EXPECT_EQ(pentagon.GetArea(AreaMode::Classic), static_cast<double>(pentagon));
+}
+
+TEST(PolygonTests, StreamsAndComparison) {
+    Polygon polygon(7);
+    std::istringstream is("0 0 1 0 2 1 2 2 1 3 0 2 -1 1");
+    is >> polygon;
+    std::ostringstream os;
+    os << polygon;
+    EXPECT_EQ(os.str(), "(0 0) (1 0) (2 1) (2 2) (1 3) (0 2) (-1 1)");
+
+    Polygon rotated({Point(-1, 1), Point(0, 0), Point(1, 0), Point(2, 1), Point(2, 2), Point(1, 3), Point(0, 2)});
+    EXPECT_TRUE(polygon == rotated);
+    EXPECT_FALSE(polygon == Polygon(3));
+
+    Polygon copy(3);
+    copy = polygon;
+    EXPECT_TRUE(copy == polygon);
+    swap(copy, rotated);
+    EXPECT_EQ(copy.GetPoints()[0].x, -1);
+
+    std::istringstream bad("0 0 1 x");
+    EXPECT_THROW(bad >> copy, std::invalid_argument);
+}
+
+TEST(PolygonTests, TooFewPoints) {
+    EXPECT_THROW(Polygon(2), std::invalid_argument);
+    EXPECT_THROW(Polygon(std::vector<Point>{Point(), Point()}), std::invalid_argument);
+}
+
+TEST(PolygonTests, Transforms) {
+    Polygon polygon({Point(0, 0), Point(4, 0), Point(4, 2), Point(0, 2)});
+    polygon.Rotate(3.141592653589793);
+    EXPECT_TRUE(polygon.GetPoints()[0] == Point(4, 2));
+    EXPECT_NEAR(static_cast<double>(polygon), 8, 1e-12);
+
+    polygon.Scale(2, 3);
+    polygon.Translate(-1, 1);
+    EXPECT_TRUE(polygon.GetPoints()[0] == Point(7, 7));
+    EXPECT_NEAR(static_cast<double>(polygon), 48, 1e-12);
+}
+
+TEST(PolygonTests, Contains) {
+    const Polygon polygon({Point(0, 0), Point(6, 0), Point(6, 1), Point(1, 1), Point(1, 5), Point(0, 5), Point(0, 3)});
+    EXPECT_TRUE(polygon.Contains(Point(0.5, 4)));
+    EXPECT_TRUE(polygon.Contains(Point(5, 0.5)));
+    EXPECT_TRUE(polygon.Contains(Point(1, 3)));
+    EXPECT_FALSE(polygon.Contains(Point(3, 3)));
+    EXPECT_FALSE(polygon.Contains(Point(7, 0.5)));
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "SpatialIndex.h"
+#include "TestFigures.h"
+
+namespace {
+
+std::vector<SpatialEntry> MakeEntries(uint64_t count, uint64_t seed) {
+    return MakeSpatialEntries(MakeHexagons(count, seed, 0.1, 2.0));
+}
+
+std::vector<uint64_t> BruteQuery(const std::vector<SpatialEntry>& entries, const BoundingBox& window) {
+    std::vector<uint64_t> ids;
+    for (const SpatialEntry& entry : entries) {
+        if (entry.box.Intersects(window)) {
+            ids.push_back(entry.id);
+        }
+    }
+    return ids;
+}
+
+std::vector<uint64_t> BruteNearest(const std::vector<SpatialEntry>& entries, const Point& point, uint64_t k) {
+    std::vector<std::pair<double, uint64_t>> candidates;
+    for (const SpatialEntry& entry : entries) {
+        const double dx = entry.centroid.x - point.x;
+        const double dy = entry.centroid.y - point.y;
+        candidates.emplace_back(dx * dx + dy * dy, entry.id);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    std::vector<uint64_t> ids;
+    for (uint64_t i = 0; i < std::min<uint64_t>(k, candidates.size()); ++i) {
+        ids.push_back(candidates[i].second);
+    }
+    return ids;
+}
+
+std::vector<SpatialPair> BrutePairs(const std::vector<SpatialEntry>& entries) {
+    std::vector<SpatialPair> pairs;
+    for (uint64_t i = 0; i < entries.size(); ++i) {
+        for (uint64_t j = i + 1; j < entries.size(); ++j) {
+            if (entries[i].box.Intersects(entries[j].box)) {
+                pairs.emplace_back(entries[i].id, entries[j].id);
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+std::vector<uint64_t> Sorted(std::vector<uint64_t> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+template <typename Index>
+void ExpectMatchesBruteForce(const Index& index, const std::vector<SpatialEntry>& entries) {
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> position(-10.0, 110.0);
+    std::uniform_real_distribution<double> extent(0.0, 20.0);
+    for (int i = 0; i < 100; ++i) {
+        const double x = position(generator);
+        const double y = position(generator);
+        const BoundingBox window(x, y, x + extent(generator), y + extent(generator));
+        EXPECT_EQ(Sorted(index.Query(window)), BruteQuery(entries, window));
+
+        const Point point(position(generator), position(generator));
+        for (uint64_t k : {1, 5, 37}) {
+            EXPECT_EQ(index.Nearest(point, k), BruteNearest(entries, point, k));
+        }
+    }
+    EXPECT_EQ(index.OverlapPairs(), BrutePairs(entries));
+}
+
+}
+
+TEST(RTreeTests, MatchesBruteForce) {
+    const std::vector<SpatialEntry> entries = MakeEntries(3000, 1);
+    const RTree tree(entries, 8);
+    EXPECT_EQ(tree.Size(), 3000);
+    EXPECT_GE(tree.GetHeight(), 3);
+    ExpectMatchesBruteForce(tree, entries);
+}
+
+TEST(RTreeTests, ParallelBuildIsIdentical) {
+    const std::vector<SpatialEntry> entries = MakeEntries(20000, 2);
+    ThreadPool pool(4);
+    const RTree sequential(entries);
+    const RTree parallel(entries, pool);
+
+    const BoundingBox window(20, 20, 40, 30);
+    EXPECT_EQ(sequential.Query(window), parallel.Query(window));
+    EXPECT_EQ(sequential.Nearest(Point(50, 50), 20), parallel.Nearest(Point(50, 50), 20));
+    EXPECT_EQ(sequential.OverlapPairs(), parallel.OverlapPairs(pool));
+}
+
+TEST(RTreeTests, EmptyAndInvalid) {
+    const RTree tree;
+    EXPECT_TRUE(tree.Empty());
+    EXPECT_TRUE(tree.Query(BoundingBox(0, 0, 1, 1)).empty());
+    EXPECT_TRUE(tree.Nearest(Point(0, 0), 3).empty());
+    EXPECT_TRUE(tree.OverlapPairs().empty());
+    EXPECT_TRUE(tree.GetBounds().Empty());
+
+    std::vector<SpatialEntry> entries = MakeEntries(10, 3);
+    EXPECT_THROW(RTree(entries, 1), std::invalid_argument);
+    entries[4].box = BoundingBox();
+    EXPECT_THROW(RTree tree(entries), std::invalid_argument);
+}
+
+TEST(RTreeTests, NearestBreaksTiesById) {
+    std::vector<SpatialEntry> entries;
+    for (uint64_t i = 0; i < 40; ++i) {
+        const Point centroid(i % 2 == 0 ? 1.0 : -1.0, 0);
+        entries.push_back({BoundingBox(centroid.x, 0, centroid.x, 0), centroid, 39 - i});
+    }
+    const RTree tree(entries, 4);
+    const std::vector<uint64_t> nearest = tree.Nearest(Point(0, 0), 40);
+    ASSERT_EQ(nearest.size(), 40);
+    for (uint64_t i = 0; i < 40; ++i) {
+        EXPECT_EQ(nearest[i], i);
+    }
+}
+
+TEST(UniformGridTests, MatchesBruteForce) {
+    const std::vector<SpatialEntry> entries = MakeEntries(3000, 4);
+    const UniformGrid grid(entries);
+    EXPECT_GT(grid.GetColumnCount() * grid.GetRowCount(), 100);
+    ExpectMatchesBruteForce(grid, entries);
+
+    const UniformGrid coarse(entries, 30.0);
+    EXPECT_EQ(coarse.GetColumnCount(), 4);
+    ExpectMatchesBruteForce(coarse, entries);
+}
+
+TEST(UniformGridTests, ParallelBuildAndDegenerateData) {
+    const std::vector<SpatialEntry> entries = MakeEntries(20000, 5);
+    ThreadPool pool(4);
+    const UniformGrid grid(entries, pool);
+    EXPECT_EQ(grid.OverlapPairs(pool), UniformGrid(entries).OverlapPairs());
+
+    std::vector<SpatialEntry> line;
+    for (uint64_t i = 0; i < 100; ++i) {
+        const Point centroid(static_cast<double>(i), 5);
+        line.push_back({BoundingBox(centroid.x - 1, 4, centroid.x + 1, 6), centroid, i});
+    }
+    const UniformGrid lineGrid(line);
+    EXPECT_EQ(lineGrid.GetRowCount(), 1);
+    ExpectMatchesBruteForce(lineGrid, line);
+
+    EXPECT_THROW(UniformGrid(line, -1.0), std::invalid_argument);
+    EXPECT_TRUE(UniformGrid().Nearest(Point(0, 0), 1).empty());
+}
+
+TEST(SpatialEntryTests, FromFigures) {
+    FigureArray figures;
+    figures.PushBack(Rhombus({Point(0, 1), Point(1, 0), Point(0, -1), Point(-1, 0)}));
+    figures.PushBack(Hexagon({Point(10, 10), Point(12, 10), Point(13, 11), Point(12, 12), Point(10, 12), Point(9, 11)}));
+
+    const std::vector<SpatialEntry> entries = MakeSpatialEntries(figures);
+    ASSERT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries[1].id, 1);
+    EXPECT_EQ(entries[1].box.minX, 9);
+    EXPECT_EQ(entries[1].box.maxY, 12);
+    EXPECT_TRUE(entries[1].centroid == Point(11, 11));
+
+    const RTree tree(entries);
+    EXPECT_EQ(tree.Query(BoundingBox(8, 8, 9, 10)), std::vector<uint64_t>{1});
+    EXPECT_EQ(tree.Nearest(Point(2, 2), 1), std::vector<uint64_t>{0});
+}
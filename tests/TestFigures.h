@@ -0,0 +1,104 @@
+#ifndef TEST_FIGURES_H
+#define TEST_FIGURES_H
+
+#include <array>
+#include <cinttypes>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include "AnyFigure.h"
+#include "FigureBatch.h"
+#include "Figures.h"
+
+// Figures and figure files shared by the tests. Everything random is drawn
+// from a generator seeded with seed, so a test sees the same figures on
+// every run.
+
+inline Rhombus MakeRectangle(double minX, double minY, double maxX, double maxY) {
+    return Rhombus({Point(minX, minY), Point(maxX, minY), Point(maxX, maxY), Point(minX, maxY)});
+}
+
+inline Rhombus MakeSquare(double x, double y, double side) {
+    return MakeRectangle(x, y, x + side, y + side);
+}
+
+// Vertices on the circle of radius around center, the first at angle phase.
+template <uint64_t N>
+RegularPolygon<N> MakeRegular(const Point& center, double radius, double phase) {
+    std::array<Point, N> points;
+    for (uint64_t i = 0; i < N; ++i) {
+        const double angle = phase + 2 * 3.141592653589793 * static_cast<double>(i) / static_cast<double>(N);
+        points[i] = Point(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+    }
+    return RegularPolygon<N>(points);
+}
+
+// Regular hexagons centered in [0, 100) x [0, 100).
+inline HexagonBatch MakeHexagons(uint64_t count, uint64_t seed, double minRadius, double maxRadius) {
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> position(0.0, 100.0);
+    std::uniform_real_distribution<double> radius(minRadius, maxRadius);
+    HexagonBatch batch(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        const Point center(position(generator), position(generator));
+        batch.PushBack(MakeRegular<6>(center, radius(generator), 0));
+    }
+    return batch;
+}
+
+// Figures up to size across, scattered around center.
+template <uint64_t N>
+FigureBatch<N> MakeScatteredBatch(uint64_t count, const Point& center, double spread, double size, uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> position(-spread, spread);
+    std::uniform_real_distribution<double> offset(0.0, size);
+    FigureBatch<N> batch(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        const Point corner(center.x + position(generator), center.y + position(generator));
+        std::array<Point, N> points;
+        for (uint64_t j = 0; j < N; ++j) {
+            points[j] = Point(corner.x + offset(generator), corner.y + offset(generator));
+        }
+        batch.PushBack(points);
+    }
+    return batch;
+}
+
+// Squares and hexagons in [0, 100) x [0, 100), every third a square.
+inline FigureArray MakeFigureArray(uint64_t count, uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> position(0, 100);
+    std::uniform_real_distribution<double> size(0.5, 3);
+    FigureArray figures;
+    for (uint64_t i = 0; i < count; ++i) {
+        const double x = position(generator);
+        const double y = position(generator);
+        const double side = size(generator);
+        if (i % 3 == 0) {
+            figures.PushBack(MakeSquare(x, y, side));
+        } else {
+            figures.PushBack(Hexagon({Point(x, y), Point(x + side, y), Point(x + 1.5 * side, y + side),
+                                      Point(x + side, y + 2 * side), Point(x, y + 2 * side),
+                                      Point(x - 0.5 * side, y + side)}));
+        }
+    }
+    return figures;
+}
+
+// Text of count rhombi, 8 coordinates in [-10, 10) each. A figure ends its
+// line, and its values are wrapped onto further lines after every
+// valuesPerLine of them.
+inline std::string MakeFigureText(uint64_t count, uint64_t seed, uint64_t valuesPerLine = 8) {
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> distribution(-10.0, 10.0);
+    std::ostringstream os;
+    for (uint64_t i = 0; i < count; ++i) {
+        for (uint64_t j = 0; j < 8; ++j) {
+            os << distribution(generator) << (j == 7 || (j + 1) % valuesPerLine == 0 ? '\n' : ' ');
+        }
+    }
+    return os.str();
+}
+
+#endif
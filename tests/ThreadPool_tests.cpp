@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "ThreadPool.h"
+
+TEST(ThreadPoolTests, EveryIndexVisitedOnce) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.GetThreadCount(), 4);
+    std::vector<std::atomic<int>> visits(10007);
+    pool.ParallelFor(visits.size(), 100, [&visits](uint64_t, uint64_t begin, uint64_t end) {
+        for (uint64_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+    for (const std::atomic<int>& visit : visits) {
+        EXPECT_EQ(visit.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTests, ExceptionIsRethrown) {
+    ThreadPool pool(3);
+    EXPECT_THROW(pool.ParallelFor(1000, 10, [](uint64_t chunk, uint64_t, uint64_t) {
+        if (chunk == 42) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+    std::atomic<uint64_t> total(0);
+    pool.ParallelFor(1000, 10, [&total](uint64_t, uint64_t begin, uint64_t end) { total += end - begin; });
+    EXPECT_EQ(total.load(), 1000);
+}
+
+TEST(ThreadPoolTests, NestedParallelForRunsInline) {
+    ThreadPool pool(2);
+    std::atomic<uint64_t> total(0);
+    pool.ParallelFor(4, 1, [&pool, &total](uint64_t, uint64_t, uint64_t) {
+        pool.ParallelFor(10, 3, [&total](uint64_t, uint64_t begin, uint64_t end) { total += end - begin; });
+    });
+    EXPECT_EQ(total.load(), 40);
+}
+
+TEST(ThreadPoolTests, RunChunksWithoutPoolRunsInOrder) {
+    std::vector<uint64_t> chunks;
+    ThreadPool::RunChunks(nullptr, 250, 100, [&chunks](uint64_t chunk, uint64_t begin, uint64_t end) {
+        EXPECT_EQ(begin, chunk * 100);
+        EXPECT_EQ(end, std::min<uint64_t>(250, begin + 100));
+        chunks.push_back(chunk);
+    });
+    EXPECT_EQ(chunks, (std::vector<uint64_t>{0, 1, 2}));
+}